@@ -4,11 +4,60 @@
  * SPDX-License-Identifier: BSD-2-Clause-Patent
  */
 #define D_LOGFAC	DD_FAC(bio)
+#include <unistd.h>
+#include <sys/syscall.h>
 #include <spdk/env.h>
 #include <spdk/blob.h>
 #include <spdk/thread.h>
+#include <gurt/trace.h>
 #include "bio_internal.h"
 
+/*
+ * Huge chunks are rounded up to 1MB so that released ones can be reused by
+ * later huge IOVs of similar size, at most BIO_DMA_HUGE_MAG_CHKS regular
+ * chunks worth of huge chunks are cached in the per-xstream magazine.
+ */
+#define BIO_DMA_HUGE_ALIGN	(1UL << (20 - BIO_DMA_PAGE_SHIFT))
+#define BIO_DMA_HUGE_MAG_CHKS	4
+/* Max NUMA nodes tracked by the shared DMA chunk pool */
+#define BIO_DMA_NODES_MAX	8
+
+/*
+ * Per-NUMA pool of idle DMA chunks. Chunks of a destroyed per-xstream DMA
+ * buffer are parked here instead of being returned to SPDK, so that the
+ * hugepage backed memory (and the IOMMU mappings) stay stable across the
+ * engine lifetime, the buffer of the next xstream on the same node will
+ * grab chunks from here before allocating from SPDK.
+ */
+struct bio_dma_pool {
+	ABT_mutex	bdp_mutex;
+	d_list_t	bdp_idle_list;
+	unsigned int	bdp_idle_cnt;
+};
+
+static struct bio_dma_pool	dma_pools[BIO_DMA_NODES_MAX];
+static bool			dma_pool_inited;
+
+static inline int
+dma_numa_node_self(void)
+{
+	unsigned int	cpu, node;
+
+	if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0)
+		return SPDK_ENV_SOCKET_ID_ANY;
+	return node;
+}
+
+static inline struct bio_dma_pool *
+dma_pool_get(int node)
+{
+	if (!dma_pool_inited)
+		return NULL;
+	if (node < 0 || node >= BIO_DMA_NODES_MAX)
+		node = 0;
+	return &dma_pools[node];
+}
+
 static void
 dma_free_chunk(struct bio_dma_chunk *chunk)
 {
@@ -26,7 +75,7 @@ dma_free_chunk(struct bio_dma_chunk *chunk)
 }
 
 static struct bio_dma_chunk *
-dma_alloc_chunk(unsigned int cnt)
+dma_alloc_chunk(unsigned int cnt, int node)
 {
 	struct bio_dma_chunk *chunk;
 	ssize_t bytes = (ssize_t)cnt << BIO_DMA_PAGE_SHIFT;
@@ -40,7 +89,12 @@ dma_alloc_chunk(unsigned int cnt)
 	}
 
 	if (bio_nvme_configured()) {
-		chunk->bdc_ptr = spdk_dma_malloc(bytes, BIO_DMA_PAGE_SZ, NULL);
+		chunk->bdc_ptr = spdk_dma_malloc_socket(bytes, BIO_DMA_PAGE_SZ,
+							NULL, node);
+		/* Fallback to any node when the local node is exhausted */
+		if (chunk->bdc_ptr == NULL && node != SPDK_ENV_SOCKET_ID_ANY)
+			chunk->bdc_ptr = spdk_dma_malloc(bytes, BIO_DMA_PAGE_SZ,
+							 NULL);
 	} else {
 		rc = posix_memalign(&chunk->bdc_ptr, BIO_DMA_PAGE_SZ, bytes);
 		if (rc)
@@ -53,26 +107,113 @@ dma_alloc_chunk(unsigned int cnt)
 		return NULL;
 	}
 	D_INIT_LIST_HEAD(&chunk->bdc_link);
+	chunk->bdc_pg_cnt = cnt;
 
 	return chunk;
 }
 
+int
+dma_pool_init(void)
+{
+	int	i, rc;
+
+	D_ASSERT(!dma_pool_inited);
+	for (i = 0; i < BIO_DMA_NODES_MAX; i++) {
+		rc = ABT_mutex_create(&dma_pools[i].bdp_mutex);
+		if (rc != ABT_SUCCESS) {
+			while (--i >= 0)
+				ABT_mutex_free(&dma_pools[i].bdp_mutex);
+			return dss_abterr2der(rc);
+		}
+		D_INIT_LIST_HEAD(&dma_pools[i].bdp_idle_list);
+		dma_pools[i].bdp_idle_cnt = 0;
+	}
+	dma_pool_inited = true;
+
+	return 0;
+}
+
+void
+dma_pool_fini(void)
+{
+	struct bio_dma_pool	*pool;
+	struct bio_dma_chunk	*chunk, *tmp;
+	int			 i;
+
+	if (!dma_pool_inited)
+		return;
+
+	for (i = 0; i < BIO_DMA_NODES_MAX; i++) {
+		pool = &dma_pools[i];
+		d_list_for_each_entry_safe(chunk, tmp, &pool->bdp_idle_list,
+					   bdc_link) {
+			d_list_del_init(&chunk->bdc_link);
+			dma_free_chunk(chunk);
+			pool->bdp_idle_cnt--;
+		}
+		D_ASSERT(pool->bdp_idle_cnt == 0);
+		ABT_mutex_free(&pool->bdp_mutex);
+	}
+	dma_pool_inited = false;
+}
+
+/* Grab up to @cnt idle chunks from the per-NUMA pool */
+static unsigned int
+dma_pool_grab(struct bio_dma_buffer *buf, unsigned int cnt)
+{
+	struct bio_dma_pool	*pool = dma_pool_get(buf->bdb_numa_node);
+	struct bio_dma_chunk	*chunk;
+	unsigned int		 grabbed = 0;
+
+	if (pool == NULL)
+		return 0;
+
+	ABT_mutex_lock(pool->bdp_mutex);
+	while (grabbed < cnt && !d_list_empty(&pool->bdp_idle_list)) {
+		chunk = d_list_entry(pool->bdp_idle_list.next,
+				     struct bio_dma_chunk, bdc_link);
+		d_list_move_tail(&chunk->bdc_link, &buf->bdb_idle_list);
+		D_ASSERT(pool->bdp_idle_cnt > 0);
+		pool->bdp_idle_cnt--;
+		grabbed++;
+	}
+	ABT_mutex_unlock(pool->bdp_mutex);
+
+	buf->bdb_tot_cnt += grabbed;
+	return grabbed;
+}
+
 static void
 dma_buffer_shrink(struct bio_dma_buffer *buf, unsigned int cnt)
 {
-	struct bio_dma_chunk *chunk, *tmp;
+	struct bio_dma_pool	*pool = dma_pool_get(buf->bdb_numa_node);
+	struct bio_dma_chunk	*chunk, *tmp;
+
+	if (pool != NULL)
+		ABT_mutex_lock(pool->bdp_mutex);
 
 	d_list_for_each_entry_safe(chunk, tmp, &buf->bdb_idle_list, bdc_link) {
 		if (cnt == 0)
 			break;
 
-		d_list_del_init(&chunk->bdc_link);
-		dma_free_chunk(chunk);
+		if (pool != NULL) {
+			d_list_move_tail(&chunk->bdc_link,
+					 &pool->bdp_idle_list);
+			pool->bdp_idle_cnt++;
+		} else {
+			d_list_del_init(&chunk->bdc_link);
+			dma_free_chunk(chunk);
+		}
 
 		D_ASSERT(buf->bdb_tot_cnt > 0);
 		buf->bdb_tot_cnt--;
 		cnt--;
 	}
+
+	if (pool != NULL)
+		ABT_mutex_unlock(pool->bdp_mutex);
+
+	d_tm_set_gauge(buf->bdb_stats.bds_chks_tot, buf->bdb_tot_cnt);
 }
 
 int
@@ -83,8 +224,9 @@ dma_buffer_grow(struct bio_dma_buffer *buf, unsigned int cnt)
 
 	D_ASSERT((buf->bdb_tot_cnt + cnt) <= bio_chk_cnt_max);
 
+	cnt -= dma_pool_grab(buf, cnt);
 	for (i = 0; i < cnt; i++) {
-		chunk = dma_alloc_chunk(bio_chk_sz);
+		chunk = dma_alloc_chunk(bio_chk_sz, buf->bdb_numa_node);
 		if (chunk == NULL) {
 			rc = -DER_NOMEM;
 			break;
@@ -93,28 +235,188 @@ dma_buffer_grow(struct bio_dma_buffer *buf, unsigned int cnt)
 		d_list_add_tail(&chunk->bdc_link, &buf->bdb_idle_list);
 		buf->bdb_tot_cnt++;
 	}
+	d_tm_set_gauge(buf->bdb_stats.bds_chks_tot, buf->bdb_tot_cnt);
+	buf->bdb_grow_ts = d_timeus_secdiff(0);
 
 	return rc;
 }
 
+/*
+ * Hand the chunks grown by an I/O burst to the per-NUMA pool, so that other
+ * xstreams can grow from them. Called periodically from the NVMe poll, the
+ * chunks are kept until the xstream is idle and has stopped growing for
+ * BIO_DMA_RECLAIM_PERIOD.
+ */
+void
+dma_buffer_reclaim(struct bio_dma_buffer *buf, uint64_t now)
+{
+	if (now - buf->bdb_reclaim_ts < BIO_DMA_RECLAIM_PERIOD)
+		return;
+	buf->bdb_reclaim_ts = now;
+
+	if (buf->bdb_active_iods != 0 || buf->bdb_tot_cnt <= buf->bdb_init_cnt)
+		return;
+
+	if (now - buf->bdb_grow_ts < BIO_DMA_RECLAIM_PERIOD ||
+	    dma_pool_get(buf->bdb_numa_node) == NULL)
+		return;
+
+	dma_buffer_shrink(buf, buf->bdb_tot_cnt - buf->bdb_init_cnt);
+}
+
+/* Get a huge chunk from the per-xstream magazine or allocate a new one */
+static struct bio_dma_chunk *
+dma_huge_get(struct bio_dma_buffer *buf, unsigned int pg_cnt)
+{
+	struct bio_dma_chunk *chunk;
+
+	d_list_for_each_entry(chunk, &buf->bdb_huge_list, bdc_link) {
+		/* Don't waste more than half of a cached chunk */
+		if (chunk->bdc_pg_cnt < pg_cnt ||
+		    chunk->bdc_pg_cnt > pg_cnt * 2)
+			continue;
+
+		d_list_del_init(&chunk->bdc_link);
+		D_ASSERT(buf->bdb_huge_pgs >= chunk->bdc_pg_cnt);
+		buf->bdb_huge_pgs -= chunk->bdc_pg_cnt;
+		return chunk;
+	}
+
+	d_tm_inc_counter(buf->bdb_stats.bds_huge_allocs, 1);
+	pg_cnt = D_ALIGNUP(pg_cnt, BIO_DMA_HUGE_ALIGN);
+	return dma_alloc_chunk(pg_cnt, buf->bdb_numa_node);
+}
+
+/* Put a released huge chunk in the magazine, evict LRU ones if it's full */
+static void
+dma_huge_put(struct bio_dma_buffer *buf, struct bio_dma_chunk *chunk)
+{
+	struct bio_dma_chunk	*victim;
+	unsigned int		 max_pgs;
+
+	D_ASSERT(d_list_empty(&chunk->bdc_link));
+	max_pgs = bio_chk_sz * BIO_DMA_HUGE_MAG_CHKS;
+	if (chunk->bdc_pg_cnt > max_pgs) {
+		dma_free_chunk(chunk);
+		return;
+	}
+
+	while (buf->bdb_huge_pgs + chunk->bdc_pg_cnt > max_pgs) {
+		D_ASSERT(!d_list_empty(&buf->bdb_huge_list));
+		victim = d_list_entry(buf->bdb_huge_list.prev,
+				      struct bio_dma_chunk, bdc_link);
+		d_list_del_init(&victim->bdc_link);
+		D_ASSERT(buf->bdb_huge_pgs >= victim->bdc_pg_cnt);
+		buf->bdb_huge_pgs -= victim->bdc_pg_cnt;
+		dma_free_chunk(victim);
+	}
+
+	d_list_add(&chunk->bdc_link, &buf->bdb_huge_list);
+	buf->bdb_huge_pgs += chunk->bdc_pg_cnt;
+}
+
 void
 dma_buffer_destroy(struct bio_dma_buffer *buf)
 {
+	struct bio_dma_chunk	*chunk, *tmp;
+	int			 i;
+
 	D_ASSERT(d_list_empty(&buf->bdb_used_list));
 	D_ASSERT(buf->bdb_active_iods == 0);
 
 	bulk_cache_destroy(buf);
 	dma_buffer_shrink(buf, buf->bdb_tot_cnt);
 
+	d_list_for_each_entry_safe(chunk, tmp, &buf->bdb_huge_list, bdc_link) {
+		d_list_del_init(&chunk->bdc_link);
+		D_ASSERT(buf->bdb_huge_pgs >= chunk->bdc_pg_cnt);
+		buf->bdb_huge_pgs -= chunk->bdc_pg_cnt;
+		dma_free_chunk(chunk);
+	}
+	D_ASSERT(buf->bdb_huge_pgs == 0);
+
 	D_ASSERT(buf->bdb_tot_cnt == 0);
 	ABT_mutex_free(&buf->bdb_mutex);
 	ABT_cond_free(&buf->bdb_wait_iods);
 
+	d_tm_set_gauge(buf->bdb_stats.bds_chks_tot, 0);
+	for (i = 0; i < BIO_CHK_TYPE_MAX; i++)
+		d_tm_set_gauge(buf->bdb_stats.bds_chks_used[i], 0);
+
 	D_FREE(buf);
 }
 
+static const char *dma_chk_type_names[BIO_CHK_TYPE_MAX] = {
+	"io", "local", "rebuild",
+};
+
+static void
+dma_metrics_init(struct bio_dma_stats *stats, int tgt_id)
+{
+	int	i, rc;
+
+	rc = d_tm_add_metric(&stats->bds_chks_tot, D_TM_GAUGE,
+			     "Total DMA chunks", "chunks",
+			     "dmabuff/total_chunks/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create total_chunks sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	for (i = 0; i < BIO_CHK_TYPE_MAX; i++) {
+		rc = d_tm_add_metric(&stats->bds_chks_used[i], D_TM_GAUGE,
+				     "Used DMA chunks", "chunks",
+				     "dmabuff/used_chunks_%s/tgt_%d",
+				     dma_chk_type_names[i], tgt_id);
+		if (rc)
+			D_WARN("Failed to create used_chunks_%s sensor: "
+			       DF_RC"\n", dma_chk_type_names[i], DP_RC(rc));
+	}
+
+	rc = d_tm_add_metric(&stats->bds_queued_iods, D_TM_COUNTER,
+			     "IODs stalled on exhausted DMA buffer", "iods",
+			     "dmabuff/queued_iods/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create queued_iods sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_grab_errs, D_TM_COUNTER,
+			     "Failed attempts to grab an idle DMA chunk",
+			     "errors", "dmabuff/grab_errs/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create grab_errs sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_huge_allocs, D_TM_COUNTER,
+			     "Huge DMA chunks allocated from SPDK", "chunks",
+			     "dmabuff/huge_allocs/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create huge_allocs sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_read_ios, D_TM_COUNTER,
+			     "NVMe read commands issued", "cmds",
+			     "dmabuff/read_ios/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create read_ios sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_read_merged, D_TM_COUNTER,
+			     "NVMe read regions merged into a larger read",
+			     "regions", "dmabuff/read_merged/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create read_merged sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_read_gap_bytes, D_TM_COUNTER,
+			     "Bytes read to bridge the gaps of merged reads",
+			     "bytes", "dmabuff/read_gap_bytes/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create read_gap_bytes sensor: "DF_RC"\n",
+		       DP_RC(rc));
+}
+
 struct bio_dma_buffer *
-dma_buffer_create(unsigned int init_cnt)
+dma_buffer_create(unsigned int init_cnt, int tgt_id)
 {
 	struct bio_dma_buffer *buf;
 	int rc;
@@ -125,8 +427,16 @@ dma_buffer_create(unsigned int init_cnt)
 
 	D_INIT_LIST_HEAD(&buf->bdb_idle_list);
 	D_INIT_LIST_HEAD(&buf->bdb_used_list);
+	D_INIT_LIST_HEAD(&buf->bdb_huge_list);
 	buf->bdb_tot_cnt = 0;
+	buf->bdb_init_cnt = init_cnt;
 	buf->bdb_active_iods = 0;
+	buf->bdb_huge_pgs = 0;
+	buf->bdb_numa_node = dma_numa_node_self();
+
+	/* Skip metrics registration for the self poll context */
+	if (tgt_id >= 0)
+		dma_metrics_init(&buf->bdb_stats, tgt_id);
 
 	rc = ABT_mutex_create(&buf->bdb_mutex);
 	if (rc != ABT_SUCCESS) {
@@ -213,10 +523,17 @@ bio_iod_free(struct bio_desc *biod)
 	D_FREE(biod);
 }
 
+static inline void
+dma_used_gauge_set(struct bio_dma_buffer *bdb, unsigned int type)
+{
+	d_tm_set_gauge(bdb->bdb_stats.bds_chks_used[type],
+		       bdb->bdb_used_cnt[type]);
+}
+
 static inline bool
 dma_chunk_is_huge(struct bio_dma_chunk *chunk)
 {
-	return d_list_empty(&chunk->bdc_link);
+	return chunk->bdc_pg_cnt > bio_chk_sz;
 }
 
 /*
@@ -245,6 +562,9 @@ iod_release_buffer(struct bio_desc *biod)
 	D_FREE(rsrvd_dma->brd_regions);
 	rsrvd_dma->brd_regions = NULL;
 	rsrvd_dma->brd_rg_max = rsrvd_dma->brd_rg_cnt = 0;
+	rsrvd_dma->brd_nvme_cnt = 0;
+	rsrvd_dma->brd_rg_merged = 0;
+	rsrvd_dma->brd_gap_bytes = 0;
 
 	/* All DMA chunks are used through cached bulk handle */
 	if (rsrvd_dma->brd_chk_cnt == 0) {
@@ -272,11 +592,12 @@ iod_release_buffer(struct bio_desc *biod)
 			chunk->bdc_type);
 
 		if (dma_chunk_is_huge(chunk)) {
-			dma_free_chunk(chunk);
+			dma_huge_put(bdb, chunk);
 		} else if (chunk->bdc_ref == 0) {
 			chunk->bdc_pg_idx = 0;
 			D_ASSERT(bdb->bdb_used_cnt[chunk->bdc_type] > 0);
 			bdb->bdb_used_cnt[chunk->bdc_type] -= 1;
+			dma_used_gauge_set(bdb, chunk->bdc_type);
 			if (chunk == bdb->bdb_cur_chk[chunk->bdc_type])
 				bdb->bdb_cur_chk[chunk->bdc_type] = NULL;
 			d_list_move_tail(&chunk->bdc_link, &bdb->bdb_idle_list);
@@ -432,8 +753,11 @@ chunk_reserve(struct bio_dma_chunk *chk, unsigned int chk_pg_idx,
 	D_ASSERTF(chk->bdc_pg_idx <= bio_chk_sz, "%u > %u\n",
 		  chk->bdc_pg_idx, bio_chk_sz);
 
-	D_ASSERTF(chk_pg_idx == chk->bdc_pg_idx ||
-		  (chk_pg_idx + 1) == chk->bdc_pg_idx, "%u, %u\n",
+	/*
+	 * The reserve could start from the last used page for consecutive
+	 * reserve, or skip a few pages for the gap bridged on read.
+	 */
+	D_ASSERTF(chk_pg_idx + 1 >= chk->bdc_pg_idx, "%u, %u\n",
 		  chk_pg_idx, chk->bdc_pg_idx);
 
 	/* The chunk doesn't have enough unused pages */
@@ -472,8 +796,10 @@ chunk_get_idle(struct bio_dma_buffer *bdb, struct bio_dma_chunk **chk_ptr)
 
 		/* Try to reclaim an unused chunk from bulk groups */
 		rc = bulk_reclaim_chunk(bdb, NULL);
-		if (rc)
+		if (rc) {
+			d_tm_inc_counter(bdb->bdb_stats.bds_grab_errs, 1);
 			return rc;
+		}
 	}
 done:
 	D_ASSERT(!d_list_empty(&bdb->bdb_idle_list));
@@ -583,6 +909,42 @@ direct_scm_access(struct bio_desc *biod, struct bio_iov *biov)
 	return false;
 }
 
+/*
+ * Check if the NVMe read [@off, @end) could be coalesced with the last
+ * reserved region @rg by reading the gap in between, so that the two
+ * regions can be served by single NVMe command. The gap pages are read
+ * into the DMA buffer and simply discarded.
+ */
+static inline bool
+read_coalescable(struct bio_desc *biod, struct bio_rsrvd_region *rg,
+		 uint64_t off, uint64_t end)
+{
+	uint64_t	rg_pg_start, rg_pg_end, cur_pg;
+
+	/* Never write the gap back to media */
+	if (biod->bd_type != BIO_IOD_TYPE_FETCH || bio_read_max == 0 ||
+	    biod->bd_no_coalesce)
+		return false;
+
+	if (off < rg->brr_end)
+		return false;
+
+	rg_pg_start = rg->brr_off >> BIO_DMA_PAGE_SHIFT;
+	rg_pg_end = (rg->brr_end + BIO_DMA_PAGE_SZ - 1) >> BIO_DMA_PAGE_SHIFT;
+	cur_pg = off >> BIO_DMA_PAGE_SHIFT;
+
+	if (cur_pg - rg_pg_end > bio_read_gap)
+		return false;
+
+	if (((end + BIO_DMA_PAGE_SZ - 1) >> BIO_DMA_PAGE_SHIFT) - rg_pg_start >
+	    bio_read_max)
+		return false;
+
+	/* Region must be the last reservation in its chunk */
+	return rg->brr_chk->bdc_pg_idx ==
+		rg->brr_pg_idx + (rg_pg_end - rg_pg_start);
+}
+
 /* Convert offset of @biov into memory pointer */
 int
 dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
@@ -611,26 +973,31 @@ dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
 	}
 	D_ASSERT(!BIO_ADDR_IS_DEDUP(&biov->bi_addr));
 
+	if (bio_iov2media(biov) == DAOS_MEDIA_NVME)
+		biod->bd_rsrvd.brd_nvme_cnt++;
+
 	bdb = iod_dma_buf(biod);
 	dma_biov2pg(biov, &off, &end, &pg_cnt, &pg_off);
 
 	/*
 	 * For huge IOV, we'll bypass our per-xstream DMA buffer cache and
 	 * allocate chunk from the SPDK reserved huge pages directly, this
-	 * kind of huge chunk will be freed immediately on I/O completion.
+	 * kind of huge chunk will be parked in the per-xstream huge chunk
+	 * magazine on I/O completion, so that back-to-back huge IOVs don't
+	 * have to hit the SPDK huge page allocator each time.
 	 *
 	 * We assume the contiguous huge IOV is quite rare, so there won't
 	 * be high contention over the SPDK huge page cache.
 	 */
 	if (pg_cnt > bio_chk_sz) {
-		chk = dma_alloc_chunk(pg_cnt);
+		chk = dma_huge_get(bdb, pg_cnt);
 		if (chk == NULL)
 			return -DER_NOMEM;
 
 		chk->bdc_type = biod->bd_chk_type;
 		rc = iod_add_chunk(biod, chk);
 		if (rc) {
-			dma_free_chunk(chk);
+			dma_huge_put(bdb, chk);
 			return rc;
 		}
 		bio_iov_set_raw_buf(biov, chk->bdc_ptr + pg_off);
@@ -672,6 +1039,21 @@ dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
 				D_DEBUG(DB_TRACE, "Consecutive reserve %p.\n",
 					bio_iov2raw_buf(biov));
 				last_rg->brr_end = end;
+				biod->bd_rsrvd.brd_rg_merged++;
+				return 0;
+			}
+		} else if (read_coalescable(biod, last_rg, off, end)) {
+			chk_pg_idx += (cur_pg - prev_pg_start);
+			bio_iov_set_raw_buf(biov,
+				chunk_reserve(chk, chk_pg_idx, pg_cnt, pg_off));
+			if (bio_iov2raw_buf(biov) != NULL) {
+				D_DEBUG(DB_TRACE, "Coalesced reserve %p, gap:"
+					DF_U64"\n", bio_iov2raw_buf(biov),
+					off - last_rg->brr_end);
+				biod->bd_rsrvd.brd_gap_bytes +=
+					off - last_rg->brr_end;
+				last_rg->brr_end = end;
+				biod->bd_rsrvd.brd_rg_merged++;
 				return 0;
 			}
 		}
@@ -731,6 +1113,7 @@ dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
 	chk->bdc_type = biod->bd_chk_type;
 	bdb->bdb_cur_chk[chk->bdc_type] = chk;
 	bdb->bdb_used_cnt[chk->bdc_type] += 1;
+	dma_used_gauge_set(bdb, chk->bdc_type);
 	chk_pg_idx = chk->bdc_pg_idx;
 
 	D_ASSERT(chk_pg_idx == 0);
@@ -912,6 +1295,7 @@ dma_rw(struct bio_desc *biod)
 	struct bio_rsrvd_dma	*rsrvd_dma = &biod->bd_rsrvd;
 	struct bio_rsrvd_region	*rg;
 	struct bio_xs_context	*xs_ctxt;
+	unsigned int		 nvme_ios = 0;
 	int			 i;
 
 	D_ASSERT(biod->bd_ctxt->bic_xs_ctxt);
@@ -931,10 +1315,23 @@ dma_rw(struct bio_desc *biod)
 		D_ASSERT(rg->brr_chk != NULL);
 		D_ASSERT(rg->brr_end > rg->brr_off);
 
-		if (rg->brr_media == DAOS_MEDIA_SCM)
+		if (rg->brr_media == DAOS_MEDIA_SCM) {
 			scm_rw(biod, rg);
-		else
+		} else {
 			nvme_rw(biod, rg);
+			nvme_ios++;
+		}
+	}
+
+	/* Per-target counters, target xstreams never share them */
+	if (biod->bd_type == BIO_IOD_TYPE_FETCH && nvme_ios != 0) {
+		struct bio_dma_stats *stats = &iod_dma_buf(biod)->bdb_stats;
+
+		d_tm_inc_counter(stats->bds_read_ios, nvme_ios);
+		d_tm_inc_counter(stats->bds_read_merged,
+				 rsrvd_dma->brd_rg_merged);
+		d_tm_inc_counter(stats->bds_read_gap_bytes,
+				 rsrvd_dma->brd_gap_bytes);
 	}
 
 	if (xs_ctxt->bxc_tgt_id == -1) {
@@ -961,9 +1358,43 @@ dma_drop_iod(struct bio_dma_buffer *bdb)
 	ABT_mutex_unlock(bdb->bdb_mutex);
 }
 
-int
-bio_iod_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
-	     unsigned int bulk_perm)
+/*
+ * Sanity check the coalesced NVMe reads before issuing them: each NVMe biov
+ * either started a region or was merged into one, and a bridged gap spans
+ * at most bio_read_gap whole pages.
+ */
+static int
+dma_check_coalesced(struct bio_desc *biod)
+{
+	struct bio_rsrvd_dma	*rsrvd_dma = &biod->bd_rsrvd;
+	unsigned int		 nvme_rgs = 0;
+	int			 i;
+
+	if (rsrvd_dma->brd_rg_merged == 0)
+		return 0;
+
+	for (i = 0; i < rsrvd_dma->brd_rg_cnt; i++) {
+		if (rsrvd_dma->brd_regions[i].brr_media != DAOS_MEDIA_SCM)
+			nvme_rgs++;
+	}
+
+	if (nvme_rgs + rsrvd_dma->brd_rg_merged != rsrvd_dma->brd_nvme_cnt ||
+	    rsrvd_dma->brd_gap_bytes >
+	    ((uint64_t)rsrvd_dma->brd_rg_merged * (bio_read_gap + 2) <<
+	     BIO_DMA_PAGE_SHIFT)) {
+		D_ERROR("IOD %p bad coalesced read, regions:%u merged:%u "
+			"biovs:%u gap:"DF_U64", "DF_RC"\n", biod, nvme_rgs,
+			rsrvd_dma->brd_rg_merged, rsrvd_dma->brd_nvme_cnt,
+			rsrvd_dma->brd_gap_bytes, DP_RC(-DER_INVAL));
+		return -DER_INVAL;
+	}
+
+	return 0;
+}
+
+static int
+iod_prep_internal(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
+		  unsigned int bulk_perm)
 {
 	struct bio_bulk_args	 bulk_arg;
 	struct bio_dma_buffer	*bdb;
@@ -1003,6 +1434,7 @@ retry:
 
 		D_DEBUG(DB_IO, "IOD %p waits for active IODs. %d\n",
 			biod, retry_cnt++);
+		d_tm_inc_counter(bdb->bdb_stats.bds_queued_iods, 1);
 
 		ABT_mutex_lock(bdb->bdb_mutex);
 		ABT_cond_wait(bdb->bdb_wait_iods, bdb->bdb_mutex);
@@ -1013,6 +1445,14 @@ retry:
 
 		goto retry;
 	}
+
+	/* Map the IOD again without coalescing if the accounting is off */
+	if (biod->bd_type == BIO_IOD_TYPE_FETCH && !biod->bd_no_coalesce &&
+	    dma_check_coalesced(biod) != 0) {
+		iod_release_buffer(biod);
+		biod->bd_no_coalesce = 1;
+		goto retry;
+	}
 	biod->bd_buffer_prep = 1;
 
 	/* All direct SCM access, no DMA buffer prepared */
@@ -1048,6 +1488,19 @@ failed:
 	return rc;
 }
 
+int
+bio_iod_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
+	     unsigned int bulk_perm)
+{
+	int	rc;
+
+	D_TRACE_BEGIN(D_TRACE_BIO_PREP, biod, type);
+	rc = iod_prep_internal(biod, type, bulk_ctxt, bulk_perm);
+	D_TRACE_END(D_TRACE_BIO_PREP, biod, rc);
+
+	return rc;
+}
+
 int
 bio_iod_post(struct bio_desc *biod)
 {
@@ -458,6 +458,7 @@ bulk_get_hdl(struct bio_desc *biod, unsigned int pg_cnt,
 		D_ERROR("Failed to grow bulk grp (%u pages) "DF_RC"\n",
 			pg_cnt, DP_RC(rc));
 		dump_dma_info(bdb);
+		d_tm_inc_counter(bdb->bdb_stats.bds_grab_errs, 1);
 
 		if (rc == -DER_AGAIN)
 			biod->bd_retry = 1;
@@ -582,6 +583,8 @@ bulk_map_one(struct bio_desc *biod, struct bio_iov *biov, void *data)
 		bulk_hdl_unhold(hdl);
 		return rc;
 	}
+	if (bio_iov2media(biov) == DAOS_MEDIA_NVME)
+		biod->bd_rsrvd.brd_nvme_cnt++;
 done:
 	D_ASSERT(biod->bd_bulk_hdls != NULL);
 	D_ASSERT(biod->bd_bulk_cnt < biod->bd_bulk_max);
@@ -25,6 +25,12 @@
 #define NVME_MONITOR_PERIOD	    (60ULL * (NSEC_PER_SEC / NSEC_PER_USEC))
 #define NVME_MONITOR_SHORT_PERIOD   (3ULL * (NSEC_PER_SEC / NSEC_PER_USEC))
 
+/*
+ * Period to return the DMA chunks grown by an I/O burst to the per-NUMA pool,
+ * the DMA buffer must not have grown within the last period.
+ */
+#define BIO_DMA_RECLAIM_PERIOD	    (1ULL * (NSEC_PER_SEC / NSEC_PER_USEC))
+
 struct bio_bulk_args {
 	void		*ba_bulk_ctxt;
 	unsigned int	 ba_bulk_perm;
@@ -72,6 +78,8 @@ struct bio_dma_chunk {
 	unsigned int	 bdc_ref;
 	/* Chunk type */
 	unsigned int	 bdc_type;
+	/* Chunk size in pages (4K page) */
+	unsigned int	 bdc_pg_cnt;
 	/* == Bulk handle caching related fields == */
 	struct bio_bulk_group	*bdc_bulk_grp;
 	struct bio_bulk_hdl	*bdc_bulks;
@@ -90,6 +98,18 @@ struct bio_bulk_cache {
 	d_list_t		  bbc_grp_lru;
 };
 
+/* Per-xstream DMA buffer telemetry */
+struct bio_dma_stats {
+	struct d_tm_node_t	*bds_chks_tot;
+	struct d_tm_node_t	*bds_chks_used[BIO_CHK_TYPE_MAX];
+	struct d_tm_node_t	*bds_queued_iods;
+	struct d_tm_node_t	*bds_grab_errs;
+	struct d_tm_node_t	*bds_huge_allocs;
+	struct d_tm_node_t	*bds_read_ios;
+	struct d_tm_node_t	*bds_read_merged;
+	struct d_tm_node_t	*bds_read_gap_bytes;
+};
+
 /*
  * Per-xstream DMA buffer, used as SPDK dma I/O buffer or as temporary
  * RDMA buffer for ZC fetch/update over NVMe devices.
@@ -97,13 +117,25 @@ struct bio_bulk_cache {
 struct bio_dma_buffer {
 	d_list_t		 bdb_idle_list;
 	d_list_t		 bdb_used_list;
+	/* Magazine of released huge chunks, in MRU order */
+	d_list_t		 bdb_huge_list;
 	struct bio_dma_chunk	*bdb_cur_chk[BIO_CHK_TYPE_MAX];
 	unsigned int		 bdb_used_cnt[BIO_CHK_TYPE_MAX];
 	unsigned int		 bdb_tot_cnt;
+	/* Chunks kept when idle, the others go back to the per-NUMA pool */
+	unsigned int		 bdb_init_cnt;
 	unsigned int		 bdb_active_iods;
+	/* Last time the DMA buffer grew and was reclaimed, in usecs */
+	uint64_t		 bdb_grow_ts;
+	uint64_t		 bdb_reclaim_ts;
+	/* Total pages held by the huge chunk magazine */
+	unsigned int		 bdb_huge_pgs;
+	/* NUMA node the owner xstream is running on */
+	int			 bdb_numa_node;
 	ABT_cond		 bdb_wait_iods;
 	ABT_mutex		 bdb_mutex;
 	struct bio_bulk_cache	 bdb_bulk_cache;
+	struct bio_dma_stats	 bdb_stats;
 };
 
 #define BIO_PROTO_NVME_STATS_LIST					\
@@ -392,6 +424,12 @@ struct bio_rsrvd_dma {
 	unsigned int		  brd_chk_max;
 	/* Total number of chunks being referenced */
 	unsigned int		  brd_chk_cnt;
+	/* Number of NVMe biovs mapped to the regions */
+	unsigned int		  brd_nvme_cnt;
+	/* Number of NVMe regions merged into the previous region */
+	unsigned int		  brd_rg_merged;
+	/* Bytes of the gaps between NVMe regions bridged on read */
+	uint64_t		  brd_gap_bytes;
 };
 
 /* I/O descriptor */
@@ -410,7 +448,8 @@ struct bio_desc {
 	unsigned int		 bd_buffer_prep:1,
 				 bd_dma_issued:1,
 				 bd_retry:1,
-				 bd_rdma:1;
+				 bd_rdma:1,
+				 bd_no_coalesce:1;
 	/* Cached bulk handles being used by this IOD */
 	struct bio_bulk_hdl    **bd_bulk_hdls;
 	unsigned int		 bd_bulk_max;
@@ -482,6 +521,8 @@ struct media_error_msg {
 extern bool		bio_scm_rdma;
 extern unsigned int	bio_chk_sz;
 extern unsigned int	bio_chk_cnt_max;
+extern unsigned int	bio_read_gap;
+extern unsigned int	bio_read_max;
 int xs_poll_completion(struct bio_xs_context *ctxt, unsigned int *inflights,
 		       uint64_t timeout);
 void bio_bdev_event_cb(enum spdk_bdev_event_type type, struct spdk_bdev *bdev,
@@ -505,7 +546,9 @@ void replace_bio_bdev(struct bio_bdev *old_dev, struct bio_bdev *new_dev);
 
 /* bio_buffer.c */
 void dma_buffer_destroy(struct bio_dma_buffer *buf);
-struct bio_dma_buffer *dma_buffer_create(unsigned int init_cnt);
+struct bio_dma_buffer *dma_buffer_create(unsigned int init_cnt, int tgt_id);
+int dma_pool_init(void);
+void dma_pool_fini(void);
 void bio_memcpy(struct bio_desc *biod, uint16_t media, void *media_addr,
 		void *addr, ssize_t n);
 int dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg);
@@ -513,6 +556,7 @@ int iod_add_region(struct bio_desc *biod, struct bio_dma_chunk *chk,
 		   unsigned int chk_pg_idx, uint64_t off, uint64_t end,
 		   uint8_t media);
 int dma_buffer_grow(struct bio_dma_buffer *buf, unsigned int cnt);
+void dma_buffer_reclaim(struct bio_dma_buffer *buf, uint64_t now);
 
 static inline struct bio_dma_buffer *
 iod_dma_buf(struct bio_desc *biod)
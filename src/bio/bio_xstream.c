@@ -31,6 +31,8 @@
 #define DAOS_DMA_CHUNK_CNT_INIT	32	/* Per-xstream init chunks */
 #define DAOS_DMA_CHUNK_CNT_MAX	128	/* Per-xstream max chunks */
 #define DAOS_DMA_MIN_UB_BUF_MB	1024	/* 1GB min upper bound DMA buffer */
+#define DAOS_NVME_READ_GAP_KB	16	/* Max gap bridged by read coalescing */
+#define DAOS_NVME_READ_MAX_KB	1024	/* Max coalesced read size */
 
 /* Max inflight blob IOs per io channel */
 #define BIO_BS_MAX_CHANNEL_OPS	(4096)
@@ -45,6 +47,10 @@ unsigned int bio_chk_cnt_max;
 static unsigned int bio_chk_cnt_init;
 /* Diret RDMA over SCM */
 bool bio_scm_rdma;
+/* Max gap (in pages) between NVMe regions being coalesced on read */
+unsigned int bio_read_gap;
+/* Max size (in pages) of the coalesced NVMe read */
+unsigned int bio_read_max;
 
 struct bio_nvme_data {
 	ABT_mutex		 bd_mutex;
@@ -156,10 +162,28 @@ bio_nvme_init(const char *nvme_conf, int shm_id, int mem_size,
 	bio_chk_cnt_init = DAOS_DMA_CHUNK_CNT_INIT;
 	bio_chk_cnt_max = DAOS_DMA_CHUNK_CNT_MAX;
 	bio_chk_sz = ((uint64_t)size_mb << 20) >> BIO_DMA_PAGE_SHIFT;
+	d_getenv_int("DAOS_DMA_CHUNK_CNT_INIT", &bio_chk_cnt_init);
+	if (bio_chk_cnt_init > bio_chk_cnt_max)
+		bio_chk_cnt_init = bio_chk_cnt_max;
+
+	rc = dma_pool_init();
+	if (rc) {
+		D_ERROR("Failed to init DMA chunk pool. "DF_RC"\n", DP_RC(rc));
+		goto free_cond;
+	}
 
 	d_getenv_bool("DAOS_SCM_RDMA_ENABLED", &bio_scm_rdma);
 	D_INFO("RDMA to SCM is %s\n", bio_scm_rdma ? "enabled" : "disabled");
 
+	bio_read_gap = DAOS_NVME_READ_GAP_KB;
+	bio_read_max = DAOS_NVME_READ_MAX_KB;
+	d_getenv_int("DAOS_NVME_READ_GAP_KB", &bio_read_gap);
+	d_getenv_int("DAOS_NVME_READ_MAX_KB", &bio_read_max);
+	bio_read_gap = (bio_read_gap << 10) >> BIO_DMA_PAGE_SHIFT;
+	bio_read_max = (bio_read_max << 10) >> BIO_DMA_PAGE_SHIFT;
+	D_INFO("Coalesce NVMe reads with max gap %u pages, max size %u pages\n",
+	       bio_read_gap, bio_read_max);
+
 	if (nvme_conf == NULL || strlen(nvme_conf) == 0) {
 		D_INFO("NVMe config isn't specified, skip NVMe setup.\n");
 		return 0;
@@ -184,17 +208,22 @@ bio_nvme_init(const char *nvme_conf, int shm_id, int mem_size,
 		D_ERROR("Per-xstream DMA buffer upper bound limit < 1GB!\n");
 		D_DEBUG(DB_MGMT, "mem_size:%dMB, DMA upper bound:%dMB\n",
 			mem_size, (mem_size / tgt_nr));
-		return -DER_INVAL;
+		rc = -DER_INVAL;
+		goto fini_pool;
 	}
 
 	bio_chk_cnt_max = (mem_size / tgt_nr) / size_mb;
 	D_INFO("Set per-xstream DMA buffer upper bound to %u %uMB chunks\n",
 	       bio_chk_cnt_max, size_mb);
+	if (bio_chk_cnt_init > bio_chk_cnt_max)
+		bio_chk_cnt_init = bio_chk_cnt_max;
+	D_INFO("Pre-reserve %u %uMB chunks for per-xstream DMA buffer\n",
+	       bio_chk_cnt_init, size_mb);
 
 	rc = smd_init(db);
 	if (rc != 0) {
 		D_ERROR("Initialize SMD store failed. "DF_RC"\n", DP_RC(rc));
-		goto free_cond;
+		goto fini_pool;
 	}
 
 	spdk_bs_opts_init(&nvme_glb.bd_bs_opts, sizeof(nvme_glb.bd_bs_opts));
@@ -226,6 +255,8 @@ bio_nvme_init(const char *nvme_conf, int shm_id, int mem_size,
 
 fini_smd:
 	smd_fini();
+fini_pool:
+	dma_pool_fini();
 free_cond:
 	ABT_cond_free(&nvme_glb.bd_barrier);
 free_mutex:
@@ -246,6 +277,8 @@ bio_spdk_env_fini(void)
 void
 bio_nvme_fini(void)
 {
+	/* Idle DMA chunks have to be released before SPDK env fini */
+	dma_pool_fini();
 	bio_spdk_env_fini();
 	ABT_cond_free(&nvme_glb.bd_barrier);
 	ABT_mutex_free(&nvme_glb.bd_mutex);
@@ -296,6 +329,28 @@ bio_need_nvme_poll(struct bio_xs_context *ctxt)
 	return ctxt->bxc_blob_rw > BIO_BS_POLL_WATERMARK;
 }
 
+unsigned int
+bio_xs_load(struct bio_xs_context *ctxt)
+{
+	struct bio_dma_buffer	*bdb;
+	unsigned int		 load, used = 0;
+	int			 i;
+
+	if (ctxt == NULL)
+		return 0;
+
+	load = ctxt->bxc_blob_rw * 100 / BIO_BS_POLL_WATERMARK;
+
+	bdb = ctxt->bxc_dma_buf;
+	if (bdb != NULL && bio_chk_cnt_max != 0) {
+		for (i = 0; i < BIO_CHK_TYPE_MAX; i++)
+			used += bdb->bdb_used_cnt[i];
+		load = max(load, used * 100 / bio_chk_cnt_max);
+	}
+
+	return min(load, 100U);
+}
+
 struct common_cp_arg {
 	unsigned int		 cca_inflights;
 	int			 cca_rc;
@@ -1250,7 +1305,7 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id)
 
 	/* Skip NVMe context setup if the daos_nvme.conf isn't present */
 	if (!bio_nvme_configured()) {
-		ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init);
+		ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id);
 		if (ctxt->bxc_dma_buf == NULL) {
 			D_FREE(ctxt);
 			*pctxt = NULL;
@@ -1326,7 +1381,7 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id)
 	if (rc)
 		goto out;
 
-	ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init);
+	ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id);
 	if (ctxt->bxc_dma_buf == NULL) {
 		D_ERROR("failed to initialize dma buffer\n");
 		rc = -DER_NOMEM;
@@ -1541,6 +1596,9 @@ bio_nvme_poll(struct bio_xs_context *ctxt, bool bypass)
 	D_ASSERT(ctxt != NULL && ctxt->bxc_thread != NULL);
 	rc = spdk_thread_poll(ctxt->bxc_thread, 0, 0);
 
+	if (ctxt->bxc_dma_buf != NULL)
+		dma_buffer_reclaim(ctxt->bxc_dma_buf, now);
+
 	/*
 	 * To avoid complicated race handling (init xstream and starting
 	 * VOS xstream concurrently access global device list & xstream
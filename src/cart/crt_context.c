@@ -141,6 +141,16 @@ crt_context_init(crt_context_t crt_ctx)
 	if (rc != 0)
 		D_GOTO(out, rc);
 
+	rc = D_MUTEX_INIT(&ctx->cc_rpc_types_mutex, NULL);
+	if (rc != 0)
+		D_GOTO(out_mutex_destroy, rc);
+
+	rc = d_slab_init(&ctx->cc_rpc_slab, ctx);
+	if (rc != 0) {
+		D_ERROR("d_slab_init() failed, " DF_RC "\n", DP_RC(rc));
+		D_GOTO(out_types_mutex_destroy, rc);
+	}
+
 	D_INIT_LIST_HEAD(&ctx->cc_link);
 
 	/* create timeout binheap */
@@ -150,7 +160,7 @@ crt_context_init(crt_context_t crt_ctx)
 				      &ctx->cc_bh_timeout);
 	if (rc != 0) {
 		D_ERROR("d_binheap_create() failed, " DF_RC "\n", DP_RC(rc));
-		D_GOTO(out_mutex_destroy, rc);
+		D_GOTO(out_slab_destroy, rc);
 	}
 
 	/* create epi table, use external lock */
@@ -166,6 +176,10 @@ crt_context_init(crt_context_t crt_ctx)
 
 out_binheap_destroy:
 	d_binheap_destroy_inplace(&ctx->cc_bh_timeout);
+out_slab_destroy:
+	d_slab_destroy(&ctx->cc_rpc_slab);
+out_types_mutex_destroy:
+	D_MUTEX_DESTROY(&ctx->cc_rpc_types_mutex);
 out_mutex_destroy:
 	D_MUTEX_DESTROY(&ctx->cc_mutex);
 out:
@@ -541,6 +555,15 @@ crt_context_destroy(crt_context_t crt_ctx, int force)
 	d_list_del(&ctx->cc_link);
 	D_RWLOCK_UNLOCK(&crt_gdata.cg_rwlock);
 
+	/* the types of the descriptors still in use are freed on the release
+	 * of their last descriptor
+	 */
+	if (d_slab_reclaim(&ctx->cc_rpc_slab))
+		D_WARN("context (idx %d) destroyed with RPCs in use\n",
+		       ctx->cc_idx);
+	d_slab_destroy(&ctx->cc_rpc_slab);
+	D_MUTEX_DESTROY(&ctx->cc_rpc_types_mutex);
+
 	D_MUTEX_DESTROY(&ctx->cc_mutex);
 	D_DEBUG(DB_TRACE, "destroyed context (idx %d, force %d)\n",
 		ctx->cc_idx, force);
@@ -980,10 +1003,14 @@ crt_context_req_track(struct crt_rpc_priv *rpc_priv)
 	D_MUTEX_LOCK(&crt_ctx->cc_mutex);
 	rlink = d_hash_rec_find(&crt_ctx->cc_epi_table, (void *)&ep_rank,
 				sizeof(ep_rank));
+	D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
 	if (rlink == NULL) {
+		/* allocated out of cc_mutex, which all RPCs of the context
+		 * take, and kept until the context is destroyed.
+		 */
 		D_ALLOC_PTR(epi);
 		if (epi == NULL)
-			D_GOTO(out_unlock, rc = -DER_NOMEM);
+			D_GOTO(out, rc = -DER_NOMEM);
 
 		/* init the epi fields */
 		D_INIT_LIST_HEAD(&epi->epi_link);
@@ -999,22 +1026,24 @@ crt_context_req_track(struct crt_rpc_priv *rpc_priv)
 		epi->epi_ref = 1;
 		epi->epi_initialized = 1;
 		rc = D_MUTEX_INIT(&epi->epi_mutex, NULL);
-		if (rc != 0)
-			D_GOTO(out_unlock, rc);
-
-		rc = d_hash_rec_insert(&crt_ctx->cc_epi_table, &ep_rank,
-				       sizeof(ep_rank), &epi->epi_link,
-				       true /* exclusive */);
 		if (rc != 0) {
-			D_ERROR("d_hash_rec_insert failed, rc: %d.\n", rc);
+			D_FREE(epi);
+			D_GOTO(out, rc);
+		}
+
+		D_MUTEX_LOCK(&crt_ctx->cc_mutex);
+		rlink = d_hash_rec_find_insert(&crt_ctx->cc_epi_table, &ep_rank,
+					       sizeof(ep_rank),
+					       &epi->epi_link);
+		D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
+		if (rlink != &epi->epi_link) {
+			/* created by another RPC to the same rank meanwhile */
 			D_MUTEX_DESTROY(&epi->epi_mutex);
-			D_GOTO(out_unlock, rc);
+			D_FREE(epi);
 		}
-	} else {
-		epi = epi_link2ptr(rlink);
-		D_ASSERT(epi->epi_ctx == crt_ctx);
 	}
-	D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
+	epi = epi_link2ptr(rlink);
+	D_ASSERT(epi->epi_ctx == crt_ctx);
 
 	/* add the RPC req to crt_ep_inflight */
 	D_MUTEX_LOCK(&epi->epi_mutex);
@@ -1065,12 +1094,6 @@ crt_context_req_track(struct crt_rpc_priv *rpc_priv)
 
 out:
 	return rc;
-
-out_unlock:
-	D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
-	if (epi != NULL)
-		D_FREE(epi);
-	return rc;
 }
 
 void
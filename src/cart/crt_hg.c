@@ -8,6 +8,7 @@
  */
 #define D_LOGFAC	DD_FAC(hg)
 
+#include <gurt/trace.h>
 #include "crt_internal.h"
 
 /*
@@ -799,7 +800,7 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 	}
 	D_ASSERT(opc_info->coi_opc == opc);
 
-	D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+	rpc_priv = crt_rpc_priv_acquire(crt_ctx, opc_info, false);
 	if (unlikely(rpc_priv == NULL)) {
 		crt_hg_reply_error_send(&rpc_tmp, -DER_DOS);
 		crt_hg_unpack_cleanup(proc);
@@ -819,6 +820,7 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 	rpc_pub->cr_opc = rpc_tmp.crp_pub.cr_opc;
 	rpc_pub->cr_ep.ep_rank = rpc_priv->crp_req_hdr.cch_dst_rank;
 	rpc_pub->cr_ep.ep_tag = rpc_priv->crp_req_hdr.cch_dst_tag;
+	D_TRACE_BEGIN(D_TRACE_RPC, rpc_pub, opc);
 
 	RPC_TRACE(DB_TRACE, rpc_priv,
 		  "(opc: %#x rpc_pub: %p) allocated per RPC request received.\n",
@@ -831,7 +833,7 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 		crt_hg_reply_error_send(&rpc_tmp, -DER_MISC);
 		crt_hg_unpack_cleanup(proc);
 		HG_Destroy(rpc_tmp.crp_hg_hdl);
-		D_FREE(rpc_priv);
+		crt_rpc_priv_free(rpc_priv);
 		D_GOTO(out, hg_ret = HG_SUCCESS);
 	}
 
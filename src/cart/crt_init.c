@@ -12,6 +12,7 @@
 #include <sys/mman.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <gurt/trace.h>
 #include "crt_internal.h"
 
 struct crt_gdata crt_gdata;
@@ -332,6 +333,13 @@ crt_init_opt(crt_group_id_t grpid, uint32_t flags, crt_init_options_t *opt)
 
 	D_INFO("libcart version %s initializing\n", CART_VERSION);
 
+	/* d_trace_init() is reference counted, the process runs untraced if
+	 * the segment cannot be created
+	 */
+	rc = d_trace_init();
+	if (rc != 0)
+		D_WARN("d_trace_init() failed, rc: %d.\n", rc);
+
 	/* d_fault_inject_init() is reference counted */
 	rc = d_fault_inject_init();
 	if (rc != DER_SUCCESS && rc != -DER_NOSYS) {
@@ -557,6 +565,7 @@ out:
 	if (rc != 0) {
 		D_ERROR("failed, "DF_RC"\n", DP_RC(rc));
 		d_fault_inject_fini();
+		d_trace_fini();
 		d_log_fini();
 	}
 	return rc;
@@ -644,6 +653,9 @@ out:
 	local_rc = d_fault_inject_fini();
 	if (local_rc != 0 && local_rc != -DER_NOSYS)
 		D_ERROR("d_fault_inject_fini() failed, rc: %d\n", local_rc);
+	/* the reference is kept if the finalize failed and can be retried */
+	if (rc == 0)
+		d_trace_fini();
 
 direct_out:
 	if (rc == 0)
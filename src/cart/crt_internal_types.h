@@ -19,6 +19,7 @@
 #include <gurt/list.h>
 #include <gurt/hash.h>
 #include <gurt/heap.h>
+#include <gurt/slab.h>
 #include <gurt/atomic.h>
 #include <gurt/telemetry_common.h>
 #include <gurt/telemetry_producer.h>
@@ -131,6 +132,13 @@ struct crt_event_cb_priv {
 # define CRT_SRV_CONTEXT_NUM		(256)
 #endif
 
+/* Max number of opcodes with a pool of RPC descriptors in each context */
+#define CRT_RPC_TYPES_MAX		(1024)
+/* Max number of pooled RPC descriptors per opcode in each context, any more
+ * are allocated and freed on their own
+ */
+#define CRT_RPC_POOL_MAX_NUM		(64)
+
 #ifndef CRT_PROGRESS_NUM
 # define CRT_CALLBACKS_NUM		(4)	/* start number of CBs */
 #endif
@@ -184,6 +192,13 @@ struct crt_context {
 	/** mutex to protect cc_epi_table and timeout binheap */
 	pthread_mutex_t		 cc_mutex;
 
+	/** pool of the RPC descriptors, one type per opcode */
+	struct d_slab		 cc_rpc_slab;
+	/** types of cc_rpc_slab, indexed by crt_opc_info::coi_rpc_idx */
+	struct d_slab_type *ATOMIC cc_rpc_types[CRT_RPC_TYPES_MAX];
+	/** mutex to protect the registration of cc_rpc_types */
+	pthread_mutex_t		 cc_rpc_types_mutex;
+
 	/** timeout per-context */
 	uint32_t		 cc_timeout_sec;
 	/** HLC time of last received RPC */
@@ -256,6 +271,8 @@ struct crt_opc_info {
 	size_t			 coi_rpc_size;
 	off_t			 coi_input_offset;
 	off_t			 coi_output_offset;
+	/* index of the pool of descriptors in each context, 0 for none */
+	unsigned int		 coi_rpc_idx;
 	struct crt_req_format	*coi_crf;
 };
 
@@ -281,6 +298,8 @@ struct crt_opc_queried {
 struct crt_opc_map {
 	pthread_rwlock_t	com_rwlock;
 	unsigned int		com_num_slots_total;
+	/* last crt_opc_info::coi_rpc_idx assigned, under com_rwlock */
+	unsigned int		com_rpc_idx;
 	d_list_t		com_coq_list;
 	struct crt_opc_map_L2	*com_map;
 };
@@ -253,6 +253,10 @@ crt_opc_reg(struct crt_opc_info *opc_info, crt_opcode_t opc, uint32_t flags,
 	opc_info->coi_rpc_size = sizeof(struct crt_rpc_priv) +
 				 opc_info->coi_input_offset + size_in;
 
+	/* the descriptors of the first opcodes are pooled per context */
+	if (crt_gdata.cg_opc_map->com_rpc_idx + 1 < CRT_RPC_TYPES_MAX)
+		opc_info->coi_rpc_idx = ++crt_gdata.cg_opc_map->com_rpc_idx;
+
 	/* set RPC features */
 	opc_info->coi_no_reply = D_BIT_IS_SET(flags, CRT_RPC_FEAT_NO_REPLY);
 	opc_info->coi_reset_timer = D_BIT_IS_SET(flags, CRT_RPC_FEAT_NO_TIMEOUT);
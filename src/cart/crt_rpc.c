@@ -10,6 +10,7 @@
 
 #include <semaphore.h>
 
+#include <gurt/trace.h>
 #include "crt_internal.h"
 
 #define CRT_CTL_MAX_LOG_MSG_SIZE 256
@@ -408,9 +409,80 @@ out:
 	return rc;
 }
 
+/* Get the pool of the descriptors of \a opc_info in \a ctx, register it on
+ * first use.
+ */
+static struct d_slab_type *
+crt_rpc_slab_type(struct crt_context *ctx, struct crt_opc_info *opc_info)
+{
+	struct d_slab_type	*type;
+	struct d_slab_reg	 reg = {
+		.sr_name		= "crt_rpc_priv",
+		.sr_size		= opc_info->coi_rpc_size,
+		.sr_offset		= offsetof(struct crt_rpc_priv,
+						   crp_slab_link),
+		.sr_max_desc		= CRT_RPC_POOL_MAX_NUM,
+	};
+	unsigned int		 idx = opc_info->coi_rpc_idx;
+
+	if (idx == 0)
+		return NULL;
+
+	type = atomic_load_relaxed(&ctx->cc_rpc_types[idx]);
+	if (likely(type != NULL))
+		return type;
+
+	D_MUTEX_LOCK(&ctx->cc_rpc_types_mutex);
+	type = atomic_load_relaxed(&ctx->cc_rpc_types[idx]);
+	if (type == NULL) {
+		type = d_slab_register(&ctx->cc_rpc_slab, &reg);
+		if (type != NULL)
+			atomic_store_release(&ctx->cc_rpc_types[idx], type);
+		else
+			D_WARN("opc: %#x, cannot create a descriptor pool.\n",
+			       opc_info->coi_opc);
+	}
+	D_MUTEX_UNLOCK(&ctx->cc_rpc_types_mutex);
+
+	return type;
+}
+
+/* Allocate a zeroed descriptor of \a opc_info, from the pool of \a ctx
+ * unless it is a forwarded one, which does not have the input buffer.
+ */
+struct crt_rpc_priv *
+crt_rpc_priv_acquire(struct crt_context *ctx, struct crt_opc_info *opc_info,
+		     bool forward)
+{
+	struct crt_rpc_priv	*rpc_priv;
+	struct d_slab_type	*type = NULL;
+
+	if (!forward)
+		type = crt_rpc_slab_type(ctx, opc_info);
+
+	if (type == NULL) {
+		if (forward)
+			D_ALLOC(rpc_priv, opc_info->coi_input_offset);
+		else
+			D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+		return rpc_priv;
+	}
+
+	/* beyond the pool limit the descriptor is allocated on its own */
+	rpc_priv = d_slab_acquire(type);
+	if (rpc_priv == NULL) {
+		D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+		return rpc_priv;
+	}
+
+	memset(rpc_priv, 0, opc_info->coi_rpc_size);
+	rpc_priv->crp_slab_type = type;
+	return rpc_priv;
+}
+
 int
-crt_rpc_priv_alloc(crt_opcode_t opc, struct crt_rpc_priv **priv_allocated,
-		   bool forward)
+crt_rpc_priv_alloc(struct crt_context *ctx, crt_opcode_t opc,
+		   struct crt_rpc_priv **priv_allocated, bool forward)
 {
 	struct crt_rpc_priv	*rpc_priv;
 	struct crt_opc_info	*opc_info;
@@ -434,10 +506,7 @@ crt_rpc_priv_alloc(crt_opcode_t opc, struct crt_rpc_priv **priv_allocated,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
-	if (forward)
-		D_ALLOC(rpc_priv, opc_info->coi_input_offset);
-	else
-		D_ALLOC(rpc_priv, opc_info->coi_rpc_size);
+	rpc_priv = crt_rpc_priv_acquire(ctx, opc_info, forward);
 	if (rpc_priv == NULL)
 		D_GOTO(out, rc = -DER_NOMEM);
 
@@ -457,6 +526,8 @@ out:
 void
 crt_rpc_priv_free(struct crt_rpc_priv *rpc_priv)
 {
+	struct d_slab_type	*type;
+
 	if (rpc_priv == NULL)
 		return;
 
@@ -468,7 +539,16 @@ crt_rpc_priv_free(struct crt_rpc_priv *rpc_priv)
 
 	D_SPIN_DESTROY(&rpc_priv->crp_lock);
 
-	D_FREE(rpc_priv);
+	type = rpc_priv->crp_slab_type;
+	if (type == NULL) {
+		D_FREE(rpc_priv);
+		return;
+	}
+
+	/* recycle the descriptor, along with its input and output buffers,
+	 * unless its context is gone
+	 */
+	d_slab_release(type, rpc_priv);
 }
 
 static inline void
@@ -513,7 +593,7 @@ crt_req_create_internal(crt_context_t crt_ctx, crt_endpoint_t *tgt_ep,
 
 	D_ASSERT(crt_ctx != CRT_CONTEXT_NULL && req != NULL);
 
-	rc = crt_rpc_priv_alloc(opc, &rpc_priv, forward);
+	rc = crt_rpc_priv_alloc(crt_ctx, opc, &rpc_priv, forward);
 	if (rc != 0) {
 		D_ERROR("crt_rpc_priv_alloc(%#x) failed, " DF_RC "\n",
 			opc, DP_RC(rc));
@@ -1450,6 +1530,7 @@ crt_reply_send(crt_rpc_t *req)
 	}
 
 	rpc_priv->crp_reply_pending = 0;
+	D_TRACE_END(D_TRACE_RPC, req, rc);
 out:
 	return rc;
 }
@@ -127,6 +127,10 @@ struct crt_rpc_priv {
 	d_list_t		crp_tmp_link;
 	/* link to parent RPC crp_opc_info->co_child_rpcs/co_replied_rpcs */
 	d_list_t		crp_parent_link;
+	/* link to the free lists of crp_slab_type while not in use */
+	d_list_t		crp_slab_link;
+	/* pool of the descriptor, NULL if allocated on its own */
+	struct d_slab_type	*crp_slab_type;
 	/* binheap node for timeout management, in crt_context::cc_bh_timeout */
 	struct d_binheap_node	crp_timeout_bp_node;
 	/* the timeout in seconds set by user */
@@ -621,8 +625,11 @@ crt_rpc_cb_customized(struct crt_context *crt_ctx,
 }
 
 /* crt_rpc.c */
-int crt_rpc_priv_alloc(crt_opcode_t opc, struct crt_rpc_priv **priv_allocated,
-		       bool forward);
+struct crt_rpc_priv *crt_rpc_priv_acquire(struct crt_context *ctx,
+					  struct crt_opc_info *opc_info,
+					  bool forward);
+int crt_rpc_priv_alloc(struct crt_context *ctx, crt_opcode_t opc,
+		       struct crt_rpc_priv **priv_allocated, bool forward);
 void crt_rpc_priv_free(struct crt_rpc_priv *rpc_priv);
 int crt_rpc_priv_init(struct crt_rpc_priv *rpc_priv, crt_context_t crt_ctx,
 		      bool srv_flag);
@@ -124,6 +124,7 @@ daos_eq_lib_fini()
 	ev_thpriv_is_init = false;
 
 	tse_sched_complete(&daos_sched_g, 0, true);
+	tse_task_cache_fini();
 
 	rc = crt_finalize();
 	if (rc != 0) {
@@ -122,6 +122,9 @@ const struct daos_task_api dc_funcs[] = {
 	{dc_kv_put, sizeof(daos_kv_put_t)},
 	{dc_kv_remove, sizeof(daos_kv_remove_t)},
 	{dc_kv_list, sizeof(daos_kv_list_t)},
+	{dc_kv_get_multi, sizeof(daos_kv_get_multi_t)},
+	{dc_kv_put_multi, sizeof(daos_kv_put_multi_t)},
+	{dc_kv_remove_multi, sizeof(daos_kv_remove_multi_t)},
 };
 
 /**
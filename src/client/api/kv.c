@@ -161,3 +161,77 @@ daos_kv_list(daos_handle_t oh, daos_handle_t th, uint32_t *nr,
 
 	return dc_task_schedule(task, true);
 }
+
+int
+daos_kv_put_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags,
+		  unsigned int nr, const char *const keys[],
+		  const daos_size_t buf_sizes[], const void *const bufs[],
+		  daos_event_t *ev)
+{
+	daos_kv_put_multi_t	*args;
+	tse_task_t		*task;
+	int			rc;
+
+	rc = dc_task_create(dc_kv_put_multi, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->oh	= oh;
+	args->th	= th;
+	args->flags	= flags;
+	args->nr	= nr;
+	args->keys	= keys;
+	args->buf_sizes	= buf_sizes;
+	args->bufs	= bufs;
+
+	return dc_task_schedule(task, true);
+}
+
+int
+daos_kv_get_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags,
+		  unsigned int nr, const char *const keys[],
+		  daos_size_t buf_sizes[], void *const bufs[], daos_event_t *ev)
+{
+	daos_kv_get_multi_t	*args;
+	tse_task_t		*task;
+	int			rc;
+
+	rc = dc_task_create(dc_kv_get_multi, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->oh	= oh;
+	args->th	= th;
+	args->flags	= flags;
+	args->nr	= nr;
+	args->keys	= keys;
+	args->buf_sizes	= buf_sizes;
+	args->bufs	= bufs;
+
+	return dc_task_schedule(task, true);
+}
+
+int
+daos_kv_remove_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags,
+		     unsigned int nr, const char *const keys[],
+		     daos_event_t *ev)
+{
+	daos_kv_remove_multi_t	*args;
+	tse_task_t		*task;
+	int			rc;
+
+	rc = dc_task_create(dc_kv_remove_multi, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->oh	= oh;
+	args->th	= th;
+	args->flags	= flags;
+	args->nr	= nr;
+	args->keys	= keys;
+
+	return dc_task_schedule(task, true);
+}
@@ -40,6 +40,23 @@ struct dc_array {
 	unsigned int		mode;
 	/** Is this a byte array (set short fetch & memset holes to 0 */
 	bool			byte_array;
+	/**
+	 * Keep the array size on the client, set when the array is opened
+	 * with DAOS_OO_EXCL since no other handle is then expected to modify
+	 * it. The size is updated from the local writes and set size calls
+	 * and invalidated by punches of the tail and failed operations.
+	 */
+	bool			size_cached;
+	/** Is the cached size valid */
+	bool			size_valid;
+	/** Cached array size in records */
+	daos_size_t		size;
+	/** Bumped on every start and completion of a modification */
+	uint64_t		size_gen;
+	/** Number of modifications in flight */
+	uint32_t		size_mod_nr;
+	/** Protects the cached size */
+	pthread_mutex_t		size_lock;
 };
 
 struct md_params {
@@ -75,6 +92,7 @@ array_free(struct d_hlink *hlink)
 
 	array = container_of(hlink, struct dc_array, hlink);
 	D_ASSERT(daos_hhash_link_empty(&array->hlink));
+	D_MUTEX_DESTROY(&array->size_lock);
 	D_FREE(array);
 }
 
@@ -91,6 +109,11 @@ array_alloc(void)
 	if (array == NULL)
 		return NULL;
 
+	if (D_MUTEX_INIT(&array->size_lock, NULL) != 0) {
+		D_FREE(array);
+		return NULL;
+	}
+
 	daos_hhash_hlink_init(&array->hlink, &array_h_ops);
 	return array;
 }
@@ -134,6 +157,82 @@ array_hdl_unlink(struct dc_array *array)
 	daos_hhash_link_delete(&array->hlink);
 }
 
+struct size_mod_props {
+	struct dc_array		*array;
+	daos_opc_t		op;
+	/** end of the write or punch, new size for a set size */
+	daos_size_t		end;
+	/** modification done in a transaction, can't be tracked */
+	bool			in_tx;
+};
+
+static int
+size_mod_cb(tse_task_t *task, void *data)
+{
+	struct size_mod_props	*props = data;
+	struct dc_array		*array = props->array;
+
+	D_MUTEX_LOCK(&array->size_lock);
+	D_ASSERT(array->size_mod_nr > 0);
+	array->size_mod_nr--;
+	array->size_gen++;
+
+	if (task->dt_result != 0 || props->in_tx) {
+		array->size_valid = false;
+	} else if (props->op == DAOS_OPC_ARRAY_WRITE) {
+		if (array->size_valid && props->end > array->size)
+			array->size = props->end;
+	} else if (props->op == DAOS_OPC_ARRAY_PUNCH) {
+		/** punching the tail can shrink the array by an unknown amount */
+		if (array->size_valid && props->end >= array->size)
+			array->size_valid = false;
+	} else {
+		D_ASSERT(props->op == DAOS_OPC_ARRAY_SET_SIZE);
+		/** a concurrent write might extend the array further */
+		array->size = props->end;
+		array->size_valid = (array->size_mod_nr == 0);
+	}
+	D_MUTEX_UNLOCK(&array->size_lock);
+
+	array_decref(array);
+	return 0;
+}
+
+/**
+ * Track a modification of the array size on a handle that caches it. The
+ * cached size is updated when the task completes.
+ */
+static int
+size_mod_register(struct dc_array *array, tse_task_t *task, daos_opc_t op,
+		  daos_handle_t th, daos_size_t end)
+{
+	struct size_mod_props	props;
+	int			rc;
+
+	if (!array->size_cached)
+		return 0;
+
+	props.array = array;
+	props.op = op;
+	props.end = end;
+	props.in_tx = daos_handle_is_valid(th);
+
+	daos_hhash_link_getref(&array->hlink);
+	rc = tse_task_register_comp_cb(task, size_mod_cb, &props,
+				       sizeof(props));
+	if (rc) {
+		array_decref(array);
+		return rc;
+	}
+
+	D_MUTEX_LOCK(&array->size_lock);
+	array->size_mod_nr++;
+	array->size_gen++;
+	D_MUTEX_UNLOCK(&array->size_lock);
+
+	return 0;
+}
+
 static int
 free_md_params_cb(tse_task_t *task, void *data)
 {
@@ -408,6 +507,7 @@ dc_array_g2l(daos_handle_t coh, struct dc_array_glob *array_glob,
 	array->oid.hi = array_glob->oid.hi;
 	array->oid.lo = array_glob->oid.lo;
 	array->mode = array_mode;
+	/** the size is not cached on handles shared across processes */
 
 	feat = daos_obj_id2feat(array->oid);
 	if (feat & DAOS_OF_ARRAY_BYTE)
@@ -657,6 +757,7 @@ open_handle_cb(tse_task_t *task, void *data)
 	array->cell_size	= *args->cell_size;
 	array->chunk_size	= *args->chunk_size;
 	array->daos_oh		= *args->oh;
+	array->size_cached	= (args->mode & DAOS_OO_EXCL) != 0;
 
 	feat = daos_obj_id2feat(args->oid);
 	if (feat & DAOS_OF_ARRAY_BYTE)
@@ -922,6 +1023,12 @@ dc_array_destroy(tse_task_t *task)
 	if (array == NULL)
 		D_GOTO(err_ptask, rc = -DER_NO_HDL);
 
+	/** the array is empty once punched */
+	rc = size_mod_register(array, task, DAOS_OPC_ARRAY_SET_SIZE, args->th,
+			       0);
+	if (rc)
+		D_GOTO(err_put1, rc);
+
 	/** Create task to punch object */
 	rc = daos_task_create(DAOS_OPC_OBJ_PUNCH, tse_task2sched(task),
 			      0, NULL, &punch_task);
@@ -1449,6 +1556,21 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 
 	oh = array->daos_oh;
 
+	if (op_type != DAOS_OPC_ARRAY_READ && array->size_cached) {
+		daos_size_t	end = 0;
+
+		for (u = 0; u < rg_iod->arr_nr; u++) {
+			daos_range_t *rg = &rg_iod->arr_rgs[u];
+
+			if (rg->rg_len && rg->rg_idx + rg->rg_len > end)
+				end = rg->rg_idx + rg->rg_len;
+		}
+
+		rc = size_mod_register(array, task, op_type, th, end);
+		if (rc)
+			D_GOTO(err_task, rc);
+	}
+
 	cur_off = 0;
 	cur_i = 0;
 	u = 0;
@@ -1489,7 +1611,6 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 		daos_size_t	dkey_records;
 		tse_task_t	*io_task = NULL;
 		struct io_params *params;
-		daos_size_t	i; /* index for iod recx */
 
 		/** In some cases, users can pass an empty range, so skip it. */
 		if (rg_iod->arr_rgs[u].rg_len == 0) {
@@ -1579,7 +1700,6 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 		iom->iom_type	= DAOS_IOD_ARRAY;
 		iom->iom_nr	= 0;
 
-		i = 0;
 		dkey_records = 0;
 
 		/*
@@ -1590,24 +1710,34 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 		do {
 			daos_off_t	old_array_idx;
 			daos_recx_t	*new_recxs;
+			daos_recx_t	*recx;
+			daos_size_t	nr;
 
-			/** add another element to recxs */
-			D_REALLOC_ARRAY(new_recxs, iod->iod_recxs,
-					iod->iod_nr, iod->iod_nr + 1);
-			if (new_recxs == NULL)
-				D_GOTO(err_stask, rc = -DER_NOMEM);
+			nr = (num_records > records) ? records : num_records;
+			recx = iod->iod_nr ? &iod->iod_recxs[iod->iod_nr - 1] :
+				NULL;
 
-			iod->iod_nr++;
-			iod->iod_recxs = new_recxs;
-
-			/** set the record access for this range */
-			iod->iod_recxs[i].rx_idx = record_i;
-			iod->iod_recxs[i].rx_nr = (num_records > records) ?
-				records : num_records;
+			if (recx && recx->rx_idx + recx->rx_nr == record_i) {
+				/** range follows the last one, extend it */
+				recx->rx_nr += nr;
+			} else {
+				/** add another element to recxs */
+				D_REALLOC_ARRAY(new_recxs, iod->iod_recxs,
+						iod->iod_nr, iod->iod_nr + 1);
+				if (new_recxs == NULL)
+					D_GOTO(err_stask, rc = -DER_NOMEM);
+
+				iod->iod_nr++;
+				iod->iod_recxs = new_recxs;
+
+				/** set the record access for this range */
+				recx = &iod->iod_recxs[iod->iod_nr - 1];
+				recx->rx_idx = record_i;
+				recx->rx_nr = nr;
+			}
 
 			D_DEBUG(DB_IO, "%zu: index = "DF_U64", size = %zu\n",
-				u, iod->iod_recxs[i].rx_idx,
-				iod->iod_recxs[i].rx_nr);
+				u, recx->rx_idx, recx->rx_nr);
 
 			/*
 			 * if the current range is bigger than what the dkey can
@@ -1624,7 +1754,6 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 
 			/** bump the index for the iods */
 			u++;
-			i++;
 			dkey_records += records;
 
 			/** if there are no more ranges to write, then break */
@@ -1864,6 +1993,9 @@ struct key_query_props {
 	daos_recx_t		recx;
 	daos_size_t		*size;
 	tse_task_t		*ptask;
+	/** cache the result, with the size generation at query time */
+	bool			cache_size;
+	uint64_t		size_gen;
 };
 
 static int
@@ -1891,14 +2023,26 @@ get_array_size_cb(tse_task_t *task, void *data)
 	D_DEBUG(DB_IO, "Key Query: dkey %zu, IDX %"PRIu64", NR %"PRIu64"\n",
 		props->dkey_val, props->recx.rx_idx, props->recx.rx_nr);
 
-	if (props->dkey_val == 0) {
+	if (props->dkey_val == 0)
 		*props->size = 0;
-		return rc;
+	else
+		*props->size = props->array->chunk_size *
+			(props->dkey_val - 1) + props->recx.rx_idx +
+			props->recx.rx_nr;
+
+	if (props->cache_size) {
+		struct dc_array *array = props->array;
+
+		/** don't cache it if the array changed since the query */
+		D_MUTEX_LOCK(&array->size_lock);
+		if (array->size_gen == props->size_gen &&
+		    array->size_mod_nr == 0) {
+			array->size = *props->size;
+			array->size_valid = true;
+		}
+		D_MUTEX_UNLOCK(&array->size_lock);
 	}
 
-	*props->size = props->array->chunk_size * (props->dkey_val - 1) +
-		props->recx.rx_idx + props->recx.rx_nr;
-
 	return rc;
 }
 
@@ -1911,6 +2055,8 @@ dc_array_get_size(tse_task_t *task)
 	struct key_query_props	*kqp = NULL;
 	tse_task_t		*query_task = NULL;
 	daos_handle_t		oh;
+	bool			cache_size;
+	uint64_t		size_gen = 0;
 	int			rc;
 
 	array = array_hdl2ptr(args->oh);
@@ -1919,11 +2065,32 @@ dc_array_get_size(tse_task_t *task)
 
 	oh = array->daos_oh;
 
+	/** the cached size is the latest one, it can't serve a transaction */
+	cache_size = array->size_cached && daos_handle_is_inval(args->th);
+	if (cache_size) {
+		bool	hit;
+
+		D_MUTEX_LOCK(&array->size_lock);
+		hit = array->size_valid;
+		if (hit)
+			*args->size = array->size;
+		size_gen = array->size_gen;
+		D_MUTEX_UNLOCK(&array->size_lock);
+
+		if (hit) {
+			array_decref(array);
+			tse_task_complete(task, 0);
+			return 0;
+		}
+	}
+
 	D_ALLOC_PTR(kqp);
 	if (kqp == NULL)
 		D_GOTO(err_task, rc = -DER_NOMEM);
 
 	*args->size = 0;
+	kqp->cache_size	= cache_size;
+	kqp->size_gen	= size_gen;
 
 	kqp->akey_val	= '0';
 	d_iov_set(&kqp->akey, &kqp->akey_val, 1);
@@ -2483,6 +2650,11 @@ dc_array_set_size(tse_task_t *task)
 
 	oh = array->daos_oh;
 
+	rc = size_mod_register(array, task, DAOS_OPC_ARRAY_SET_SIZE, args->th,
+			       args->size);
+	if (rc)
+		D_GOTO(err_task, rc);
+
 	/** get key information for the last record */
 	if (args->size == 0) {
 		dkey_val = 1;
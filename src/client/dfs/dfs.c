@@ -144,6 +144,8 @@ struct dfs {
 	/** Optional prefix to account for when resolving an absolute path */
 	char			*prefix;
 	daos_size_t		prefix_len;
+	/** Cache of looked up entries, NULL if disabled */
+	struct dcache		*dcache;
 };
 
 struct dfs_entry {
@@ -510,6 +512,256 @@ out:
 	return rc;
 }
 
+/*
+ * Cache of directory entries, positive and negative, keyed by the parent
+ * object and the entry name.  Every component of a path is cached so that
+ * resolving a hot path needs no fetch at all.  Records are kept in a direct
+ * mapped table of a fixed size and are valid for a fixed time, entries
+ * changed through this DFS handle are invalidated straight away but changes
+ * from other clients are only seen once the record has expired.  Enabled by
+ * setting DFS_DCACHE_TIMEOUT (in ms), DFS_DCACHE_SIZE sets the number of
+ * records, rounded up to a power of two within [DCACHE_STRIPES,
+ * DCACHE_SIZE_MAX].
+ */
+#define DCACHE_SIZE_DEF	4096
+#define DCACHE_SIZE_MAX	(1U << 24)
+#define DCACHE_STRIPES	64
+
+struct dcache_rec {
+	daos_obj_id_t		dr_parent;
+	/** Expiry time in ns, 0 if the record is not used */
+	uint64_t		dr_expire;
+	bool			dr_exists;
+	/** Entry, with a copy of the symlink value */
+	struct dfs_entry	dr_entry;
+	size_t			dr_len;
+	char			dr_name[DFS_MAX_NAME + 1];
+};
+
+struct dcache {
+	/** Lock and generation per stripe of records, the generation is
+	 * bumped on invalidation so a fetch racing with an update is not
+	 * cached.
+	 */
+	pthread_mutex_t		dc_locks[DCACHE_STRIPES];
+	uint64_t		dc_gens[DCACHE_STRIPES];
+	uint64_t		dc_timeout;
+	uint32_t		dc_mask;
+	struct dcache_rec	*dc_recs;
+};
+
+static int
+dcache_create(dfs_t *dfs)
+{
+	struct dcache	*dc;
+	unsigned int	timeout = 0;
+	unsigned int	size = DCACHE_SIZE_DEF;
+	int		i;
+	int		rc;
+
+	d_getenv_int("DFS_DCACHE_TIMEOUT", &timeout);
+	if (timeout == 0)
+		return 0;
+
+	d_getenv_int("DFS_DCACHE_SIZE", &size);
+	if (size < DCACHE_STRIPES)
+		size = DCACHE_STRIPES;
+	else if (size > DCACHE_SIZE_MAX)
+		size = DCACHE_SIZE_MAX;
+	/* size - 1 is at least DCACHE_STRIPES - 1, clz() is defined */
+	size = 1U << (32 - __builtin_clz(size - 1));
+
+	D_ALLOC_PTR(dc);
+	if (dc == NULL)
+		return ENOMEM;
+
+	D_ALLOC_ARRAY(dc->dc_recs, size);
+	if (dc->dc_recs == NULL)
+		D_GOTO(err, rc = ENOMEM);
+
+	for (i = 0; i < DCACHE_STRIPES; i++) {
+		rc = D_MUTEX_INIT(&dc->dc_locks[i], NULL);
+		if (rc) {
+			while (i-- > 0)
+				D_MUTEX_DESTROY(&dc->dc_locks[i]);
+			D_GOTO(err_recs, rc = daos_der2errno(rc));
+		}
+	}
+
+	dc->dc_timeout = (uint64_t)timeout * NSEC_PER_MSEC;
+	dc->dc_mask = size - 1;
+	dfs->dcache = dc;
+	D_DEBUG(DB_ALL, "DFS dentry cache of %u records, timeout %u ms\n",
+		size, timeout);
+	return 0;
+
+err_recs:
+	D_FREE(dc->dc_recs);
+err:
+	D_FREE(dc);
+	return rc;
+}
+
+static void
+dcache_destroy(dfs_t *dfs)
+{
+	struct dcache	*dc = dfs->dcache;
+	uint32_t	i;
+
+	if (dc == NULL)
+		return;
+
+	for (i = 0; i <= dc->dc_mask; i++)
+		D_FREE(dc->dc_recs[i].dr_entry.value);
+	for (i = 0; i < DCACHE_STRIPES; i++)
+		D_MUTEX_DESTROY(&dc->dc_locks[i]);
+	D_FREE(dc->dc_recs);
+	D_FREE(dc);
+	dfs->dcache = NULL;
+}
+
+static inline uint32_t
+dcache_slot(struct dcache *dc, daos_obj_id_t parent, const char *name,
+	    size_t len)
+{
+	return d_hash_murmur64((unsigned char *)name, len,
+			       parent.lo ^ parent.hi) & dc->dc_mask;
+}
+
+static inline bool
+dcache_match(struct dcache_rec *dr, daos_obj_id_t parent, const char *name,
+	     size_t len)
+{
+	return dr->dr_expire != 0 && dr->dr_len == len &&
+	       daos_oid_cmp(dr->dr_parent, parent) == 0 &&
+	       memcmp(dr->dr_name, name, len) == 0;
+}
+
+/** Drop the record of an entry that has been changed */
+static void
+dcache_invalidate(dfs_t *dfs, daos_obj_id_t parent, const char *name,
+		  size_t len)
+{
+	struct dcache		*dc = dfs->dcache;
+	struct dcache_rec	*dr;
+	uint32_t		slot;
+
+	if (dc == NULL)
+		return;
+
+	slot = dcache_slot(dc, parent, name, len);
+	dr = &dc->dc_recs[slot];
+
+	D_MUTEX_LOCK(&dc->dc_locks[slot % DCACHE_STRIPES]);
+	dc->dc_gens[slot % DCACHE_STRIPES]++;
+	if (dcache_match(dr, parent, name, len)) {
+		dr->dr_expire = 0;
+		D_FREE(dr->dr_entry.value);
+	}
+	D_MUTEX_UNLOCK(&dc->dc_locks[slot % DCACHE_STRIPES]);
+}
+
+/** Drop all records, used when a whole directory tree has been removed */
+static void
+dcache_invalidate_all(dfs_t *dfs)
+{
+	struct dcache	*dc = dfs->dcache;
+	uint32_t	stripe;
+	uint32_t	i;
+
+	if (dc == NULL)
+		return;
+
+	for (stripe = 0; stripe < DCACHE_STRIPES; stripe++) {
+		D_MUTEX_LOCK(&dc->dc_locks[stripe]);
+		dc->dc_gens[stripe]++;
+		for (i = stripe; i <= dc->dc_mask; i += DCACHE_STRIPES) {
+			dc->dc_recs[i].dr_expire = 0;
+			D_FREE(dc->dc_recs[i].dr_entry.value);
+		}
+		D_MUTEX_UNLOCK(&dc->dc_locks[stripe]);
+	}
+}
+
+/*
+ * fetch_entry() with fetch_sym set, outside of a transaction, going through
+ * the dentry cache.  As with fetch_entry() the symlink value returned in
+ * \a entry must be freed by the caller.
+ */
+static int
+lookup_entry(dfs_t *dfs, daos_obj_id_t parent, daos_handle_t parent_oh,
+	     const char *name, size_t len, bool *exists,
+	     struct dfs_entry *entry)
+{
+	struct dcache		*dc = dfs->dcache;
+	struct dcache_rec	*dr;
+	pthread_mutex_t		*lock;
+	uint64_t		gen;
+	uint64_t		now;
+	uint32_t		slot;
+	int			rc;
+
+	if (dc == NULL)
+		return fetch_entry(parent_oh, DAOS_TX_NONE, name, len, true,
+				   exists, entry, 0, NULL, NULL, NULL);
+
+	slot = dcache_slot(dc, parent, name, len);
+	dr = &dc->dc_recs[slot];
+	lock = &dc->dc_locks[slot % DCACHE_STRIPES];
+
+	D_MUTEX_LOCK(lock);
+	now = daos_getntime_coarse();
+	if (dcache_match(dr, parent, name, len) && now < dr->dr_expire) {
+		*exists = dr->dr_exists;
+		if (dr->dr_exists) {
+			*entry = dr->dr_entry;
+			if (dr->dr_entry.value) {
+				D_STRNDUP(entry->value, dr->dr_entry.value,
+					  dr->dr_entry.value_len);
+				if (entry->value == NULL) {
+					D_MUTEX_UNLOCK(lock);
+					return ENOMEM;
+				}
+			}
+		}
+		D_MUTEX_UNLOCK(lock);
+		return 0;
+	}
+	gen = dc->dc_gens[slot % DCACHE_STRIPES];
+	D_MUTEX_UNLOCK(lock);
+
+	rc = fetch_entry(parent_oh, DAOS_TX_NONE, name, len, true, exists,
+			 entry, 0, NULL, NULL, NULL);
+	if (rc)
+		return rc;
+
+	D_MUTEX_LOCK(lock);
+	/** Do not cache it if the entry might have changed meanwhile */
+	if (gen == dc->dc_gens[slot % DCACHE_STRIPES]) {
+		D_FREE(dr->dr_entry.value);
+		oid_cp(&dr->dr_parent, parent);
+		memcpy(dr->dr_name, name, len);
+		dr->dr_name[len] = '\0';
+		dr->dr_len = len;
+		dr->dr_exists = *exists;
+		dr->dr_expire = now + dc->dc_timeout;
+		if (*exists) {
+			dr->dr_entry = *entry;
+			if (entry->value)
+				D_STRNDUP(dr->dr_entry.value, entry->value,
+					  entry->value_len);
+			/** could not copy the value, do not keep the entry */
+			if (entry->value && dr->dr_entry.value == NULL)
+				dr->dr_expire = 0;
+		} else {
+			memset(&dr->dr_entry, 0, sizeof(dr->dr_entry));
+		}
+	}
+	D_MUTEX_UNLOCK(lock);
+
+	return 0;
+}
+
 static int
 remove_entry(dfs_t *dfs, daos_handle_t th, daos_handle_t parent_oh,
 	     const char *name, size_t len, struct dfs_entry entry)
@@ -637,8 +889,9 @@ get_num_entries(daos_handle_t oh, daos_handle_t th, uint32_t *nr,
 }
 
 static int
-entry_stat(dfs_t *dfs, daos_handle_t th, daos_handle_t oh, const char *name,
-	   size_t len, struct dfs_obj *obj, struct stat *stbuf)
+entry_stat(dfs_t *dfs, daos_handle_t th, daos_handle_t oh,
+	   daos_obj_id_t parent_oid, const char *name, size_t len,
+	   struct dfs_obj *obj, struct stat *stbuf)
 {
 	struct dfs_entry	entry = {0};
 	bool			exists;
@@ -648,8 +901,12 @@ entry_stat(dfs_t *dfs, daos_handle_t th, daos_handle_t oh, const char *name,
 	memset(stbuf, 0, sizeof(struct stat));
 
 	/* Check if parent has the entry */
-	rc = fetch_entry(oh, th, name, len, true, &exists, &entry,
-			 0, NULL, NULL, NULL);
+	if (daos_handle_is_inval(th))
+		rc = lookup_entry(dfs, parent_oid, oh, name, len, &exists,
+				  &entry);
+	else
+		rc = fetch_entry(oh, th, name, len, true, &exists, &entry,
+				 0, NULL, NULL, NULL);
 	if (rc)
 		return rc;
 
@@ -877,8 +1134,12 @@ restart:
 	}
 
 	/* Check if parent has the filename entry */
-	rc = fetch_entry(parent->oh, th, file->name, len, false, &exists,
-			 entry, 0, NULL, NULL, NULL);
+	if (daos_handle_is_inval(th))
+		rc = lookup_entry(dfs, parent->oid, parent->oh, file->name, len,
+				  &exists, entry);
+	else
+		rc = fetch_entry(parent->oh, th, file->name, len, false,
+				 &exists, entry, 0, NULL, NULL, NULL);
 	if (rc) {
 		D_ERROR("fetch_entry %s failed %d.\n", file->name, rc);
 		D_GOTO(out, rc);
@@ -1023,8 +1284,8 @@ open_dir(dfs_t *dfs, dfs_obj_t *parent, int flags, daos_oclass_id_t cid,
 		return EINVAL;
 
 	/* Check if parent has the dirname entry */
-	rc = fetch_entry(parent_oh, DAOS_TX_NONE, dir->name, len, false,
-			 &exists, entry, 0, NULL, NULL, NULL);
+	rc = lookup_entry(dfs, parent ? parent->oid : dfs->super_oid, parent_oh,
+			  dir->name, len, &exists, entry);
 	if (rc)
 		return rc;
 
@@ -1035,8 +1296,10 @@ open_dir(dfs_t *dfs, dfs_obj_t *parent, int flags, daos_oclass_id_t cid,
 	 * happen for example if dfs_open() is called with S_IFDIR but without
 	 * O_CREATE and a entry of a different type exists already.
 	 */
-	if (!S_ISDIR(entry->mode))
+	if (!S_ISDIR(entry->mode)) {
+		D_FREE(entry->value);
 		return ENOTDIR;
+	}
 
 	rc = daos_obj_open(dfs->coh, entry->oid, daos_mode, &dir->oh, NULL);
 	if (rc) {
@@ -1591,6 +1854,10 @@ dfs_mount(daos_handle_t poh, daos_handle_t coh, int flags, dfs_t **_dfs)
 			dfs->oid.hi = 0;
 	}
 
+	rc = dcache_create(dfs);
+	if (rc)
+		D_GOTO(err_root, rc);
+
 	dfs->mounted = true;
 	*_dfs = dfs;
 	daos_prop_free(prop);
@@ -1617,6 +1884,7 @@ dfs_umount(dfs_t *dfs)
 	daos_obj_close(dfs->super_oh, NULL);
 
 	D_FREE(dfs->prefix);
+	dcache_destroy(dfs);
 
 	D_MUTEX_DESTROY(&dfs->lock);
 	D_FREE(dfs);
@@ -1837,6 +2105,13 @@ dfs_global2local(daos_handle_t poh, daos_handle_t coh, int flags, d_iov_t glob,
 		D_GOTO(err_dfs, rc = daos_der2errno(rc));
 	}
 
+	rc = dcache_create(dfs);
+	if (rc) {
+		daos_obj_close(dfs->root.oh, NULL);
+		daos_obj_close(dfs->super_oh, NULL);
+		D_GOTO(err_dfs, rc);
+	}
+
 	dfs->mounted = true;
 	*_dfs = dfs;
 
@@ -2014,6 +2289,8 @@ dfs_obj_set_oclass(dfs_t *dfs, dfs_obj_t *obj, int flags, daos_oclass_id_t cid)
 		D_GOTO(out, rc = daos_der2errno(rc));
 	}
 
+	dcache_invalidate(dfs, obj->parent_oid, obj->name, strlen(obj->name));
+
 	/** if this is root obj, we need to update the cached handle oclass */
 	if (daos_oid_cmp(obj->oid, dfs->root.oid) == 0)
 		dfs->root.d.oclass = cid;
@@ -2071,6 +2348,8 @@ dfs_obj_set_chunk_size(dfs_t *dfs, dfs_obj_t *obj, int flags, daos_size_t csize)
 		D_GOTO(out, rc = daos_der2errno(rc));
 	}
 
+	dcache_invalidate(dfs, obj->parent_oid, obj->name, strlen(obj->name));
+
 	/** if this is root object, we need to update the cached handle csize */
 	if (daos_oid_cmp(obj->oid, dfs->root.oid) == 0)
 		dfs->root.d.chunk_size = csize;
@@ -2117,6 +2396,7 @@ dfs_mkdir(dfs_t *dfs, dfs_obj_t *parent, const char *name, mode_t mode,
 
 	rc = insert_entry(parent->oh, th, name, len,
 			  DAOS_COND_DKEY_INSERT, &entry);
+	dcache_invalidate(dfs, parent->oid, name, len);
 	if (rc != 0) {
 		daos_obj_close(new_dir.oh, NULL);
 		return rc;
@@ -2204,6 +2484,7 @@ dfs_remove(dfs_t *dfs, dfs_obj_t *parent, const char *name, bool force,
 	struct dfs_entry	entry = {0};
 	daos_handle_t		th = DAOS_TX_NONE;
 	bool			exists;
+	bool			tree = false;
 	size_t			len;
 	int			rc;
 
@@ -2263,6 +2544,7 @@ restart:
 			D_GOTO(out, rc = ENOTEMPTY);
 
 		if (force && nr != 0) {
+			tree = true;
 			rc = remove_dir_contents(dfs, th, entry);
 			if (rc)
 				D_GOTO(out, rc);
@@ -2286,6 +2568,14 @@ restart:
 		oid_cp(oid, entry.oid);
 
 out:
+	/** Only once the transaction is committed, or a racing lookup could
+	 * cache the old entries again.  Entries of a removed tree are not
+	 * tracked, so drop everything.
+	 */
+	if (tree)
+		dcache_invalidate_all(dfs);
+	else
+		dcache_invalidate(dfs, parent->oid, name, len);
 	rc = check_tx(th, rc);
 	if (rc == ERESTART)
 		goto restart;
@@ -2399,8 +2689,8 @@ lookup_rel_path_loop:
 		len = strlen(token);
 
 		entry.chunk_size = 0;
-		rc = fetch_entry(parent.oh, DAOS_TX_NONE, token, len, true,
-				 &exists, &entry, 0, NULL, NULL, NULL);
+		rc = lookup_entry(dfs, parent.oid, parent.oh, token, len,
+				  &exists, &entry);
 		if (rc)
 			D_GOTO(err_obj, rc);
 
@@ -2679,6 +2969,298 @@ out:
 	return rc;
 }
 
+/** Max number of entry fetches in flight for dfs_readdirplus() */
+#define RDP_INFLIGHT	128
+
+/** State of one entry of dfs_readdirplus() */
+struct rdp_entry {
+	daos_event_t		re_ev;
+	daos_key_t		re_dkey;
+	daos_iod_t		re_iod;
+	daos_recx_t		re_recx;
+	d_sg_list_t		re_sgl;
+	d_iov_t			re_iovs[INODE_AKEYS];
+	struct dfs_entry	re_entry;
+	daos_handle_t		re_oh;
+	daos_size_t		re_size;
+	int			re_rc;
+	bool			re_inflight;
+};
+
+/* Wait for the operations in flight on entries [start, end) */
+static void
+rdp_wait(struct rdp_entry *ents, uint32_t start, uint32_t end)
+{
+	bool		flag;
+	uint32_t	i;
+	int		rc;
+
+	for (i = start; i < end; i++) {
+		if (!ents[i].re_inflight)
+			continue;
+		rc = daos_event_test(&ents[i].re_ev, DAOS_EQ_WAIT, &flag);
+		if (rc == 0)
+			rc = ents[i].re_ev.ev_error;
+		daos_event_fini(&ents[i].re_ev);
+		ents[i].re_inflight = false;
+		if (rc)
+			ents[i].re_rc = daos_der2errno(rc);
+	}
+}
+
+static void
+rdp_fetch_launch(dfs_obj_t *parent, struct rdp_entry *re, const char *name)
+{
+	uint32_t	i = 0;
+	int		rc;
+
+	rc = daos_event_init(&re->re_ev, DAOS_HDL_INVAL, NULL);
+	if (rc) {
+		re->re_rc = daos_der2errno(rc);
+		return;
+	}
+
+	d_iov_set(&re->re_dkey, (void *)name, strlen(name));
+	d_iov_set(&re->re_iod.iod_name, INODE_AKEY_NAME,
+		  sizeof(INODE_AKEY_NAME) - 1);
+	re->re_iod.iod_nr	= 1;
+	re->re_recx.rx_idx	= 0;
+	re->re_recx.rx_nr	= SYML_IDX;
+	re->re_iod.iod_recxs	= &re->re_recx;
+	re->re_iod.iod_type	= DAOS_IOD_ARRAY;
+	re->re_iod.iod_size	= 1;
+
+	d_iov_set(&re->re_iovs[i++], &re->re_entry.mode, sizeof(mode_t));
+	d_iov_set(&re->re_iovs[i++], &re->re_entry.oid, sizeof(daos_obj_id_t));
+	d_iov_set(&re->re_iovs[i++], &re->re_entry.atime, sizeof(time_t));
+	d_iov_set(&re->re_iovs[i++], &re->re_entry.mtime, sizeof(time_t));
+	d_iov_set(&re->re_iovs[i++], &re->re_entry.ctime, sizeof(time_t));
+	d_iov_set(&re->re_iovs[i++], &re->re_entry.chunk_size,
+		  sizeof(daos_size_t));
+	d_iov_set(&re->re_iovs[i++], &re->re_entry.oclass,
+		  sizeof(daos_oclass_id_t));
+	re->re_sgl.sg_nr	= i;
+	re->re_sgl.sg_nr_out	= 0;
+	re->re_sgl.sg_iovs	= re->re_iovs;
+
+	rc = daos_obj_fetch(parent->oh, DAOS_TX_NONE, 0, &re->re_dkey, 1,
+			    &re->re_iod, &re->re_sgl, NULL, &re->re_ev);
+	if (rc) {
+		daos_event_fini(&re->re_ev);
+		re->re_rc = daos_der2errno(rc);
+		return;
+	}
+	re->re_inflight = true;
+}
+
+/* Open the array of a regular file, the size is queried only if @size */
+static void
+rdp_array_launch(dfs_t *dfs, struct rdp_entry *re, bool size)
+{
+	int	rc;
+
+	rc = daos_array_open_with_attr(dfs->coh, re->re_entry.oid,
+				       DAOS_TX_NONE, DAOS_OO_RO, 1,
+				       re->re_entry.chunk_size ?
+				       re->re_entry.chunk_size :
+				       dfs->attr.da_chunk_size,
+				       &re->re_oh, NULL);
+	if (rc) {
+		D_ERROR("daos_array_open_with_attr() Failed (%d)\n", rc);
+		re->re_rc = daos_der2errno(rc);
+		return;
+	}
+
+	if (!size)
+		return;
+
+	rc = daos_event_init(&re->re_ev, DAOS_HDL_INVAL, NULL);
+	if (rc)
+		D_GOTO(err, rc);
+
+	rc = daos_array_get_size(re->re_oh, DAOS_TX_NONE, &re->re_size,
+				 &re->re_ev);
+	if (rc) {
+		daos_event_fini(&re->re_ev);
+		D_GOTO(err, rc);
+	}
+	re->re_inflight = true;
+	return;
+err:
+	daos_array_close(re->re_oh, NULL);
+	re->re_oh = DAOS_HDL_INVAL;
+	re->re_rc = daos_der2errno(rc);
+}
+
+/* Build the stat, and optionally the object, of a fetched entry */
+static int
+rdp_entry_fill(dfs_t *dfs, dfs_obj_t *parent, struct rdp_entry *re,
+	       const char *name, struct stat *stbuf, dfs_obj_t **_obj)
+{
+	struct dfs_entry	*entry = &re->re_entry;
+	struct stat		 tmp_stbuf;
+	dfs_obj_t		*obj = NULL;
+	bool			exists;
+	int			rc = 0;
+
+	/* Only the objects are wanted */
+	if (stbuf == NULL)
+		stbuf = &tmp_stbuf;
+	memset(stbuf, 0, sizeof(*stbuf));
+
+	if (_obj) {
+		D_ALLOC_PTR(obj);
+		if (obj == NULL)
+			return ENOMEM;
+
+		strncpy(obj->name, name, DFS_MAX_NAME);
+		obj->name[DFS_MAX_NAME] = '\0';
+		oid_cp(&obj->parent_oid, parent->oid);
+		oid_cp(&obj->oid, entry->oid);
+		obj->mode = entry->mode;
+		obj->flags = O_RDONLY | O_NOFOLLOW;
+	}
+
+	switch (entry->mode & S_IFMT) {
+	case S_IFREG:
+		stbuf->st_size = re->re_size;
+		stbuf->st_blocks = (stbuf->st_size + (1 << 9) - 1) >> 9;
+		stbuf->st_blksize = entry->chunk_size ? entry->chunk_size :
+			dfs->attr.da_chunk_size;
+		if (obj) {
+			obj->oh = re->re_oh;
+			re->re_oh = DAOS_HDL_INVAL;
+		}
+		break;
+	case S_IFLNK:
+		/* The value is not part of the batched fetch */
+		rc = fetch_entry(parent->oh, DAOS_TX_NONE, name, strlen(name),
+				 true, &exists, entry, 0, NULL, NULL, NULL);
+		if (rc)
+			D_GOTO(err, rc);
+		if (!exists)
+			D_GOTO(err, rc = ENOENT);
+		stbuf->st_size = entry->value_len;
+		if (obj) {
+			D_STRNDUP(obj->value, entry->value,
+				  entry->value_len + 1);
+			if (obj->value == NULL) {
+				D_FREE(entry->value);
+				D_GOTO(err, rc = ENOMEM);
+			}
+		}
+		D_FREE(entry->value);
+		break;
+	case S_IFDIR:
+		stbuf->st_size = sizeof(*entry);
+		if (obj) {
+			rc = daos_obj_open(dfs->coh, entry->oid, DAOS_OO_RO,
+					   &obj->oh, NULL);
+			if (rc) {
+				D_ERROR("daos_obj_open() Failed (%d)\n", rc);
+				D_GOTO(err, rc = daos_der2errno(rc));
+			}
+			obj->d.chunk_size = entry->chunk_size;
+			obj->d.oclass = entry->oclass;
+		}
+		break;
+	default:
+		D_ERROR("Invalid entry type (not a dir, file, symlink).\n");
+		D_GOTO(err, rc = EINVAL);
+	}
+
+	stbuf->st_nlink = 1;
+	stbuf->st_mode = entry->mode;
+	stbuf->st_uid = dfs->uid;
+	stbuf->st_gid = dfs->gid;
+	stbuf->st_atim.tv_sec = entry->atime;
+	stbuf->st_mtim.tv_sec = entry->mtime;
+	stbuf->st_ctim.tv_sec = entry->ctime;
+
+	if (_obj)
+		*_obj = obj;
+	return 0;
+err:
+	D_FREE(obj);
+	return rc;
+}
+
+int
+dfs_readdirplus(dfs_t *dfs, dfs_obj_t *obj, daos_anchor_t *anchor,
+		uint32_t *nr, struct dirent *dirs, struct stat *stbufs,
+		dfs_obj_t **objs)
+{
+	struct rdp_entry	*ents;
+	uint32_t		number, i, j, start, end;
+	int			rc;
+
+	if (stbufs == NULL && objs == NULL)
+		return EINVAL;
+
+	number = *nr;
+	rc = dfs_readdir(dfs, obj, anchor, &number, dirs);
+	if (rc || number == 0) {
+		*nr = number;
+		return rc;
+	}
+
+	D_ALLOC_ARRAY(ents, number);
+	if (ents == NULL)
+		return ENOMEM;
+
+	for (i = 0; i < number; i++)
+		ents[i].re_oh = DAOS_HDL_INVAL;
+
+	/* Fetch the inode entries of the batch concurrently, then the sizes
+	 * of the regular files if the stat is wanted, rather than one lookup
+	 * and stat per entry.
+	 */
+	for (start = 0; start < number; start = end) {
+		end = min(start + RDP_INFLIGHT, number);
+		for (i = start; i < end; i++)
+			rdp_fetch_launch(obj, &ents[i], dirs[i].d_name);
+		rdp_wait(ents, start, end);
+
+		for (i = start; i < end; i++) {
+			if (ents[i].re_rc == 0 && ents[i].re_sgl.sg_nr_out == 0)
+				ents[i].re_rc = ENOENT;
+			if (ents[i].re_rc == 0 && S_ISREG(ents[i].re_entry.mode))
+				rdp_array_launch(dfs, &ents[i], stbufs != NULL);
+		}
+		rdp_wait(ents, start, end);
+	}
+
+	/* Entries removed since they were listed are skipped */
+	for (i = 0, j = 0; i < number; i++) {
+		if (ents[i].re_rc == 0 && rc == 0)
+			ents[i].re_rc = rdp_entry_fill(dfs, obj, &ents[i],
+						       dirs[i].d_name,
+						       stbufs ? &stbufs[j] : NULL,
+						       objs ? &objs[j] : NULL);
+		if (daos_handle_is_valid(ents[i].re_oh))
+			daos_array_close(ents[i].re_oh, NULL);
+
+		if (ents[i].re_rc == ENOENT)
+			continue;
+		if (ents[i].re_rc && rc == 0)
+			rc = ents[i].re_rc;
+		if (rc)
+			continue;
+		if (i != j)
+			dirs[j] = dirs[i];
+		j++;
+	}
+
+	if (rc && objs) {
+		for (i = 0; i < j; i++)
+			dfs_release(objs[i]);
+	}
+
+	*nr = rc ? 0 : j;
+	D_FREE(ents);
+	return rc;
+}
+
 int
 dfs_iterate(dfs_t *dfs, dfs_obj_t *obj, daos_anchor_t *anchor,
 	    uint32_t *nr, size_t size, dfs_filler_cb_t op, void *udata)
@@ -2794,8 +3376,12 @@ dfs_lookup_rel_int(dfs_t *dfs, dfs_obj_t *parent, const char *name, int flags,
 	if (daos_mode == -1)
 		return EINVAL;
 
-	rc = fetch_entry(parent->oh, DAOS_TX_NONE, name, len, true, &exists,
-			 &entry, xnr, xnames, xvals, xsizes);
+	if (xnr == 0)
+		rc = lookup_entry(dfs, parent->oid, parent->oh, name, len,
+				  &exists, &entry);
+	else
+		rc = fetch_entry(parent->oh, DAOS_TX_NONE, name, len, true,
+				 &exists, &entry, xnr, xnames, xvals, xsizes);
 	if (rc)
 		return rc;
 
@@ -3012,6 +3598,8 @@ dfs_open_stat(dfs_t *dfs, dfs_obj_t *parent, const char *name, mode_t mode,
 	}
 
 out:
+	if (flags & O_CREAT)
+		dcache_invalidate(dfs, parent->oid, name, len);
 	if (rc == 0) {
 		if (stbuf) {
 			stbuf->st_size = file_size;
@@ -3579,6 +4167,7 @@ int
 dfs_stat(dfs_t *dfs, dfs_obj_t *parent, const char *name, struct stat *stbuf)
 {
 	daos_handle_t	oh;
+	daos_obj_id_t	parent_oid;
 	size_t		len;
 	int		rc;
 
@@ -3598,14 +4187,17 @@ dfs_stat(dfs_t *dfs, dfs_obj_t *parent, const char *name, struct stat *stbuf)
 		name = parent->name;
 		len = strlen(parent->name);
 		oh = dfs->super_oh;
+		parent_oid = dfs->super_oid;
 	} else {
 		rc = check_name(name, &len);
 		if (rc)
 			return rc;
 		oh = parent->oh;
+		parent_oid = parent->oid;
 	}
 
-	return entry_stat(dfs, DAOS_TX_NONE, oh, name, len, NULL, stbuf);
+	return entry_stat(dfs, DAOS_TX_NONE, oh, parent_oid, name, len, NULL,
+			  stbuf);
 }
 
 int
@@ -3624,8 +4216,8 @@ dfs_ostat(dfs_t *dfs, dfs_obj_t *obj, struct stat *stbuf)
 	if (rc)
 		return daos_der2errno(rc);
 
-	rc = entry_stat(dfs, DAOS_TX_NONE, oh, obj->name, strlen(obj->name),
-			obj, stbuf);
+	rc = entry_stat(dfs, DAOS_TX_NONE, oh, obj->parent_oid, obj->name,
+			strlen(obj->name), obj, stbuf);
 	if (rc)
 		D_GOTO(out, rc);
 
@@ -3638,6 +4230,7 @@ int
 dfs_access(dfs_t *dfs, dfs_obj_t *parent, const char *name, int mask)
 {
 	daos_handle_t		oh;
+	daos_obj_id_t		parent_oid;
 	bool			exists;
 	struct dfs_entry	entry = {0};
 	size_t			len;
@@ -3661,16 +4254,17 @@ dfs_access(dfs_t *dfs, dfs_obj_t *parent, const char *name, int mask)
 		name = parent->name;
 		len = strlen(name);
 		oh = dfs->super_oh;
+		parent_oid = dfs->super_oid;
 	} else {
 		rc = check_name(name, &len);
 		if (rc)
 			return rc;
 		oh = parent->oh;
+		parent_oid = parent->oid;
 	}
 
 	/* Check if parent has the entry */
-	rc = fetch_entry(oh, DAOS_TX_NONE, name, len, true, &exists, &entry,
-			 0, NULL, NULL, NULL);
+	rc = lookup_entry(dfs, parent_oid, oh, name, len, &exists, &entry);
 	if (rc)
 		return rc;
 
@@ -3709,6 +4303,7 @@ int
 dfs_chmod(dfs_t *dfs, dfs_obj_t *parent, const char *name, mode_t mode)
 {
 	daos_handle_t		oh;
+	daos_obj_id_t		parent_oid;
 	daos_handle_t		th = DAOS_TX_NONE;
 	bool			exists;
 	struct dfs_entry	entry = {0};
@@ -3740,11 +4335,13 @@ dfs_chmod(dfs_t *dfs, dfs_obj_t *parent, const char *name, mode_t mode)
 		name = parent->name;
 		len = strlen(name);
 		oh = dfs->super_oh;
+		parent_oid = dfs->super_oid;
 	} else {
 		rc = check_name(name, &len);
 		if (rc)
 			return rc;
 		oh = parent->oh;
+		parent_oid = parent->oid;
 	}
 
 	/** sticky bit, set-user-id and set-group-id, are not supported */
@@ -3815,6 +4412,10 @@ dfs_chmod(dfs_t *dfs, dfs_obj_t *parent, const char *name, mode_t mode)
 
 	rc = daos_obj_update(oh, th, DAOS_COND_DKEY_UPDATE, &dkey, 1, &iod,
 			     &sgl, NULL);
+	if (S_ISLNK(entry.mode))
+		dcache_invalidate(dfs, sym->parent_oid, entry_name, len);
+	else
+		dcache_invalidate(dfs, parent_oid, entry_name, len);
 	if (rc) {
 		D_ERROR("Failed to update mode, "DF_RC"\n", DP_RC(rc));
 		D_GOTO(out, rc = daos_der2errno(rc));
@@ -3874,7 +4475,8 @@ dfs_osetattr(dfs_t *dfs, dfs_obj_t *obj, struct stat *stbuf, int flags)
 	/* Fetch the remote entry first so we can check the oid, then keep
 	 * a track locally of what has been updated
 	 */
-	rc = entry_stat(dfs, th, oh, obj->name, len, obj, &rstat);
+	rc = entry_stat(dfs, th, oh, obj->parent_oid, obj->name, len, obj,
+			&rstat);
 	if (rc)
 		D_GOTO(out_obj, rc);
 
@@ -3943,6 +4545,7 @@ dfs_osetattr(dfs_t *dfs, dfs_obj_t *obj, struct stat *stbuf, int flags)
 
 	rc = daos_obj_update(oh, th, DAOS_COND_DKEY_UPDATE, &dkey, 1, &iod,
 			     &sgl, NULL);
+	dcache_invalidate(dfs, obj->parent_oid, obj->name, len);
 	if (rc) {
 		D_ERROR("Failed to update attr (rc = %d)\n", rc);
 		D_GOTO(out_obj, rc = daos_der2errno(rc));
@@ -4331,6 +4934,8 @@ restart:
 	}
 
 out:
+	dcache_invalidate(dfs, parent->oid, name, len);
+	dcache_invalidate(dfs, new_parent->oid, new_name, new_len);
 	rc = check_tx(th, rc);
 	if (rc == ERESTART)
 		goto restart;
@@ -4450,6 +5055,8 @@ restart:
 	}
 
 out:
+	dcache_invalidate(dfs, parent1->oid, name1, len1);
+	dcache_invalidate(dfs, parent2->oid, name2, len2);
 	rc = check_tx(th, rc);
 	if (rc == ERESTART)
 		goto restart;
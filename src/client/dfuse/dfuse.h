@@ -28,10 +28,48 @@ struct dfuse_info {
 	char				*di_group;
 	char				*di_mountpoint;
 	uint32_t			di_thread_count;
+	uint32_t			di_eq_count;
 	bool				di_threaded;
 	bool				di_foreground;
 	bool				di_caching;
 	bool				di_wb_cache;
+	/** Size of the dfuse chunk cache in bytes, 0 if disabled */
+	size_t				di_chunk_cache_size;
+};
+
+/** Max number of event queues, and of events reaped per poll */
+#define DFUSE_EQ_MAX		64
+#define DFUSE_EQ_BATCH		64
+
+/** Event queue for async events, and the progress thread polling it */
+struct dfuse_eq {
+	struct dfuse_projection_info	*deq_handle;
+	daos_handle_t			deq_eq;
+	/** Semaphore to signal event waiting for async thread */
+	sem_t				deq_sem;
+	pthread_t			deq_thread;
+	uint32_t			deq_idx;
+};
+
+/** Number of lock stripes in the chunk cache, inodes are spread over them */
+#define DFUSE_CACHE_STRIPES	64
+
+struct dfuse_cache_stripe {
+	pthread_mutex_t			dcs_lock;
+	/** Signalled when I/O on a chunk of this stripe completes */
+	pthread_cond_t			dcs_cond;
+	/** Cached chunks of the inodes in this stripe, most recent first */
+	d_list_t			dcs_chunks;
+};
+
+/** Chunk cache of file data, see dfuse_cache.c */
+struct dfuse_chunk_cache {
+	/** Protects dcc_lru and dcc_size, taken after any stripe lock */
+	pthread_mutex_t			dcc_lock;
+	d_list_t			dcc_lru;
+	size_t				dcc_size;
+	size_t				dcc_max;
+	struct dfuse_cache_stripe	dcc_stripes[DFUSE_CACHE_STRIPES];
 };
 
 struct dfuse_projection_info {
@@ -42,14 +80,26 @@ struct dfuse_projection_info {
 	struct d_hash_table		dpi_pool_table;
 	/** Next available inode number */
 	ATOMIC uint64_t			dpi_ino_next;
-	/* Event queue for async events */
-	daos_handle_t			dpi_eq;
-	/** Semaphore to signal event waiting for async thread */
-	sem_t				dpi_sem;
-	pthread_t			dpi_thread;
+	/** Event queues, I/O is routed to them by inode number */
+	struct dfuse_eq			*dpi_eqt;
+	uint32_t			dpi_eqt_count;
+	/** Number of progress threads started */
+	uint32_t			dpi_eqt_running;
 	bool				dpi_shutdown;
+	/** Chunk cache, NULL if not enabled */
+	struct dfuse_chunk_cache	*dpi_cache;
 };
 
+/* Pick the event queue for I/O on inode \a ino, I/O from many FUSE threads
+ * is spread over all the progress threads but the events of one inode are
+ * always reaped by the same thread.
+ */
+static inline struct dfuse_eq *
+dfuse_eq_pick(struct dfuse_projection_info *fs_handle, fuse_ino_t ino)
+{
+	return &fs_handle->dpi_eqt[ino % fs_handle->dpi_eqt_count];
+}
+
 /* Launch fuse, and do not return until complete */
 bool
 dfuse_launch_fuse(struct dfuse_projection_info *fs_handle,
@@ -70,6 +120,15 @@ struct dfuse_readdir_entry {
 	 * of directory.
 	 */
 	off_t	dre_next_offset;
+
+	/* Attributes and object of the entry from dfs_readdirplus(), the
+	 * object is NULL once used, in which case the entry is looked up
+	 * again if needed.  Only the mode is set unless it was read for
+	 * readdirplus.
+	 */
+	struct stat	dre_stat;
+	dfs_obj_t	*dre_obj;
+	bool		dre_plus;
 };
 
 /** what is returned as the handle for fuse fuse_file_info on
@@ -259,6 +318,46 @@ dfuse_start(struct dfuse_projection_info *fs_handle, struct dfuse_cont *dfs);
 int
 dfuse_fs_fini(struct dfuse_projection_info *fs_handle);
 
+/* dfuse_cache.c */
+
+int
+dfuse_cache_init(struct dfuse_projection_info *fs_handle);
+
+void
+dfuse_cache_fini(struct dfuse_projection_info *fs_handle);
+
+/* Return the chunk size to cache I/O on \a oh with, or 0 if I/O on the handle
+ * should bypass the cache.
+ */
+size_t
+dfuse_cache_chunk_size(struct dfuse_projection_info *fs_handle,
+		       struct dfuse_obj_hdl *oh);
+
+int
+dfuse_cache_write(struct dfuse_projection_info *fs_handle,
+		  struct dfuse_obj_hdl *oh, size_t chunk_size, void *buf,
+		  size_t len, off_t position);
+
+int
+dfuse_cache_read(struct dfuse_projection_info *fs_handle,
+		 struct dfuse_obj_hdl *oh, size_t chunk_size, void *buf,
+		 size_t len, off_t position, size_t *read_len);
+
+/* Write back the cached data of an inode and, if \a drop is set, remove all
+ * its chunks from the cache.  Returns any deferred write back error, which
+ * is kept.
+ */
+int
+dfuse_cache_flush(struct dfuse_projection_info *fs_handle,
+		  struct dfuse_inode_entry *ie, bool drop);
+
+/* Write back the cached data of an inode for flush or fsync, returning and
+ * clearing any deferred write back error.
+ */
+int
+dfuse_cache_sync(struct dfuse_projection_info *fs_handle,
+		 struct dfuse_inode_entry *ie);
+
 /* dfuse_thread.c */
 
 extern int
@@ -530,6 +629,15 @@ struct dfuse_inode_entry {
 	/** file was truncated from 0 to a certain size */
 	bool			ie_truncated;
 
+	/** Error from writing back cached data, set with the chunk cache
+	 * stripe lock held.  Writes fail while it is set, it is kept until
+	 * returned by flush or fsync.
+	 */
+	ATOMIC int		ie_wb_err;
+
+	/** Number of chunks of the inode in the chunk cache */
+	ATOMIC uint		ie_chunks;
+
 	bool			ie_root;
 };
 
@@ -601,6 +709,12 @@ dfuse_cb_open(fuse_req_t, fuse_ino_t, struct fuse_file_info *);
 void
 dfuse_cb_release(fuse_req_t, fuse_ino_t, struct fuse_file_info *);
 
+void
+dfuse_cb_flush(fuse_req_t, fuse_ino_t, struct fuse_file_info *);
+
+void
+dfuse_cb_fsync(fuse_req_t, fuse_ino_t, int, struct fuse_file_info *);
+
 void
 dfuse_cb_read(fuse_req_t, fuse_ino_t, size_t, off_t,
 	      struct fuse_file_info *);
@@ -612,6 +726,10 @@ dfuse_cb_unlink(fuse_req_t, struct dfuse_inode_entry *,
 void
 dfuse_cb_readdir(fuse_req_t, struct dfuse_obj_hdl *, size_t, off_t, bool);
 
+/* Release the entries read from dfs but not yet returned to the kernel */
+void
+dfuse_readdir_release(struct dfuse_obj_hdl *);
+
 void
 dfuse_cb_rename(fuse_req_t, struct dfuse_inode_entry *, const char *,
 		struct dfuse_inode_entry *, const char *, unsigned int);
@@ -0,0 +1,751 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/* Chunk cache for file data.
+ *
+ * Data is cached in buffers of the DFS chunk size of the file, aligned to
+ * chunk boundaries.  Writes are copied into the chunk and replied to straight
+ * away, contiguous writes are merged and the dirty range written back with a
+ * single dfs_write() once the chunk is full, when a non-contiguous write
+ * arrives, on eviction, or on flush/fsync/release/getattr/setattr of the
+ * inode.  Reads fetch the whole chunk and are then served locally until the
+ * attribute timeout of the container expires.  A write back error is kept
+ * on the inode until it is returned by flush or fsync.
+ *
+ * Chunks are kept on per-inode stripes, the stripe lock protects the chunks
+ * but is not held during I/O.  A chunk is marked busy for the duration of
+ * its I/O instead, anyone else needing a busy chunk waits on the stripe
+ * condition and looks the chunk up again afterwards, as it might have been
+ * evicted in the meantime.  A global LRU of all chunks is used to keep the
+ * memory used under the configured limit, the cache lock protecting it is
+ * only ever taken after a stripe lock, or with trylock on a stripe when
+ * evicting.
+ */
+
+#include "dfuse_common.h"
+#include "dfuse.h"
+
+/* Number of LRU entries to look at when trying to make space */
+#define DFUSE_CACHE_EVICT_SCAN	16
+
+struct dfuse_chunk {
+	/** Link in the stripe list */
+	d_list_t			 dc_link;
+	/** Link in the cache LRU */
+	d_list_t			 dc_lru;
+	fuse_ino_t			 dc_ino;
+	/** Inode the chunk is counted against, see ie_chunks */
+	struct dfuse_inode_entry	*dc_owner;
+	/** Chunk index within the file */
+	uint64_t			 dc_idx;
+	size_t				 dc_size;
+	char				*dc_buf;
+	/** Number of bytes from the start of the chunk which are file data,
+	 * only set if dc_filled is, less than dc_size if the chunk holds EOF
+	 */
+	size_t				 dc_valid;
+	/** Time after which the fetched data is not used */
+	double				 dc_expire;
+	bool				 dc_filled;
+	/** I/O is in progress without the stripe lock, nobody else may use,
+	 * change or free the chunk until it is cleared
+	 */
+	bool				 dc_busy;
+	/** Dirty range, and the handle to write it back with.  The handle
+	 * is always one that is still open as release flushes the inode.
+	 */
+	size_t				 dc_dirty_start;
+	size_t				 dc_dirty_end;
+	struct dfuse_inode_entry	*dc_ie;
+	dfs_t				*dc_dfs;
+	dfs_obj_t			*dc_obj;
+};
+
+static double
+cache_now(void)
+{
+	struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static inline struct dfuse_cache_stripe *
+cache_stripe(struct dfuse_chunk_cache *cache, fuse_ino_t ino)
+{
+	return &cache->dcc_stripes[ino % DFUSE_CACHE_STRIPES];
+}
+
+static inline bool
+chunk_dirty(struct dfuse_chunk *dc)
+{
+	return dc->dc_dirty_end != 0;
+}
+
+/* Mark a chunk busy and drop the stripe lock to do I/O on it */
+static void
+chunk_io_begin(struct dfuse_cache_stripe *dcs, struct dfuse_chunk *dc)
+{
+	D_ASSERT(!dc->dc_busy);
+	dc->dc_busy = true;
+	D_MUTEX_UNLOCK(&dcs->dcs_lock);
+}
+
+/* Retake the stripe lock after I/O on a chunk and wake up any waiters */
+static void
+chunk_io_end(struct dfuse_cache_stripe *dcs, struct dfuse_chunk *dc)
+{
+	D_MUTEX_LOCK(&dcs->dcs_lock);
+	dc->dc_busy = false;
+	pthread_cond_broadcast(&dcs->dcs_cond);
+}
+
+/* Write back the dirty range of a chunk, on failure the data is discarded
+ * and the error saved on the inode to be returned by the next write, flush
+ * or fsync.  Called with the stripe lock held, which is dropped during the
+ * write.
+ */
+static int
+chunk_flush(struct dfuse_cache_stripe *dcs, struct dfuse_chunk *dc)
+{
+	struct dfuse_inode_entry	*ie = dc->dc_ie;
+	size_t				 start = dc->dc_dirty_start;
+	size_t				 end = dc->dc_dirty_end;
+	uint64_t			 pos = dc->dc_idx * dc->dc_size;
+	d_sg_list_t			 sgl;
+	d_iov_t				 iov;
+	int				 rc;
+
+	if (!chunk_dirty(dc))
+		return 0;
+
+	d_iov_set(&iov, dc->dc_buf + start, end - start);
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &iov;
+
+	chunk_io_begin(dcs, dc);
+	rc = dfs_write(dc->dc_dfs, dc->dc_obj, &sgl, pos + start, NULL);
+	chunk_io_end(dcs, dc);
+
+	if (rc != 0) {
+		DFUSE_TRA_ERROR(ie, "write back of %#zx-%#zx failed: %d",
+				pos + start, pos + end - 1, rc);
+		atomic_store_relaxed(&ie->ie_wb_err, rc);
+		dc->dc_filled = false;
+	} else if (dc->dc_filled) {
+		/* Fetched data is still good if the write extended it
+		 * without leaving a gap.
+		 */
+		if (start > dc->dc_valid)
+			dc->dc_filled = false;
+		else if (end > dc->dc_valid)
+			dc->dc_valid = end;
+	}
+
+	DFUSE_TRA_DEBUG(ie, "wrote back %#zx bytes of chunk %#lx: %d",
+			end - start, dc->dc_idx, rc);
+
+	dc->dc_dirty_start = 0;
+	dc->dc_dirty_end = 0;
+	dc->dc_ie = NULL;
+	dc->dc_dfs = NULL;
+	dc->dc_obj = NULL;
+	return rc;
+}
+
+static void
+chunk_free(struct dfuse_chunk *dc)
+{
+	D_FREE(dc->dc_buf);
+	D_FREE(dc);
+}
+
+/* Remove a chunk from its stripe and free it */
+static void
+chunk_unlink(struct dfuse_chunk *dc)
+{
+	d_list_del(&dc->dc_link);
+	atomic_fetch_sub(&dc->dc_owner->ie_chunks, 1);
+	chunk_free(dc);
+}
+
+/* Remove a chunk from the cache and free it.  Called with the stripe lock
+ * held.
+ */
+static void
+chunk_drop(struct dfuse_chunk_cache *cache, struct dfuse_chunk *dc)
+{
+	D_ASSERT(!dc->dc_busy);
+
+	D_MUTEX_LOCK(&cache->dcc_lock);
+	d_list_del(&dc->dc_lru);
+	cache->dcc_size -= dc->dc_size;
+	D_MUTEX_UNLOCK(&cache->dcc_lock);
+
+	chunk_unlink(dc);
+}
+
+static void
+cache_unreserve(struct dfuse_chunk_cache *cache, size_t size)
+{
+	D_MUTEX_LOCK(&cache->dcc_lock);
+	cache->dcc_size -= size;
+	D_MUTEX_UNLOCK(&cache->dcc_lock);
+}
+
+/* Account for \a size more bytes in the cache, evicting least recently used
+ * chunks to make space.  Busy chunks, and chunks on stripes which are locked,
+ * are skipped, if not enough space can be made then -DER_NOMEM is returned
+ * and the caller should bypass the cache.  Called without any stripe lock
+ * held.
+ */
+static int
+cache_reserve(struct dfuse_chunk_cache *cache, size_t size)
+{
+	struct dfuse_cache_stripe	*dcs;
+	struct dfuse_chunk		*dc;
+	int				 loops = 0;
+	int				 rc = -DER_SUCCESS;
+
+	D_MUTEX_LOCK(&cache->dcc_lock);
+	cache->dcc_size += size;
+
+	while (cache->dcc_size > cache->dcc_max &&
+	       !d_list_empty(&cache->dcc_lru) &&
+	       loops++ < DFUSE_CACHE_EVICT_SCAN) {
+		dc = d_list_entry(cache->dcc_lru.prev, struct dfuse_chunk,
+				  dc_lru);
+		dcs = cache_stripe(cache, dc->dc_ino);
+		if (pthread_mutex_trylock(&dcs->dcs_lock) != 0) {
+			d_list_move(&dc->dc_lru, &cache->dcc_lru);
+			continue;
+		}
+
+		if (dc->dc_busy) {
+			D_MUTEX_UNLOCK(&dcs->dcs_lock);
+			d_list_move(&dc->dc_lru, &cache->dcc_lru);
+			continue;
+		}
+
+		d_list_del_init(&dc->dc_lru);
+		cache->dcc_size -= dc->dc_size;
+		D_MUTEX_UNLOCK(&cache->dcc_lock);
+
+		/* The chunk is busy while being written back so nobody
+		 * else uses it, and can be freed afterwards.
+		 */
+		chunk_flush(dcs, dc);
+		chunk_unlink(dc);
+
+		D_MUTEX_UNLOCK(&dcs->dcs_lock);
+		D_MUTEX_LOCK(&cache->dcc_lock);
+	}
+
+	if (cache->dcc_size > cache->dcc_max) {
+		cache->dcc_size -= size;
+		rc = -DER_NOMEM;
+	}
+	D_MUTEX_UNLOCK(&cache->dcc_lock);
+
+	return rc;
+}
+
+static void
+cache_touch(struct dfuse_chunk_cache *cache, struct dfuse_cache_stripe *dcs,
+	    struct dfuse_chunk *dc)
+{
+	d_list_move(&dc->dc_link, &dcs->dcs_chunks);
+
+	D_MUTEX_LOCK(&cache->dcc_lock);
+	d_list_move(&dc->dc_lru, &cache->dcc_lru);
+	D_MUTEX_UNLOCK(&cache->dcc_lock);
+}
+
+/* Find a chunk, waiting for any I/O on it to complete.  Called with the
+ * stripe lock held.
+ */
+static struct dfuse_chunk *
+chunk_find(struct dfuse_cache_stripe *dcs, fuse_ino_t ino, uint64_t idx)
+{
+	struct dfuse_chunk	*dc;
+
+again:
+	d_list_for_each_entry(dc, &dcs->dcs_chunks, dc_link) {
+		if (dc->dc_ino != ino || dc->dc_idx != idx)
+			continue;
+
+		if (dc->dc_busy) {
+			pthread_cond_wait(&dcs->dcs_cond, &dcs->dcs_lock);
+			goto again;
+		}
+		return dc;
+	}
+
+	return NULL;
+}
+
+/* Find or allocate a chunk.  Recently used chunks are kept at the head of the
+ * stripe list as most access is sequential.  Called with the stripe lock
+ * held, which is dropped while making space for a new chunk.
+ */
+static struct dfuse_chunk *
+chunk_get(struct dfuse_chunk_cache *cache, struct dfuse_cache_stripe *dcs,
+	  struct dfuse_inode_entry *ie, uint64_t idx, size_t size)
+{
+	fuse_ino_t		 ino = ie->ie_stat.st_ino;
+	struct dfuse_chunk	*dc;
+	struct dfuse_chunk	*found;
+	int			 rc;
+
+	dc = chunk_find(dcs, ino, idx);
+	if (dc != NULL) {
+		cache_touch(cache, dcs, dc);
+		return dc;
+	}
+
+	/* Eviction might write back chunks of this stripe */
+	D_MUTEX_UNLOCK(&dcs->dcs_lock);
+
+	rc = cache_reserve(cache, size);
+	if (rc != -DER_SUCCESS)
+		goto out;
+
+	D_ALLOC_PTR(dc);
+	if (dc == NULL)
+		goto out;
+
+	/* No need to zero the buffer, only dirty or fetched data is used */
+	D_ALLOC_NZ(dc->dc_buf, size);
+	if (dc->dc_buf == NULL) {
+		D_FREE(dc);
+		goto out;
+	}
+
+	dc->dc_ino = ino;
+	dc->dc_owner = ie;
+	dc->dc_idx = idx;
+	dc->dc_size = size;
+
+out:
+	D_MUTEX_LOCK(&dcs->dcs_lock);
+	if (rc != -DER_SUCCESS)
+		return NULL;
+
+	/* Another thread might have added the chunk in the meantime */
+	found = chunk_find(dcs, ino, idx);
+	if (dc == NULL || found != NULL) {
+		if (dc != NULL)
+			chunk_free(dc);
+		cache_unreserve(cache, size);
+		if (found != NULL)
+			cache_touch(cache, dcs, found);
+		return found;
+	}
+
+	d_list_add(&dc->dc_link, &dcs->dcs_chunks);
+	atomic_fetch_add(&ie->ie_chunks, 1);
+
+	D_MUTEX_LOCK(&cache->dcc_lock);
+	d_list_add(&dc->dc_lru, &cache->dcc_lru);
+	D_MUTEX_UNLOCK(&cache->dcc_lock);
+
+	return dc;
+}
+
+/* Return true if the inode has a dirty chunk after chunk \a idx, which might
+ * extend the file past what DAOS reports.  Called with the stripe lock held.
+ */
+static bool
+inode_dirty_after(struct dfuse_cache_stripe *dcs, fuse_ino_t ino,
+		  uint64_t idx)
+{
+	struct dfuse_chunk	*dc;
+
+	d_list_for_each_entry(dc, &dcs->dcs_chunks, dc_link) {
+		if (dc->dc_ino == ino && dc->dc_idx > idx &&
+		    (dc->dc_busy || chunk_dirty(dc)))
+			return true;
+	}
+	return false;
+}
+
+/* Write back all the dirty chunks of an inode and, if \a drop is set, remove
+ * all of them from the cache.  Returns the pending write back error of the
+ * inode, which is kept.  Called with the stripe lock held, which is dropped
+ * while waiting for or doing I/O.
+ */
+static int
+inode_flush(struct dfuse_chunk_cache *cache, struct dfuse_cache_stripe *dcs,
+	    struct dfuse_inode_entry *ie, bool drop)
+{
+	fuse_ino_t		 ino = ie->ie_stat.st_ino;
+	struct dfuse_chunk	*dc, *tmp;
+
+	/* Start again after the stripe lock has been dropped */
+again:
+	d_list_for_each_entry_safe(dc, tmp, &dcs->dcs_chunks, dc_link) {
+		if (dc->dc_ino != ino)
+			continue;
+
+		if (dc->dc_busy) {
+			pthread_cond_wait(&dcs->dcs_cond, &dcs->dcs_lock);
+			goto again;
+		}
+
+		if (chunk_dirty(dc)) {
+			chunk_flush(dcs, dc);
+			goto again;
+		}
+
+		if (drop)
+			chunk_drop(cache, dc);
+	}
+
+	return atomic_load_relaxed(&ie->ie_wb_err);
+}
+
+size_t
+dfuse_cache_chunk_size(struct dfuse_projection_info *fs_handle,
+		       struct dfuse_obj_hdl *oh)
+{
+	struct dfuse_cont	*dfc = oh->doh_ie->ie_dfs;
+	daos_size_t		 size;
+	int			 rc;
+
+	/* Only cache data for handles which allow caching, and only as long
+	 * as the container lets the attributes be cached.
+	 */
+	if (fs_handle->dpi_cache == NULL || !oh->doh_caching ||
+	    !dfc->dfc_data_caching || dfc->dfc_attr_timeout <= 0)
+		return 0;
+
+	rc = dfs_get_chunk_size(oh->doh_obj, &size);
+	if (rc != 0)
+		return 0;
+
+	/* Do not let one chunk take over the cache */
+	if (size == 0 || size > fs_handle->dpi_cache->dcc_max / 4)
+		return 0;
+
+	return size;
+}
+
+int
+dfuse_cache_write(struct dfuse_projection_info *fs_handle,
+		  struct dfuse_obj_hdl *oh, size_t chunk_size, void *buf,
+		  size_t len, off_t position)
+{
+	struct dfuse_chunk_cache	*cache = fs_handle->dpi_cache;
+	struct dfuse_inode_entry	*ie = oh->doh_ie;
+	fuse_ino_t			 ino = ie->ie_stat.st_ino;
+	struct dfuse_cache_stripe	*dcs = cache_stripe(cache, ino);
+	struct dfuse_chunk		*dc;
+	size_t				 done = 0;
+	int				 rc = 0;
+
+	D_MUTEX_LOCK(&dcs->dcs_lock);
+
+	/* Fail writes until the error is returned by flush or fsync */
+	rc = atomic_load_relaxed(&ie->ie_wb_err);
+	if (rc != 0)
+		goto out;
+
+	while (done < len) {
+		uint64_t	pos = position + done;
+		uint64_t	idx = pos / chunk_size;
+		size_t		off = pos % chunk_size;
+		size_t		n = min(len - done, chunk_size - off);
+
+		dc = chunk_get(cache, dcs, ie, idx, chunk_size);
+		if (dc == NULL) {
+			d_sg_list_t	sgl;
+			d_iov_t		iov;
+
+			/* No space, write through */
+			d_iov_set(&iov, buf + done, n);
+			sgl.sg_nr = 1;
+			sgl.sg_nr_out = 0;
+			sgl.sg_iovs = &iov;
+			D_MUTEX_UNLOCK(&dcs->dcs_lock);
+			rc = dfs_write(oh->doh_dfs, oh->doh_obj, &sgl, pos,
+				       NULL);
+			D_MUTEX_LOCK(&dcs->dcs_lock);
+			if (rc != 0)
+				goto out;
+
+			/* A reader might have cached the old data meanwhile */
+			dc = chunk_find(dcs, ino, idx);
+			if (dc != NULL)
+				dc->dc_filled = false;
+			done += n;
+			continue;
+		}
+
+		/* Only one contiguous dirty range is kept per chunk */
+		if (chunk_dirty(dc) && (off > dc->dc_dirty_end ||
+					off + n < dc->dc_dirty_start)) {
+			rc = chunk_flush(dcs, dc);
+			if (rc != 0)
+				goto out;
+		}
+
+		memcpy(dc->dc_buf + off, buf + done, n);
+		if (chunk_dirty(dc)) {
+			dc->dc_dirty_start = min(dc->dc_dirty_start, off);
+			dc->dc_dirty_end = max(dc->dc_dirty_end, off + n);
+		} else {
+			dc->dc_dirty_start = off;
+			dc->dc_dirty_end = off + n;
+		}
+		dc->dc_ie = ie;
+		dc->dc_dfs = oh->doh_dfs;
+		dc->dc_obj = oh->doh_obj;
+
+		if (dc->dc_dirty_start == 0 && dc->dc_dirty_end == chunk_size) {
+			rc = chunk_flush(dcs, dc);
+			if (rc != 0)
+				goto out;
+		}
+		done += n;
+	}
+
+out:
+	D_MUTEX_UNLOCK(&dcs->dcs_lock);
+	return rc;
+}
+
+int
+dfuse_cache_read(struct dfuse_projection_info *fs_handle,
+		 struct dfuse_obj_hdl *oh, size_t chunk_size, void *buf,
+		 size_t len, off_t position, size_t *read_len)
+{
+	struct dfuse_chunk_cache	*cache = fs_handle->dpi_cache;
+	struct dfuse_inode_entry	*ie = oh->doh_ie;
+	fuse_ino_t			 ino = ie->ie_stat.st_ino;
+	struct dfuse_cache_stripe	*dcs = cache_stripe(cache, ino);
+	struct dfuse_chunk		*dc;
+	d_sg_list_t			 sgl;
+	d_iov_t				 iov;
+	daos_size_t			 got;
+	size_t				 done = 0;
+	bool				 flushed = false;
+	int				 rc = 0;
+
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &iov;
+
+	D_MUTEX_LOCK(&dcs->dcs_lock);
+
+	while (done < len) {
+		uint64_t	pos = position + done;
+		uint64_t	idx = pos / chunk_size;
+		size_t		off = pos % chunk_size;
+		size_t		n = min(len - done, chunk_size - off);
+
+		dc = chunk_get(cache, dcs, ie, idx, chunk_size);
+		if (dc == NULL) {
+			/* No space, read directly into the reply buffer */
+			d_iov_set(&iov, buf + done, n);
+			D_MUTEX_UNLOCK(&dcs->dcs_lock);
+			rc = dfs_read(oh->doh_dfs, oh->doh_obj, &sgl, pos,
+				      &got, NULL);
+			D_MUTEX_LOCK(&dcs->dcs_lock);
+			if (rc != 0)
+				goto out;
+			done += got;
+			if (got == n)
+				continue;
+
+			/* Dirty chunks after EOF extend the file */
+			if (flushed || !inode_dirty_after(dcs, ino, idx))
+				break;
+			inode_flush(cache, dcs, ie, false);
+			flushed = true;
+			continue;
+		}
+
+		if (chunk_dirty(dc)) {
+			rc = chunk_flush(dcs, dc);
+			if (rc != 0)
+				goto out;
+		}
+
+		if (!dc->dc_filled || cache_now() > dc->dc_expire) {
+			d_iov_set(&iov, dc->dc_buf, chunk_size);
+			chunk_io_begin(dcs, dc);
+			rc = dfs_read(oh->doh_dfs, oh->doh_obj, &sgl,
+				      idx * chunk_size, &got, NULL);
+			chunk_io_end(dcs, dc);
+			if (rc != 0) {
+				dc->dc_filled = false;
+				goto out;
+			}
+			dc->dc_valid = got;
+			dc->dc_filled = true;
+			dc->dc_expire = cache_now() +
+					ie->ie_dfs->dfc_attr_timeout;
+		} else {
+			DFUSE_TRA_DEBUG(oh, "%#lx-%#lx served from cache",
+					pos, pos + n - 1);
+		}
+
+		/* The chunk holds EOF as far as DAOS knows, but dirty chunks
+		 * after it extend the file so write them back and fetch the
+		 * chunk again.  It might be evicted while the lock is dropped.
+		 */
+		if (dc->dc_valid < chunk_size && !flushed &&
+		    inode_dirty_after(dcs, ino, idx)) {
+			inode_flush(cache, dcs, ie, false);
+			flushed = true;
+			dc = chunk_find(dcs, ino, idx);
+			if (dc != NULL)
+				dc->dc_filled = false;
+			continue;
+		}
+
+		if (dc->dc_valid <= off)
+			break;
+		n = min(n, dc->dc_valid - off);
+		memcpy(buf + done, dc->dc_buf + off, n);
+		done += n;
+		if (dc->dc_valid < chunk_size)
+			break;
+	}
+
+out:
+	D_MUTEX_UNLOCK(&dcs->dcs_lock);
+	*read_len = done;
+	return rc;
+}
+
+int
+dfuse_cache_flush(struct dfuse_projection_info *fs_handle,
+		  struct dfuse_inode_entry *ie, bool drop)
+{
+	struct dfuse_chunk_cache	*cache = fs_handle->dpi_cache;
+	struct dfuse_cache_stripe	*dcs;
+	int				 rc;
+
+	if (cache == NULL)
+		return 0;
+
+	/* Most inodes, and all of them when caching is off, have no chunks */
+	if (atomic_load_relaxed(&ie->ie_chunks) == 0)
+		return atomic_load_relaxed(&ie->ie_wb_err);
+
+	dcs = cache_stripe(cache, ie->ie_stat.st_ino);
+	D_MUTEX_LOCK(&dcs->dcs_lock);
+	rc = inode_flush(cache, dcs, ie, drop);
+	D_MUTEX_UNLOCK(&dcs->dcs_lock);
+	return rc;
+}
+
+int
+dfuse_cache_sync(struct dfuse_projection_info *fs_handle,
+		 struct dfuse_inode_entry *ie)
+{
+	struct dfuse_chunk_cache	*cache = fs_handle->dpi_cache;
+	struct dfuse_cache_stripe	*dcs;
+	int				 rc;
+
+	if (cache == NULL)
+		return 0;
+
+	dcs = cache_stripe(cache, ie->ie_stat.st_ino);
+	D_MUTEX_LOCK(&dcs->dcs_lock);
+	rc = inode_flush(cache, dcs, ie, false);
+	atomic_store_relaxed(&ie->ie_wb_err, 0);
+	D_MUTEX_UNLOCK(&dcs->dcs_lock);
+	return rc;
+}
+
+int
+dfuse_cache_init(struct dfuse_projection_info *fs_handle)
+{
+	struct dfuse_chunk_cache	*cache;
+	int				 i;
+	int				 rc;
+
+	D_ALLOC_PTR(cache);
+	if (cache == NULL)
+		return -DER_NOMEM;
+
+	rc = D_MUTEX_INIT(&cache->dcc_lock, NULL);
+	if (rc != -DER_SUCCESS)
+		goto err;
+
+	for (i = 0; i < DFUSE_CACHE_STRIPES; i++) {
+		struct dfuse_cache_stripe *dcs = &cache->dcc_stripes[i];
+
+		rc = D_MUTEX_INIT(&dcs->dcs_lock, NULL);
+		if (rc != -DER_SUCCESS)
+			goto err_lock;
+
+		rc = pthread_cond_init(&dcs->dcs_cond, NULL);
+		if (rc != 0) {
+			D_MUTEX_DESTROY(&dcs->dcs_lock);
+			rc = d_errno2der(rc);
+			goto err_lock;
+		}
+		D_INIT_LIST_HEAD(&dcs->dcs_chunks);
+	}
+
+	D_INIT_LIST_HEAD(&cache->dcc_lru);
+	cache->dcc_max = fs_handle->dpi_info->di_chunk_cache_size;
+	fs_handle->dpi_cache = cache;
+
+	DFUSE_TRA_INFO(fs_handle, "Chunk cache enabled, %zu MiB",
+		       cache->dcc_max >> 20);
+	return -DER_SUCCESS;
+
+err_lock:
+	while (i-- > 0) {
+		pthread_cond_destroy(&cache->dcc_stripes[i].dcs_cond);
+		D_MUTEX_DESTROY(&cache->dcc_stripes[i].dcs_lock);
+	}
+	D_MUTEX_DESTROY(&cache->dcc_lock);
+err:
+	D_FREE(cache);
+	return rc;
+}
+
+void
+dfuse_cache_fini(struct dfuse_projection_info *fs_handle)
+{
+	struct dfuse_chunk_cache	*cache = fs_handle->dpi_cache;
+	struct dfuse_chunk		*dc, *tmp;
+	int				 dirty = 0;
+	int				 i;
+
+	if (cache == NULL)
+		return;
+
+	/* All files have been released by now so there should not be any
+	 * dirty data, and the handles to write it back with are gone.
+	 */
+	for (i = 0; i < DFUSE_CACHE_STRIPES; i++) {
+		struct dfuse_cache_stripe *dcs = &cache->dcc_stripes[i];
+
+		d_list_for_each_entry_safe(dc, tmp, &dcs->dcs_chunks, dc_link) {
+			if (chunk_dirty(dc))
+				dirty++;
+			d_list_del(&dc->dc_link);
+			chunk_free(dc);
+		}
+		pthread_cond_destroy(&dcs->dcs_cond);
+		D_MUTEX_DESTROY(&dcs->dcs_lock);
+	}
+
+	if (dirty != 0)
+		DFUSE_TRA_WARNING(fs_handle, "Discarded %d dirty chunks",
+				  dirty);
+
+	D_MUTEX_DESTROY(&cache->dcc_lock);
+	D_FREE(cache);
+	fs_handle->dpi_cache = NULL;
+}
@@ -11,21 +11,27 @@
 
 /* Async progress thread.
  *
- * This thread is started at launch time with an event queue and blocks
+ * One thread is started at launch time for each event queue and blocks
  * on a semaphore until a asynchronous event is created, at which point
  * the thread wakes up and busy polls in daos_eq_poll() until it's complete.
+ * All the events which are complete by then are reaped in one batch.
  */
 static void *
 dfuse_progress_thread(void *arg)
 {
-	struct dfuse_projection_info *fs_handle = arg;
-	int rc;
-	daos_event_t *dev;
-	struct dfuse_event *ev;
+	struct dfuse_eq			*eqt = arg;
+	struct dfuse_projection_info	*fs_handle = eqt->deq_handle;
+	int				rc;
+	int				i;
+	daos_event_t			*devs[DFUSE_EQ_BATCH];
+	struct dfuse_event		*ev;
 
-	while (1) {
+	/* The flag is set before the shutdown post, and checked after every
+	 * wake since the post might be consumed below for a reaped event.
+	 */
+	while (!fs_handle->dpi_shutdown) {
 		errno = 0;
-		rc = sem_wait(&fs_handle->dpi_sem);
+		rc = sem_wait(&eqt->deq_sem);
 		if (rc != 0) {
 			rc = errno;
 
@@ -39,13 +45,23 @@ dfuse_progress_thread(void *arg)
 		if (fs_handle->dpi_shutdown)
 			return NULL;
 
-		rc = daos_eq_poll(fs_handle->dpi_eq, 1,
-				  DAOS_EQ_WAIT,
-				1,
-				&dev);
+		rc = daos_eq_poll(eqt->deq_eq, 1, DAOS_EQ_WAIT, DFUSE_EQ_BATCH,
+				  devs);
+		if (rc <= 0)
+			continue;
 
-		if (rc == 1) {
-			ev = container_of(dev, struct dfuse_event, de_ev);
+		/* The semaphore is posted once per event, so consume the
+		 * posts for the other events reaped in this batch. They are
+		 * posted right after the events are launched so this does not
+		 * block for long.
+		 */
+		for (i = 1; i < rc && !fs_handle->dpi_shutdown; i++) {
+			while (sem_wait(&eqt->deq_sem) != 0 && errno == EINTR)
+				;
+		}
+
+		for (i = 0; i < rc; i++) {
+			ev = container_of(devs[i], struct dfuse_event, de_ev);
 
 			ev->de_complete_cb(ev);
 
@@ -55,6 +71,80 @@ dfuse_progress_thread(void *arg)
 	return NULL;
 }
 
+/* Pin progress thread \a idx to one of the CPUs dfuse is allowed to run on,
+ * so the event queues are spread over the cores.
+ */
+static void
+dfuse_progress_pin(struct dfuse_eq *eqt)
+{
+	cpu_set_t	cpuset;
+	cpu_set_t	pin;
+	uint32_t	nth;
+	int		cpu;
+	int		rc;
+
+	rc = sched_getaffinity(0, sizeof(cpuset), &cpuset);
+	if (rc != 0 || CPU_COUNT(&cpuset) == 0)
+		return;
+
+	nth = eqt->deq_idx % CPU_COUNT(&cpuset);
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, &cpuset))
+			continue;
+		if (nth-- == 0)
+			break;
+	}
+
+	CPU_ZERO(&pin);
+	CPU_SET(cpu, &pin);
+	rc = pthread_setaffinity_np(eqt->deq_thread, sizeof(pin), &pin);
+	if (rc != 0)
+		DFUSE_TRA_WARNING(eqt->deq_handle,
+				  "Failed to pin progress thread %u: %d",
+				  eqt->deq_idx, rc);
+}
+
+static int
+dfuse_progress_start(struct dfuse_projection_info *fs_handle)
+{
+	struct dfuse_eq	*eqt;
+	int		rc;
+
+	while (fs_handle->dpi_eqt_running < fs_handle->dpi_eqt_count) {
+		eqt = &fs_handle->dpi_eqt[fs_handle->dpi_eqt_running];
+
+		rc = pthread_create(&eqt->deq_thread, NULL,
+				    dfuse_progress_thread, eqt);
+		if (rc != 0)
+			return rc;
+
+		pthread_setname_np(eqt->deq_thread, "dfuse_progress");
+		/* A single progress thread is left to the scheduler */
+		if (fs_handle->dpi_eqt_count > 1)
+			dfuse_progress_pin(eqt);
+		fs_handle->dpi_eqt_running++;
+	}
+
+	DFUSE_TRA_INFO(fs_handle, "Started %u progress threads",
+		       fs_handle->dpi_eqt_running);
+	return 0;
+}
+
+static void
+dfuse_progress_stop(struct dfuse_projection_info *fs_handle)
+{
+	uint32_t	i;
+
+	fs_handle->dpi_shutdown = true;
+	for (i = 0; i < fs_handle->dpi_eqt_running; i++)
+		sem_post(&fs_handle->dpi_eqt[i].deq_sem);
+
+	for (i = 0; i < fs_handle->dpi_eqt_running; i++)
+		pthread_join(fs_handle->dpi_eqt[i].deq_thread, NULL);
+
+	fs_handle->dpi_eqt_running = 0;
+}
+
 #if 0
 /* Parse a string to a time, used for reading container attributes info
  * timeouts.
@@ -948,6 +1038,7 @@ dfuse_fs_init(struct dfuse_info *dfuse_info,
 	      struct dfuse_projection_info **_fsh)
 {
 	struct dfuse_projection_info	*fs_handle;
+	uint32_t			i;
 	int				rc;
 
 	D_ALLOC_PTR(fs_handle);
@@ -972,20 +1063,48 @@ dfuse_fs_init(struct dfuse_info *dfuse_info,
 
 	atomic_store_relaxed(&fs_handle->dpi_ino_next, 2);
 
-	rc = daos_eq_create(&fs_handle->dpi_eq);
-	if (rc != -DER_SUCCESS)
-		D_GOTO(err_iht, 0);
+	fs_handle->dpi_eqt_count = dfuse_info->di_eq_count;
+	if (fs_handle->dpi_eqt_count == 0)
+		fs_handle->dpi_eqt_count = 1;
 
-	rc = sem_init(&fs_handle->dpi_sem, 0, 0);
-	if (rc != 0)
-		D_GOTO(err_eq, 0);
+	D_ALLOC_ARRAY(fs_handle->dpi_eqt, fs_handle->dpi_eqt_count);
+	if (fs_handle->dpi_eqt == NULL)
+		D_GOTO(err_iht, rc = -DER_NOMEM);
+
+	for (i = 0; i < fs_handle->dpi_eqt_count; i++) {
+		struct dfuse_eq *eqt = &fs_handle->dpi_eqt[i];
+
+		eqt->deq_handle = fs_handle;
+		eqt->deq_idx = i;
+
+		rc = daos_eq_create(&eqt->deq_eq);
+		if (rc != -DER_SUCCESS)
+			D_GOTO(err_eq, 0);
+
+		rc = sem_init(&eqt->deq_sem, 0, 0);
+		if (rc != 0) {
+			daos_eq_destroy(eqt->deq_eq, DAOS_EQ_DESTROY_FORCE);
+			D_GOTO(err_eq, rc = daos_errno2der(errno));
+		}
+	}
+
+	if (dfuse_info->di_chunk_cache_size != 0) {
+		rc = dfuse_cache_init(fs_handle);
+		if (rc != -DER_SUCCESS)
+			D_GOTO(err_eq, 0);
+	}
 
 	fs_handle->dpi_shutdown = false;
 	*_fsh = fs_handle;
 	return rc;
 
 err_eq:
-	daos_eq_destroy(fs_handle->dpi_eq, DAOS_EQ_DESTROY_FORCE);
+	while (i-- > 0) {
+		sem_destroy(&fs_handle->dpi_eqt[i].deq_sem);
+		daos_eq_destroy(fs_handle->dpi_eqt[i].deq_eq,
+				DAOS_EQ_DESTROY_FORCE);
+	}
+	D_FREE(fs_handle->dpi_eqt);
 err_iht:
 	d_hash_table_destroy_inplace(&fs_handle->dpi_iet, false);
 err_pt:
@@ -1008,6 +1127,9 @@ dfuse_ie_close(struct dfuse_projection_info *fs_handle,
 
 	D_ASSERT(ref == 0);
 
+	/* The chunks of the inode point to it */
+	dfuse_cache_flush(fs_handle, ie, true);
+
 	if (ie->ie_obj) {
 		rc = dfs_release(ie->ie_obj);
 		if (rc) {
@@ -1069,6 +1191,14 @@ dfuse_start(struct dfuse_projection_info *fs_handle,
 	if (!fuse_ops)
 		D_GOTO(err, rc = -DER_NOMEM);
 
+	/* With the chunk cache writes are only acknowledged locally, so
+	 * handle flush and fsync to write back and return any errors.
+	 */
+	if (fs_handle->dpi_cache) {
+		fuse_ops->flush = dfuse_cb_flush;
+		fuse_ops->fsync = dfuse_cb_fsync;
+	}
+
 	/* Create the root inode and insert into table */
 	D_ALLOC_PTR(ie);
 	if (!ie)
@@ -1107,12 +1237,11 @@ dfuse_start(struct dfuse_projection_info *fs_handle,
 		D_GOTO(err, 0);
 	}
 
-	rc = pthread_create(&fs_handle->dpi_thread, NULL,
-			    dfuse_progress_thread, fs_handle);
-	if (rc != 0)
+	rc = dfuse_progress_start(fs_handle);
+	if (rc != 0) {
+		dfuse_progress_stop(fs_handle);
 		D_GOTO(err_ie_remove, 0);
-
-	pthread_setname_np(fs_handle->dpi_thread, "dfuse_progress");
+	}
 
 	rc = dfuse_launch_fuse(fs_handle, fuse_ops, &args);
 	D_FREE(fuse_ops);
@@ -1232,22 +1361,20 @@ dfuse_fs_fini(struct dfuse_projection_info *fs_handle)
 	d_list_t	*rlink;
 	uint64_t	refs = 0;
 	int		handles = 0;
+	uint32_t	i;
 	int		rc;
 	int		rcp = 0;
 
 	DFUSE_TRA_INFO(fs_handle, "Flushing inode table");
 
-	fs_handle->dpi_shutdown = true;
-	sem_post(&fs_handle->dpi_sem);
-
-	pthread_join(fs_handle->dpi_thread, NULL);
-
-	sem_destroy(&fs_handle->dpi_sem);
+	dfuse_progress_stop(fs_handle);
 
 	rc = d_hash_table_traverse(&fs_handle->dpi_iet, ino_flush, fs_handle);
 
 	DFUSE_TRA_INFO(fs_handle, "Flush complete: "DF_RC, DP_RC(rc));
 
+	dfuse_cache_fini(fs_handle);
+
 	DFUSE_TRA_INFO(fs_handle, "Draining inode table");
 	do {
 		struct dfuse_inode_entry *ie;
@@ -1277,11 +1404,15 @@ dfuse_fs_fini(struct dfuse_projection_info *fs_handle)
 			       refs, handles);
 	}
 
-	rc = daos_eq_destroy(fs_handle->dpi_eq, 0);
-	if (rc) {
-		DFUSE_TRA_WARNING(fs_handle, "Failed to destroy EQ");
-		rcp = EINVAL;
+	for (i = 0; i < fs_handle->dpi_eqt_count; i++) {
+		sem_destroy(&fs_handle->dpi_eqt[i].deq_sem);
+		rc = daos_eq_destroy(fs_handle->dpi_eqt[i].deq_eq, 0);
+		if (rc) {
+			DFUSE_TRA_WARNING(fs_handle, "Failed to destroy EQ");
+			rcp = EINVAL;
+		}
 	}
+	D_FREE(fs_handle->dpi_eqt);
 
 	rc = d_hash_table_destroy_inplace(&fs_handle->dpi_iet, false);
 	if (rc) {
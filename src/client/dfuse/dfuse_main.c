@@ -241,9 +241,11 @@ show_help(char *name)
 		"\n"
 		"	-S --singlethread	Single threaded\n"
 		"	-t --thread-count=count	Number of fuse threads to use\n"
+		"	   --eq-count=count	Number of event queues to use\n"
 		"	-f --foreground		Run in foreground\n"
 		"	   --disable-caching	Disable all caching\n"
 		"	   --disable-wb-cache	Use write-through rather than write-back cache\n"
+		"	   --chunk-cache=MiB	Size of the dfuse chunk cache (default 0, disabled)\n"
 		"\n"
 		"	-h --help		Show this help\n"
 		"	-v --version		Show version\n"
@@ -258,8 +260,11 @@ show_help(char *name)
 		"\n"
 		"The default thread count is one per available core to allow maximum throughput,\n"
 		"this can be modified by running dfuse in a cpuset via numactl or similar tools.\n"
-		"One thread will be started for asynchronous I/O handling so at least two threads\n"
-		"must be specified in all cases.\n"
+		"One thread will be started for asynchronous I/O handling per event queue, so the\n"
+		"thread count must be more than the event queue count in all cases.  By default\n"
+		"one event queue is used per eight threads, the I/O is spread over the event\n"
+		"queues by inode number and, if there is more than one, each of their threads is\n"
+		"pinned to one core.\n"
 		"Singlethreaded mode will use the libfuse loop to handle requests rather than the\n"
 		"threading logic in dfuse."
 		"\n"
@@ -275,6 +280,13 @@ show_help(char *name)
 		"given the data caching for the whole mount is performed in write-back mode and\n"
 		"the container attributes are still used\n"
 		"\n"
+		"The chunk cache keeps file data in dfuse, in buffers of the DFS chunk size of\n"
+		"each file.  Small sequential writes are merged and written back as whole chunks,\n"
+		"and repeated reads are served locally until the attribute timeout expires.\n"
+		"Written data is sent to DAOS at the latest on close or fsync of the file, write\n"
+		"back errors are returned by those calls.  It is only used where data caching is\n"
+		"enabled and the attribute timeout of the container is not zero.\n"
+		"\n"
 		"version: %s\n",
 		name, DAOS_VERSION);
 }
@@ -296,6 +308,7 @@ main(int argc, char **argv)
 	int			rc;
 	char			*path = NULL;
 	bool			have_thread_count = false;
+	bool			have_eq_count = false;
 
 	struct option long_options[] = {
 		{"mountpoint",		required_argument, 0, 'm'},
@@ -305,9 +318,11 @@ main(int argc, char **argv)
 		{"sys-name",		required_argument, 0, 'G'},
 		{"singlethread",	no_argument,	   0, 'S'},
 		{"thread-count",	required_argument, 0, 't'},
+		{"eq-count",		required_argument, 0, 'E'},
 		{"foreground",		no_argument,	   0, 'f'},
 		{"disable-caching",	no_argument,	   0, 'A'},
 		{"disable-wb-cache",	no_argument,	   0, 'B'},
+		{"chunk-cache",		required_argument, 0, 'C'},
 		{"version",		no_argument,	   0, 'v'},
 		{"help",		no_argument,	   0, 'h'},
 		{0, 0, 0, 0}
@@ -349,6 +364,10 @@ main(int argc, char **argv)
 		case 'B':
 			dfuse_info->di_wb_cache = false;
 			break;
+		case 'C':
+			dfuse_info->di_chunk_cache_size =
+				strtoull(optarg, NULL, 0) << 20;
+			break;
 		case 'm':
 			dfuse_info->di_mountpoint = optarg;
 			break;
@@ -366,6 +385,10 @@ main(int argc, char **argv)
 			dfuse_info->di_thread_count = atoi(optarg);
 			have_thread_count = true;
 			break;
+		case 'E':
+			dfuse_info->di_eq_count = atoi(optarg);
+			have_eq_count = true;
+			break;
 		case 'f':
 			dfuse_info->di_foreground = true;
 			break;
@@ -414,8 +437,20 @@ main(int argc, char **argv)
 		D_GOTO(out_debug, rc = -DER_INVAL);
 	}
 
-	/* Reserve one CPU thread for the daos event queue */
-	dfuse_info->di_thread_count -= 1;
+	if (!have_eq_count)
+		dfuse_info->di_eq_count = max(dfuse_info->di_thread_count / 8,
+					      1U);
+
+	if (dfuse_info->di_eq_count < 1 ||
+	    dfuse_info->di_eq_count > DFUSE_EQ_MAX ||
+	    dfuse_info->di_eq_count >= dfuse_info->di_thread_count) {
+		printf("Event queue count must be between 1 and %d, and less "
+		       "than thread count.\n", DFUSE_EQ_MAX);
+		D_GOTO(out_debug, rc = -DER_INVAL);
+	}
+
+	/* Reserve one CPU thread for each daos event queue */
+	dfuse_info->di_thread_count -= dfuse_info->di_eq_count;
 
 	if (!dfuse_info->di_foreground) {
 		rc = dfuse_bg(dfuse_info);
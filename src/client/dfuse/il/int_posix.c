@@ -53,6 +53,8 @@ struct ioil_global {
 	uint64_t	iog_read_count;		/**< Number of read operations intercepted */
 	uint64_t	iog_write_count;	/**< Number of write operations intercepted */
 	uint64_t	iog_fstat_count;	/**< Number of fstat operations intercepted */
+
+	size_t		iog_ra_size;		/**< Per file readahead window, 0 if disabled */
 };
 
 static vector_t	fd_table;
@@ -154,6 +156,7 @@ entry_array_close(void *arg) {
 	DFUSE_LOG_DEBUG("entry %p closing array fd_count %d",
 			entry, entry->fd_cont->ioc_open_count);
 
+	ioil_ra_fini(entry);
 	DFUSE_TRA_DOWN(entry->fd_dfsoh);
 	dfs_release(entry->fd_dfsoh);
 
@@ -279,6 +282,7 @@ ioil_init(void)
 	struct rlimit rlimit;
 	int rc;
 	uint64_t report_count = 0;
+	uint64_t ra_kb = 0;
 
 	pthread_once(&init_links_flag, init_links);
 
@@ -307,6 +311,11 @@ ioil_init(void)
 		ioil_iog.iog_report_count = report_count;
 	}
 
+	/* Opt-in readahead for sequential reads, the window size in KiB */
+	rc = d_getenv_uint64_t("D_IL_READAHEAD", &ra_kb);
+	if (rc == -DER_SUCCESS)
+		ioil_iog.iog_ra_size = ra_kb << 10;
+
 	rc = ioil_initialize_fd_table(rlimit.rlim_max);
 	if (rc != 0) {
 		DFUSE_LOG_ERROR("Could not create fd_table, "
@@ -726,6 +735,14 @@ get_file:
 	if (rc)
 		D_GOTO(shrink, 0);
 
+	entry->fd_ra = NULL;
+	if (ioil_iog.iog_ra_size != 0 && (flags & O_ACCMODE) != O_WRONLY) {
+		rc = ioil_ra_init(entry, ioil_iog.iog_ra_size);
+		if (rc != 0)
+			DFUSE_LOG_DEBUG("Failed to allocate readahead window, "
+					DF_RC, DP_RC(rc));
+	}
+
 	rc = vector_set(&fd_table, fd, entry);
 	if (rc != 0) {
 		DFUSE_LOG_DEBUG("Failed to track IOF file fd=%d., disabling kernel bypass",
@@ -744,6 +761,7 @@ get_file:
 	return true;
 
 obj_close:
+	ioil_ra_fini(entry);
 	dfs_release(entry->fd_dfsoh);
 
 shrink:
@@ -1263,6 +1281,29 @@ do_real_fdatasync:
 	return __real_fdatasync(fd);
 }
 
+DFUSE_PUBLIC int
+dfuse_ftruncate(int fd, off_t length)
+{
+	struct fd_entry *entry;
+	int rc;
+
+	rc = vector_get(&fd_table, fd, &entry);
+	if (rc != 0)
+		return __real_ftruncate(fd, length);
+
+	DFUSE_LOG_DEBUG("ftruncate(fd=%d, length=%jd) intercepted, bypass=%s",
+			fd, (intmax_t)length, bypass_status[entry->fd_status]);
+
+	rc = __real_ftruncate(fd, length);
+
+	/* Drop the readahead window once the file size has changed */
+	if (rc == 0)
+		ioil_ra_invalidate(entry);
+
+	vector_decref(&fd_table, entry);
+	return rc;
+}
+
 DFUSE_PUBLIC int dfuse_dup(int oldfd)
 {
 	struct fd_entry *entry = NULL;
@@ -37,33 +37,234 @@ read_bulk(char *buff, size_t len, off_t position,
 	return read_size;
 }
 
+/* Readahead window of a file descriptor.  There is at most one prefetch in
+ * flight, it reads the window following the last sequential read into the
+ * buffer and is waited for on the next read, so the round trip overlaps with
+ * whatever the application does between its reads.
+ */
+struct ioil_ra {
+	pthread_mutex_t	ra_lock;
+	daos_event_t	ra_ev;
+	d_iov_t		ra_iov;
+	d_sg_list_t	ra_sgl;
+	char		*ra_buf;
+	size_t		ra_size;
+	/* File offset of the buffer, and number of valid bytes in it */
+	off_t		ra_off;
+	daos_size_t	ra_len;
+	/* Expected offset of the next sequential read */
+	off_t		ra_next;
+	bool		ra_inflight;
+	/* The event could not be set up again after a failure */
+	bool		ra_disabled;
+};
+
+int
+ioil_ra_init(struct fd_entry *entry, size_t size)
+{
+	struct ioil_ra	*ra;
+	int		 rc;
+
+	D_ALLOC_PTR(ra);
+	if (ra == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC(ra->ra_buf, size);
+	if (ra->ra_buf == NULL)
+		D_GOTO(free_ra, rc = -DER_NOMEM);
+
+	rc = D_MUTEX_INIT(&ra->ra_lock, NULL);
+	if (rc != 0)
+		D_GOTO(free_buf, rc);
+
+	/* No event queue, the prefetch is completed by daos_event_test() */
+	rc = daos_event_init(&ra->ra_ev, DAOS_HDL_INVAL, NULL);
+	if (rc != 0)
+		D_GOTO(free_lock, rc);
+
+	ra->ra_size = size;
+	ra->ra_sgl.sg_nr = 1;
+	ra->ra_sgl.sg_iovs = &ra->ra_iov;
+	entry->fd_ra = ra;
+	return 0;
+
+free_lock:
+	D_MUTEX_DESTROY(&ra->ra_lock);
+free_buf:
+	D_FREE(ra->ra_buf);
+free_ra:
+	D_FREE(ra);
+	return rc;
+}
+
+/* Wait for the prefetch in flight, the caller holds ra_lock */
+static void
+ra_wait(struct ioil_ra *ra)
+{
+	bool	flag = false;
+	int	rc;
+
+	if (!ra->ra_inflight)
+		return;
+
+	rc = daos_event_test(&ra->ra_ev, DAOS_EQ_WAIT, &flag);
+	if (rc != 0 || !flag || ra->ra_ev.ev_error != 0) {
+		DFUSE_LOG_DEBUG("prefetch failed: %d/%d", rc,
+				ra->ra_ev.ev_error);
+		ra->ra_len = 0;
+	}
+	ra->ra_inflight = false;
+}
+
+void
+ioil_ra_fini(struct fd_entry *entry)
+{
+	struct ioil_ra	*ra = entry->fd_ra;
+
+	if (ra == NULL)
+		return;
+
+	ra_wait(ra);
+	if (!ra->ra_disabled)
+		daos_event_fini(&ra->ra_ev);
+	D_MUTEX_DESTROY(&ra->ra_lock);
+	D_FREE(ra->ra_buf);
+	D_FREE(ra);
+	entry->fd_ra = NULL;
+}
+
+void
+ioil_ra_invalidate(struct fd_entry *entry)
+{
+	struct ioil_ra	*ra = entry->fd_ra;
+
+	if (ra == NULL)
+		return;
+
+	D_MUTEX_LOCK(&ra->ra_lock);
+	ra_wait(ra);
+	ra->ra_len = 0;
+	D_MUTEX_UNLOCK(&ra->ra_lock);
+}
+
+static void
+ra_launch(struct ioil_ra *ra, off_t position, struct fd_entry *entry)
+{
+	int	rc;
+
+	if (ra->ra_disabled)
+		return;
+
+	ra->ra_off = position;
+	ra->ra_len = 0;
+	d_iov_set(&ra->ra_iov, ra->ra_buf, ra->ra_size);
+	rc = dfs_read(entry->fd_cont->ioc_dfs, entry->fd_dfsoh, &ra->ra_sgl,
+		      position, &ra->ra_len, &ra->ra_ev);
+	if (rc != 0) {
+		DFUSE_LOG_WARNING("prefetch failed to start: %d", rc);
+		/* The event may be left launched, so it's set up again for
+		 * the next prefetch.
+		 */
+		daos_event_fini(&ra->ra_ev);
+		rc = daos_event_init(&ra->ra_ev, DAOS_HDL_INVAL, NULL);
+		if (rc != 0) {
+			DFUSE_LOG_ERROR("failed to reset prefetch event: %d",
+					rc);
+			ra->ra_disabled = true;
+		}
+		return;
+	}
+	ra->ra_inflight = true;
+}
+
+static ssize_t
+read_ahead(char *buff, size_t len, off_t position, struct fd_entry *entry,
+	   int *errcode)
+{
+	struct ioil_ra	*ra = entry->fd_ra;
+	ssize_t		 bytes_read;
+	bool		 seq;
+
+	D_MUTEX_LOCK(&ra->ra_lock);
+	ra_wait(ra);
+
+	if (position >= ra->ra_off &&
+	    position + len <= ra->ra_off + ra->ra_len) {
+		memcpy(buff, ra->ra_buf + (position - ra->ra_off), len);
+		bytes_read = len;
+	} else if (position >= ra->ra_off &&
+		   position < ra->ra_off + ra->ra_len &&
+		   ra->ra_len < ra->ra_size) {
+		/* The window was cut short by EOF */
+		bytes_read = ra->ra_off + ra->ra_len - position;
+		memcpy(buff, ra->ra_buf + (position - ra->ra_off), bytes_read);
+	} else {
+		bytes_read = read_bulk(buff, len, position, entry, errcode);
+		if (bytes_read < 0)
+			goto out;
+	}
+
+	seq = (position == ra->ra_next);
+	ra->ra_next = position + bytes_read;
+
+	/* Prefetch the next window once a sequential stream is about to run
+	 * out of the current one.
+	 */
+	if (seq && bytes_read == len &&
+	    ra->ra_next + len > ra->ra_off + ra->ra_len)
+		ra_launch(ra, ra->ra_next, entry);
+out:
+	D_MUTEX_UNLOCK(&ra->ra_lock);
+	return bytes_read;
+}
+
 ssize_t ioil_do_pread(char *buff, size_t len, off_t position,
 		      struct fd_entry *entry, int *errcode)
 {
+	if (entry->fd_ra != NULL && len < entry->fd_ra->ra_size)
+		return read_ahead(buff, len, position, entry, errcode);
+
 	return read_bulk(buff, len, position, entry, errcode);
 }
 
+/* Read all the segments of a vectored read with a single request, they are
+ * contiguous in the file so only the sgl has multiple entries.
+ */
 ssize_t
 ioil_do_preadv(const struct iovec *iov, int count, off_t position,
 	       struct fd_entry *entry, int *errcode)
 {
-	ssize_t bytes_read;
-	ssize_t total_read = 0;
-	int i;
+	daos_size_t	read_size = 0;
+	d_iov_t		*iovs;
+	d_sg_list_t	sgl = {};
+	int		i;
+	int		rc;
 
-	for (i = 0; i < count; i++) {
-		bytes_read = read_bulk(iov[i].iov_base, iov[i].iov_len,
-				       position, entry, errcode);
+	if (count == 1)
+		return ioil_do_pread(iov[0].iov_base, iov[0].iov_len,
+				     position, entry, errcode);
+
+	D_ALLOC_ARRAY(iovs, count);
+	if (iovs == NULL) {
+		*errcode = ENOMEM;
+		return -1;
+	}
 
-		if (bytes_read == -1)
-			return (ssize_t)-1;
+	for (i = 0; i < count; i++)
+		d_iov_set(&iovs[i], iov[i].iov_base, iov[i].iov_len);
+	sgl.sg_nr = count;
+	sgl.sg_iovs = iovs;
 
-		if (bytes_read == 0)
-			return total_read;
+	DFUSE_TRA_DEBUG(entry->fd_dfsoh, "%#zx %d segments", position, count);
 
-		position += bytes_read;
-		total_read += bytes_read;
+	rc = dfs_read(entry->fd_cont->ioc_dfs, entry->fd_dfsoh, &sgl,
+		      position, &read_size, NULL);
+	D_FREE(iovs);
+	if (rc) {
+		DFUSE_TRA_DEBUG(entry->fd_dfsoh, "dfs_read() failed: %d", rc);
+		*errcode = rc;
+		return -1;
 	}
 
-	return total_read;
+	return read_size;
 }
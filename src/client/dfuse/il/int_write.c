@@ -27,6 +27,7 @@ ioil_do_writex(const char *buff, size_t len, off_t position,
 	d_iov_set(&iov, (void *)buff, len);
 	sgl.sg_iovs = &iov;
 
+	ioil_ra_invalidate(entry);
 	rc = dfs_write(entry->fd_cont->ioc_dfs,
 		       entry->fd_dfsoh, &sgl, position, NULL);
 	if (rc) {
@@ -37,27 +38,47 @@ ioil_do_writex(const char *buff, size_t len, off_t position,
 	return len;
 }
 
+/* Write all the segments of a vectored write with a single request, they are
+ * contiguous in the file so only the sgl has multiple entries.
+ */
 ssize_t
 ioil_do_pwritev(const struct iovec *iov, int count, off_t position,
 		struct fd_entry *entry, int *errcode)
 {
-	ssize_t bytes_written;
-	ssize_t total_write = 0;
-	int i;
-
-	for (i = 0; i < count; i++) {
-		bytes_written = ioil_do_writex(iov[i].iov_base, iov[i].iov_len,
-					       position, entry, errcode);
+	d_iov_t		*iovs;
+	d_sg_list_t	sgl = {};
+	size_t		len = 0;
+	int		i;
+	int		rc;
 
-		if (bytes_written == -1)
-			return (ssize_t)-1;
+	if (count == 1)
+		return ioil_do_writex(iov[0].iov_base, iov[0].iov_len,
+				      position, entry, errcode);
 
-		if (bytes_written == 0)
-			return total_write;
+	D_ALLOC_ARRAY(iovs, count);
+	if (iovs == NULL) {
+		*errcode = ENOMEM;
+		return -1;
+	}
 
-		position += bytes_written;
-		total_write += bytes_written;
+	for (i = 0; i < count; i++) {
+		d_iov_set(&iovs[i], iov[i].iov_base, iov[i].iov_len);
+		len += iov[i].iov_len;
 	}
+	sgl.sg_nr = count;
+	sgl.sg_iovs = iovs;
 
-	return total_write;
+	DFUSE_TRA_DEBUG(entry->fd_dfsoh, "%#zx-%#zx %d segments",
+			position, position + len - 1, count);
+
+	ioil_ra_invalidate(entry);
+	rc = dfs_write(entry->fd_cont->ioc_dfs,
+		       entry->fd_dfsoh, &sgl, position, NULL);
+	D_FREE(iovs);
+	if (rc) {
+		DFUSE_TRA_DEBUG(entry->fd_dfsoh, "dfs_write() failed: %d", rc);
+		*errcode = rc;
+		return -1;
+	}
+	return len;
 }
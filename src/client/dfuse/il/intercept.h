@@ -33,6 +33,7 @@
 	ACTION(ssize_t, pread,     (int, void *, size_t, off_t))              \
 	ACTION(ssize_t, pwrite,    (int, const void *, size_t, off_t))        \
 	ACTION(off_t,   lseek,     (int, off_t, int))                         \
+	ACTION(int,     ftruncate, (int, off_t))                              \
 	ACTION(ssize_t, preadv,    (int, const struct iovec *, int, off_t))   \
 	ACTION(ssize_t, pwritev,   (int, const struct iovec *, int, off_t))   \
 	ACTION(void *,  mmap,      (void *, size_t, int, int, int, off_t))
@@ -28,9 +28,13 @@ struct ioil_cont {
 	int		ioc_open_count;
 };
 
+struct ioil_ra;
+
 struct fd_entry {
 	struct ioil_cont	*fd_cont;
 	dfs_obj_t		*fd_dfsoh;
+	/* Readahead window, NULL if disabled */
+	struct ioil_ra		*fd_ra;
 	off_t			fd_pos;
 	int			fd_flags;
 	int			fd_status;
@@ -52,4 +56,11 @@ ssize_t
 ioil_do_pwritev(const struct iovec *iov, int count, off_t position,
 		struct fd_entry *entry, int *errcode);
 
+int
+ioil_ra_init(struct fd_entry *entry, size_t size);
+void
+ioil_ra_fini(struct fd_entry *entry);
+void
+ioil_ra_invalidate(struct fd_entry *entry);
+
 #endif /* __IOIL_H__ */
@@ -10,8 +10,14 @@
 void
 dfuse_cb_getattr(fuse_req_t req, struct dfuse_inode_entry *ie)
 {
-	struct stat	stat = {};
-	int		rc;
+	struct dfuse_projection_info	*fs_handle = fuse_req_userdata(req);
+	struct stat			stat = {};
+	int				rc;
+
+	/* Write back any cached data first so the size is correct, write back
+	 * errors are returned by flush and fsync.
+	 */
+	dfuse_cache_flush(fs_handle, ie, false);
 
 	rc = dfs_ostat(ie->ie_dfs->dfs_ns, ie->ie_obj, &stat);
 	if (rc != 0)
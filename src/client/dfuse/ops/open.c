@@ -72,6 +72,11 @@ dfuse_cb_open(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
 	 * O_TRUNC flag, we need to truncate the file manually.
 	 */
 	if (fi->flags & O_TRUNC) {
+		/* The data is punched anyway, any write back error is still
+		 * returned by the next flush or fsync.
+		 */
+		dfuse_cache_flush(fs_handle, ie, true);
+
 		rc = dfs_punch(ie->ie_dfs->dfs_ns, ie->ie_obj, 0,
 			       DFS_MAX_FSIZE);
 		if (rc)
@@ -91,8 +96,16 @@ err:
 void
 dfuse_cb_release(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
 {
-	struct dfuse_obj_hdl	*oh = (struct dfuse_obj_hdl *)fi->fh;
-	int			rc;
+	struct dfuse_projection_info	*fs_handle = fuse_req_userdata(req);
+	struct dfuse_obj_hdl		*oh = (struct dfuse_obj_hdl *)fi->fh;
+	int				rc;
+
+	/* Cached data might have been written by this handle so write it
+	 * back before the handle goes away.
+	 */
+	rc = dfuse_cache_flush(fs_handle, oh->doh_ie, false);
+	if (rc != 0)
+		DFUSE_TRA_WARNING(oh, "Cache write back failed: %d", rc);
 
 	rc = dfs_release(oh->doh_obj);
 	if (rc == 0)
@@ -101,3 +114,24 @@ dfuse_cb_release(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
 		DFUSE_REPLY_ERR_RAW(oh, req, rc);
 	D_FREE(oh);
 }
+
+void
+dfuse_cb_flush(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
+{
+	struct dfuse_projection_info	*fs_handle = fuse_req_userdata(req);
+	struct dfuse_obj_hdl		*oh = (struct dfuse_obj_hdl *)fi->fh;
+	int				rc;
+
+	rc = dfuse_cache_sync(fs_handle, oh->doh_ie);
+	if (rc == 0)
+		DFUSE_REPLY_ZERO(oh, req);
+	else
+		DFUSE_REPLY_ERR_RAW(oh, req, rc);
+}
+
+void
+dfuse_cb_fsync(fuse_req_t req, fuse_ino_t ino, int datasync,
+	       struct fuse_file_info *fi)
+{
+	dfuse_cb_flush(req, ino, fi);
+}
@@ -45,6 +45,8 @@ dfuse_cb_read(fuse_req_t req, fuse_ino_t ino, size_t len, off_t position,
 	bool				readahead = false;
 	bool				async = false;
 	struct dfuse_event		*ev = NULL;
+	struct dfuse_eq			*eqt = dfuse_eq_pick(fs_handle, ino);
+	size_t				chunk_size = 0;
 
 	D_ALLOC_PTR(ev);
 	if (ev == NULL)
@@ -83,12 +85,42 @@ dfuse_cb_read(fuse_req_t req, fuse_ino_t ino, size_t len, off_t position,
 		readahead = true;
 	}
 
+	/* Serve the read from the chunk cache, which also acts as readahead,
+	 * otherwise make sure any data cached for the file is written back
+	 * before reading directly.  Write back errors are returned by flush
+	 * and fsync.
+	 */
+	if (!skip_read) {
+		chunk_size = dfuse_cache_chunk_size(fs_handle, oh);
+		if (chunk_size == 0)
+			dfuse_cache_flush(fs_handle, oh->doh_ie, false);
+	}
+
+	if (chunk_size != 0) {
+		size_t read_len;
+
+		D_ALLOC(buff, len);
+		if (!buff)
+			D_GOTO(err, rc = ENOMEM);
+
+		rc = dfuse_cache_read(fs_handle, oh, chunk_size, buff, len,
+				      position, &read_len);
+		if (rc != 0) {
+			D_FREE(buff);
+			D_GOTO(err, rc);
+		}
+
+		DFUSE_REPLY_BUF(oh, req, buff, read_len);
+		D_FREE(buff);
+		D_FREE(ev);
+		return;
+	}
+
 	if (readahead) {
 		buff_len += READAHEAD_SIZE;
 	} else {
 		if (!skip_read) {
-			rc = daos_event_init(&ev->de_ev,
-					     fs_handle->dpi_eq, NULL);
+			rc = daos_event_init(&ev->de_ev, eqt->deq_eq, NULL);
 			if (rc != -DER_SUCCESS)
 				D_GOTO(err, rc = daos_der2errno(rc));
 
@@ -123,7 +155,7 @@ dfuse_cb_read(fuse_req_t req, fuse_ino_t ino, size_t len, off_t position,
 		/* Send a message to the async thread to wake it up and poll
 		 * for events
 		 */
-		sem_post(&fs_handle->dpi_sem);
+		sem_post(&eqt->deq_sem);
 		return;
 	}
 
@@ -23,49 +23,54 @@
 /* Offset of the first file, allow two entries for . and .. */
 #define OFFSET_BASE 2
 
-struct iterate_data {
-	off_t			id_base_offset;
-	int			id_index;
-	struct dfuse_obj_hdl	 *id_oh;
-};
-
-static int
-filler_cb(dfs_t *dfs, dfs_obj_t *dir, const char name[], void *arg)
-{
-	struct iterate_data		*idata = arg;
-	struct dfuse_readdir_entry	*dre;
-
-	dre = &idata->id_oh->doh_dre[idata->id_index];
-
-	DFUSE_TRA_DEBUG(idata->id_oh, "Adding at index %d offset %ld '%s'",
-			idata->id_index,
-			idata->id_base_offset + idata->id_index,
-			name);
-
-	strncpy(dre->dre_name, name, NAME_MAX);
-	dre->dre_offset = idata->id_base_offset + idata->id_index;
-	dre->dre_next_offset = idata->id_base_offset + idata->id_index + 1;
-	idata->id_index++;
-
-	return 0;
-}
-
 static int
 fetch_dir_entries(struct dfuse_obj_hdl *oh, off_t offset, int to_fetch,
-		  bool *eod)
+		  bool plus, bool *eod)
 {
-	struct iterate_data	idata = {};
+	struct dirent		*dirs;
+	struct stat		*stbufs;
+	dfs_obj_t		**objs;
 	uint32_t		count = to_fetch;
-	int			rc;
-
-	idata.id_base_offset = offset;
-	idata.id_oh = oh;
+	uint32_t		i;
+	int			rc = ENOMEM;
 
 	DFUSE_TRA_DEBUG(oh, "Fetching new entries at offset %ld", offset);
 
-	rc = dfs_iterate(oh->doh_dfs, oh->doh_obj, &oh->doh_anchor, &count,
-			 (NAME_MAX + 1) * count, filler_cb, &idata);
+	D_ALLOC_ARRAY(dirs, count);
+	D_ALLOC_ARRAY(stbufs, count);
+	D_ALLOC_ARRAY(objs, count);
+	if (dirs == NULL || stbufs == NULL || objs == NULL) {
+		count = 0;
+		goto out;
+	}
+
+	/* Read the entries along with their objects in one batch so they do
+	 * not need to be looked up one by one, the file sizes are only needed
+	 * for readdirplus.
+	 */
+	rc = dfs_readdirplus(oh->doh_dfs, oh->doh_obj, &oh->doh_anchor, &count,
+			     dirs, plus ? stbufs : NULL, objs);
+	if (rc != 0)
+		count = 0;
+
+	for (i = 0; i < count; i++) {
+		struct dfuse_readdir_entry *dre = &oh->doh_dre[i];
+
+		DFUSE_TRA_DEBUG(oh, "Adding at index %d offset %ld '%s'",
+				i, offset + i, dirs[i].d_name);
+
+		strncpy(dre->dre_name, dirs[i].d_name, NAME_MAX);
+		dre->dre_name[NAME_MAX] = '\0';
+		dre->dre_offset = offset + i;
+		dre->dre_next_offset = offset + i + 1;
+		dre->dre_stat = stbufs[i];
+		dre->dre_obj = objs[i];
+		dre->dre_plus = plus;
+		if (!plus)
+			dfs_get_mode(objs[i], &dre->dre_stat.st_mode);
+	}
 
+out:
 	oh->doh_anchor_index += count;
 	oh->doh_dre_index = 0;
 	oh->doh_dre_last_index = count;
@@ -80,6 +85,9 @@ fetch_dir_entries(struct dfuse_obj_hdl *oh, off_t offset, int to_fetch,
 		*eod = true;
 	}
 
+	D_FREE(dirs);
+	D_FREE(stbufs);
+	D_FREE(objs);
 	return rc;
 }
 
@@ -190,9 +198,26 @@ out:
 	return rc;
 }
 
+void
+dfuse_readdir_release(struct dfuse_obj_hdl *oh)
+{
+	uint32_t i;
+
+	if (oh->doh_dre == NULL)
+		return;
+
+	for (i = 0; i < READDIR_MAX_COUNT; i++) {
+		if (oh->doh_dre[i].dre_obj == NULL)
+			continue;
+		dfs_release(oh->doh_dre[i].dre_obj);
+		oh->doh_dre[i].dre_obj = NULL;
+	}
+}
+
 static inline void
 dfuse_readdir_reset(struct dfuse_obj_hdl *oh)
 {
+	dfuse_readdir_release(oh);
 	memset(&oh->doh_anchor, 0, sizeof(oh->doh_anchor));
 	memset(oh->doh_dre, 0, sizeof(*oh->doh_dre) * READDIR_MAX_COUNT);
 	oh->doh_dre_index = 0;
@@ -307,7 +332,8 @@ dfuse_cb_readdir(fuse_req_t req, struct dfuse_obj_hdl *oh,
 			else
 				to_fetch = READDIR_BASE_COUNT - added;
 
-			rc = fetch_dir_entries(oh, offset, to_fetch, &eod);
+			rc = fetch_dir_entries(oh, offset, to_fetch, plus,
+					       &eod);
 			if (rc != 0)
 				D_GOTO(out_reset, 0);
 
@@ -343,7 +369,32 @@ dfuse_cb_readdir(fuse_req_t req, struct dfuse_obj_hdl *oh,
 					dre->dre_next_offset,
 					dre->dre_name);
 
-			if (plus)
+			if (dre->dre_obj) {
+				obj = dre->dre_obj;
+				dre->dre_obj = NULL;
+				stbuf = dre->dre_stat;
+				rc = 0;
+				/* Read by readdir, stat it now */
+				if (plus && !dre->dre_plus) {
+					rc = dfs_ostat(oh->doh_dfs, obj,
+						       &stbuf);
+					if (rc != 0)
+						dfs_release(obj);
+				}
+				if (rc != 0) {
+					attr_len = 0;
+				} else if (plus && S_ISDIR(stbuf.st_mode)) {
+					rc = dfs_getxattr(oh->doh_dfs, obj,
+							  duns_xattr_name, out,
+							  &attr_len);
+					if (rc != 0) {
+						attr_len = 0;
+						rc = 0;
+					}
+				} else {
+					attr_len = 0;
+				}
+			} else if (plus)
 				rc = dfs_lookupx(oh->doh_dfs, oh->doh_obj,
 						 dre->dre_name,
 						 O_RDONLY | O_NOFOLLOW, &obj,
@@ -11,6 +11,7 @@ void
 dfuse_cb_setattr(fuse_req_t req, struct dfuse_inode_entry *ie,
 		 struct stat *attr, int to_set)
 {
+	struct dfuse_projection_info *fs_handle = fuse_req_userdata(req);
 	int dfs_flags = 0;
 	int rc;
 
@@ -85,6 +86,12 @@ dfuse_cb_setattr(fuse_req_t req, struct dfuse_inode_entry *ie,
 		D_GOTO(err, rc = ENOTSUP);
 	}
 
+	/* Write back cached data before changing the attributes, and drop
+	 * the cache if the size changes.  Write back errors are returned by
+	 * flush and fsync.
+	 */
+	dfuse_cache_flush(fs_handle, ie, dfs_flags & DFS_SET_ATTR_SIZE);
+
 	rc = dfs_osetattr(ie->ie_dfs->dfs_ns, ie->ie_obj, attr, dfs_flags);
 	if (rc)
 		D_GOTO(err, rc);
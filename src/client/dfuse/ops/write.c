@@ -29,6 +29,8 @@ dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv,
 	struct dfuse_event		*ev;
 	size_t				len = fuse_buf_size(bufv);
 	struct fuse_bufvec		ibuf = FUSE_BUFVEC_INIT(len);
+	struct dfuse_eq			*eqt = dfuse_eq_pick(fs_handle, ino);
+	size_t				chunk_size;
 
 	DFUSE_TRA_INFO(oh, "%#zx-%#zx requested flags %#x pid=%d",
 		       position, position + len - 1,
@@ -56,18 +58,6 @@ dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv,
 	if (rc != len)
 		D_GOTO(err, rc = EIO);
 
-	rc = daos_event_init(&ev->de_ev, fs_handle->dpi_eq, NULL);
-	if (rc != -DER_SUCCESS)
-		D_GOTO(err, rc = daos_der2errno(rc));
-
-	ev->de_req = req;
-	ev->de_len = len;
-	ev->de_complete_cb = dfuse_cb_write_complete;
-
-	ev->de_sgl.sg_nr = 1;
-	d_iov_set(&ev->de_iov, ibuf.buf[0].mem, len);
-	ev->de_sgl.sg_iovs = &ev->de_iov;
-
 	/* Check for potentially using readahead on this file, ie_truncated
 	 * will only be set if caching is enabled so only check for the one
 	 * flag rather than two here
@@ -85,6 +75,39 @@ dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv,
 		}
 	}
 
+	/* Merge into the chunk cache and reply straight away, the data is
+	 * written back later, otherwise make sure any cached data for the
+	 * file is written back and dropped before writing directly.
+	 */
+	chunk_size = dfuse_cache_chunk_size(fs_handle, oh);
+	if (chunk_size != 0) {
+		rc = dfuse_cache_write(fs_handle, oh, chunk_size,
+				       ibuf.buf[0].mem, len, position);
+		if (rc != 0)
+			D_GOTO(err, rc);
+
+		DFUSE_REPLY_WRITE(oh, req, len);
+		D_FREE(ibuf.buf[0].mem);
+		D_FREE(ev);
+		return;
+	}
+
+	rc = dfuse_cache_flush(fs_handle, oh->doh_ie, true);
+	if (rc != 0)
+		D_GOTO(err, rc);
+
+	rc = daos_event_init(&ev->de_ev, eqt->deq_eq, NULL);
+	if (rc != -DER_SUCCESS)
+		D_GOTO(err, rc = daos_der2errno(rc));
+
+	ev->de_req = req;
+	ev->de_len = len;
+	ev->de_complete_cb = dfuse_cb_write_complete;
+
+	ev->de_sgl.sg_nr = 1;
+	d_iov_set(&ev->de_iov, ibuf.buf[0].mem, len);
+	ev->de_sgl.sg_iovs = &ev->de_iov;
+
 	rc = dfs_write(oh->doh_dfs, oh->doh_obj, &ev->de_sgl,
 		       position, &ev->de_ev);
 	if (rc != 0)
@@ -92,7 +115,7 @@ dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv,
 
 	/* Send a message to the async thread to wake it up and poll for events
 	 */
-	sem_post(&fs_handle->dpi_sem);
+	sem_post(&eqt->deq_sem);
 	return;
 
 err:
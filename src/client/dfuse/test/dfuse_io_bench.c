@@ -0,0 +1,273 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * I/O benchmark of a dfuse mount, it runs random preads or pwrites of a
+ * fixed size from an increasing number of threads, each on its own file,
+ * and reports the IOPS for every thread count so the scaling of the dfuse
+ * progress threads can be observed.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+static char	*db_dir;
+static size_t	 db_bsize = 4096;
+static size_t	 db_fsize = 64 << 20;		/* 64MB */
+static int	 db_threads = 16;
+static int	 db_secs = 5;
+static bool	 db_write;
+
+struct db_thread {
+	pthread_t	 dt_id;
+	int		 dt_idx;
+	int		 dt_fd;
+	uint64_t	 dt_ops;
+	int		 dt_rc;
+};
+
+static volatile bool	 db_stop;
+static pthread_barrier_t db_barrier;
+
+static uint64_t
+db_now_ns(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int
+db_file_open(int idx)
+{
+	char	 path[PATH_MAX];
+	char	*buf;
+	size_t	 off;
+	ssize_t	 rc;
+	int	 fd;
+
+	snprintf(path, sizeof(path), "%s/dfuse_io_bench.%d", db_dir, idx);
+	fd = open(path, O_RDWR | O_CREAT, 0600);
+	if (fd < 0) {
+		fprintf(stderr, "Failed to open %s: %d\n", path, errno);
+		return -1;
+	}
+
+	/* Fill the file so reads are served from real extents */
+	buf = calloc(1, 1 << 20);
+	if (buf == NULL) {
+		close(fd);
+		return -1;
+	}
+	for (off = 0; off < db_fsize; off += 1 << 20) {
+		rc = pwrite(fd, buf, 1 << 20, off);
+		if (rc != 1 << 20) {
+			fprintf(stderr, "Failed to fill %s: %d\n", path, errno);
+			close(fd);
+			fd = -1;
+			break;
+		}
+	}
+	free(buf);
+	return fd;
+}
+
+static void *
+db_thread_run(void *arg)
+{
+	struct db_thread	*dt = arg;
+	unsigned int		 seed = dt->dt_idx;
+	uint64_t		 nr_blks = db_fsize / db_bsize;
+	char			*buf;
+	off_t			 off;
+	ssize_t			 rc;
+
+	buf = malloc(db_bsize);
+	if (buf == NULL) {
+		dt->dt_rc = ENOMEM;
+		pthread_barrier_wait(&db_barrier);
+		return NULL;
+	}
+	memset(buf, dt->dt_idx, db_bsize);
+
+	pthread_barrier_wait(&db_barrier);
+	while (!db_stop) {
+		off = (rand_r(&seed) % nr_blks) * db_bsize;
+		if (db_write)
+			rc = pwrite(dt->dt_fd, buf, db_bsize, off);
+		else
+			rc = pread(dt->dt_fd, buf, db_bsize, off);
+		if (rc != (ssize_t)db_bsize) {
+			dt->dt_rc = rc < 0 ? errno : EIO;
+			break;
+		}
+		dt->dt_ops++;
+	}
+
+	free(buf);
+	return NULL;
+}
+
+static int
+db_run(struct db_thread *threads, int nr)
+{
+	uint64_t	then, ops = 0;
+	double		secs;
+	int		i, rc = 0;
+
+	db_stop = false;
+	pthread_barrier_init(&db_barrier, NULL, nr + 1);
+	for (i = 0; i < nr; i++) {
+		threads[i].dt_ops = 0;
+		threads[i].dt_rc = 0;
+		rc = pthread_create(&threads[i].dt_id, NULL, db_thread_run,
+				    &threads[i]);
+		if (rc != 0) {
+			fprintf(stderr, "Failed to create thread: %d\n", rc);
+			exit(1);
+		}
+	}
+
+	pthread_barrier_wait(&db_barrier);
+	then = db_now_ns();
+	sleep(db_secs);
+	db_stop = true;
+
+	for (i = 0; i < nr; i++) {
+		pthread_join(threads[i].dt_id, NULL);
+		ops += threads[i].dt_ops;
+		if (threads[i].dt_rc != 0)
+			rc = threads[i].dt_rc;
+	}
+	secs = (db_now_ns() - then) / 1e9;
+	pthread_barrier_destroy(&db_barrier);
+
+	if (rc != 0) {
+		fprintf(stderr, "I/O failed: %d\n", rc);
+		return rc;
+	}
+
+	printf("%8d %12.0f %10.2f\n", nr, ops / secs,
+	       ops * db_bsize / secs / (1 << 20));
+	return 0;
+}
+
+static void
+print_usage(const char *prog)
+{
+	printf("Usage: %s -d <dir> [OPTIONS]\n"
+	       "  -d, --dir <path>     Directory in a dfuse mount\n"
+	       "  -t, --threads <n>    Max number of threads (default %d)\n"
+	       "  -b, --bsize <bytes>  I/O size (default %zu)\n"
+	       "  -f, --fsize <MB>     File size per thread (default %zu)\n"
+	       "  -s, --secs <n>       Seconds per thread count (default %d)\n"
+	       "  -w, --write          Run pwrite rather than pread\n",
+	       prog, db_threads, db_bsize, db_fsize >> 20, db_secs);
+}
+
+int
+main(int argc, char **argv)
+{
+	static struct option	long_ops[] = {
+		{ "dir",	required_argument,	NULL,	'd' },
+		{ "threads",	required_argument,	NULL,	't' },
+		{ "bsize",	required_argument,	NULL,	'b' },
+		{ "fsize",	required_argument,	NULL,	'f' },
+		{ "secs",	required_argument,	NULL,	's' },
+		{ "write",	no_argument,		NULL,	'w' },
+		{ "help",	no_argument,		NULL,	'h' },
+		{ NULL,		0,			NULL,	0   },
+	};
+	struct db_thread	*threads;
+	char			 path[PATH_MAX];
+	int			 opt;
+	int			 nr;
+	int			 i;
+	int			 rc = 0;
+
+	while ((opt = getopt_long(argc, argv, "d:t:b:f:s:wh", long_ops,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'd':
+			db_dir = optarg;
+			break;
+		case 't':
+			db_threads = atoi(optarg);
+			break;
+		case 'b':
+			db_bsize = strtoull(optarg, NULL, 0);
+			break;
+		case 'f':
+			db_fsize = strtoull(optarg, NULL, 0) << 20;
+			break;
+		case 's':
+			db_secs = atoi(optarg);
+			break;
+		case 'w':
+			db_write = true;
+			break;
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (db_dir == NULL || db_threads <= 0 || db_bsize == 0 ||
+	    db_fsize < db_bsize || db_secs <= 0) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	threads = calloc(db_threads, sizeof(*threads));
+	if (threads == NULL)
+		return -1;
+
+	for (i = 0; i < db_threads; i++)
+		threads[i].dt_fd = -1;
+
+	for (i = 0; i < db_threads; i++) {
+		threads[i].dt_idx = i;
+		threads[i].dt_fd = db_file_open(i);
+		if (threads[i].dt_fd < 0) {
+			rc = -1;
+			goto out;
+		}
+	}
+
+	printf("dfuse %s benchmark, bsize=%zu, fsize=%zuMB, secs=%d\n",
+	       db_write ? "pwrite" : "pread", db_bsize, db_fsize >> 20,
+	       db_secs);
+	printf("%8s %12s %10s\n", "threads", "IOPS", "MB/s");
+	for (nr = 1; nr < db_threads; nr *= 2) {
+		rc = db_run(threads, nr);
+		if (rc != 0)
+			goto out;
+	}
+	/* Always finish with the max thread count */
+	rc = db_run(threads, db_threads);
+
+out:
+	for (i = 0; i < db_threads; i++) {
+		if (threads[i].dt_fd < 0)
+			continue;
+		close(threads[i].dt_fd);
+		snprintf(path, sizeof(path), "%s/dfuse_io_bench.%d", db_dir, i);
+		unlink(path);
+	}
+	free(threads);
+	return rc;
+}
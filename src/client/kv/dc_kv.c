@@ -635,3 +635,259 @@ err_task:
 		kv_decref(kv);
 	return rc;
 }
+
+/** Max number of I/O tasks in flight for a multi key operation */
+#define KV_MULTI_INFLIGHT	64
+
+/** State of a multi key operation, freed when the upper task completes */
+struct kv_multi {
+	tse_task_t		*km_task;
+	daos_opc_t		 km_opc;
+	daos_handle_t		 km_oh;
+	daos_handle_t		 km_th;
+	uint64_t		 km_flags;
+	unsigned int		 km_nr;
+	/** Index of the next key to launch */
+	unsigned int		 km_next;
+	/** First error, no more keys are launched once set */
+	int			 km_rc;
+	const char *const	*km_keys;
+	daos_size_t		*km_sizes;
+	void *const		*km_bufs;
+	struct io_params	 km_params[0];
+};
+
+static int kv_multi_launch(struct kv_multi *km);
+
+/* Launch the next key in place of the completed one */
+static int
+kv_multi_refill_cb(tse_task_t *io_task, void *data)
+{
+	struct kv_multi	*km = *((struct kv_multi **)data);
+	int		 rc;
+
+	if (km->km_rc == 0)
+		km->km_rc = io_task->dt_result;
+	if (km->km_rc != 0 || km->km_next == km->km_nr)
+		return 0;
+
+	rc = kv_multi_launch(km);
+	if (rc != 0)
+		km->km_rc = rc;
+	return 0;
+}
+
+/* Report the error of a key that could not be launched, then free */
+static int
+kv_multi_free_cb(tse_task_t *task, void *data)
+{
+	struct kv_multi	*km = *((struct kv_multi **)data);
+	int		 rc = km->km_rc;
+
+	D_FREE(km);
+	return rc;
+}
+
+/* Create and schedule the I/O task of the next key, a dependency of the upper
+ * task. On failure, the error is reported through the upper task.
+ */
+static int
+kv_multi_launch(struct kv_multi *km)
+{
+	unsigned int		 i = km->km_next++;
+	struct io_params	*p = &km->km_params[i];
+	void			*buf = km->km_bufs ? km->km_bufs[i] : NULL;
+	tse_task_t		*io_task;
+	int			 rc;
+
+	/** init dkey */
+	d_iov_set(&p->dkey, (void *)km->km_keys[i], strlen(km->km_keys[i]));
+
+	rc = daos_task_create(km->km_opc, tse_task2sched(km->km_task), 0, NULL,
+			      &io_task);
+	if (rc != 0)
+		return rc;
+
+	if (km->km_opc == DAOS_OPC_OBJ_PUNCH_DKEYS) {
+		daos_obj_punch_t *punch_args;
+
+		punch_args = daos_task_get_args(io_task);
+		punch_args->oh		= km->km_oh;
+		punch_args->th		= km->km_th;
+		punch_args->flags	= km->km_flags;
+		punch_args->dkey	= &p->dkey;
+		punch_args->akeys	= NULL;
+		punch_args->akey_nr	= 0;
+	} else {
+		daos_obj_rw_t	*rw_args;
+
+		/** init iod. */
+		p->akey_val = '0';
+		d_iov_set(&p->iod.iod_name, &p->akey_val, 1);
+		p->iod.iod_nr	= 1;
+		p->iod.iod_recxs = NULL;
+		p->iod.iod_size	= km->km_sizes[i];
+		p->iod.iod_type	= DAOS_IOD_SINGLE;
+
+		/** init sgl */
+		if (buf && km->km_sizes[i]) {
+			d_iov_set(&p->iov, buf, km->km_sizes[i]);
+			p->sgl.sg_iovs = &p->iov;
+			p->sgl.sg_nr = 1;
+		}
+
+		rw_args = daos_task_get_args(io_task);
+		rw_args->oh	= km->km_oh;
+		rw_args->th	= km->km_th;
+		rw_args->flags	= km->km_flags;
+		rw_args->dkey	= &p->dkey;
+		rw_args->nr	= 1;
+		rw_args->iods	= &p->iod;
+		if (buf && km->km_sizes[i])
+			rw_args->sgls = &p->sgl;
+
+		if (km->km_opc == DAOS_OPC_OBJ_FETCH) {
+			daos_size_t *buf_size = &km->km_sizes[i];
+
+			rc = tse_task_register_comp_cb(io_task, set_size_cb,
+						       &buf_size,
+						       sizeof(buf_size));
+			if (rc != 0)
+				D_GOTO(err_iotask, rc);
+		}
+	}
+
+	rc = tse_task_register_deps(km->km_task, 1, &io_task);
+	if (rc != 0)
+		D_GOTO(err_iotask, rc);
+
+	/* Registered last so that it only runs for a scheduled task */
+	rc = tse_task_register_comp_cb(io_task, kv_multi_refill_cb, &km,
+				       sizeof(km));
+	if (rc != 0)
+		D_GOTO(err_iotask, rc);
+
+	rc = tse_task_schedule(io_task, false);
+	if (rc != 0)
+		D_GOTO(err_iotask, rc);
+
+	return 0;
+
+err_iotask:
+	tse_task_complete(io_task, rc);
+	return rc;
+}
+
+/**
+ * Issue one object update, fetch or dkey punch per key of a multi key
+ * operation. Up to KV_MULTI_INFLIGHT I/O tasks are in flight, so that the
+ * RPCs for the different keys, and the shards they map to, are sent
+ * concurrently. The completion of each one launches the next key, and the
+ * upper task completes when the last one does, with the first error if any.
+ */
+static int
+kv_multi_io(tse_task_t *task, daos_opc_t opc, daos_handle_t oh,
+	    daos_handle_t th, uint64_t flags, unsigned int nr,
+	    const char *const keys[], daos_size_t *sizes, void *const bufs[])
+{
+	struct dc_kv		*kv = NULL;
+	struct kv_multi		*km = NULL;
+	unsigned int		i;
+	int			rc;
+
+	if (nr == 0 || keys == NULL)
+		D_GOTO(err_task, rc = -DER_INVAL);
+	if (opc != DAOS_OPC_OBJ_PUNCH_DKEYS && sizes == NULL) {
+		D_ERROR("Buffer size array is NULL\n");
+		D_GOTO(err_task, rc = -DER_INVAL);
+	}
+	if (opc == DAOS_OPC_OBJ_UPDATE && bufs == NULL)
+		D_GOTO(err_task, rc = -DER_INVAL);
+
+	/* Checked up front since the keys are launched over time */
+	for (i = 0; i < nr; i++) {
+		if (keys[i] == NULL)
+			D_GOTO(err_task, rc = -DER_INVAL);
+		if (opc == DAOS_OPC_OBJ_UPDATE &&
+		    (bufs[i] == NULL || sizes[i] == 0))
+			D_GOTO(err_task, rc = -DER_INVAL);
+	}
+
+	kv = kv_hdl2ptr(oh);
+	if (kv == NULL)
+		D_GOTO(err_task, rc = -DER_NO_HDL);
+
+	D_ALLOC(km, sizeof(*km) + sizeof(km->km_params[0]) * nr);
+	if (km == NULL)
+		D_GOTO(err_task, rc = -DER_NOMEM);
+
+	km->km_task	= task;
+	km->km_opc	= opc;
+	km->km_oh	= kv->daos_oh;
+	km->km_th	= th;
+	km->km_flags	= flags;
+	km->km_nr	= nr;
+	km->km_keys	= keys;
+	km->km_sizes	= sizes;
+	km->km_bufs	= bufs;
+
+	rc = tse_task_register_comp_cb(task, kv_multi_free_cb, &km,
+				       sizeof(km));
+	if (rc != 0) {
+		D_FREE(km);
+		D_GOTO(err_task, rc);
+	}
+
+	for (i = 0; i < min(nr, KV_MULTI_INFLIGHT); i++) {
+		rc = kv_multi_launch(km);
+		if (rc == 0)
+			continue;
+
+		/* Nothing in flight, complete with the error */
+		if (i == 0)
+			D_GOTO(err_task, rc);
+		/* Reported once the keys in flight complete */
+		km->km_rc = rc;
+		break;
+	}
+
+	tse_sched_progress(tse_task2sched(task));
+	kv_decref(kv);
+	return 0;
+
+err_task:
+	tse_task_complete(task, rc);
+	if (kv)
+		kv_decref(kv);
+	return rc;
+}
+
+int
+dc_kv_put_multi(tse_task_t *task)
+{
+	daos_kv_put_multi_t	*args = daos_task_get_args(task);
+
+	return kv_multi_io(task, DAOS_OPC_OBJ_UPDATE, args->oh, args->th,
+			   args->flags, args->nr, args->keys,
+			   (daos_size_t *)args->buf_sizes,
+			   (void *const *)args->bufs);
+}
+
+int
+dc_kv_get_multi(tse_task_t *task)
+{
+	daos_kv_get_multi_t	*args = daos_task_get_args(task);
+
+	return kv_multi_io(task, DAOS_OPC_OBJ_FETCH, args->oh, args->th,
+			   args->flags, args->nr, args->keys, args->buf_sizes,
+			   args->bufs);
+}
+
+int
+dc_kv_remove_multi(tse_task_t *task)
+{
+	daos_kv_remove_multi_t	*args = daos_task_get_args(task);
+
+	return kv_multi_io(task, DAOS_OPC_OBJ_PUNCH_DKEYS, args->oh, args->th,
+			   args->flags, args->nr, args->keys, NULL, NULL);
+}
@@ -15,6 +15,9 @@
 #include <daos_errno.h>
 #include <daos/btree.h>
 #include <daos/dtx.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 /**
  * Tree node types.
@@ -116,6 +119,11 @@ struct btr_context {
 	 * while draining the tree
 	 */
 	int				 tc_creds_on:1;
+	/**
+	 * bulk upsert is in progress, see dbtree_upsert_bulk, the leaf
+	 * \a tcx::tc_bulk_node has been added to the transaction.
+	 */
+	int				 tc_bulk_on:1;
 	/**
 	 * returned value of the probe, it should be reset after upsert
 	 * or delete because the probe path could have been changed.
@@ -127,6 +135,8 @@ struct btr_context {
 	int				 tc_class;
 	/** cached feature bits, avoid loading from slow memory */
 	uint64_t			 tc_feats;
+	/** the last leaf node added to transaction by bulk upsert */
+	umem_off_t			 tc_bulk_node;
 	/** trace for the tree root */
 	struct btr_trace		*tc_trace;
 	/** trace buffer */
@@ -181,6 +191,17 @@ btr_is_int_key(struct btr_context *tcx)
 	return BTR_IS_UINT_KEY(tcx->tc_feats);
 }
 
+#define BTR_IS_KEY_SCAN(feats)					\
+	(((feats) & (BTR_FEAT_KEY_SCAN | BTR_FEAT_UINT_KEY |	\
+		     BTR_FEAT_DIRECT_KEY)) ==			\
+	 (BTR_FEAT_KEY_SCAN | BTR_FEAT_UINT_KEY))
+
+static bool
+btr_is_key_scan(struct btr_context *tcx)
+{
+	return BTR_IS_KEY_SCAN(tcx->tc_feats);
+}
+
 static bool
 btr_has_collision(struct btr_context *tcx)
 {
@@ -299,7 +320,9 @@ btr_context_create(umem_off_t root_off, struct btr_root *root,
 
 	} else {
 		tcx->tc_class		= root->tr_class;
-		tcx->tc_feats		= root->tr_feats;
+		/* KEY_SCAN is not stored in root, take it from the class */
+		tcx->tc_feats		= root->tr_feats |
+					  (tree_feats & BTR_FEAT_KEY_SCAN);
 		tcx->tc_order		= root->tr_order;
 		depth			= root->tr_depth;
 		D_DEBUG(DB_TRACE, "Load tree context from "DF_X64"\n",
@@ -628,7 +651,18 @@ btr_node_free(struct btr_context *tcx, umem_off_t nd_off)
 static int
 btr_node_tx_add(struct btr_context *tcx, umem_off_t nd_off)
 {
-	return umem_tx_add(btr_umm(tcx), nd_off, btr_node_size(tcx));
+	int	rc;
+
+	/* bulk upsert modifies the same leaf many times in one transaction,
+	 * only add it to the transaction for the first time.
+	 */
+	if (tcx->tc_bulk_on && tcx->tc_bulk_node == nd_off)
+		return 0;
+
+	rc = umem_tx_add(btr_umm(tcx), nd_off, btr_node_size(tcx));
+	if (rc == 0 && tcx->tc_bulk_on)
+		tcx->tc_bulk_node = nd_off;
+	return rc;
 }
 
 /* helper functions */
@@ -772,7 +806,7 @@ btr_root_init(struct btr_context *tcx, struct btr_root *root, bool in_place)
 	if (in_place)
 		memset(root, 0, sizeof(*root));
 	root->tr_class		= tcx->tc_class;
-	root->tr_feats		= tcx->tc_feats;
+	root->tr_feats		= tcx->tc_feats & ~BTR_FEAT_KEY_SCAN;
 	root->tr_order		= tcx->tc_order;
 	if (tcx->tc_feats & BTR_FEAT_DYNAMIC_ROOT)
 		root->tr_node_size	= 1;
@@ -1305,6 +1339,110 @@ btr_cmp(struct btr_context *tcx, umem_off_t nd_off,
 	return cmp;
 }
 
+/** offset of the integer key within a record of a BTR_FEAT_UINT_KEY tree */
+#define BTR_UKEY_OFF		offsetof(struct btr_record, rec_ukey)
+/** size of a record of a BTR_FEAT_UINT_KEY tree */
+#define BTR_UKEY_REC_SIZE	(sizeof(struct btr_record) + sizeof(uint64_t))
+
+static inline uint64_t
+btr_ukey_at(const char *recs, int at)
+{
+	return *(const uint64_t *)&recs[at * BTR_UKEY_REC_SIZE + BTR_UKEY_OFF];
+}
+
+/**
+ * Return the number of keys in the sorted records \a recs which are less than
+ * \a key, which is also the index of the first key that is greater than or
+ * equal to \a key.
+ */
+static int
+btr_ukey_scan_scalar(const char *recs, int keyn, uint64_t key)
+{
+	int	at;
+
+	for (at = 0; at < keyn && btr_ukey_at(recs, at) < key; at++)
+		;
+	return at;
+}
+
+#if defined(__x86_64__)
+/**
+ * AVX2 version of btr_ukey_scan_scalar, it compares four keys at a time.
+ *
+ * Records are stored as {rec_off, rec_ukey} pairs, so the keys of four
+ * records can be extracted from two 256-bit loads with one unpack. AVX2 only
+ * provides signed 64-bit comparison, both sides are biased by the sign bit to
+ * compare them as unsigned integers.
+ */
+__attribute__((target("avx2")))
+static int
+btr_ukey_scan_avx2(const char *recs, int keyn, uint64_t key)
+{
+	const __m256i	sign = _mm256_set1_epi64x(INT64_MIN);
+	const __m256i	target = _mm256_xor_si256(_mm256_set1_epi64x(key),
+						  sign);
+	__m256i		lo;
+	__m256i		hi;
+	__m256i		keys;
+	int		mask;
+	int		at;
+
+	D_CASSERT(BTR_UKEY_REC_SIZE == 16 && BTR_UKEY_OFF == 8);
+	for (at = 0; at + 4 <= keyn; at += 4) {
+		lo = _mm256_loadu_si256((const __m256i *)
+					&recs[at * BTR_UKEY_REC_SIZE]);
+		hi = _mm256_loadu_si256((const __m256i *)
+					&recs[(at + 2) * BTR_UKEY_REC_SIZE]);
+		keys = _mm256_xor_si256(_mm256_unpackhi_epi64(lo, hi), sign);
+		mask = _mm256_movemask_pd(_mm256_castsi256_pd(
+					  _mm256_cmpgt_epi64(target, keys)));
+		if (mask != 0xf)
+			return at + __builtin_popcount(mask);
+	}
+	return at + btr_ukey_scan_scalar(&recs[at * BTR_UKEY_REC_SIZE],
+					 keyn - at, key);
+}
+#endif
+
+static int (*btr_ukey_scan)(const char *recs, int keyn, uint64_t key) =
+	btr_ukey_scan_scalar;
+
+/** Choose the best key scan function for the running CPU */
+static void
+btr_ukey_scan_init(void)
+{
+#if defined(__x86_64__)
+	if (__builtin_cpu_supports("avx2"))
+		btr_ukey_scan = btr_ukey_scan_avx2;
+#endif
+}
+
+/**
+ * Search integer key \a key within node \a nd_off without key callbacks, see
+ * BTR_FEAT_KEY_SCAN. It returns the same position and comparison result as
+ * the binary search in btr_probe, which can be consumed by the same code.
+ */
+static int
+btr_node_scan_ukey(struct btr_context *tcx, umem_off_t nd_off, uint64_t key,
+		   int *cmp)
+{
+	struct btr_node	*nd = btr_off2ptr(tcx, nd_off);
+	const char	*recs = (char *)btr_node_rec_at(tcx, nd_off, 0);
+	int		 at;
+
+	D_ASSERT(nd->tn_keyn > 0);
+	at = btr_ukey_scan(recs, nd->tn_keyn, key);
+	if (at == nd->tn_keyn) {
+		*cmp = BTR_CMP_LT;
+		at--;
+	} else {
+		*cmp = btr_ukey_at(recs, at) == key ? BTR_CMP_EQ : BTR_CMP_GT;
+	}
+
+	D_DEBUG(DB_TRACE, "scanned record at %d, cmp %d\n", at, *cmp);
+	return at;
+}
+
 bool
 btr_probe_valid(dbtree_probe_opc_t opc)
 {
@@ -1318,13 +1456,16 @@ btr_probe_valid(dbtree_probe_opc_t opc)
 
 /**
  * Try to find \a key within a btree, it will store the searching path in
- * tcx::tc_traces.
+ * tcx::tc_traces. If \a from_leaf is true, the search starts from the leaf
+ * of the current path instead of the root, the caller should guarantee that
+ * the leaf covers \a key.
  *
  * \return	see btr_probe_rc
  */
 static enum btr_probe_rc
-btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
-	  uint32_t intent, d_iov_t *key, char hkey[DAOS_HKEY_MAX])
+btr_probe_internal(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
+		   uint32_t intent, d_iov_t *key, char hkey[DAOS_HKEY_MAX],
+		   bool from_leaf)
 {
 	int			 start;
 	int			 end;
@@ -1343,6 +1484,15 @@ btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 		goto out;
 	}
 
+	if (from_leaf) {
+		/* reuse the path of the previous probe, only search the
+		 * leaf node, see btr_leaf_covers.
+		 */
+		level = tcx->tc_depth - 1;
+		nd_off = tcx->tc_trace[level].tr_node;
+		goto search;
+	}
+
 	memset(&tcx->tc_traces[0], 0,
 	       sizeof(tcx->tc_traces[0]) * BTR_TRACE_MAX);
 
@@ -1359,8 +1509,9 @@ btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 	}
 
 	nd_off = tcx->tc_tins.ti_root->tr_node;
-
-	for (start = end = 0, level = 0, next_level = true ;;) {
+	level = 0;
+search:
+	for (start = end = 0, next_level = true ;;) {
 		if (next_level) { /* search a new level of the tree */
 			next_level = false;
 			start	= 0;
@@ -1379,6 +1530,11 @@ btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 		} else if (probe_opc == BTR_PROBE_LAST) {
 			at = start = end;
 			cmp = BTR_CMP_LT;
+		} else if (btr_is_key_scan(tcx)) {
+			D_ASSERT(probe_opc & BTR_PROBE_SPEC);
+			at = btr_node_scan_ukey(tcx, nd_off,
+						*(uint64_t *)hkey, &cmp);
+			start = end = at;
 		} else {
 			D_ASSERT(probe_opc & BTR_PROBE_SPEC);
 			/* binary search */
@@ -1582,6 +1738,19 @@ again:
 	return rc;
 }
 
+/**
+ * Try to find \a key within a btree, it will store the searching path in
+ * tcx::tc_traces.
+ *
+ * \return	see btr_probe_rc
+ */
+static enum btr_probe_rc
+btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
+	  uint32_t intent, d_iov_t *key, char hkey[DAOS_HKEY_MAX])
+{
+	return btr_probe_internal(tcx, probe_opc, intent, key, hkey, false);
+}
+
 static enum btr_probe_rc
 btr_probe_key(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 	      uint32_t intent, d_iov_t *key)
@@ -1592,6 +1761,45 @@ btr_probe_key(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 	return btr_probe(tcx, probe_opc, intent, key, hkey);
 }
 
+/**
+ * Check whether \a key belongs to the leaf of the current path, so a probe
+ * can start from this leaf. Key of the leaf should be in the range of its
+ * first key and last key, or it is larger than the first key of the
+ * right-most leaf.
+ */
+static bool
+btr_leaf_covers(struct btr_context *tcx, d_iov_t *key, char *hkey)
+{
+	struct btr_trace	*trace;
+	struct btr_node		*nd;
+	int			 level;
+	int			 cmp;
+
+	level = tcx->tc_depth - 1;
+	trace = &tcx->tc_trace[level];
+	nd = btr_off2ptr(tcx, trace->tr_node);
+	if (nd->tn_keyn == 0)
+		return false;
+
+	cmp = btr_cmp(tcx, trace->tr_node, 0, hkey, key);
+	if (cmp == BTR_CMP_ERR || (cmp & BTR_CMP_GT))
+		return false;
+
+	cmp = btr_cmp(tcx, trace->tr_node, nd->tn_keyn - 1, hkey, key);
+	if (cmp == BTR_CMP_ERR)
+		return false;
+	if (!(cmp & BTR_CMP_LT))
+		return true;
+
+	for (level--; level >= 0; level--) {
+		trace = &tcx->tc_trace[level];
+		nd = btr_off2ptr(tcx, trace->tr_node);
+		if (trace->tr_at != nd->tn_keyn)
+			return false;
+	}
+	return true;
+}
+
 static bool
 btr_probe_next(struct btr_context *tcx)
 {
@@ -2009,6 +2217,311 @@ dbtree_upsert(daos_handle_t toh, dbtree_probe_opc_t opc, uint32_t intent,
 	return btr_tx_end(tcx, rc);
 }
 
+/** default fill factor (percentage) of nodes created by bulk load */
+#define BTR_BULK_FILL_DEF	90
+
+/** node of the tree being built by bulk load */
+struct btr_bulk_node {
+	/** the node */
+	umem_off_t	bn_off;
+	/** the left-most leaf under the node, it has the first key */
+	umem_off_t	bn_leaf;
+};
+
+/**
+ * Number of nodes to group \a nr children (records for leaves) into, with
+ * at most \a fanout and at least \a min children in each node.
+ */
+static int
+btr_bulk_groups(int nr, int fanout, int min)
+{
+	int	groups = (nr + fanout - 1) / fanout;
+
+	if (groups > nr / min)
+		groups = MAX(nr / min, 1);
+	return groups;
+}
+
+/** Release the nodes (and records) of a failed bulk load for vmem */
+static void
+btr_bulk_cleanup(struct btr_context *tcx, struct btr_bulk_node *bn,
+		 int start, int end)
+{
+	int	i;
+
+	if (btr_has_tx(tcx))
+		return; /* transaction abort will release them */
+
+	for (i = start; i < end; i++)
+		btr_node_destroy(tcx, bn[i].bn_off, NULL, NULL);
+}
+
+/**
+ * Bottom-up build of an empty tree from the sorted \a keys and \a vals, each
+ * node is filled to \a fill percent of the tree order. None of the new nodes
+ * needs to be added to the transaction, only the root is modified in place.
+ */
+static int
+btr_bulk_load(struct btr_context *tcx, d_iov_t *keys, d_iov_t *vals,
+	      unsigned int nr, unsigned int fill)
+{
+	struct btr_root		*root = tcx->tc_tins.ti_root;
+	uint8_t			 node_size = root->tr_node_size;
+	struct btr_bulk_node	*bn;
+	struct btr_record	*rec;
+	struct btr_record	*prev = NULL;
+	struct btr_node		*nd;
+	union btr_rec_buf	 rec_buf;
+	umem_off_t		 nd_off;
+	int			 fanout;
+	int			 count;
+	int			 groups;
+	int			 leaves = 0;
+	int			 depth;
+	int			 cnt;
+	int			 cmp;
+	int			 at;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	D_ASSERT(root != NULL && UMOFF_IS_NULL(root->tr_node));
+
+	/* leaf can have (order - 1) records, non-leaf has one more child */
+	fanout = MAX((tcx->tc_order - 1) * fill / 100, 1);
+	groups = btr_bulk_groups(nr, fanout, 1);
+
+	D_ALLOC_ARRAY(bn, groups);
+	if (bn == NULL)
+		return -DER_NOMEM;
+
+	if (btr_has_tx(tcx)) {
+		rc = btr_root_tx_add(tcx);
+		if (rc != 0)
+			goto out;
+	}
+
+	if (groups > 1) {
+		root->tr_node_size = tcx->tc_order;
+	} else {
+		/* single leaf which is the root, grow the dynamic root as
+		 * btr_root_resize does until it can hold all records.
+		 */
+		while (root->tr_node_size <= nr &&
+		       root->tr_node_size < tcx->tc_order)
+			root->tr_node_size = MIN(root->tr_node_size * 2 + 1,
+						 tcx->tc_order);
+	}
+
+	D_DEBUG(DB_TRACE, "Bulk load %u records into %d leaves\n", nr, groups);
+	for (i = j = at = 0; i < nr; i++) {
+		if (at == 0) {
+			rc = btr_node_alloc(tcx, &bn[j].bn_off);
+			if (rc != 0)
+				goto failed_leaf;
+			leaves++;
+
+			btr_node_set(tcx, bn[j].bn_off, BTR_NODE_LEAF);
+			bn[j].bn_leaf = bn[j].bn_off;
+			nd = btr_off2ptr(tcx, bn[j].bn_off);
+		}
+
+		memset(&rec_buf, 0, sizeof(rec_buf));
+		rec = &rec_buf.rb_rec;
+		btr_hkey_gen(tcx, &keys[i], &rec->rec_hkey[0]);
+		if (prev != NULL) {
+			if (btr_is_direct_key(tcx))
+				cmp = btr_key_cmp(tcx, prev, &keys[i]);
+			else
+				cmp = btr_hkey_cmp(tcx, prev,
+						   &rec->rec_hkey[0]);
+			if (cmp != BTR_CMP_LT) {
+				D_ERROR("Keys of bulk load are not sorted or "
+					"unique, record %d, cmp %d\n", i, cmp);
+				rc = -DER_INVAL;
+				goto failed_leaf;
+			}
+		}
+
+		rc = btr_rec_alloc(tcx, &keys[i], &vals[i], rec);
+		if (rc != 0)
+			goto failed_leaf;
+
+		prev = btr_node_rec_at(tcx, bn[j].bn_off, at);
+		btr_rec_copy(tcx, prev, rec, 1);
+		nd->tn_keyn++;
+
+		if (++at == nr / groups + (j < nr % groups)) {
+			at = 0;
+			j++;
+		}
+	}
+	D_ASSERT(j == groups);
+
+	/* build non-leaf levels, nodes of the new level replace their
+	 * children in \a bn, it is safe because a node never has less than
+	 * one child.
+	 */
+	fanout = MAX(tcx->tc_order * fill / 100, 2);
+	for (count = groups, depth = 1; count > 1; count = groups, depth++) {
+		groups = btr_bulk_groups(count, fanout, 2);
+		for (i = j = 0; i < groups; i++) {
+			cnt = count / groups + (i < count % groups);
+			rc = btr_node_alloc(tcx, &nd_off);
+			if (rc != 0) {
+				btr_bulk_cleanup(tcx, bn, 0, i);
+				btr_bulk_cleanup(tcx, bn, j, count);
+				goto out;
+			}
+
+			nd = btr_off2ptr(tcx, nd_off);
+			nd->tn_child = bn[j].bn_off;
+			for (at = 1; at < cnt; at++) {
+				rec = btr_node_rec_at(tcx, nd_off, at - 1);
+				rec->rec_off = bn[j + at].bn_off;
+				if (btr_is_direct_key(tcx))
+					rec->rec_node[0] = bn[j + at].bn_leaf;
+				else
+					btr_rec_copy_hkey(tcx, rec,
+						btr_node_rec_at(tcx,
+							bn[j + at].bn_leaf, 0));
+			}
+			nd->tn_keyn = cnt - 1;
+
+			bn[i].bn_off = nd_off;
+			bn[i].bn_leaf = bn[j].bn_leaf;
+			j += cnt;
+		}
+		D_ASSERT(j == count);
+	}
+
+	btr_node_set(tcx, bn[0].bn_off, BTR_NODE_ROOT);
+	root->tr_node = bn[0].bn_off;
+	root->tr_depth = depth;
+	btr_context_set_depth(tcx, depth);
+	D_DEBUG(DB_TRACE, "Bulk loaded tree depth %d\n", depth);
+	rc = 0;
+out:
+	/* the tree is still empty, nodes allocated later use the old size */
+	if (rc != 0)
+		root->tr_node_size = node_size;
+	D_FREE(bn);
+	return rc;
+
+failed_leaf:
+	btr_bulk_cleanup(tcx, bn, 0, leaves);
+	goto out;
+}
+
+/**
+ * Upsert sorted \a keys and \a vals one by one. The probe of a key starts
+ * from the leaf of the previous upsert if the leaf covers the key, the leaf is
+ * only added to the transaction once, see btr_node_tx_add.
+ */
+static int
+btr_upsert_sorted(struct btr_context *tcx, uint32_t intent, d_iov_t *keys,
+		  d_iov_t *vals, unsigned int nr)
+{
+	struct btr_trace	*trace;
+	char			 hkey[DAOS_HKEY_MAX];
+	bool			 cached = false;
+	bool			 split;
+	int			 i;
+	int			 rc = 0;
+
+	tcx->tc_bulk_on = 1;
+	tcx->tc_bulk_node = BTR_NODE_NULL;
+
+	for (i = 0; i < nr; i++) {
+		btr_hkey_gen(tcx, &keys[i], hkey);
+		if (cached && btr_leaf_covers(tcx, &keys[i], hkey))
+			rc = btr_probe_internal(tcx, BTR_PROBE_EQ, intent,
+						&keys[i], hkey, true);
+		else
+			rc = btr_probe(tcx, BTR_PROBE_EQ, intent, &keys[i],
+				       hkey);
+
+		/* the path can't be reused if the leaf is going to split,
+		 * because traces of upper levels are not updated by split.
+		 */
+		split = false;
+		if (rc == PROBE_RC_NONE && tcx->tc_depth > 0) {
+			trace = &tcx->tc_trace[tcx->tc_depth - 1];
+			split = btr_node_is_full(tcx, trace->tr_node) ||
+				btr_root_resize_needed(tcx);
+		}
+
+		rc = btr_upsert(tcx, BTR_PROBE_BYPASS, intent, &keys[i],
+				&vals[i]);
+		if (rc != 0)
+			break;
+
+		cached = !split && tcx->tc_depth > 0;
+	}
+
+	tcx->tc_bulk_on = 0;
+	tcx->tc_bulk_node = BTR_NODE_NULL;
+	return rc;
+}
+
+/**
+ * Upsert a batch of keys and values within one transaction.
+ *
+ * If the tree is empty, it is built bottom-up from the records, the records
+ * are packed into nodes filled to \a fill percent of the tree order. In this
+ * case keys must be sorted and unique in the order of the tree, e.g. as they
+ * are returned by the iterator of a tree of the same class, otherwise
+ * -DER_INVAL is returned.
+ *
+ * Otherwise the records are upserted one by one, a key can reuse the search
+ * path of the previous one if both are in the same leaf, and each leaf is only
+ * added to the transaction once. Unsorted keys are accepted but lose most of
+ * the benefit.
+ *
+ * \param toh		[IN]	Tree open handle.
+ * \param intent	[IN]	The operation intent.
+ * \param keys		[IN]	Array of keys.
+ * \param vals		[IN]	Array of values.
+ * \param nr		[IN]	Number of keys and values.
+ * \param fill		[IN]	Fill factor (percentage) of nodes for bulk
+ *				load, 0 for the default value.
+ *
+ * \return		0	success
+ *			-ve	error code
+ */
+int
+dbtree_upsert_bulk(daos_handle_t toh, uint32_t intent, d_iov_t *keys,
+		   d_iov_t *vals, unsigned int nr, unsigned int fill)
+{
+	struct btr_context *tcx;
+	int		    rc;
+
+	tcx = btr_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	if (fill > 100)
+		return -DER_INVAL;
+
+	if (nr == 0)
+		return 0;
+
+	if (fill == 0)
+		fill = BTR_BULK_FILL_DEF;
+
+	rc = btr_tx_begin(tcx);
+	if (rc != 0)
+		return rc;
+
+	if (btr_root_empty(tcx))
+		rc = btr_bulk_load(tcx, keys, vals, nr, fill);
+	else
+		rc = btr_upsert_sorted(tcx, intent, keys, vals, nr);
+
+	tcx->tc_probe_rc = PROBE_RC_UNKNOWN; /* path changed */
+	return btr_tx_end(tcx, rc);
+}
+
 /**
  * Delete the leaf record pointed by @cur_tr from the current node, then fill
  * the deletion gap by shifting remainded records on the specified direction.
@@ -3849,6 +4362,10 @@ btr_class_init(umem_off_t root_off, struct btr_root *root,
 	if (tc->tc_feats & BTR_FEAT_SKIP_LEAF_REBAL)
 		*tree_feats |= BTR_FEAT_SKIP_LEAF_REBAL;
 
+	/* search strategy of the class, it is not a feature of the tree */
+	*tree_feats &= ~BTR_FEAT_KEY_SCAN;
+	*tree_feats |= tc->tc_feats & BTR_FEAT_KEY_SCAN;
+
 	if ((*tree_feats & tc->tc_feats) != *tree_feats) {
 		D_ERROR("Unsupported features "DF_X64"/"DF_X64"\n",
 			*tree_feats, tc->tc_feats);
@@ -3892,6 +4409,9 @@ dbtree_class_register(unsigned int tree_class, uint64_t tree_feats,
 	D_ASSERT(ops->to_rec_alloc != NULL);
 	D_ASSERT(ops->to_rec_free != NULL);
 
+	if (tree_feats & BTR_FEAT_KEY_SCAN)
+		btr_ukey_scan_init();
+
 	btr_class_registered[tree_class].tc_ops = ops;
 	btr_class_registered[tree_class].tc_feats = tree_feats;
 
@@ -46,6 +46,8 @@
 #include <gurt/hash.h>
 #include <daos/lru.h>
 
+#define LRU_FPRINT_SEED		0x2a5f3bd7
+
 static inline struct daos_llink*
 link2llink(d_list_t *link)
 {
@@ -92,11 +94,28 @@ lru_hop_rec_hash(struct d_hash_table *htable, d_list_t *link)
 	return llink->ll_ops->lop_rec_hash(llink);
 }
 
+static void
+lru_queue_del(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	if (llink->ll_queue == DAOS_LRU_Q_NONE)
+		return;
+
+	if (llink->ll_queue == DAOS_LRU_Q_A1IN) {
+		D_ASSERT(lcache->dlc_a1in_cnt > 0);
+		lcache->dlc_a1in_cnt--;
+	}
+	d_list_del_init(&llink->ll_lru);
+	llink->ll_queue = DAOS_LRU_Q_NONE;
+}
+
 static void
 lru_hop_rec_free(struct d_hash_table *htable, d_list_t *link)
 {
-	struct daos_llink *llink = link2llink(link);
+	struct daos_llink	*llink = link2llink(link);
+	struct daos_lru_cache	*lcache;
 
+	lcache = container_of(htable, struct daos_lru_cache, dlc_htable);
+	lru_queue_del(lcache, llink);
 	llink->ll_ops->lop_free_ref(llink);
 }
 
@@ -112,11 +131,25 @@ int
 daos_lru_cache_create(int bits, uint32_t feats,
 		      struct daos_llink_ops *ops,
 		      struct daos_lru_cache **lcache_pp)
+{
+	/* negative bits disables LRU */
+	return daos_lru_cache_create_policy(bits >= 0 ? (1U << bits) : 0,
+					    feats, DAOS_LRU_POLICY_FLUSH, ops,
+					    lcache_pp);
+}
+
+int
+daos_lru_cache_create_policy(uint32_t csize, uint32_t feats,
+			     enum daos_lru_policy policy,
+			     struct daos_llink_ops *ops,
+			     struct daos_lru_cache **lcache_pp)
 {
 	struct daos_lru_cache	*lcache = NULL;
+	int			 bits = daos_power2_nbits(csize);
 	int			 rc = 0;
 
-	D_DEBUG(DB_TRACE, "Creating a new LRU cache of size (2^%d)\n", bits);
+	D_DEBUG(DB_TRACE, "Creating a new LRU cache of size %u, policy %d\n",
+		csize, policy);
 
 	if (ops == NULL ||
 	    ops->lop_cmp_keys  == NULL ||
@@ -131,25 +164,38 @@ daos_lru_cache_create(int bits, uint32_t feats,
 	if (lcache == NULL)
 		D_GOTO(out, rc = -DER_NOMEM);
 
+	D_INIT_LIST_HEAD(&lcache->dlc_a1in);
+	D_INIT_LIST_HEAD(&lcache->dlc_am);
+	if (policy == DAOS_LRU_POLICY_2Q && csize != 0) {
+		/*
+		 * A1in takes 1/4 of the cache, A1out remembers 1/2 of the
+		 * cache size keys, as recommended by the 2Q paper.
+		 */
+		lcache->dlc_a1in_max = max(csize / 4, 1U);
+		lcache->dlc_ghost_mask = (1U << max_t(int, bits, 2) >> 1) - 1;
+		D_ALLOC_ARRAY(lcache->dlc_ghosts, lcache->dlc_ghost_mask + 1);
+		if (lcache->dlc_ghosts == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+	}
+
 	rc = d_hash_table_create_inplace(feats | D_HASH_FT_LRU,
 					 (uint32_t)max_t(int, 4, bits - 3),
 					 NULL, &lru_ops, &lcache->dlc_htable);
 	if (rc)
 		D_GOTO(out, rc);
 
-	if (bits >= 0)
-		lcache->dlc_csize = (1U << bits);
-	else /* disable LRU */
-		lcache->dlc_csize = 0;
-
+	lcache->dlc_csize = csize;
 	lcache->dlc_count = 0;
 	lcache->dlc_ops = ops;
+	lcache->dlc_policy = policy;
 
 	*lcache_pp = lcache;
 	lcache = NULL;
 out:
-	if (lcache != NULL)
+	if (lcache != NULL) {
+		D_FREE(lcache->dlc_ghosts);
 		D_FREE(lcache);
+	}
 	return rc;
 }
 
@@ -162,6 +208,7 @@ daos_lru_cache_destroy(struct daos_lru_cache *lcache)
 	D_DEBUG(DB_TRACE, "Destroying LRU cache\n");
 	d_hash_table_debug(&lcache->dlc_htable);
 	d_hash_table_destroy_inplace(&lcache->dlc_htable, true);
+	D_FREE(lcache->dlc_ghosts);
 	D_FREE(lcache);
 }
 
@@ -216,6 +263,78 @@ daos_lru_cache_evict(struct daos_lru_cache *lcache,
 		count, lcache->dlc_count, lcache->dlc_csize);
 }
 
+static inline uint32_t *
+lru_2q_ghost(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	return &lcache->dlc_ghosts[(llink->ll_fprint >> 1) &
+				   lcache->dlc_ghost_mask];
+}
+
+/**
+ * Admit a new item, it goes to Am directly if A1out remembers its key.
+ * The fingerprint is a murmur hash of the key, because the record hash
+ * provided by user may collide a lot on similar keys.
+ */
+static void
+lru_2q_admit(struct daos_lru_cache *lcache, struct daos_llink *llink,
+	     void *key, unsigned int ksize)
+{
+	uint32_t	*ghost;
+
+	/* 0 is reserved for empty slot */
+	llink->ll_fprint = d_hash_murmur64(key, ksize, LRU_FPRINT_SEED) | 1;
+	ghost = lru_2q_ghost(lcache, llink);
+	if (*ghost == llink->ll_fprint) {
+		*ghost = 0;
+		d_list_add(&llink->ll_lru, &lcache->dlc_am);
+		llink->ll_queue = DAOS_LRU_Q_AM;
+	} else {
+		d_list_add(&llink->ll_lru, &lcache->dlc_a1in);
+		llink->ll_queue = DAOS_LRU_Q_A1IN;
+		lcache->dlc_a1in_cnt++;
+	}
+}
+
+/**
+ * Evict idle items from the queue tails until the cache is back within its
+ * capacity. Busy items are rotated to the queue head, the scan is bounded so
+ * a cache full of busy items can temporarily exceed its capacity.
+ */
+static void
+lru_2q_reclaim(struct daos_lru_cache *lcache)
+{
+	struct daos_llink	*llink;
+	d_list_t		*queue;
+	uint32_t		 scan = lcache->dlc_count;
+
+	while (lcache->dlc_count > lcache->dlc_csize && scan-- > 0) {
+		if (lcache->dlc_a1in_cnt > lcache->dlc_a1in_max ||
+		    d_list_empty(&lcache->dlc_am))
+			queue = &lcache->dlc_a1in;
+		else
+			queue = &lcache->dlc_am;
+
+		if (d_list_empty(queue))
+			break;
+
+		llink = d_list_entry(queue->prev, struct daos_llink, ll_lru);
+		if (llink->ll_ref > 1) {
+			d_list_move(&llink->ll_lru, queue);
+			continue;
+		}
+
+		if (llink->ll_queue == DAOS_LRU_Q_A1IN)
+			*lru_2q_ghost(lcache, llink) = llink->ll_fprint;
+
+		D_DEBUG(DB_TRACE, "Reclaim %p from LRU cache\n", llink);
+		llink->ll_evicted = 1;
+		/* be freed within hash callback */
+		d_hash_rec_delete_at(&lcache->dlc_htable, &llink->ll_link);
+		lcache->dlc_count--;
+		lcache->dlc_evicts++;
+	}
+}
+
 int
 daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 		  unsigned int key_size, void *create_args,
@@ -232,9 +351,14 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 	link = d_hash_rec_find(&lcache->dlc_htable, key, key_size);
 	if (link != NULL) {
 		llink = link2llink(link);
+		lcache->dlc_hits++;
+		/* A1in is FIFO, correlated references don't promote the item */
+		if (llink->ll_queue == DAOS_LRU_Q_AM)
+			d_list_move(&llink->ll_lru, &lcache->dlc_am);
 		D_GOTO(found, rc = 0);
 	}
 
+	lcache->dlc_misses++;
 	if (create_args == NULL)
 		D_GOTO(out, rc = -DER_NONEXIST);
 
@@ -247,7 +371,9 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 	llink->ll_evicted = 0;
 	llink->ll_ref	  = 1; /* 1 for caller */
 	llink->ll_ops	  = lcache->dlc_ops;
+	llink->ll_queue	  = DAOS_LRU_Q_NONE;
 	D_INIT_LIST_HEAD(&llink->ll_qlink);
+	D_INIT_LIST_HEAD(&llink->ll_lru);
 
 	rc = d_hash_rec_insert(&lcache->dlc_htable, key, key_size,
 			       &llink->ll_link, true);
@@ -256,6 +382,8 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 		return rc;
 	}
 	lcache->dlc_count++;
+	if (lcache->dlc_ghosts != NULL)
+		lru_2q_admit(lcache, llink, key, key_size);
 found:
 	*llink_pp = llink;
 out:
@@ -274,9 +402,17 @@ lru_flush_cond(struct daos_llink *llink, void *arg)
 void
 daos_lru_ref_flush(struct daos_lru_cache *lcache)
 {
+	uint32_t	count = lcache->dlc_count;
+
 	D_DEBUG(DB_TRACE, "Flush LRU cache: %d > %d\n",
 		lcache->dlc_count, lcache->dlc_csize);
+	if (lcache->dlc_policy == DAOS_LRU_POLICY_2Q) {
+		lru_2q_reclaim(lcache);
+		return;
+	}
+
 	daos_lru_cache_evict(lcache, lru_flush_cond, NULL);
+	lcache->dlc_evicts += count - lcache->dlc_count;
 }
 
 void
@@ -865,6 +865,143 @@ ik_btr_drain(void **state)
 	D_FREE(arr);
 }
 
+static bool	ik_bulk_uint;
+
+/* sort keys in the order of the tree, it is memcmp of the hashed key (the
+ * key itself) if BTR_FEAT_UINT_KEY is not set.
+ */
+static int
+ik_bulk_key_cmp(const void *a, const void *b)
+{
+	uint64_t	ka = *(uint64_t *)a;
+	uint64_t	kb = *(uint64_t *)b;
+
+	if (!ik_bulk_uint)
+		return memcmp(&ka, &kb, sizeof(ka));
+
+	return (ka > kb) - (ka < kb);
+}
+
+/**
+ * bulk upsert:
+ * 1) bulk load @key_nr sorted keys into the empty tree
+ * 2) bulk upsert every other key plus @key_nr new keys
+ * 3) lookup and verify all keys, then delete them
+ */
+static void
+ik_btr_bulk(void **state)
+{
+	struct btr_attr	 attr;
+	unsigned int	*arr;
+	uint64_t	*keys;
+	uint64_t	*vals;
+	d_iov_t		*key_iovs;
+	d_iov_t		*val_iovs;
+	d_iov_t		 key_iov;
+	d_iov_t		 val_iov;
+	unsigned int	 key_nr;
+	int		 nr;
+	int		 i;
+	int		 rc;
+
+	key_nr = atoi(tst_fn_val.optval);
+	if (key_nr == 0 || key_nr > (1U << 24)) {
+		D_PRINT("Invalid key number: %d\n", key_nr);
+		fail();
+	}
+
+	rc = dbtree_query(ik_toh, &attr, NULL);
+	assert_rc_equal(rc, 0);
+	ik_bulk_uint = attr.ba_feats & BTR_FEAT_UINT_KEY;
+
+	D_ALLOC_ARRAY(arr, key_nr * 2);
+	D_ALLOC_ARRAY(keys, key_nr * 2);
+	D_ALLOC_ARRAY(vals, key_nr * 2);
+	D_ALLOC_ARRAY(key_iovs, key_nr * 2);
+	D_ALLOC_ARRAY(val_iovs, key_nr * 2);
+	if (arr == NULL || keys == NULL || vals == NULL || key_iovs == NULL ||
+	    val_iovs == NULL)
+		fail_msg("Array allocation failed");
+
+	/* odd keys are loaded, even keys are added by the second batch */
+	ik_btr_gen_keys(arr, key_nr * 2);
+	for (i = nr = 0; i < key_nr * 2; i++) {
+		if (arr[i] % 2 == 1)
+			keys[nr++] = arr[i];
+	}
+	qsort(keys, nr, sizeof(keys[0]), ik_bulk_key_cmp);
+	for (i = 0; i < nr; i++) {
+		vals[i] = keys[i];
+		d_iov_set(&key_iovs[i], &keys[i], sizeof(keys[i]));
+		d_iov_set(&val_iovs[i], &vals[i], sizeof(vals[i]));
+	}
+
+	if (nr > 1) {
+		/* unsorted keys are rejected and leave the tree empty */
+		key_iovs[0].iov_buf = &keys[1];
+		key_iovs[1].iov_buf = &keys[0];
+		rc = dbtree_upsert_bulk(ik_toh, DAOS_INTENT_UPDATE, key_iovs,
+					val_iovs, nr, 0);
+		assert_rc_equal(rc, -DER_INVAL);
+		assert_int_equal(dbtree_is_empty(ik_toh), 1);
+		key_iovs[0].iov_buf = &keys[0];
+		key_iovs[1].iov_buf = &keys[1];
+	}
+
+	D_PRINT("Bulk load %d records.\n", nr);
+	rc = dbtree_upsert_bulk(ik_toh, DAOS_INTENT_UPDATE, key_iovs,
+				val_iovs, nr, 0);
+	if (rc != 0)
+		fail_msg("Bulk load failed: "DF_RC"\n", DP_RC(rc));
+
+	ik_btr_query(NULL);
+
+	for (i = nr = 0; i < key_nr * 2; i++) {
+		if (arr[i] % 4 != 1)
+			keys[nr++] = arr[i];
+	}
+	qsort(keys, nr, sizeof(keys[0]), ik_bulk_key_cmp);
+	for (i = 0; i < nr; i++) {
+		vals[i] = keys[i] * 2;
+		d_iov_set(&key_iovs[i], &keys[i], sizeof(keys[i]));
+		d_iov_set(&val_iovs[i], &vals[i], sizeof(vals[i]));
+	}
+
+	D_PRINT("Bulk upsert %d records.\n", nr);
+	rc = dbtree_upsert_bulk(ik_toh, DAOS_INTENT_UPDATE, key_iovs,
+				val_iovs, nr, 0);
+	if (rc != 0)
+		fail_msg("Bulk upsert failed: "DF_RC"\n", DP_RC(rc));
+
+	ik_btr_query(NULL);
+
+	D_PRINT("Verify and delete %d records.\n", key_nr * 2);
+	for (i = 0; i < key_nr * 2; i++) {
+		uint64_t	key = arr[i];
+
+		d_iov_set(&key_iov, &key, sizeof(key));
+		d_iov_set(&val_iov, NULL, 0);
+		rc = dbtree_lookup(ik_toh, &key_iov, &val_iov);
+		if (rc != 0)
+			fail_msg("Failed to lookup "DF_U64"\n", key);
+
+		assert_int_equal(val_iov.iov_len, sizeof(uint64_t));
+		assert_int_equal(*(uint64_t *)val_iov.iov_buf,
+				 arr[i] % 4 == 1 ? key : key * 2);
+
+		rc = dbtree_delete(ik_toh, BTR_PROBE_EQ, &key_iov, NULL);
+		if (rc != 0)
+			fail_msg("Failed to delete "DF_U64"\n", key);
+	}
+	assert_int_equal(dbtree_is_empty(ik_toh), 1);
+
+	D_FREE(arr);
+	D_FREE(keys);
+	D_FREE(vals);
+	D_FREE(key_iovs);
+	D_FREE(val_iovs);
+}
+
 static struct option btr_ops[] = {
 	{ "create",	required_argument,	NULL,	'C'	},
 	{ "destroy",	no_argument,		NULL,	'D'	},
@@ -880,6 +1017,7 @@ static struct option btr_ops[] = {
 	{ "iterate",	required_argument,	NULL,	'i'	},
 	{ "batch",	required_argument,	NULL,	'b'	},
 	{ "perf",	required_argument,	NULL,	'p'	},
+	{ "bulk",	required_argument,	NULL,	'B'	},
 	{ NULL,		0,			NULL,	0	},
 };
 
@@ -904,7 +1042,7 @@ ts_group(void **state) {
 
 	while ((opt = getopt_long(test_group_stop-test_group_start+1,
 				  test_group_args+test_group_start,
-				  "tmC:Deocqu:d:r:f:i:b:p:",
+				  "tmC:Deocqu:d:r:f:i:b:p:B:",
 				  btr_ops,
 				  NULL)) != -1) {
 		tst_fn_val.optval = optarg;
@@ -958,6 +1096,9 @@ ts_group(void **state) {
 		case 'p':
 			ik_btr_perf(st);
 			break;
+		case 'B':
+			ik_btr_bulk(st);
+			break;
 		default:
 			D_PRINT("Unsupported command %c\n", opt);
 		case 'm':
@@ -1035,7 +1176,7 @@ main(int argc, char **argv)
 		test_name = "Btree testing tool";
 		optind = 0;
 		/* Check for -m option first */
-		while ((opt = getopt_long(argc, argv, "tmC:Deocqu:d:r:f:i:b:p:",
+		while ((opt = getopt_long(argc, argv, "tmC:Deocqu:d:r:f:i:b:p:B:",
 					  btr_ops, NULL)) != -1) {
 			if (opt == 'm') {
 				rc = use_pmem();
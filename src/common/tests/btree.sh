@@ -37,6 +37,7 @@ EOF
 
 PERF=""
 UINT=""
+DIRECT=""
 test_conf_pre=""
 while [ $# -gt 0 ]; do
     case "$1" in
@@ -67,6 +68,7 @@ while [ $# -gt 0 ]; do
         ;;
     direct)
         BTR=${SL_BUILD_DIR}/src/common/tests/btree_direct
+        DIRECT="on"
         KEYS=${KEYS:-"delta,lambda,kappa,omega,beta,alpha,epsilon"}
         RECORDS=${RECORDS:-"omega:loaded,delta:that,kappa:dice,beta:knows,epsilon:the,lambda:are,alpha:Everybody"}
         shift
@@ -133,6 +135,14 @@ run_test()
         "${DYN}" "${PMEM}" -C "${UINT}${IPL}o:$ORDER" \
         -e -D
 
+        if [ -z "${DIRECT}" ]; then
+            echo "B+tree bulk upsert test..."
+            eval "${VCMD[@]}" "$BTR" \
+            --start-test "btree bulk ${test_conf_pre} ${test_conf}" \
+            "${DYN}" "${PMEM}" -C "${UINT}${IPL}o:$ORDER" \
+            -B "$BAT_NUM" -D
+        fi
+
     else
         echo "B+tree performance test..."
         eval "${VCMD[@]}" "$BTR" \
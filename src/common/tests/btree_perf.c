@@ -0,0 +1,384 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Micro-benchmark of integer key btree, it compares insert and probe rates of
+ * the default binary search with the callback-free key scan enabled by
+ * BTR_FEAT_KEY_SCAN, and insert rates of sorted keys with and without
+ * dbtree_upsert_bulk.
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <getopt.h>
+#include <daos/btree.h>
+#include <daos/tests_lib.h>
+
+#define BP_CLASS_BSEARCH	110
+#define BP_CLASS_SCAN		111
+
+static int	bp_order = 16;
+static int	bp_keys = 1000000;
+static int	bp_loops = 3;
+
+/** value is stored in rec_off directly, no allocation for record body */
+static int
+bp_rec_alloc(struct btr_instance *tins, d_iov_t *key, d_iov_t *val,
+	     struct btr_record *rec)
+{
+	rec->rec_off = *(uint64_t *)val->iov_buf;
+	return 0;
+}
+
+static int
+bp_rec_free(struct btr_instance *tins, struct btr_record *rec, void *args)
+{
+	return 0;
+}
+
+static int
+bp_rec_fetch(struct btr_instance *tins, struct btr_record *rec,
+	     d_iov_t *key, d_iov_t *val)
+{
+	if (val != NULL && val->iov_buf_len >= sizeof(rec->rec_off)) {
+		*(uint64_t *)val->iov_buf = rec->rec_off;
+		val->iov_len = sizeof(rec->rec_off);
+	}
+	return 0;
+}
+
+static int
+bp_rec_update(struct btr_instance *tins, struct btr_record *rec,
+	      d_iov_t *key, d_iov_t *val)
+{
+	rec->rec_off = *(uint64_t *)val->iov_buf;
+	return 0;
+}
+
+static btr_ops_t bp_ops = {
+	.to_rec_alloc	= bp_rec_alloc,
+	.to_rec_free	= bp_rec_free,
+	.to_rec_fetch	= bp_rec_fetch,
+	.to_rec_update	= bp_rec_update,
+};
+
+static void
+bp_shuffle(uint64_t *keys, int nr)
+{
+	uint64_t	tmp;
+	int		i;
+	int		j;
+
+	for (i = nr - 1; i > 0; i--) {
+		j = rand() % (i + 1);
+		tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+}
+
+static int
+bp_run(const char *name, unsigned int tclass, uint64_t *keys)
+{
+	struct umem_attr	uma = { .uma_id = UMEM_CLASS_VMEM };
+	struct btr_root		root = { 0 };
+	daos_handle_t		toh;
+	d_iov_t			key;
+	d_iov_t			val;
+	uint64_t		kbuf;
+	uint64_t		vbuf;
+	double			then;
+	double			ins = 0;
+	double			lkp = 0;
+	double			prb = 0;
+	int			loop;
+	int			i;
+	int			rc;
+
+	d_iov_set(&key, &kbuf, sizeof(kbuf));
+	d_iov_set(&val, &vbuf, sizeof(vbuf));
+
+	for (loop = 0; loop < bp_loops; loop++) {
+		rc = dbtree_create_inplace(tclass, BTR_FEAT_UINT_KEY, bp_order,
+					   &uma, &root, &toh);
+		if (rc != 0) {
+			fprintf(stderr, "Failed to create tree: %d\n", rc);
+			return rc;
+		}
+
+		bp_shuffle(keys, bp_keys);
+		then = dts_time_now();
+		for (i = 0; i < bp_keys; i++) {
+			kbuf = vbuf = keys[i];
+			rc = dbtree_upsert(toh, BTR_PROBE_EQ, DAOS_INTENT_UPDATE,
+					   &key, &val);
+			if (rc != 0)
+				goto out;
+		}
+		ins += dts_time_now() - then;
+
+		bp_shuffle(keys, bp_keys);
+		then = dts_time_now();
+		for (i = 0; i < bp_keys; i++) {
+			kbuf = keys[i];
+			rc = dbtree_lookup(toh, &key, &val);
+			if (rc != 0 || vbuf != kbuf) {
+				fprintf(stderr, "Lookup "DF_U64" failed: %d\n",
+					kbuf, rc);
+				rc = rc ?: -DER_MISMATCH;
+				goto out;
+			}
+		}
+		lkp += dts_time_now() - then;
+
+		/* keys are even numbers, probe the odd ones in between */
+		then = dts_time_now();
+		for (i = 0; i < bp_keys; i++) {
+			kbuf = keys[i] - 1;
+			rc = dbtree_fetch(toh, BTR_PROBE_GE,
+					  DAOS_INTENT_DEFAULT, &key, NULL,
+					  &val);
+			if (rc != 0 || vbuf != keys[i]) {
+				fprintf(stderr, "Probe "DF_U64" failed: %d\n",
+					kbuf, rc);
+				rc = rc ?: -DER_MISMATCH;
+				goto out;
+			}
+		}
+		prb += dts_time_now() - then;
+out:
+		dbtree_destroy(toh, NULL);
+		if (rc != 0)
+			return rc;
+	}
+
+	printf("%-10s insert %12.2f/sec lookup %12.2f/sec probe_ge %12.2f/sec\n",
+	       name, (double)bp_keys * bp_loops / ins,
+	       (double)bp_keys * bp_loops / lkp,
+	       (double)bp_keys * bp_loops / prb);
+	return 0;
+}
+
+/**
+ * Create a tree and insert every other key of \a iovs into it, the other keys
+ * are moved to the second half of \a iovs, which is still sorted.
+ */
+static int
+bp_half_tree(unsigned int tclass, struct btr_root *root, d_iov_t *iovs,
+	     daos_handle_t *toh)
+{
+	struct umem_attr	uma = { .uma_id = UMEM_CLASS_VMEM };
+	int			i;
+	int			rc;
+
+	rc = dbtree_create_inplace(tclass, BTR_FEAT_UINT_KEY, bp_order, &uma,
+				   root, toh);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < bp_keys / 2; i++) {
+		rc = dbtree_upsert(*toh, BTR_PROBE_EQ, DAOS_INTENT_UPDATE,
+				   &iovs[i * 2], &iovs[i * 2]);
+		if (rc != 0) {
+			dbtree_destroy(*toh, NULL);
+			return rc;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Insert sorted \a keys into an empty tree and into a half full tree, one by
+ * one with dbtree_upsert and in one batch with dbtree_upsert_bulk.
+ */
+static int
+bp_run_sorted(unsigned int tclass, uint64_t *keys)
+{
+	struct umem_attr	 uma = { .uma_id = UMEM_CLASS_VMEM };
+	struct btr_root		 root = { 0 };
+	daos_handle_t		 toh;
+	d_iov_t			*iovs;
+	d_iov_t			*odds;
+	double			 then;
+	double			 single = 0;
+	double			 load = 0;
+	double			 merge_single = 0;
+	double			 merge = 0;
+	int			 half = bp_keys / 2;
+	int			 loop;
+	int			 i;
+	int			 rc = 0;
+
+	D_ALLOC_ARRAY(iovs, bp_keys);
+	D_ALLOC_ARRAY(odds, half);
+	if (iovs == NULL || odds == NULL) {
+		rc = -DER_NOMEM;
+		goto out;
+	}
+
+	/* value is the same as the key */
+	for (i = 0; i < bp_keys; i++)
+		d_iov_set(&iovs[i], &keys[i], sizeof(keys[i]));
+	for (i = 0; i < half; i++)
+		odds[i] = iovs[i * 2 + 1];
+
+	for (loop = 0; loop < bp_loops; loop++) {
+		rc = dbtree_create_inplace(tclass, BTR_FEAT_UINT_KEY, bp_order,
+					   &uma, &root, &toh);
+		if (rc != 0)
+			goto out;
+
+		then = dts_time_now();
+		for (i = 0; i < bp_keys && rc == 0; i++)
+			rc = dbtree_upsert(toh, BTR_PROBE_EQ,
+					   DAOS_INTENT_UPDATE, &iovs[i],
+					   &iovs[i]);
+		single += dts_time_now() - then;
+		dbtree_destroy(toh, NULL);
+		if (rc != 0)
+			goto out;
+
+		rc = dbtree_create_inplace(tclass, BTR_FEAT_UINT_KEY, bp_order,
+					   &uma, &root, &toh);
+		if (rc != 0)
+			goto out;
+
+		then = dts_time_now();
+		rc = dbtree_upsert_bulk(toh, DAOS_INTENT_UPDATE, iovs, iovs,
+					bp_keys, 0);
+		load += dts_time_now() - then;
+		dbtree_destroy(toh, NULL);
+		if (rc != 0)
+			goto out;
+
+		rc = bp_half_tree(tclass, &root, iovs, &toh);
+		if (rc != 0)
+			goto out;
+
+		then = dts_time_now();
+		for (i = 0; i < half && rc == 0; i++)
+			rc = dbtree_upsert(toh, BTR_PROBE_EQ,
+					   DAOS_INTENT_UPDATE, &odds[i],
+					   &odds[i]);
+		merge_single += dts_time_now() - then;
+		dbtree_destroy(toh, NULL);
+		if (rc != 0)
+			goto out;
+
+		rc = bp_half_tree(tclass, &root, iovs, &toh);
+		if (rc != 0)
+			goto out;
+
+		then = dts_time_now();
+		rc = dbtree_upsert_bulk(toh, DAOS_INTENT_UPDATE, odds, odds,
+					half, 0);
+		merge += dts_time_now() - then;
+		dbtree_destroy(toh, NULL);
+		if (rc != 0)
+			goto out;
+	}
+
+	printf("%-10s upsert %12.2f/sec bulk load %12.2f/sec\n"
+	       "%-10s upsert %12.2f/sec bulk upsert %12.2f/sec\n",
+	       "sorted", (double)bp_keys * bp_loops / single,
+	       (double)bp_keys * bp_loops / load,
+	       "merge", (double)half * bp_loops / merge_single,
+	       (double)half * bp_loops / merge);
+out:
+	if (rc != 0)
+		fprintf(stderr, "Sorted insert failed: %d\n", rc);
+	D_FREE(iovs);
+	D_FREE(odds);
+	return rc;
+}
+
+static void
+print_usage(const char *prog)
+{
+	printf("Usage: %s [OPTIONS]\n"
+	       "  -o, --order <n>   Tree order (default %d)\n"
+	       "  -n, --keys <n>    Number of keys (default %d)\n"
+	       "  -l, --loops <n>   Number of rounds (default %d)\n",
+	       prog, bp_order, bp_keys, bp_loops);
+}
+
+int
+main(int argc, char **argv)
+{
+	static struct option	long_ops[] = {
+		{ "order",	required_argument,	NULL,	'o' },
+		{ "keys",	required_argument,	NULL,	'n' },
+		{ "loops",	required_argument,	NULL,	'l' },
+		{ "help",	no_argument,		NULL,	'h' },
+		{ NULL,		0,			NULL,	0   },
+	};
+	uint64_t		*keys;
+	int			 opt;
+	int			 i;
+	int			 rc;
+
+	while ((opt = getopt_long(argc, argv, "o:n:l:h", long_ops,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'o':
+			bp_order = atoi(optarg);
+			break;
+		case 'n':
+			bp_keys = atoi(optarg);
+			break;
+		case 'l':
+			bp_loops = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (bp_order < BTR_ORDER_MIN || bp_order > BTR_ORDER_MAX ||
+	    bp_keys <= 0 || bp_loops <= 0) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	rc = dbtree_class_register(BP_CLASS_BSEARCH, BTR_FEAT_UINT_KEY,
+				   &bp_ops);
+	if (rc == 0)
+		rc = dbtree_class_register(BP_CLASS_SCAN,
+					   BTR_FEAT_UINT_KEY |
+					   BTR_FEAT_KEY_SCAN, &bp_ops);
+	if (rc != 0)
+		goto out;
+
+	D_ALLOC_ARRAY(keys, bp_keys);
+	if (keys == NULL) {
+		rc = -DER_NOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < bp_keys; i++)
+		keys[i] = (i + 1) * 2;
+
+	printf("Btree key search benchmark, order=%d, keys=%d, loops=%d\n",
+	       bp_order, bp_keys, bp_loops);
+	rc = bp_run("bsearch", BP_CLASS_BSEARCH, keys);
+	if (rc == 0)
+		rc = bp_run("key_scan", BP_CLASS_SCAN, keys);
+
+	/* sorted keys for bulk insert */
+	for (i = 0; i < bp_keys; i++)
+		keys[i] = (i + 1) * 2;
+	if (rc == 0)
+		rc = bp_run_sorted(BP_CLASS_SCAN, keys);
+
+	D_FREE(keys);
+out:
+	daos_debug_fini();
+	return rc;
+}
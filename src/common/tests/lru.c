@@ -99,6 +99,79 @@ test_ref_hold(struct daos_lru_cache *cache,
 	return rc;
 }
 
+static int
+test_2q_touch(struct daos_lru_cache *tcache, uint64_t start, uint64_t end)
+{
+	struct daos_llink	*link;
+	uint64_t		 key;
+	int			 rc;
+
+	for (key = start; key < end; key++) {
+		rc = daos_lru_ref_hold(tcache, &key, sizeof(key), (void *)1,
+				       &link);
+		if (rc)
+			return rc;
+		daos_lru_ref_release(tcache, link);
+	}
+	return 0;
+}
+
+/**
+ * A hot set that is referenced repeatedly is promoted to Am, most of it must
+ * survive a one-time scan of twice the cache size with the 2Q policy.
+ */
+static int
+test_2q_scan(uint32_t csize)
+{
+	struct daos_lru_cache	*tcache = NULL;
+	struct daos_llink	*link;
+	uint64_t		 nr_hot = csize / 4;
+	uint64_t		 scan = 1000000;
+	uint64_t		 hits = 0;
+	uint64_t		 key;
+	int			 round;
+	int			 rc;
+
+	rc = daos_lru_cache_create_policy(csize, D_HASH_FT_NOLOCK,
+					  DAOS_LRU_POLICY_2Q,
+					  &uint_ref_llink_ops, &tcache);
+	if (rc)
+		return rc;
+
+	for (round = 0; round < 8; round++) {
+		rc = test_2q_touch(tcache, 0, nr_hot);
+		if (rc)
+			D_GOTO(out, rc);
+		rc = test_2q_touch(tcache, scan, scan + csize / 2);
+		if (rc)
+			D_GOTO(out, rc);
+		scan += csize / 2;
+	}
+
+	rc = test_2q_touch(tcache, scan, scan + csize * 2);
+	if (rc)
+		D_GOTO(out, rc);
+	D_ASSERT(tcache->dlc_count <= csize);
+
+	for (key = 0; key < nr_hot; key++) {
+		rc = daos_lru_ref_hold(tcache, &key, sizeof(key), NULL, &link);
+		if (rc == -DER_NONEXIST)
+			continue;
+		if (rc)
+			D_GOTO(out, rc);
+		daos_lru_ref_release(tcache, link);
+		hits++;
+	}
+	rc = 0;
+
+	D_PRINT("2Q hot set "DF_U64"/"DF_U64" survived scan, hits "DF_U64
+		", misses "DF_U64", evicts "DF_U64"\n", hits, nr_hot,
+		tcache->dlc_hits, tcache->dlc_misses, tcache->dlc_evicts);
+	D_ASSERT(hits * 2 >= nr_hot);
+out:
+	daos_lru_cache_destroy(tcache);
+	return rc;
+}
 
 int
 main(int argc, char **argv)
@@ -166,6 +239,8 @@ main(int argc, char **argv)
 	daos_lru_ref_release(tcache, link_ret[1]);
 	D_PRINT("Completed ref release for key: %"PRIu64"\n",
 		keys[1]);
+
+	rc = test_2q_scan(1U << csize);
 exit:
 	daos_lru_cache_destroy(tcache);
 	D_FREE(keys);
@@ -0,0 +1,232 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Task scheduler micro-benchmark. A number of threads create, schedule and
+ * progress small tasks either on one shared scheduler or on a scheduler per
+ * thread, and the rate of completed tasks is reported. Each task can be given
+ * a fan-in of dependent tasks to exercise the dependency tracking as well.
+ *
+ * common/tests/tse_perf.c
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+#include <daos/common.h>
+#include <daos/tse.h>
+
+static int		opt_threads = 8;
+static int		opt_tasks = 100000;
+static int		opt_deps;
+static int		opt_batch = 64;
+static bool		opt_private;
+
+struct tp_thread {
+	pthread_t	 tt_id;
+	tse_sched_t	*tt_sched;
+	int		 tt_rc;
+};
+
+static tse_sched_t		*tp_scheds;
+static pthread_barrier_t	 tp_barrier;
+
+static inline uint64_t
+tp_now_ns(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int
+tp_task_body(tse_task_t *task)
+{
+	tse_task_complete(task, 0);
+	return 0;
+}
+
+static int
+tp_task_submit(tse_sched_t *sched)
+{
+	tse_task_t	*deps[opt_deps > 0 ? opt_deps : 1];
+	tse_task_t	*task;
+	int		 i;
+	int		 rc;
+
+	rc = tse_task_create(tp_task_body, sched, NULL, &task);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < opt_deps; i++) {
+		rc = tse_task_create(tp_task_body, sched, NULL, &deps[i]);
+		if (rc != 0)
+			goto abort;
+	}
+
+	if (opt_deps > 0) {
+		rc = tse_task_register_deps(task, opt_deps, deps);
+		if (rc != 0)
+			goto abort;
+	}
+
+	for (i = 0; i < opt_deps; i++)
+		tse_task_schedule(deps[i], false);
+	return tse_task_schedule(task, false);
+
+abort:
+	while (--i >= 0)
+		tse_task_complete(deps[i], rc);
+	tse_task_complete(task, rc);
+	return rc;
+}
+
+static void *
+tp_thread_run(void *arg)
+{
+	struct tp_thread	*tt = arg;
+	int			 i;
+
+	pthread_barrier_wait(&tp_barrier);
+	for (i = 0; i < opt_tasks; i++) {
+		tt->tt_rc = tp_task_submit(tt->tt_sched);
+		if (tt->tt_rc != 0)
+			break;
+		if ((i + 1) % opt_batch == 0)
+			tse_sched_progress(tt->tt_sched);
+	}
+
+	while (!tse_sched_check_complete(tt->tt_sched))
+		tse_sched_progress(tt->tt_sched);
+	return NULL;
+}
+
+static int
+tp_run(struct tp_thread *threads)
+{
+	uint64_t	then;
+	uint64_t	tasks;
+	double		secs;
+	int		nr_scheds = opt_private ? opt_threads : 1;
+	int		i;
+	int		rc = 0;
+
+	for (i = 0; i < nr_scheds; i++) {
+		rc = tse_sched_init(&tp_scheds[i], NULL, NULL);
+		if (rc != 0) {
+			fprintf(stderr, "Failed to init scheduler: %d\n", rc);
+			return rc;
+		}
+	}
+
+	pthread_barrier_init(&tp_barrier, NULL, opt_threads + 1);
+	for (i = 0; i < opt_threads; i++) {
+		threads[i].tt_sched = &tp_scheds[opt_private ? i : 0];
+		threads[i].tt_rc = 0;
+		rc = pthread_create(&threads[i].tt_id, NULL, tp_thread_run,
+				    &threads[i]);
+		if (rc != 0) {
+			fprintf(stderr, "Failed to create thread: %d\n", rc);
+			exit(-1);
+		}
+	}
+
+	pthread_barrier_wait(&tp_barrier);
+	then = tp_now_ns();
+	for (i = 0; i < opt_threads; i++) {
+		pthread_join(threads[i].tt_id, NULL);
+		if (threads[i].tt_rc != 0)
+			rc = threads[i].tt_rc;
+	}
+	secs = (tp_now_ns() - then) / 1e9;
+	pthread_barrier_destroy(&tp_barrier);
+
+	for (i = 0; i < nr_scheds; i++)
+		tse_sched_complete(&tp_scheds[i], 0, false);
+
+	if (rc != 0) {
+		fprintf(stderr, "Failed to run tasks: %d\n", rc);
+		return rc;
+	}
+
+	tasks = (uint64_t)opt_threads * opt_tasks * (opt_deps + 1);
+	printf("%8d %10s %12.0f tasks/s %8.2f secs\n", opt_threads,
+	       opt_private ? "private" : "shared", tasks / secs, secs);
+	return 0;
+}
+
+static struct option tp_ops[] = {
+	/** number of threads */
+	{ "threads",	required_argument,	NULL,	't'	},
+	/** number of tasks submitted by each thread */
+	{ "num",	required_argument,	NULL,	'n'	},
+	/** number of dependent tasks of each task */
+	{ "deps",	required_argument,	NULL,	'd'	},
+	/** number of tasks submitted between two progress calls */
+	{ "batch",	required_argument,	NULL,	'b'	},
+	/** a scheduler per thread rather than one shared scheduler */
+	{ "private",	no_argument,		NULL,	'p'	},
+	{ NULL,		0,			NULL,	0	},
+};
+
+int
+main(int argc, char **argv)
+{
+	struct tp_thread	*threads;
+	int			 rc;
+
+	while ((rc = getopt_long(argc, argv, "t:n:d:b:p",
+				 tp_ops, NULL)) != -1) {
+		switch (rc) {
+		default:
+			fprintf(stderr, "unknown opc=%c\n", rc);
+			exit(-1);
+		case 't':
+			opt_threads = atoi(optarg);
+			break;
+		case 'n':
+			opt_tasks = atoi(optarg);
+			break;
+		case 'd':
+			opt_deps = atoi(optarg);
+			break;
+		case 'b':
+			opt_batch = atoi(optarg);
+			break;
+		case 'p':
+			opt_private = true;
+			break;
+		}
+	}
+
+	if (opt_threads <= 0 || opt_tasks <= 0 || opt_deps < 0 ||
+	    opt_batch <= 0) {
+		fprintf(stderr, "invalid threads=%d, num=%d, deps=%d, "
+			"batch=%d\n", opt_threads, opt_tasks, opt_deps,
+			opt_batch);
+		return -1;
+	}
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	D_ALLOC_ARRAY(threads, opt_threads);
+	D_ALLOC_ARRAY(tp_scheds, opt_private ? opt_threads : 1);
+	if (threads == NULL || tp_scheds == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	printf("TSE benchmark, tasks=%d per thread, deps=%d, batch=%d\n",
+	       opt_tasks, opt_deps, opt_batch);
+	rc = tp_run(threads);
+out:
+	D_FREE(tp_scheds);
+	D_FREE(threads);
+	tse_task_cache_fini();
+	daos_debug_fini();
+	return rc;
+}
@@ -218,45 +218,216 @@ tse_task2sched(tse_task_t *task)
 	return tse_priv2sched(sched_priv);
 }
 
+/*
+ * Per-thread cache of released tasks. tse_task_decref() parks the task there
+ * on the last reference and tse_task_create() takes it back before falling
+ * back to the allocator, which saves a 1KB calloc/free pair per task. Since
+ * each thread only touches its own cache no locking is needed on that path.
+ * The caches are also registered on a global list, so that
+ * tse_task_cache_fini() can free the caches of all threads and delete the
+ * thread key before the library is unloaded; the caches of the threads that
+ * exit before that are freed by the key destructor.
+ */
+#define TSE_TASK_CACHE_MAX	256
+
+struct tse_task_cache {
+	d_list_t	ttc_list;
+	/* link in tse_task_caches */
+	d_list_t	ttc_link;
+	int		ttc_count;
+};
+
+/* protects tse_task_caches and the thread key */
+static pthread_mutex_t			tse_task_cache_lock =
+						PTHREAD_MUTEX_INITIALIZER;
+static d_list_t				tse_task_caches =
+					D_LIST_HEAD_INIT(tse_task_caches);
+static pthread_key_t			tse_task_cache_key;
+static bool				tse_task_cache_key_valid;
+/* bumped by tse_task_cache_fini(), which frees the caches of all threads */
+static ATOMIC uint32_t			tse_task_cache_gen;
+static __thread struct tse_task_cache	*tse_task_cache;
+static __thread uint32_t		tse_task_cache_tgen;
+
 static void
-tse_task_addref_locked(struct tse_task_private *dtp)
+tse_task_cache_free(struct tse_task_cache *cache)
 {
-	dtp->dtp_refcnt++;
+	struct tse_task_private	*dtp;
+
+	while (!d_list_empty(&cache->ttc_list)) {
+		tse_task_t	*task;
+
+		dtp = d_list_entry(cache->ttc_list.next,
+				   struct tse_task_private, dtp_list);
+		d_list_del(&dtp->dtp_list);
+		task = tse_priv2task(dtp);
+		D_FREE(task);
+	}
+	cache->ttc_count = 0;
 }
 
-static bool
-tse_task_decref_locked(struct tse_task_private *dtp)
+/* The cache of the calling thread, unless freed by tse_task_cache_fini() */
+static inline struct tse_task_cache *
+tse_task_cache_self(void)
+{
+	if (tse_task_cache_tgen != atomic_load_relaxed(&tse_task_cache_gen))
+		return NULL;
+	return tse_task_cache;
+}
+
+static void
+tse_task_cache_destroy(void *arg)
+{
+	struct tse_task_cache	*cache = arg;
+
+	D_MUTEX_LOCK(&tse_task_cache_lock);
+	/* otherwise tse_task_cache_fini() has freed it already */
+	if (tse_task_cache_tgen == atomic_load_relaxed(&tse_task_cache_gen)) {
+		d_list_del(&cache->ttc_link);
+		tse_task_cache_free(cache);
+		D_FREE(cache);
+	}
+	D_MUTEX_UNLOCK(&tse_task_cache_lock);
+	tse_task_cache = NULL;
+}
+
+static struct tse_task_cache *
+tse_task_cache_get(void)
 {
-	D_ASSERT(dtp->dtp_refcnt > 0);
-	dtp->dtp_refcnt--;
-	return dtp->dtp_refcnt == 0;
+	struct tse_task_cache	*cache;
+	int			 rc;
+
+	cache = tse_task_cache_self();
+	if (cache != NULL)
+		return cache;
+
+	/* the cache would hide use-after-free of tasks from valgrind */
+	if (D_ON_VALGRIND)
+		return NULL;
+
+	D_ALLOC_PTR(cache);
+	if (cache == NULL)
+		return NULL;
+	D_INIT_LIST_HEAD(&cache->ttc_list);
+
+	D_MUTEX_LOCK(&tse_task_cache_lock);
+	if (!tse_task_cache_key_valid) {
+		rc = pthread_key_create(&tse_task_cache_key,
+					tse_task_cache_destroy);
+		if (rc != 0) {
+			D_WARN("Failed to create the task cache key: %d\n",
+			       rc);
+			goto err;
+		}
+		tse_task_cache_key_valid = true;
+	}
+
+	rc = pthread_setspecific(tse_task_cache_key, cache);
+	if (rc != 0)
+		goto err;
+
+	d_list_add(&cache->ttc_link, &tse_task_caches);
+	tse_task_cache_tgen = atomic_load_relaxed(&tse_task_cache_gen);
+	tse_task_cache = cache;
+	D_MUTEX_UNLOCK(&tse_task_cache_lock);
+	return cache;
+
+err:
+	D_MUTEX_UNLOCK(&tse_task_cache_lock);
+	D_FREE(cache);
+	return NULL;
+}
+
+static tse_task_t *
+tse_task_alloc(void)
+{
+	struct tse_task_cache	*cache = tse_task_cache_self();
+	struct tse_task_private	*dtp;
+	tse_task_t		*task;
+
+	if (cache == NULL || d_list_empty(&cache->ttc_list)) {
+		D_ALLOC_PTR(task);
+		return task;
+	}
+
+	dtp = d_list_entry(cache->ttc_list.next, struct tse_task_private,
+			   dtp_list);
+	d_list_del(&dtp->dtp_list);
+	cache->ttc_count--;
+
+	task = tse_priv2task(dtp);
+	memset(task, 0, sizeof(*task));
+	return task;
+}
+
+static void
+tse_task_release(tse_task_t *task)
+{
+	struct tse_task_cache	*cache = tse_task_cache_get();
+	struct tse_task_private	*dtp = tse_task2priv(task);
+
+	if (cache == NULL || cache->ttc_count >= TSE_TASK_CACHE_MAX) {
+		D_FREE(task);
+		return;
+	}
+
+	d_list_add(&dtp->dtp_list, &cache->ttc_list);
+	cache->ttc_count++;
+}
+
+void
+tse_task_cache_fini(void)
+{
+	struct tse_task_cache	*cache;
+
+	D_MUTEX_LOCK(&tse_task_cache_lock);
+	while ((cache = d_list_pop_entry(&tse_task_caches,
+					 struct tse_task_cache, ttc_link))) {
+		tse_task_cache_free(cache);
+		D_FREE(cache);
+	}
+
+	/* no destructor may run once the library is unloaded */
+	if (tse_task_cache_key_valid) {
+		pthread_key_delete(tse_task_cache_key);
+		tse_task_cache_key_valid = false;
+	}
+	atomic_fetch_add(&tse_task_cache_gen, 1);
+	D_MUTEX_UNLOCK(&tse_task_cache_lock);
+}
+
+static inline void
+tse_task_priv_addref(struct tse_task_private *dtp)
+{
+	atomic_fetch_add_relaxed(&dtp->dtp_refcnt, 1);
+}
+
+static inline bool
+tse_task_priv_decref(struct tse_task_private *dtp)
+{
+	uint32_t	refcnt;
+
+	refcnt = atomic_fetch_sub(&dtp->dtp_refcnt, 1);
+	D_ASSERT(refcnt > 0);
+	return refcnt == 1;
 }
 
 void
 tse_task_addref(tse_task_t *task)
 {
 	struct tse_task_private  *dtp = tse_task2priv(task);
-	struct tse_sched_private *dsp = dtp->dtp_sched;
-
-	D_ASSERT(dsp != NULL);
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-	tse_task_addref_locked(dtp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	D_ASSERT(dtp->dtp_sched != NULL);
+	tse_task_priv_addref(dtp);
 }
 
 void
 tse_task_decref(tse_task_t *task)
 {
 	struct tse_task_private  *dtp = tse_task2priv(task);
-	struct tse_sched_private *dsp = dtp->dtp_sched;
-	bool			   zombie;
 
-	D_ASSERT(dsp != NULL);
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-	zombie = tse_task_decref_locked(dtp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
-	if (!zombie)
+	D_ASSERT(dtp->dtp_sched != NULL);
+	if (!tse_task_priv_decref(dtp))
 		return;
 
 	D_ASSERT(d_list_empty(&dtp->dtp_dep_list));
@@ -266,7 +437,7 @@ tse_task_decref(tse_task_t *task)
 	 * user also free it. This now requires task to be on the heap all the
 	 * time.
 	 */
-	D_FREE(task);
+	tse_task_release(task);
 }
 
 void
@@ -284,36 +455,27 @@ tse_sched_fini(tse_sched_t *sched)
 }
 
 static inline void
-tse_sched_priv_addref_locked(struct tse_sched_private *dsp)
+tse_sched_priv_addref(struct tse_sched_private *dsp)
 {
-	dsp->dsp_refcount++;
+	atomic_fetch_add_relaxed(&dsp->dsp_refcount, 1);
 }
 
 static void
 tse_sched_priv_decref(struct tse_sched_private *dsp)
 {
-	bool	finalize;
+	int	refcount;
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-
-	D_ASSERT(dsp->dsp_refcount > 0);
-	dsp->dsp_refcount--;
-	finalize = dsp->dsp_refcount == 0;
+	refcount = atomic_fetch_sub(&dsp->dsp_refcount, 1);
+	D_ASSERT(refcount > 0);
 
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
-
-	if (finalize)
+	if (refcount == 1)
 		tse_sched_fini(tse_priv2sched(dsp));
 }
 
 void
 tse_sched_addref(tse_sched_t *sched)
 {
-	struct tse_sched_private *dsp = tse_sched2priv(sched);
-
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-	tse_sched_priv_addref_locked(dsp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_priv_addref(tse_sched2priv(sched));
 }
 
 void
@@ -375,7 +537,7 @@ tse_task_complete_locked(struct tse_task_private *dtp,
 	 * before adding it to tail of completed list.
 	 */
 	if (!dtp->dtp_running) {
-		tse_sched_priv_addref_locked(dsp);
+		tse_sched_priv_addref(dsp);
 		dsp->dsp_inflight++;
 	}
 
@@ -489,7 +651,7 @@ tse_task_complete_callback(tse_task_t *task)
 {
 	struct tse_task_private	*dtp = tse_task2priv(task);
 	struct tse_sched_private *dsp = dtp->dtp_sched;
-	uint32_t		 dep_cnt = dtp->dtp_dep_cnt;
+	uint32_t		 dep_cnt = atomic_load_relaxed(&dtp->dtp_dep_cnt);
 	struct tse_task_cb	*dtc;
 	struct tse_task_cb	*tmp;
 
@@ -512,7 +674,7 @@ tse_task_complete_callback(tse_task_t *task)
 		}
 
 		/** New dependent task added in completion call-back */
-		if (dtp->dtp_dep_cnt > dep_cnt) {
+		if (atomic_load_relaxed(&dtp->dtp_dep_cnt) > dep_cnt) {
 			D_DEBUG(DB_TRACE, "new dep-task added to task %p\n",
 				task);
 			D_MUTEX_UNLOCK(&dsp->dsp_comp_lock);
@@ -549,7 +711,8 @@ tse_sched_process_init(struct tse_sched_private *dsp)
 		d_list_move_tail(&dtp->dtp_list, &dsp->dsp_init_list);
 	}
 	d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_init_list, dtp_list) {
-		if (dtp->dtp_dep_cnt == 0 || dsp->dsp_cancelling) {
+		if (atomic_load_relaxed(&dtp->dtp_dep_cnt) == 0 ||
+		    dsp->dsp_cancelling) {
 			d_list_move_tail(&dtp->dtp_list, &list);
 			dsp->dsp_inflight++;
 		}
@@ -573,7 +736,7 @@ tse_sched_process_init(struct tse_sched_private *dsp)
 			d_list_move_tail(&dtp->dtp_list,
 					 &dsp->dsp_running_list);
 			/** +1 in case prep cb calls task_complete() */
-			tse_task_addref_locked(dtp);
+			tse_task_priv_addref(dtp);
 			bumped = true;
 		}
 		D_MUTEX_UNLOCK(&dsp->dsp_lock);
@@ -619,6 +782,7 @@ tse_task_post_process(tse_task_t *task)
 		struct tse_task_link	*tlink;
 		tse_task_t		*task_tmp;
 		struct tse_task_private	*dtp_tmp;
+		uint32_t		 dep_cnt;
 
 		tlink = d_list_entry(dtp->dtp_dep_list.next,
 				     struct tse_task_link, tl_link);
@@ -632,11 +796,11 @@ tse_task_post_process(tse_task_t *task)
 			task_tmp->dt_result = task->dt_result;
 
 		/* see if the dependent task is ready to be scheduled */
-		D_ASSERT(dtp_tmp->dtp_dep_cnt > 0);
-		dtp_tmp->dtp_dep_cnt--;
-		D_DEBUG(DB_TRACE, "daos task %p dep_cnt %d\n", dtp_tmp,
-			dtp_tmp->dtp_dep_cnt);
-		if (!dsp->dsp_cancelling && dtp_tmp->dtp_dep_cnt == 0 &&
+		dep_cnt = atomic_fetch_sub(&dtp_tmp->dtp_dep_cnt, 1);
+		D_ASSERT(dep_cnt > 0);
+		D_DEBUG(DB_TRACE, "daos task %p dep_cnt %u\n", dtp_tmp,
+			dep_cnt - 1);
+		if (!dsp->dsp_cancelling && dep_cnt == 1 &&
 		    dtp_tmp->dtp_running) {
 			bool done;
 
@@ -662,7 +826,7 @@ tse_task_post_process(tse_task_t *task)
 			 */
 			if (!done) {
 				/* -1 for tlink (addref by add_dependent) */
-				tse_task_decref_locked(dtp_tmp);
+				tse_task_priv_decref(dtp_tmp);
 				continue;
 			}
 
@@ -670,7 +834,7 @@ tse_task_post_process(tse_task_t *task)
 		}
 
 		/* -1 for tlink (addref by add_dependent) */
-		tse_task_decref_locked(dtp_tmp);
+		tse_task_priv_decref(dtp_tmp);
 	}
 
 	D_ASSERT(dsp->dsp_inflight > 0);
@@ -759,10 +923,8 @@ tse_sched_progress(tse_sched_t *sched)
 	if (dsp->dsp_cancelling)
 		return;
 
-	D_MUTEX_LOCK(&dsp->dsp_lock);
 	/** +1 for tse_sched_run() */
-	tse_sched_priv_addref_locked(dsp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_priv_addref(dsp);
 
 	if (!dsp->dsp_cancelling)
 		tse_sched_run(sched);
@@ -781,7 +943,7 @@ tse_sched_complete_inflight(struct tse_sched_private *dsp)
 	D_MUTEX_LOCK(&dsp->dsp_lock);
 	d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_running_list,
 				      dtp_list)
-		if (dtp->dtp_dep_cnt == 0) {
+		if (atomic_load_relaxed(&dtp->dtp_dep_cnt) == 0) {
 			d_list_del(&dtp->dtp_list);
 			tse_task_complete_locked(dtp, dsp);
 			processed++;
@@ -813,7 +975,7 @@ tse_sched_complete(tse_sched_t *sched, int ret, bool cancel)
 	/** Wait for all in-flight tasks */
 	while (1) {
 		/** +1 for tse_sched_run */
-		tse_sched_priv_addref_locked(dsp);
+		tse_sched_priv_addref(dsp);
 		D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
 		tse_sched_run(sched);
@@ -854,7 +1016,7 @@ tse_task_complete(tse_task_t *task, int ret)
 		if (done)
 			tse_task_complete_locked(dtp, dsp);
 	} else {
-		tse_task_decref_locked(dtp);
+		tse_task_priv_decref(dtp);
 	}
 	D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
@@ -897,11 +1059,11 @@ tse_task_add_dependent(tse_task_t *task, tse_task_t *dep)
 
 	D_MUTEX_LOCK(&dtp->dtp_sched->dsp_lock);
 
-	tse_task_addref_locked(dtp);
+	tse_task_priv_addref(dtp);
 	tlink->tl_task = task;
 
 	d_list_add_tail(&tlink->tl_link, &dep_dtp->dtp_dep_list);
-	dtp->dtp_dep_cnt++;
+	atomic_fetch_add_relaxed(&dtp->dtp_dep_cnt, 1);
 
 	D_MUTEX_UNLOCK(&dtp->dtp_sched->dsp_lock);
 
@@ -931,7 +1093,7 @@ tse_task_create(tse_task_func_t task_func, tse_sched_t *sched, void *priv,
 	struct tse_task_private	 *dtp;
 	tse_task_t		 *task;
 
-	D_ALLOC_PTR(task);
+	task = tse_task_alloc();
 	if (task == NULL)
 		return -DER_NOMEM;
 
@@ -1008,7 +1170,7 @@ tse_task_schedule_with_delay(tse_task_t *task, bool instant, uint64_t delay)
 
 		/** +1 in case task is completed in body function */
 		if (instant)
-			tse_task_addref_locked(dtp);
+			tse_task_priv_addref(dtp);
 	} else if (delay == 0) {
 		/** Otherwise, scheduler will process it from init list */
 		dtp->dtp_wakeup_time = 0;
@@ -1019,7 +1181,7 @@ tse_task_schedule_with_delay(tse_task_t *task, bool instant, uint64_t delay)
 		tse_task_insert_sleeping(dtp, dsp);
 	}
 	/* decref when remove the task from dsp (tse_sched_process_complete) */
-	tse_sched_priv_addref_locked(dsp);
+	tse_sched_priv_addref(dsp);
 	D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
 	/* if caller wants to run the task instantly, call the task body
@@ -1069,9 +1231,9 @@ tse_task_reinit_with_delay(tse_task_t *task, uint64_t delay)
 	if (dtp->dtp_completed) {
 		D_ASSERT(d_list_empty(&dtp->dtp_list));
 		/* +1 ref for valid until complete */
-		tse_task_addref_locked(dtp);
+		tse_task_priv_addref(dtp);
 		/* +1 dsp ref as will add back to dsp again below */
-		tse_sched_priv_addref_locked(dsp);
+		tse_sched_priv_addref(dsp);
 	} else if (dtp->dtp_running) {
 		/** Task not in-flight anymore */
 		dsp->dsp_inflight--;
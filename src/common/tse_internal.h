@@ -16,6 +16,7 @@
  * Author: Di Wang  <di.wang@intel.com>
  */
 
+#include <gurt/atomic.h>
 #include <daos/tse.h>
 
 struct tse_task_private {
@@ -54,10 +55,9 @@ struct tse_task_private {
 					 */
 					 dtp_completing:1,
 					/* task is in running state */
-					 dtp_running:1,
-					 dtp_dep_cnt:29;
+					 dtp_running:1;
 	/* refcount of the task */
-	uint32_t			 dtp_refcnt;
+	ATOMIC uint32_t			 dtp_refcnt;
 	/**
 	 * task parameter pointer, it can be assigned while creating task,
 	 * or explicitly call API tse_task_priv_set. User can just use
@@ -78,8 +78,14 @@ struct tse_task_private {
 	 * The sum of dtp_stack_top and dtp_embed_top should not exceed
 	 * TSE_TASK_ARG_LEN.
 	 */
-	uint32_t			 dtp_stack_top;
-	uint32_t			 dtp_embed_top;
+	uint16_t			 dtp_stack_top;
+	uint16_t			 dtp_embed_top;
+	/**
+	 * number of tasks this task depends on. It is kept apart from the
+	 * state bits above so that updating it never races with the lockless
+	 * updates of these bits.
+	 */
+	ATOMIC uint32_t			 dtp_dep_cnt;
 	char				 dtp_buf[TSE_TASK_ARG_LEN];
 };
 
@@ -118,7 +124,7 @@ struct tse_sched_private {
 	/* the list for complete callback */
 	d_list_t	dsp_comp_cb_list;
 
-	int		dsp_refcount;
+	ATOMIC int	dsp_refcount;
 
 	/* number of tasks being executed */
 	int		dsp_inflight;
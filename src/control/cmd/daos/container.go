@@ -745,6 +745,7 @@ type containerCloneCmd struct {
 
 	Source      string `long:"src" short:"S" description:"source container" required:"1"`
 	Destination string `long:"dst" short:"D" description:"destination container" required:"1"`
+	Threads     uint32 `long:"threads" description:"number of copy threads (default 8)"`
 }
 
 func (cmd *containerCloneCmd) Execute(_ []string) error {
@@ -764,6 +765,7 @@ func (cmd *containerCloneCmd) Execute(_ []string) error {
 	defer freeString(ap.src)
 	ap.dst = C.CString(cmd.Destination)
 	defer freeString(ap.dst)
+	ap.threads = C.uint32_t(cmd.Threads)
 
 	ap.c_op = C.CONT_CLONE
 	rc := C.cont_clone_hdlr(ap)
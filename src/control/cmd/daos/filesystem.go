@@ -39,8 +39,9 @@ type fsCmd struct {
 type fsCopyCmd struct {
 	daosCmd
 
-	Source string `long:"src" short:"s" description:"copy source" required:"1"`
-	Dest   string `long:"dst" short:"d" description:"copy destination" required:"1"`
+	Source  string `long:"src" short:"s" description:"copy source" required:"1"`
+	Dest    string `long:"dst" short:"d" description:"copy destination" required:"1"`
+	Threads uint32 `long:"threads" description:"number of copy threads (default 8)"`
 }
 
 func (cmd *fsCopyCmd) Execute(_ []string) error {
@@ -54,6 +55,7 @@ func (cmd *fsCopyCmd) Execute(_ []string) error {
 	defer freeString(ap.src)
 	ap.dst = C.CString(cmd.Dest)
 	defer freeString(ap.dst)
+	ap.threads = C.uint32_t(cmd.Threads)
 
 	ap.fs_op = C.FS_COPY
 	rc := C.fs_copy_hdlr(ap)
@@ -274,8 +274,8 @@ dtx_init(void)
 	int	rc;
 
 	rc = dbtree_class_register(DBTREE_CLASS_DTX_CF,
-				   BTR_FEAT_UINT_KEY | BTR_FEAT_DYNAMIC_ROOT,
-				   &dbtree_dtx_cf_ops);
+				   BTR_FEAT_UINT_KEY | BTR_FEAT_DYNAMIC_ROOT |
+				   BTR_FEAT_KEY_SCAN, &dbtree_dtx_cf_ops);
 	if (rc == 0)
 		rc = dbtree_class_register(DBTREE_CLASS_DTX_COS, 0,
 					   &dtx_btr_cos_ops);
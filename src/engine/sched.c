@@ -11,6 +11,7 @@
 #include <daos/common.h>
 #include <daos_errno.h>
 #include <daos_srv/vos.h>
+#include <gurt/trace.h>
 #include "srv_internal.h"
 
 struct sched_req_info {
@@ -561,6 +562,37 @@ req_kickoff_internal(struct dss_xstream *dx, struct sched_req_attr *attr,
 				   0);
 }
 
+/* The wait of the last sample is forgotten after a second without IO */
+#define SCHED_FG_WAIT_AGE	1000	/* msecs */
+
+/* Smooth the queue wait of IO requests, 7/8 of old plus 1/8 of sample */
+static inline void
+fg_wait_sample(struct sched_info *info, struct sched_request *req)
+{
+	uint64_t	wait;
+
+	D_ASSERT(info->si_cur_ts >= req->sr_enqueue_ts);
+	wait = (info->si_cur_ts - req->sr_enqueue_ts) * 1000;
+
+	if (info->si_cur_ts > info->si_fg_wait_ts + SCHED_FG_WAIT_AGE)
+		info->si_fg_wait = wait;
+	else
+		info->si_fg_wait = info->si_fg_wait - info->si_fg_wait / 8 +
+				   wait / 8;
+	info->si_fg_wait_ts = info->si_cur_ts;
+}
+
+uint64_t
+sched_fg_wait_us(void)
+{
+	struct dss_xstream	*dx = dss_current_xstream();
+	struct sched_info	*info = &dx->dx_sched_info;
+
+	if (info->si_cur_ts > info->si_fg_wait_ts + SCHED_FG_WAIT_AGE)
+		return 0;
+	return info->si_fg_wait;
+}
+
 static int
 req_kickoff(struct dss_xstream *dx, struct sched_request *req)
 {
@@ -575,12 +607,17 @@ req_kickoff(struct dss_xstream *dx, struct sched_request *req)
 	} else {
 		rc = req_kickoff_internal(dx, &req->sr_attr, req->sr_func,
 					  req->sr_arg);
+		D_TRACE_END(D_TRACE_SCHED, req->sr_arg, rc);
 	}
 
 	D_ASSERT(spi != NULL);
 	D_ASSERT(req->sr_attr.sra_type < SCHED_REQ_MAX);
 	sri = &spi->spi_req_array[req->sr_attr.sra_type];
 
+	if (req->sr_attr.sra_type == SCHED_REQ_UPDATE ||
+	    req->sr_attr.sra_type == SCHED_REQ_FETCH)
+		fg_wait_sample(info, req);
+
 	D_ASSERT(sri->sri_req_cnt > 0);
 	sri->sri_req_cnt--;
 	D_ASSERT(spi->spi_req_cnt > 0);
@@ -972,6 +1009,7 @@ sched_req_enqueue(struct dss_xstream *dx, struct sched_req_attr *attr,
 		return -DER_NOMEM;
 	}
 	req_enqueue(dx, req);
+	D_TRACE_BEGIN(D_TRACE_SCHED, arg, attr->sra_type);
 
 	return 0;
 }
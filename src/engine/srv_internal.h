@@ -44,6 +44,8 @@ struct sched_info {
 	uint32_t		 si_req_cnt;	/* Total inuse request count */
 	int			 si_sleep_cnt;	/* Sleeping request count */
 	int			 si_wait_cnt;	/* Long wait request count */
+	uint64_t		 si_fg_wait;	/* Smoothed IO queue wait (us) */
+	uint64_t		 si_fg_wait_ts;	/* Last IO queue wait sample (ms) */
 	unsigned int		 si_stop:1;
 };
 
@@ -30,6 +30,9 @@ debug_dump(struct d_slab_type *type)
 		      type->st_no_restock, type->st_no_restock_hwm);
 }
 
+static void
+reclaim_type(struct d_slab_type *type);
+
 /* Create a data slab manager */
 int
 d_slab_init(struct d_slab *slab, void *arg)
@@ -72,8 +75,23 @@ d_slab_destroy(struct d_slab *slab)
 	while ((type = d_list_pop_entry(&slab->slab_list,
 					struct d_slab_type,
 					st_type_list))) {
-		if (type->st_count != 0)
-			D_TRACE_WARN(type, "Freeing type with active objects");
+		bool orphan = false;
+
+		/* Leave the type to the release of its last object, the
+		 * objects released since d_slab_reclaim() are freed first.
+		 */
+		D_MUTEX_LOCK(&type->st_lock);
+		reclaim_type(type);
+		if (type->st_count != 0) {
+			D_TRACE_WARN(type, "Orphaning type with active objects");
+			type->st_orphan = true;
+			type->st_slab = NULL;
+			orphan = true;
+		}
+		D_MUTEX_UNLOCK(&type->st_lock);
+		if (orphan)
+			continue;
+
 		rc = pthread_mutex_destroy(&type->st_lock);
 		if (rc != 0)
 			D_TRACE_ERROR(type, "Failed to destroy lock %d %s",
@@ -144,6 +162,53 @@ restock(struct d_slab_type *type, int count)
 	return reset_calls;
 }
 
+/* Helper function for freeing all the objects not in use of a type.
+ *
+ * This function should be called with the type lock held.
+ */
+static void
+reclaim_type(struct d_slab_type *type)
+{
+	d_list_t *entry, *enext;
+
+	/* Reclaim any pending objects.  Count here just needs to be
+	 * larger than pending_count + free_count however simply
+	 * using count is adequate as is guaranteed to be larger.
+	 */
+	restock(type, type->st_count);
+
+	d_list_for_each_safe(entry, enext, &type->st_free_list) {
+		void *ptr = (void *)entry - type->st_reg.sr_offset;
+
+		if (type->st_reg.sr_release) {
+			type->st_reg.sr_release(ptr);
+			type->st_release_count++;
+		}
+
+		d_list_del(entry);
+		D_FREE(ptr);
+		type->st_free_count--;
+		type->st_count--;
+	}
+
+	/* restock() stops at max_free_desc, free the rest directly so
+	 * that only the objects in use are left.
+	 */
+	d_list_for_each_safe(entry, enext, &type->st_pending_list) {
+		void *ptr = (void *)entry - type->st_reg.sr_offset;
+
+		if (type->st_reg.sr_release) {
+			type->st_reg.sr_release(ptr);
+			type->st_release_count++;
+		}
+
+		d_list_del(entry);
+		D_FREE(ptr);
+		type->st_pending_count--;
+		type->st_count--;
+	}
+}
+
 /* Reclaim any memory possible across all types
  *
  * Returns true of there are any descriptors in use.
@@ -157,31 +222,10 @@ d_slab_reclaim(struct d_slab *slab)
 
 	D_MUTEX_LOCK(&slab->slab_lock);
 	d_list_for_each_entry(type, &slab->slab_list, st_type_list) {
-		d_list_t *entry, *enext;
-
 		D_TRACE_DEBUG(DB_ANY, type, "Resetting type");
 
 		D_MUTEX_LOCK(&type->st_lock);
-
-		/* Reclaim any pending objects.  Count here just needs to be
-		 * larger than pending_count + free_count however simply
-		 * using count is adequate as is guaranteed to be larger.
-		 */
-		restock(type, type->st_count);
-
-		d_list_for_each_safe(entry, enext, &type->st_free_list) {
-			void *ptr = (void *)entry - type->st_reg.sr_offset;
-
-			if (type->st_reg.sr_release) {
-				type->st_reg.sr_release(ptr);
-				type->st_release_count++;
-			}
-
-			d_list_del(entry);
-			D_FREE(ptr);
-			type->st_free_count--;
-			type->st_count--;
-		}
+		reclaim_type(type);
 		D_TRACE_DEBUG(DB_ANY, type, "%d in use", type->st_count);
 		if (type->st_count) {
 			D_TRACE_INFO(type,
@@ -361,17 +405,58 @@ d_slab_acquire(struct d_slab_type *type)
  * This is sometimes on the critical path, sometimes not so assume that
  * for all cases it is.
  *
+ * The object is made available again under the type lock, as the type can
+ * be reclaimed and freed by d_slab_destroy() as soon as the lock is dropped.
+ * Only the objects that were already created are recycled here, new ones are
+ * left to d_slab_restock().
  */
 void
 d_slab_release(struct d_slab_type *type, void *ptr)
 {
 	d_list_t *entry = ptr + type->st_reg.sr_offset;
+	void (*release_cb)(void *) = type->st_reg.sr_release;
+	bool drop = false;
+	bool last = false;
 
 	D_TRACE_DOWN(DB_ANY, ptr);
 	D_MUTEX_LOCK(&type->st_lock);
-	type->st_pending_count++;
-	d_list_add_tail(entry, &type->st_pending_list);
+	/* Free the object rather than keep more than max_free_desc of them
+	 * for reuse, or any of them once the type is orphaned.
+	 */
+	if (type->st_orphan) {
+		type->st_count--;
+		last = (type->st_count == 0);
+		drop = true;
+	} else if (type->st_reg.sr_max_free_desc != 0 &&
+		   type->st_free_count + type->st_pending_count >=
+		   type->st_reg.sr_max_free_desc) {
+		type->st_count--;
+		if (release_cb)
+			type->st_release_count++;
+		drop = true;
+	} else {
+		type->st_pending_count++;
+		d_list_add_tail(entry, &type->st_pending_list);
+
+		if (type->st_no_restock > type->st_no_restock_hwm)
+			type->st_no_restock_hwm = type->st_no_restock;
+		type->st_no_restock = 0;
+		restock(type, type->st_no_restock_hwm + 1);
+	}
 	D_MUTEX_UNLOCK(&type->st_lock);
+
+	if (drop) {
+		if (release_cb)
+			release_cb(ptr);
+		D_FREE(ptr);
+	}
+
+	if (last) {
+		D_TRACE_DEBUG(DB_ANY, type, "Freeing orphaned type");
+		D_MUTEX_DESTROY(&type->st_lock);
+		D_TRACE_DOWN(DB_ANY, type);
+		D_FREE(type);
+	}
 }
 
 /* Re-stock an object type.
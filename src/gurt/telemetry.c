@@ -1484,6 +1484,54 @@ d_tm_compute_stats(struct d_tm_node_t *node, uint64_t value)
 		dtm_stats->dtm_min = value;
 }
 
+/**
+ * Find the histogram bucket for \a value.
+ *
+ * Bucket i of a histogram with initial width w and multiplier m starts at
+ * w * i when m is 1, and at w * (m^i - 1) / (m - 1) otherwise. With q the
+ * quotient value / w, the index is then q for linear histograms and
+ * log_m(q * (m - 1) + 1) for geometric ones, which is a log2 when m is a
+ * power of two. Other multipliers fall back to a binary search of the
+ * bucket maxima.
+ *
+ * \param[in]	histogram	Histogram of a duration or gauge
+ * \param[in]	value		The value to sort into a bucket
+ *
+ * \return			Index of the bucket
+ */
+static int
+histogram_bucket(struct d_tm_histogram_t *histogram, uint64_t value)
+{
+	uint64_t	q = value / histogram->dth_initial_width;
+	uint64_t	m = histogram->dth_value_multiplier;
+	int		last = histogram->dth_num_buckets - 1;
+	int		lo;
+	int		hi;
+	int		i;
+
+	if (m == 1)
+		return q < last ? q : last;
+
+	if ((m & (m - 1)) == 0) {
+		if (q > (UINT64_MAX - 1) / (m - 1))
+			return last;
+		i = (63 - __builtin_clzll(q * (m - 1) + 1)) /
+		    __builtin_ctzll(m);
+		return i < last ? i : last;
+	}
+
+	lo = 0;
+	hi = last;
+	while (lo < hi) {
+		i = (lo + hi) / 2;
+		if (value <= histogram->dth_buckets[i].dtb_max)
+			hi = i;
+		else
+			lo = i + 1;
+	}
+	return lo;
+}
+
 /**
  * Computes the histogram for this metric by finding the bucket that corresponds
  * to the \a value given, and increments the counter for that bucket.
@@ -1496,20 +1544,14 @@ d_tm_compute_histogram(struct d_tm_node_t *node, uint64_t value)
 {
 	struct d_tm_histogram_t	*dtm_histogram;
 	struct d_tm_node_t	*bucket;
-	int			i;
 
 	if (!node || !node->dtn_metric || !node->dtn_metric->dtm_histogram)
 		return;
 
 	dtm_histogram = node->dtn_metric->dtm_histogram;
-
-	for (i = 0; i < dtm_histogram->dth_num_buckets; i++) {
-		if (value <= dtm_histogram->dth_buckets[i].dtb_max) {
-			bucket = dtm_histogram->dth_buckets[i].dtb_bucket;
-			d_tm_inc_counter(bucket, 1);
-			break;
-		}
-	}
+	bucket = dtm_histogram->dth_buckets[histogram_bucket(dtm_histogram,
+							     value)].dtb_bucket;
+	d_tm_inc_counter(bucket, 1);
 }
 
 static void
@@ -1542,9 +1584,12 @@ d_tm_set_counter(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
-	d_tm_node_lock(metric);
-	metric->dtn_metric->dtm_data.value = value;
-	d_tm_node_unlock(metric);
+	/** counters are a single word, no need for the node lock */
+	if (unlikely(metric->dtn_protect))
+		__atomic_store_n(&metric->dtn_metric->dtm_data.value, value,
+				 __ATOMIC_RELAXED);
+	else
+		metric->dtn_metric->dtm_data.value = value;
 }
 
 /**
@@ -1566,9 +1611,11 @@ d_tm_inc_counter(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
-	d_tm_node_lock(metric);
-	metric->dtn_metric->dtm_data.value += value;
-	d_tm_node_unlock(metric);
+	if (unlikely(metric->dtn_protect))
+		__atomic_fetch_add(&metric->dtn_metric->dtm_data.value, value,
+				   __ATOMIC_RELAXED);
+	else
+		metric->dtn_metric->dtm_data.value += value;
 }
 
 /**
@@ -2792,15 +2839,11 @@ d_tm_get_counter(struct d_tm_context *ctx, uint64_t *val,
 		return -DER_OP_NOT_PERMITTED;
 
 	metric_data = conv_ptr(shmem, node->dtn_metric);
-	if (metric_data != NULL) {
-		if (node->dtn_protect)
-			D_MUTEX_LOCK(&node->dtn_lock);
-		*val = metric_data->dtm_data.value;
-		if (node->dtn_protect)
-			D_MUTEX_UNLOCK(&node->dtn_lock);
-	} else {
+	if (metric_data == NULL)
 		return -DER_METRIC_NOT_FOUND;
-	}
+
+	/** counters are updated atomically by the producer */
+	*val = __atomic_load_n(&metric_data->dtm_data.value, __ATOMIC_RELAXED);
 	return DER_SUCCESS;
 }
 
@@ -21,6 +21,7 @@
 #include <gurt/dlog.h>
 #include <gurt/hash.h>
 #include <gurt/atomic.h>
+#include <gurt/slab.h>
 
 /* machine epsilon */
 #define EPSILON (1.0E-16)
@@ -2117,6 +2118,114 @@ test_hash_perf(void **state)
 		hash_perf(HASH_JCH, 1 << i, el << i);
 }
 
+#define TEST_SLAB_NR		16
+#define TEST_SLAB_MAX_FREE	4
+
+struct test_slab_entry {
+	d_list_t	tse_link;
+	int		tse_val;
+	char		tse_buf[60];
+};
+
+static bool
+test_slab_reset(void *arg)
+{
+	struct test_slab_entry *entry = arg;
+
+	memset(entry, 0, sizeof(*entry));
+	return true;
+}
+
+static void
+test_gurt_slab(void **state)
+{
+	struct d_slab		 slab;
+	struct d_slab_type	*type;
+	struct d_slab_type	*type_max;
+	struct d_slab_reg	 reg = {
+		POOL_TYPE_INIT(test_slab_entry, tse_link)
+		.sr_reset		= test_slab_reset,
+		.sr_max_free_desc	= TEST_SLAB_MAX_FREE,
+	};
+	struct d_slab_reg	 reg_max = {
+		POOL_TYPE_INIT(test_slab_entry, tse_link)
+		.sr_max_desc		= TEST_SLAB_MAX_FREE,
+	};
+	struct test_slab_entry	*entries[TEST_SLAB_NR];
+	struct test_slab_entry	*reused[TEST_SLAB_MAX_FREE];
+	struct test_slab_entry	*entry;
+	char			 zero[sizeof(entry->tse_buf)] = {0};
+	int			 i;
+	int			 rc;
+
+	rc = d_slab_init(&slab, NULL);
+	assert_int_equal(rc, 0);
+
+	type = d_slab_register(&slab, &reg);
+	assert_non_null(type);
+
+	for (i = 0; i < TEST_SLAB_NR; i++) {
+		entries[i] = d_slab_acquire(type);
+		assert_non_null(entries[i]);
+		entries[i]->tse_val = i + 1;
+		memset(entries[i]->tse_buf, 0xff, sizeof(entries[i]->tse_buf));
+	}
+	assert_int_equal(type->st_count, TEST_SLAB_NR);
+
+	/* Only max_free_desc of the released entries are kept, and they are
+	 * ready for reuse straight away.
+	 */
+	for (i = 0; i < TEST_SLAB_NR; i++)
+		d_slab_release(type, entries[i]);
+	assert_int_equal(type->st_count, TEST_SLAB_MAX_FREE);
+	assert_int_equal(type->st_free_count, TEST_SLAB_MAX_FREE);
+	assert_int_equal(type->st_pending_count, 0);
+
+	/* Restocking does not grow the free list beyond it either */
+	d_slab_restock(type);
+	assert_int_equal(type->st_count, TEST_SLAB_MAX_FREE);
+	assert_int_equal(type->st_free_count, TEST_SLAB_MAX_FREE);
+
+	/* The reused entries are one of the kept ones, reset to zero */
+	for (i = 0; i < TEST_SLAB_MAX_FREE; i++) {
+		entry = d_slab_acquire(type);
+		assert_non_null(entry);
+		assert_true(entry == entries[0] || entry == entries[1] ||
+			    entry == entries[2] || entry == entries[3]);
+		assert_int_equal(entry->tse_val, 0);
+		assert_memory_equal(entry->tse_buf, zero, sizeof(zero));
+		reused[i] = entry;
+	}
+	assert_int_equal(type->st_count, TEST_SLAB_MAX_FREE);
+	assert_int_equal(type->st_free_count, 0);
+
+	for (i = 1; i < TEST_SLAB_MAX_FREE; i++)
+		d_slab_release(type, reused[i]);
+
+	/* No more than max_desc entries exist at once */
+	type_max = d_slab_register(&slab, &reg_max);
+	assert_non_null(type_max);
+	for (i = 0; i < TEST_SLAB_MAX_FREE; i++) {
+		entries[i] = d_slab_acquire(type_max);
+		assert_non_null(entries[i]);
+	}
+	assert_null(d_slab_acquire(type_max));
+	d_slab_release(type_max, entries[0]);
+	entry = d_slab_acquire(type_max);
+	assert_true(entry == entries[0]);
+	for (i = 0; i < TEST_SLAB_MAX_FREE; i++)
+		d_slab_release(type_max, entries[i]);
+	assert_int_equal(type_max->st_count, TEST_SLAB_MAX_FREE);
+
+	/* Destroying the manager with an entry in use orphans its type, which
+	 * is then freed by the release of the entry.
+	 */
+	d_slab_destroy(&slab);
+	assert_true(type->st_orphan);
+	assert_int_equal(type->st_count, 1);
+	d_slab_release(type, reused[0]);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -2139,6 +2248,7 @@ main(int argc, char **argv)
 		cmocka_unit_test(test_gurt_atomic),
 		cmocka_unit_test(test_gurt_string_buffer),
 		cmocka_unit_test(test_hash_perf),
+		cmocka_unit_test(test_gurt_slab),
 	};
 
 	d_register_alt_assert(mock_assert);
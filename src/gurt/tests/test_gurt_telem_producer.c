@@ -622,6 +622,45 @@ test_gauge_with_histogram_multiplier_2(void **state)
 	check_histogram_metadata(path);
 }
 
+static void
+test_gauge_with_histogram_bucket_edges(void **state)
+{
+	struct d_tm_node_t	*gauge;
+	struct d_tm_bucket_t	bucket;
+	int			multipliers[] = { 3, 4 };
+	int			num_buckets = 6;
+	int			rc;
+	int			i;
+	int			j;
+	char			path[D_TM_MAX_NAME_LEN];
+
+	for (i = 0; i < ARRAY_SIZE(multipliers); i++) {
+		snprintf(path, sizeof(path), "gurt/tests/telem/test_gauge_m%d",
+			 multipliers[i]);
+
+		rc = d_tm_add_metric(&gauge, D_TM_STATS_GAUGE,
+				     "A gauge with a geometric histogram",
+				     D_TM_BYTE, path);
+		assert_rc_equal(rc, DER_SUCCESS);
+
+		rc = d_tm_init_histogram(gauge, path, num_buckets, 10,
+					 multipliers[i]);
+		assert_rc_equal(rc, DER_SUCCESS);
+
+		/* each bucket gets its first and last value */
+		for (j = 0; j < num_buckets; j++) {
+			rc = d_tm_get_bucket_range(cli_ctx, &bucket, j,
+						   srv_to_cli_node(gauge));
+			assert_rc_equal(rc, DER_SUCCESS);
+			d_tm_set_gauge(gauge, bucket.dtb_min);
+			d_tm_set_gauge(gauge, bucket.dtb_max);
+		}
+
+		for (j = 0; j < num_buckets; j++)
+			check_bucket_counter(path, j, 2);
+	}
+}
+
 static void
 test_units(void **state)
 {
@@ -1136,9 +1175,9 @@ test_verify_object_count(void **state)
 {
 	struct d_tm_node_t	*node;
 	int			num;
-	int			exp_num_ctr = 20;
+	int			exp_num_ctr = 32;
 	int			exp_num_gauge = 3;
-	int			exp_num_gauge_stats = 3;
+	int			exp_num_gauge_stats = 5;
 	int			exp_num_dur = 2;
 	int			exp_num_timestamp = 2;
 	int			exp_num_snap = 2;
@@ -1262,6 +1301,7 @@ main(int argc, char **argv)
 		cmocka_unit_test(test_duration_stats),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_1),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_2),
+		cmocka_unit_test(test_gauge_with_histogram_bucket_edges),
 		cmocka_unit_test(test_units),
 		cmocka_unit_test(test_ephemeral_simple),
 		cmocka_unit_test(test_ephemeral_nested),
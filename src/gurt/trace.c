@@ -0,0 +1,259 @@
+/*
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of gurt, it implements the binary trace ring.
+ *
+ * The segment is a header followed by D_TRACE_MAX_RINGS rings, a thread takes
+ * the next free ring on its first event and is the only writer of it. The
+ * writer stores the record then publishes it by bumping the ring head with
+ * release semantics, the reader copies a ring between two reads of the head
+ * and drops the records that may have been overwritten meanwhile.
+ *
+ * Writers count themselves in one of a few padded slots while they touch the
+ * segment, d_trace_fini() turns recording off and waits for the counts to
+ * drop to zero before unmapping it.
+ */
+#define D_LOGFAC	DD_FAC(misc)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <gurt/common.h>
+#include <gurt/trace.h>
+
+struct d_trace_hdr		*d_trace_hdr;
+
+static pthread_mutex_t		 d_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static int			 d_trace_refcount;
+static uint64_t			 d_trace_size;
+/** writers may use the segment, cleared before it is unmapped */
+static bool			 d_trace_active;
+/** bumped each time a segment is created */
+static uint32_t			 d_trace_gen;
+
+#define D_TRACE_WRITER_SLOTS	16
+
+/** number of writers using the segment, spread to avoid false sharing */
+static struct {
+	uint32_t	tw_nr;
+} __attribute__((aligned(64))) d_trace_writers[D_TRACE_WRITER_SLOTS];
+
+/** ring of the calling thread and the generation of its segment */
+static __thread struct d_trace_ring	*d_trace_self;
+static __thread uint32_t		 d_trace_self_gen;
+static __thread int			 d_trace_self_slot = -1;
+
+static void
+trace_shm_name(char *name, size_t len)
+{
+	snprintf(name, len, D_TRACE_SHM_FMT, getpid());
+}
+
+static int
+trace_shm_create(uint32_t ring_size)
+{
+	struct d_trace_hdr	*hdr;
+	char			 name[64];
+	uint64_t		 size;
+	int			 fd;
+	int			 rc;
+
+	size = sizeof(*hdr) + D_TRACE_MAX_RINGS * d_trace_ring_bytes(ring_size);
+
+	trace_shm_name(name, sizeof(name));
+	fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) {
+		rc = d_errno2der(errno);
+		D_ERROR("Failed to create trace segment %s: "DF_RC"\n", name,
+			DP_RC(rc));
+		return rc;
+	}
+
+	/* tmpfs only allocates the pages of the rings which are written */
+	if (ftruncate(fd, size) != 0) {
+		rc = d_errno2der(errno);
+		D_ERROR("Failed to size trace segment %s: "DF_RC"\n", name,
+			DP_RC(rc));
+		goto failed;
+	}
+
+	hdr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (hdr == MAP_FAILED) {
+		rc = d_errno2der(errno);
+		D_ERROR("Failed to map trace segment %s: "DF_RC"\n", name,
+			DP_RC(rc));
+		goto failed;
+	}
+	close(fd);
+
+	hdr->th_version = D_TRACE_VERSION;
+	hdr->th_nr_rings = D_TRACE_MAX_RINGS;
+	hdr->th_ring_size = ring_size;
+	hdr->th_rings_used = 0;
+	hdr->th_enabled = 1;
+	/* the magic tells the reader the header is complete */
+	__atomic_store_n(&hdr->th_magic, D_TRACE_MAGIC, __ATOMIC_RELEASE);
+
+	d_trace_size = size;
+	__atomic_add_fetch(&d_trace_gen, 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&d_trace_hdr, hdr, __ATOMIC_RELEASE);
+	__atomic_store_n(&d_trace_active, true, __ATOMIC_SEQ_CST);
+
+	D_INFO("Trace ring enabled, %u records per ring in %s\n", ring_size,
+	       name);
+	return 0;
+
+failed:
+	close(fd);
+	shm_unlink(name);
+	return rc;
+}
+
+/*
+ * The reference is taken even on failure, so that the caller can carry on
+ * without tracing and still call d_trace_fini().
+ */
+int
+d_trace_init(void)
+{
+	char		*env;
+	uint64_t	 nr;
+	int		 rc = 0;
+
+	D_MUTEX_LOCK(&d_trace_lock);
+	if (d_trace_refcount++ > 0)
+		goto out;
+
+	env = getenv(D_TRACE_RING_ENV);
+	if (env == NULL || *env == '\0')
+		goto out;
+
+	nr = strtoull(env, NULL, 0);
+	if (nr == 0)
+		goto out;
+
+	if (nr < D_TRACE_MIN_RECS)
+		nr = D_TRACE_MIN_RECS;
+	if (nr > (1U << 31)) {
+		D_ERROR("%s=%s is too large\n", D_TRACE_RING_ENV, env);
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+	/* round up to a power of two */
+	nr = 1ULL << (64 - __builtin_clzll(nr - 1));
+
+	rc = trace_shm_create(nr);
+out:
+	D_MUTEX_UNLOCK(&d_trace_lock);
+	return rc;
+}
+
+void
+d_trace_fini(void)
+{
+	struct d_trace_hdr	*hdr;
+	char			 name[64];
+	int			 i;
+
+	D_MUTEX_LOCK(&d_trace_lock);
+	D_ASSERT(d_trace_refcount > 0);
+	if (--d_trace_refcount > 0 || d_trace_hdr == NULL)
+		goto out;
+
+	/*
+	 * Writers check the flag after counting themselves in, so once it is
+	 * cleared and the counts are zero nobody can touch the segment.
+	 */
+	__atomic_store_n(&d_trace_active, false, __ATOMIC_SEQ_CST);
+	for (i = 0; i < D_TRACE_WRITER_SLOTS; i++) {
+		while (__atomic_load_n(&d_trace_writers[i].tw_nr,
+				       __ATOMIC_ACQUIRE) != 0)
+			sched_yield();
+	}
+
+	hdr = d_trace_hdr;
+	__atomic_store_n(&d_trace_hdr, NULL, __ATOMIC_RELEASE);
+	munmap(hdr, d_trace_size);
+
+	trace_shm_name(name, sizeof(name));
+	shm_unlink(name);
+out:
+	D_MUTEX_UNLOCK(&d_trace_lock);
+}
+
+static struct d_trace_ring *
+trace_ring_self(struct d_trace_hdr *hdr)
+{
+	struct d_trace_ring	*ring;
+	uint32_t		 idx;
+	uint32_t		 gen;
+
+	gen = __atomic_load_n(&d_trace_gen, __ATOMIC_ACQUIRE);
+
+	if (likely(d_trace_self_gen == gen))
+		return d_trace_self;
+
+	d_trace_self_gen = gen;
+	d_trace_self = NULL;
+
+	idx = __atomic_fetch_add(&hdr->th_rings_used, 1, __ATOMIC_RELAXED);
+	if (idx >= hdr->th_nr_rings) {
+		D_WARN("All %u trace rings are in use, thread not traced\n",
+		       hdr->th_nr_rings);
+		return NULL;
+	}
+
+	ring = d_trace_ring_at(hdr, idx);
+	ring->trr_tid = (uint32_t)syscall(SYS_gettid);
+	d_trace_self = ring;
+	return ring;
+}
+
+void
+d_trace_record(enum d_trace_stage stage, bool end, uint64_t tag, uint32_t arg)
+{
+	struct d_trace_hdr	*hdr;
+	struct d_trace_ring	*ring;
+	struct d_trace_rec	*rec;
+	struct timespec		 now;
+	uint64_t		 head;
+	int			 slot;
+
+	if (!__atomic_load_n(&d_trace_active, __ATOMIC_RELAXED))
+		return;
+
+	slot = d_trace_self_slot;
+	if (unlikely(slot < 0)) {
+		slot = syscall(SYS_gettid) % D_TRACE_WRITER_SLOTS;
+		d_trace_self_slot = slot;
+	}
+
+	__atomic_fetch_add(&d_trace_writers[slot].tw_nr, 1, __ATOMIC_SEQ_CST);
+	if (!__atomic_load_n(&d_trace_active, __ATOMIC_SEQ_CST))
+		goto out;
+
+	hdr = __atomic_load_n(&d_trace_hdr, __ATOMIC_ACQUIRE);
+	if (hdr == NULL || !__atomic_load_n(&hdr->th_enabled, __ATOMIC_RELAXED))
+		goto out;
+
+	ring = trace_ring_self(hdr);
+	if (ring == NULL)
+		goto out;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	head = ring->trr_head;
+	rec = &ring->trr_recs[head & (hdr->th_ring_size - 1)];
+	rec->tr_time = now.tv_sec * 1000000000ULL + now.tv_nsec;
+	rec->tr_tag = tag;
+	rec->tr_arg = arg;
+	rec->tr_stage = stage;
+	rec->tr_end = end;
+	__atomic_store_n(&ring->trr_head, head + 1, __ATOMIC_RELEASE);
+out:
+	__atomic_fetch_sub(&d_trace_writers[slot].tw_nr, 1, __ATOMIC_RELEASE);
+}
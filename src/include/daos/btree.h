@@ -484,6 +484,12 @@ enum btr_feats {
 	BTR_FEAT_DYNAMIC_ROOT		= (1 << 2),
 	/** Skip rebalance leaf when delete some record from the leaf. */
 	BTR_FEAT_SKIP_LEAF_REBAL	= (1 << 3),
+	/** Search integer keys of a node by a vectorized scan without calling
+	 *  any key callback.  It only takes effect on BTR_FEAT_UINT_KEY trees.
+	 *  This bit is set for a tree class, it is never stored in the tree
+	 *  root because node layout is the same as the binary search.
+	 */
+	BTR_FEAT_KEY_SCAN		= (1 << 4),
 };
 
 /**
@@ -535,6 +541,8 @@ int  dbtree_fetch(daos_handle_t toh, dbtree_probe_opc_t opc, uint32_t intent,
 		  d_iov_t *key, d_iov_t *key_out, d_iov_t *val_out);
 int  dbtree_upsert(daos_handle_t toh, dbtree_probe_opc_t opc, uint32_t intent,
 		   d_iov_t *key, d_iov_t *val);
+int  dbtree_upsert_bulk(daos_handle_t toh, uint32_t intent, d_iov_t *keys,
+			d_iov_t *vals, unsigned int nr, unsigned int fill);
 int  dbtree_delete(daos_handle_t toh, dbtree_probe_opc_t opc,
 		   d_iov_t *key, void *args);
 int  dbtree_query(daos_handle_t toh, struct btr_attr *attr,
@@ -61,11 +61,38 @@ struct daos_llink_ops {
 	void	 (*lop_print_key)(void *key, unsigned int ksize);
 };
 
+/** Replacement policy of the LRU cache */
+enum daos_lru_policy {
+	/**
+	 * Flush all idle items once the cache is over capacity, this is
+	 * cheap but the hit rate collapses when the working set is larger
+	 * than the cache.
+	 */
+	DAOS_LRU_POLICY_FLUSH	= 0,
+	/**
+	 * Scan resistant 2Q: new items are admitted to a FIFO probation
+	 * queue (A1in), items referenced again after being evicted from it
+	 * (remembered by the A1out ghost list) are promoted to the main LRU
+	 * queue (Am). Idle items are evicted one by one from the queue tails.
+	 */
+	DAOS_LRU_POLICY_2Q,
+};
+
+/** Queue of a 2Q cache item */
+enum {
+	DAOS_LRU_Q_NONE		= 0,
+	DAOS_LRU_Q_A1IN,
+	DAOS_LRU_Q_AM,
+};
+
 struct daos_llink {
 	d_list_t		 ll_link;	/**< LRU hash link */
 	d_list_t		 ll_qlink;	/**< Temp link for traverse */
+	d_list_t		 ll_lru;	/**< 2Q queue link */
 	uint32_t		 ll_ref;	/**< refcount for this ref */
-	uint32_t		 ll_evicted:1;	/**< has been evicted */
+	uint32_t		 ll_evicted:1,	/**< has been evicted */
+				 ll_queue:2;	/**< 2Q queue, DAOS_LRU_Q_* */
+	uint32_t		 ll_fprint;	/**< 2Q key fingerprint */
 	struct daos_llink_ops	*ll_ops;	/**< ops to maintain refs */
 };
 
@@ -77,6 +104,26 @@ struct daos_lru_cache {
 	uint32_t		 dlc_count;	/**< count of refs in cache */
 	struct d_hash_table	 dlc_htable;	/**< Hash table for all refs */
 	struct daos_llink_ops	*dlc_ops;	/**< ops to maintain refs */
+	enum daos_lru_policy	 dlc_policy;	/**< replacement policy */
+	/** 2Q probation FIFO, the most recently admitted item at head */
+	d_list_t		 dlc_a1in;
+	/** 2Q main LRU, the most recently used item at head */
+	d_list_t		 dlc_am;
+	/** number of items in A1in */
+	uint32_t		 dlc_a1in_cnt;
+	/** max number of items in A1in before it is preferred for eviction */
+	uint32_t		 dlc_a1in_max;
+	/**
+	 * 2Q A1out ghost list, it is direct mapped by the fingerprint of
+	 * evicted keys, so it is approximate but costs only 4 bytes per slot.
+	 */
+	uint32_t		*dlc_ghosts;
+	/** mask of the ghost slot index */
+	uint32_t		 dlc_ghost_mask;
+	/** lookup and eviction statistics */
+	uint64_t		 dlc_hits;
+	uint64_t		 dlc_misses;
+	uint64_t		 dlc_evicts;
 };
 
 /**
@@ -95,6 +142,23 @@ daos_lru_cache_create(int bits, uint32_t feats,
 		      struct daos_llink_ops *ops,
 		      struct daos_lru_cache **lcache);
 
+/**
+ * Create a DAOS LRU cache with the specified capacity and replacement policy.
+ *
+ * \param[in]  csize		Max number of cached items, 0 to disable caching
+ * \param[in]  feats		Feature bits for DHASH, see DHASH_FT_*
+ * \param[in]  policy		Replacement policy, see daos_lru_policy
+ * \param[in]  ops		DAOS LRU callbacks
+ * \param[out] lcache		Newly created LRU cache
+ *
+ * \return		0 on success and negative on failure.
+ */
+int
+daos_lru_cache_create_policy(uint32_t csize, uint32_t feats,
+			     enum daos_lru_policy policy,
+			     struct daos_llink_ops *ops,
+			     struct daos_lru_cache **lcache);
+
 /**
  * Destroy an LRU cache
  * This function destroys and LRU cache
@@ -100,6 +100,9 @@ struct daos_task_args {
 		daos_kv_put_t		kv_put;
 		daos_kv_remove_t	kv_remove;
 		daos_kv_list_t		kv_list;
+		daos_kv_get_multi_t	kv_get_multi;
+		daos_kv_put_multi_t	kv_put_multi;
+		daos_kv_remove_multi_t	kv_remove_multi;
 	}		 ta_u;
 	daos_event_t	*ta_ev;
 };
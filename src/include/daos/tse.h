@@ -355,6 +355,15 @@ tse_task_addref(tse_task_t *task);
 void
 tse_task_decref(tse_task_t *task);
 
+/**
+ * Free the tasks kept for reuse by all threads, and delete the thread key of
+ * their caches. Released tasks are cached per thread and freed on thread
+ * exit, this must be called before the library is unloaded and while no
+ * other thread uses tasks.
+ */
+void
+tse_task_cache_fini(void);
+
 /**
  * Add a newly created task to a list. It returns error if the task is already
  * running or completed.
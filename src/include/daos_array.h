@@ -148,7 +148,10 @@ daos_array_create(daos_handle_t coh, daos_obj_id_t oid, daos_handle_t th,
  *			be set to DAOS_OF_KV_FLAT | DAOS_OF_DKEY_UINT64 |
  *			DAOS_OF_ARRAY.
  * \param[in]	th	Transaction handle.
- * \param[in]	mode	Open mode: DAOS_OO_RO/RW
+ * \param[in]	mode	Open mode: DAOS_OO_RO/RW/EXCL. With DAOS_OO_EXCL the
+ *			caller guarantees that no other handle modifies the
+ *			array, its size is then kept on the client and
+ *			daos_array_get_size() is mostly served locally.
  * \param[out]	cell_size
  *			Record size of the array.
  * \param[out]	chunk_size
@@ -183,7 +186,10 @@ daos_array_open(daos_handle_t coh, daos_obj_id_t oid, daos_handle_t th,
  * \param[in]	oid	Object ID. It is required that the feat for dkey type
  *			be set to DAOS_OF_DKEY_UINT64 | DAOS_OF_KV_FLAT.
  * \param[in]	th	Transaction handle.
- * \param[in]	mode	Open mode: DAOS_OO_RO/RW
+ * \param[in]	mode	Open mode: DAOS_OO_RO/RW/EXCL. With DAOS_OO_EXCL the
+ *			caller guarantees that no other handle modifies the
+ *			array, its size is then kept on the client and
+ *			daos_array_get_size() is mostly served locally.
  * \param[in]	cell_size
  *			Record size of the array.
  * \param[in]	chunk_size
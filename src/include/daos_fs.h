@@ -446,6 +446,39 @@ int
 dfs_readdir(dfs_t *dfs, dfs_obj_t *obj, daos_anchor_t *anchor,
 	    uint32_t *nr, struct dirent *dirs);
 
+/**
+ * directory readdir with the attributes of every entry.  Same as dfs_readdir
+ * but the entries of the batch are also looked up and stat'ed, with their
+ * inode entries and file sizes fetched concurrently rather than one lookup
+ * and one stat call per entry.  Entries removed concurrently are skipped.
+ * Without \a stbufs, only the objects are returned, \a objs is then required,
+ * and the file sizes are not fetched.
+ *
+ * \param[in]	dfs	Pointer to the mounted file system.
+ * \param[in]	obj	Opened directory object.
+ * \param[in,out]
+ *		anchor	Hash anchor for the next call, it should be set to
+ *			zeroes for the first call, it should not be changed
+ *			by caller between calls.
+ * \param[in,out]
+ *		nr	[in]: number of entries allocated in \a dirs, \a stbufs
+ *			and \a objs.
+ *			[out]: number of returned entries.
+ * \param[in,out]
+ *		dirs	[in] preallocated array of dirents.
+ *			[out]: dirents returned with d_name filled only.
+ * \param[out]	stbufs	Optional array of stat structs for the entries.
+ * \param[out]	objs	Optional array of objects for the entries, opened
+ *			read only as dfs_lookup_rel() with O_NOFOLLOW would.
+ *			Must be released with dfs_release().
+ *
+ * \return		0 on success, errno code on failure.
+ */
+int
+dfs_readdirplus(dfs_t *dfs, dfs_obj_t *obj, daos_anchor_t *anchor,
+		uint32_t *nr, struct dirent *dirs, struct stat *stbufs,
+		dfs_obj_t **objs);
+
 /**
  * User callback defined for dfs_readdir_size.
  */
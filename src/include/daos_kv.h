@@ -197,6 +197,100 @@ daos_kv_list(daos_handle_t oh, daos_handle_t th, uint32_t *nr,
 	     daos_key_desc_t *kds, d_sg_list_t *sgl, daos_anchor_t *anchor,
 	     daos_event_t *ev);
 
+/**
+ * Insert or update several KV pairs at once. This is equivalent to calling
+ * daos_kv_put() for each key but all the updates are issued concurrently
+ * under a single operation, which completes once all of them have.
+ *
+ * \param[in]	oh	Object open handle.
+ * \param[in]	th	Transaction handle.
+ * \param[in]	flags	Update flags, applied to every key.
+ * \param[in]	nr	Number of keys.
+ * \param[in]	keys	Array of \a nr keys.
+ * \param[in]	buf_sizes
+ *			Array of \a nr value sizes.
+ * \param[in]	bufs	Array of \a nr value buffers.
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode, the first error encountered is
+ *			returned if several updates fail:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_INVAL	Invalid parameter
+ *			-DER_NO_PERM	Permission denied
+ *			-DER_UNREACH	Network is unreachable
+ *			-DER_EP_RO	Epoch is read-only
+ */
+int
+daos_kv_put_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags,
+		  unsigned int nr, const char *const keys[],
+		  const daos_size_t buf_sizes[], const void *const bufs[],
+		  daos_event_t *ev);
+
+/**
+ * Fetch the values of several keys at once. This is equivalent to calling
+ * daos_kv_get() for each key but all the fetches are issued concurrently
+ * under a single operation, which completes once all of them have.
+ *
+ * \param[in]	oh	Object open handle.
+ * \param[in]	th	Transaction handle.
+ * \param[in]	flags	Fetch flags, applied to every key.
+ * \param[in]	nr	Number of keys.
+ * \param[in]	keys	Array of \a nr keys.
+ * \param[in,out]
+ *		buf_sizes
+ *			[in]: Array of \a nr user buffer sizes (DAOS_REC_ANY if
+ *			unknown). [out]: The actual size of each value, 0 if
+ *			the key does not exist.
+ * \param[out]	bufs	Array of \a nr user buffers. If NULL, or for a NULL
+ *			entry, only the size is returned.
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode, the first error encountered is
+ *			returned if several fetches fail:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_INVAL	Invalid parameter
+ *			-DER_NO_PERM	Permission denied
+ *			-DER_UNREACH	Network is unreachable
+ *			-DER_REC2BIG	Record does not fit in buffer
+ *			-DER_EP_RO	Epoch is read-only
+ */
+int
+daos_kv_get_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags,
+		  unsigned int nr, const char *const keys[],
+		  daos_size_t buf_sizes[], void *const bufs[], daos_event_t *ev);
+
+/**
+ * Remove several keys and their values from the KV store at once.
+ *
+ * \param[in]	oh	Object open handle.
+ * \param[in]	th	Transaction handle.
+ * \param[in]	flags	Remove flags, applied to every key.
+ * \param[in]	nr	Number of keys.
+ * \param[in]	keys	Array of \a nr keys to be punched/removed.
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode, the first error encountered is
+ *			returned if several removals fail:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_INVAL	Invalid parameter
+ *			-DER_NO_PERM	Permission denied
+ *			-DER_UNREACH	Network is unreachable
+ *			-DER_EP_RO	Epoch is read-only
+ */
+int
+daos_kv_remove_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags,
+		     unsigned int nr, const char *const keys[],
+		     daos_event_t *ev);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -745,6 +745,16 @@ void bio_log_csum_err(struct bio_xs_context *b, int tgt_id);
 /* Too many blob IO queued, need to schedule a NVMe poll? */
 bool bio_need_nvme_poll(struct bio_xs_context *xs);
 
+/*
+ * NVMe load of the xstream, the higher of the DMA buffer in use and of the
+ * queued blob I/O relative to the NVMe poll watermark.
+ *
+ * \param xs		[IN]	xstream context
+ *
+ * \return			Load in percent, [0, 100]
+ */
+unsigned int bio_xs_load(struct bio_xs_context *xs);
+
 /*
  * Replace a device.
  *
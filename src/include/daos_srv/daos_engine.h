@@ -358,6 +358,15 @@ int sched_req_space_check(struct sched_request *req);
  */
 void sched_cond_wait(ABT_cond cond, ABT_mutex mutex);
 
+/**
+ * Smoothed time IO requests recently spent in the scheduler queue of the
+ * current xstream, it's at millisecond granularity.
+ *
+ * \retval		Wait in microseconds, 0 if there was no queued IO
+ *			request in the last second.
+ */
+uint64_t sched_fg_wait_us(void);
+
 static inline bool
 dss_ult_exiting(struct sched_request *req)
 {
@@ -500,6 +500,15 @@ struct evt_policy_ops {
 	int	(*po_rect_weight)(struct evt_context *tcx,
 				  const struct evt_rect *rect,
 				  struct evt_weight *weight);
+	/**
+	 * Compare two rectangles \a rt1 and \a rt2 in node \a nd, return
+	 * negative, zero or positive as \a rt1 should be placed before, at
+	 * or after \a rt2 in the node.
+	 */
+	int	(*po_cmp_rect)(struct evt_context *tcx,
+			       const struct evt_node *nd,
+			       const struct evt_rect *rt1,
+			       const struct evt_rect *rt2);
 
 	/** TODO: add more member functions */
 };
@@ -562,6 +571,23 @@ int evt_destroy(daos_handle_t toh);
  */
 int evt_drain(daos_handle_t toh, int *credits, bool *destroyed);
 
+/**
+ * Rebuild an opened tree bottom-up from its sorted leaf records, so that
+ * nodes are filled evenly with some room left for later inserts. Nothing is
+ * done if the leaves are already packed, and the tree never grows. Records
+ * and data extents are left in place, only tree nodes are reallocated.
+ *
+ * A large tree is rebuilt one subtree per transaction, each rebuilt subtree
+ * consumes @credits by the number of nodes it allocates. It returns when the
+ * tree is packed or all input credits are consumed, in the later case the
+ * caller can yield and call it again to continue.
+ *
+ * \param toh		[IN]	 Tree open handle.
+ * \param credits	[IN/OUT] Input and returned rebuild credits
+ * \param rebuilt	[OUT]	 Optional, set to true if any node was rebuilt
+ */
+int evt_rebuild(daos_handle_t toh, int *credits, bool *rebuilt);
+
 /**
  * Insert a new extended version \a rect and its data memory ID \a addr to
  * a opened tree.
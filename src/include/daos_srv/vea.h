@@ -122,6 +122,7 @@ struct vea_stat {
 	uint64_t	vs_resrv_hint;	/* Number of hint reserve */
 	uint64_t	vs_resrv_large;	/* Number of large reserve */
 	uint64_t	vs_resrv_small;	/* Number of small reserve */
+	uint64_t	vs_resrv_bmap;	/* Small reserve through bitmap */
 	uint64_t	vs_resrv_vec;	/* Number of vector reserve */
 	uint32_t	vs_largest_blks;/* Largest free frag size in blocks */
 };
@@ -183,9 +184,12 @@ void vea_unload(struct vea_space_info *vsi);
 
 /**
  * Load persistent hint from SCM and initialize in-memory hint. It's usually
- * called before starting an I/O stream.
+ * called before starting an I/O stream. When @phd is NULL, a transient hint
+ * is initialized, its hint data is kept in DRAM and starts from scratch on
+ * each load, it's used for the short lived I/O streams which don't need to
+ * preserve the sequential locality across restart.
  *
- * \param phd [IN]	Hint data on SCM
+ * \param phd [IN]	Hint data on SCM, NULL for transient hint
  * \param thc [OUT]	In-memory hint context
  *
  * \return		Zero on success, in-memory hint data returned by @thd;
@@ -308,4 +312,13 @@ int vea_query(struct vea_space_info *vsi, struct vea_attr *attr,
  */
 void vea_flush(struct vea_space_info *vsi, bool plug);
 
+/**
+ * Coalesce the expired free extents in aging buffer into the free extent
+ * index, it's supposed to be called periodically by a background ULT, so
+ * that the freed space becomes available even without transactions.
+ *
+ * \param vsi       [IN]	In-memory compound index
+ */
+void vea_compact(struct vea_space_info *vsi);
+
 #endif /* __VEA_API_H__ */
@@ -17,9 +17,13 @@
 
 #define VOS_SUB_OP_MAX	((uint16_t)-2)
 
+struct vea_hint_context;
+
 struct dtx_rsrvd_uint {
 	void			*dru_scm;
 	d_list_t		dru_nvme;
+	/* Allocation hint of the I/O stream reserved dru_nvme */
+	struct vea_hint_context	*dru_hint;
 };
 
 enum dtx_cos_flags {
@@ -117,6 +117,9 @@ typedef enum {
 	DAOS_OPC_KV_PUT,
 	DAOS_OPC_KV_REMOVE,
 	DAOS_OPC_KV_LIST,
+	DAOS_OPC_KV_GET_MULTI,
+	DAOS_OPC_KV_PUT_MULTI,
+	DAOS_OPC_KV_REMOVE_MULTI,
 
 	DAOS_OPC_MAX
 } daos_opc_t;
@@ -1005,6 +1008,56 @@ typedef struct {
 	daos_anchor_t		*anchor;
 } daos_kv_list_t;
 
+/** KV multi get args */
+typedef struct {
+	/** KV open handle. */
+	daos_handle_t		oh;
+	/** Transaction open handle. */
+	daos_handle_t		th;
+	/** Operation flags. */
+	uint64_t		flags;
+	/** Number of keys. */
+	unsigned int		nr;
+	/** Array of keys. */
+	const char *const	*keys;
+	/** Array of value buffer sizes. */
+	daos_size_t		*buf_sizes;
+	/** Array of value buffers. */
+	void *const		*bufs;
+} daos_kv_get_multi_t;
+
+/** KV multi put args */
+typedef struct {
+	/** KV open handle. */
+	daos_handle_t		oh;
+	/** Transaction open handle. */
+	daos_handle_t		th;
+	/** Operation flags. */
+	uint64_t		flags;
+	/** Number of keys. */
+	unsigned int		nr;
+	/** Array of keys. */
+	const char *const	*keys;
+	/** Array of value sizes. */
+	const daos_size_t	*buf_sizes;
+	/** Array of value buffers. */
+	const void *const	*bufs;
+} daos_kv_put_multi_t;
+
+/** KV multi remove args */
+typedef struct {
+	/** KV open handle. */
+	daos_handle_t		oh;
+	/** Transaction open handle. */
+	daos_handle_t		th;
+	/** Operation flags. */
+	uint64_t		flags;
+	/** Number of keys. */
+	unsigned int		nr;
+	/** Array of keys. */
+	const char *const	*keys;
+} daos_kv_remove_multi_t;
+
 /**
  * Create an asynchronous task and associate it with a daos client operation.
  * For synchronous operations please use the specific API for that operation.
@@ -31,7 +31,9 @@ struct d_slab_reg {
 
 	/* Maximum number of descriptors to exist concurrently */
 	int	sr_max_desc;
-	/* Maximum number of descriptors to exist on the free_list */
+	/* Maximum number of descriptors to exist on the free_list, the
+	 * descriptors released beyond it are freed.
+	 */
 	int	sr_max_free_desc;
 };
 
@@ -72,6 +74,11 @@ struct d_slab_type {
 	/* Number of sequental calls to acquire() without a call to restock() */
 	int			st_no_restock; /* Current count */
 	int			st_no_restock_hwm; /* High water mark */
+
+	/* Set when the manager was destroyed with objects of the type still
+	 * in use, the type is then freed by the release of the last one.
+	 */
+	bool			st_orphan;
 };
 
 struct d_slab {
@@ -89,7 +96,10 @@ int
 d_slab_init(struct d_slab *, void *arg)
 	__attribute((warn_unused_result, nonnull(1)));
 
-/* Destroy a data slab manager, called once at shutdown */
+/* Destroy a data slab manager, called once at shutdown
+ *
+ * The types which still have objects in use are orphaned rather than freed.
+ */
 void
 d_slab_destroy(struct d_slab *);
 
@@ -101,7 +111,9 @@ d_slab_register(struct d_slab *, struct d_slab_reg *);
 void *
 d_slab_acquire(struct d_slab_type *);
 
-/* Release a data structure in a performant way */
+/* Release a data structure in a performant way, and make it available for
+ * reuse.  The objects of an orphaned type are freed instead.
+ */
 void
 d_slab_release(struct d_slab_type *, void *);
 
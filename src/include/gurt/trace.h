@@ -0,0 +1,156 @@
+/*
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * \file
+ *
+ * This file is part of gurt, it contains the binary trace ring used to time
+ * the stages of the requests handled by a process.
+ *
+ * Each thread that records an event is given its own ring of fixed size
+ * records in a shared memory segment, so recording is a handful of stores and
+ * never takes a lock. The segment is read by the daos_trace tool, which can
+ * also turn the recording on and off at runtime.
+ */
+
+#ifndef __GURT_TRACE_H__
+#define __GURT_TRACE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @addtogroup GURT
+ * @{
+ */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Env to enable the trace ring, its value is the number of records of each
+ * ring. It is rounded up to a power of two.
+ */
+#define D_TRACE_RING_ENV	"D_TRACE_RING"
+/** Name of the shared memory segment of a process, formatted with its pid */
+#define D_TRACE_SHM_FMT		"/daos_trace.%d"
+#define D_TRACE_MAGIC		0x44545243
+#define D_TRACE_VERSION		1
+/** Maximum number of threads that are given a ring */
+#define D_TRACE_MAX_RINGS	128
+#define D_TRACE_MIN_RECS	1024
+
+/** Traced stages, each is recorded as a begin and an end event */
+enum d_trace_stage {
+	/** RPC received to reply sent, tagged by the crt_rpc_t */
+	D_TRACE_RPC,
+	/** RPC queued in the xstream scheduler, tagged by the crt_rpc_t */
+	D_TRACE_SCHED,
+	/** vos_update_begin(), tagged by the returned I/O handle pointer */
+	D_TRACE_VOS_UPDATE_BEGIN,
+	/** vos_update_end(), tagged by the I/O handle cookie */
+	D_TRACE_VOS_UPDATE_END,
+	/** bio_iod_prep(), tagged by the bio_desc */
+	D_TRACE_BIO_PREP,
+	/** obj_bulk_transfer(), tagged by the crt_rpc_t */
+	D_TRACE_BULK,
+	D_TRACE_STAGE_MAX,
+};
+
+struct d_trace_rec {
+	/** CLOCK_MONOTONIC time in nanoseconds */
+	uint64_t	tr_time;
+	/** identifies one instance of the stage, e.g. the RPC pointer */
+	uint64_t	tr_tag;
+	/** opcode on RPC begin, return code on end */
+	uint32_t	tr_arg;
+	uint16_t	tr_stage;
+	/** 0 on the begin of the stage, 1 on the end */
+	uint16_t	tr_end;
+};
+
+struct d_trace_ring {
+	/**
+	 * number of records ever written to the ring, the record of sequence
+	 * number n is at n % th_ring_size
+	 */
+	uint64_t		trr_head;
+	/** thread ID of the writer */
+	uint32_t		trr_tid;
+	uint32_t		trr_padding;
+	struct d_trace_rec	trr_recs[0];
+};
+
+/** Header of the shared memory segment, followed by the rings */
+struct d_trace_hdr {
+	uint32_t	th_magic;
+	uint32_t	th_version;
+	/** number of rings in the segment */
+	uint32_t	th_nr_rings;
+	/** number of records in each ring, a power of two */
+	uint32_t	th_ring_size;
+	/** number of rings given to threads so far */
+	uint32_t	th_rings_used;
+	/** recording is on, can be flipped by the reader */
+	uint32_t	th_enabled;
+};
+
+/** Mapped segment of this process, NULL if tracing is not configured */
+extern struct d_trace_hdr	*d_trace_hdr;
+
+static inline uint64_t
+d_trace_ring_bytes(uint32_t ring_size)
+{
+	return sizeof(struct d_trace_ring) +
+	       (uint64_t)ring_size * sizeof(struct d_trace_rec);
+}
+
+static inline struct d_trace_ring *
+d_trace_ring_at(struct d_trace_hdr *hdr, uint32_t idx)
+{
+	return (struct d_trace_ring *)((char *)(hdr + 1) +
+				       idx * d_trace_ring_bytes(hdr->th_ring_size));
+}
+
+/**
+ * Create the trace segment of the process if D_TRACE_RING is set.
+ * Reference counted.
+ *
+ * \return			0 on success, negative DER error otherwise
+ */
+int d_trace_init(void);
+
+/**
+ * Drop a reference, on the last one recording is stopped, threads still
+ * recording an event are waited for and the segment is unmapped and removed.
+ */
+void d_trace_fini(void);
+
+/** Record an event, use the D_TRACE_BEGIN/END() wrappers instead */
+void d_trace_record(enum d_trace_stage stage, bool end, uint64_t tag,
+		    uint32_t arg);
+
+#define D_TRACE_BEGIN(stage, tag, arg)					\
+do {									\
+	if (unlikely(__atomic_load_n(&d_trace_hdr,			\
+				     __ATOMIC_RELAXED) != NULL))	\
+		d_trace_record(stage, false, (uint64_t)(tag), arg);	\
+} while (0)
+
+#define D_TRACE_END(stage, tag, arg)					\
+do {									\
+	if (unlikely(__atomic_load_n(&d_trace_hdr,			\
+				     __ATOMIC_RELAXED) != NULL))	\
+		d_trace_record(stage, true, (uint64_t)(tag), arg);	\
+} while (0)
+
+#if defined(__cplusplus)
+}
+#endif
+
+/** @}
+ */
+#endif /* __GURT_TRACE_H__ */
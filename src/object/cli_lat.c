@@ -0,0 +1,174 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * object client: per-target fetch latency
+ *
+ * The client keeps the smoothed latency, its mean deviation and the number of
+ * in-flight fetch RPCs of each engine target it talks to, so that reads can go
+ * to the replica which is expected to answer first.
+ *
+ * The table is shared by all pools and threads of the process. It is indexed
+ * by rank and target index in a fixed size open addressed array, and is only
+ * updated with atomic operations. Concurrent updates of the same target may
+ * lose a sample, which is fine for an estimate.
+ */
+#define D_LOGFAC	DD_FAC(object)
+
+#include <daos/common.h>
+#include "obj_internal.h"
+
+#define OBJ_TGT_LAT_BITS	12
+#define OBJ_TGT_LAT_SIZE	(1U << OBJ_TGT_LAT_BITS)
+#define OBJ_TGT_LAT_PROBES	8
+/** the latency of a target is halved for each period without sample */
+#define OBJ_TGT_LAT_DECAY_NS	NSEC_PER_SEC
+
+struct obj_tgt_lat {
+	/** (rank << 32 | target index) + 1, 0 for a free slot */
+	uint64_t	otl_key;
+	/** smoothed latency in nanoseconds, 7/8 of old plus 1/8 of sample */
+	uint64_t	otl_srtt;
+	/** smoothed mean deviation in nanoseconds */
+	uint64_t	otl_rttvar;
+	/** time of the last sample */
+	uint64_t	otl_stamp;
+	uint32_t	otl_inflight;
+};
+
+static struct obj_tgt_lat	obj_tgt_lats[OBJ_TGT_LAT_SIZE];
+
+static inline uint64_t
+tgt_lat_key(uint32_t rank, uint32_t tgt_idx)
+{
+	return ((uint64_t)rank << 32 | tgt_idx) + 1;
+}
+
+/* Find the slot of a target, take a free one if \a create is set */
+static struct obj_tgt_lat *
+tgt_lat_lookup(uint32_t rank, uint32_t tgt_idx, bool create)
+{
+	struct obj_tgt_lat	*otl;
+	uint64_t		 key = tgt_lat_key(rank, tgt_idx);
+	uint64_t		 cur;
+	uint32_t		 pos;
+	int			 i;
+
+	pos = (key * 0x9E3779B97F4A7C15ULL) >> (64 - OBJ_TGT_LAT_BITS);
+	for (i = 0; i < OBJ_TGT_LAT_PROBES; i++) {
+		otl = &obj_tgt_lats[(pos + i) & (OBJ_TGT_LAT_SIZE - 1)];
+		cur = __atomic_load_n(&otl->otl_key, __ATOMIC_ACQUIRE);
+		if (cur == key)
+			return otl;
+		if (cur != 0)
+			continue;
+		if (!create)
+			return NULL;
+		if (__atomic_compare_exchange_n(&otl->otl_key, &cur, key,
+						false, __ATOMIC_ACQ_REL,
+						__ATOMIC_ACQUIRE) ||
+		    cur == key)
+			return otl;
+	}
+	return NULL;
+}
+
+uint64_t
+obj_tgt_lat_start(uint32_t rank, uint32_t tgt_idx)
+{
+	struct obj_tgt_lat	*otl;
+
+	otl = tgt_lat_lookup(rank, tgt_idx, true);
+	if (otl != NULL)
+		__atomic_fetch_add(&otl->otl_inflight, 1, __ATOMIC_RELAXED);
+
+	return daos_get_ntime();
+}
+
+void
+obj_tgt_lat_end(uint32_t rank, uint32_t tgt_idx, uint64_t start, int rc)
+{
+	struct obj_tgt_lat	*otl;
+	uint64_t		 now;
+	uint64_t		 srtt;
+	uint64_t		 rttvar;
+	uint64_t		 sample;
+	uint64_t		 delta;
+
+	otl = tgt_lat_lookup(rank, tgt_idx, false);
+	if (otl == NULL)
+		return;
+
+	__atomic_fetch_sub(&otl->otl_inflight, 1, __ATOMIC_RELAXED);
+
+	/* other errors say nothing about the speed of the target */
+	if (rc != 0 && rc != -DER_TIMEDOUT && !daos_crt_network_error(rc))
+		return;
+
+	now = daos_get_ntime();
+	sample = now > start ? now - start : 1;
+	srtt = __atomic_load_n(&otl->otl_srtt, __ATOMIC_RELAXED);
+	rttvar = __atomic_load_n(&otl->otl_rttvar, __ATOMIC_RELAXED);
+	if (srtt == 0) {
+		srtt = sample;
+		rttvar = sample / 2;
+	} else {
+		delta = sample > srtt ? sample - srtt : srtt - sample;
+		rttvar = rttvar - rttvar / 4 + delta / 4;
+		srtt = srtt - srtt / 8 + sample / 8;
+	}
+	__atomic_store_n(&otl->otl_srtt, srtt, __ATOMIC_RELAXED);
+	__atomic_store_n(&otl->otl_rttvar, rttvar, __ATOMIC_RELAXED);
+	__atomic_store_n(&otl->otl_stamp, now, __ATOMIC_RELAXED);
+}
+
+uint64_t
+obj_tgt_lat_cost(uint32_t rank, uint32_t tgt_idx, uint64_t now)
+{
+	struct obj_tgt_lat	*otl;
+	uint64_t		 srtt;
+	uint64_t		 stamp;
+	uint64_t		 idle;
+	uint32_t		 inflight;
+
+	otl = tgt_lat_lookup(rank, tgt_idx, false);
+	if (otl == NULL)
+		return 0;
+
+	srtt = __atomic_load_n(&otl->otl_srtt, __ATOMIC_RELAXED);
+	stamp = __atomic_load_n(&otl->otl_stamp, __ATOMIC_RELAXED);
+	inflight = __atomic_load_n(&otl->otl_inflight, __ATOMIC_RELAXED);
+
+	/* Forget a slow past gradually, or a target which was once slow
+	 * would never be tried again. Not while RPCs are pending on it, they
+	 * may be stuck.
+	 */
+	if (inflight == 0 && now > stamp) {
+		idle = (now - stamp) / OBJ_TGT_LAT_DECAY_NS;
+		srtt = idle >= 64 ? 0 : srtt >> idle;
+	}
+
+	/* every in-flight RPC is expected to be served before a new one */
+	return (srtt == 0 ? 1 : srtt) * (inflight + 1);
+}
+
+uint32_t
+obj_tgt_lat_hedge_sec(uint32_t rank, uint32_t tgt_idx)
+{
+	struct obj_tgt_lat	*otl;
+	uint64_t		 tail;
+	uint32_t		 sec;
+
+	otl = tgt_lat_lookup(rank, tgt_idx, false);
+	if (otl == NULL)
+		return obj_hedge_sec;
+
+	/* smoothed latency plus four deviations bounds most samples */
+	tail = __atomic_load_n(&otl->otl_srtt, __ATOMIC_RELAXED) +
+	       4 * __atomic_load_n(&otl->otl_rttvar, __ATOMIC_RELAXED);
+	sec = (tail + NSEC_PER_SEC - 1) / NSEC_PER_SEC;
+
+	return max(sec, obj_hedge_sec);
+}
@@ -16,6 +16,8 @@
 #include "obj_internal.h"
 
 unsigned int	srv_io_mode = DIM_DTX_FULL_ENABLED;
+bool		obj_read_balance = true;
+unsigned int	obj_hedge_sec;
 
 /**
  * Initialize object interface
@@ -35,6 +37,11 @@ dc_obj_init(void)
 		D_DEBUG(DB_IO, "Full dtx mode by default\n");
 	}
 
+	d_getenv_bool("DAOS_OBJ_READ_BALANCE", &obj_read_balance);
+	d_getenv_int("DAOS_OBJ_HEDGE_SEC", &obj_hedge_sec);
+	D_DEBUG(DB_IO, "read balance %d, hedged fetch after %u sec\n",
+		obj_read_balance, obj_hedge_sec);
+
 	rc = obj_utils_init();
 	if (rc)
 		D_GOTO(out, rc);
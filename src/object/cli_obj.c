@@ -313,8 +313,6 @@ obj_layout_create(struct dc_object *obj, bool refresh)
 	}
 
 	map = pl_map_find(pool->dp_pool, obj->cob_md.omd_id);
-	dc_pool_put(pool);
-
 	if (map == NULL) {
 		D_DEBUG(DB_PL, "Cannot find valid placement map\n");
 		D_GOTO(out, rc = -DER_INVAL);
@@ -357,18 +355,32 @@ obj_layout_create(struct dc_object *obj, bool refresh)
 			D_GOTO(out, rc = -DER_NOMEM);
 	}
 
+	/* The engine target of each shard is resolved now rather than when the
+	 * shard is opened, so that the replica selection can look up its load.
+	 */
+	D_RWLOCK_RDLOCK(&pool->dp_map_lock);
 	for (i = 0; i < layout->ol_nr; i++) {
-		struct dc_obj_shard *obj_shard;
+		struct dc_obj_shard	*obj_shard;
+		struct pool_target	*map_tgt;
 
 		obj_shard = &obj->cob_shards->do_shards[i];
 		obj_shard->do_shard = layout->ol_shards[i].po_shard;
 		obj_shard->do_target_id = layout->ol_shards[i].po_target;
 		obj_shard->do_fseq = layout->ol_shards[i].po_fseq;
 		obj_shard->do_rebuilding = layout->ol_shards[i].po_rebuilding;
+		if (obj_shard->do_target_id != -1 &&
+		    pool_map_find_target(pool->dp_map, obj_shard->do_target_id,
+					 &map_tgt) == 1) {
+			obj_shard->do_target_rank = map_tgt->ta_comp.co_rank;
+			obj_shard->do_target_idx = map_tgt->ta_comp.co_index;
+		}
 	}
+	D_RWLOCK_UNLOCK(&pool->dp_map_lock);
 out:
 	if (layout)
 		pl_obj_layout_free(layout);
+	if (pool)
+		dc_pool_put(pool);
 	return rc;
 }
 
@@ -503,16 +515,58 @@ obj_get_grp_size(struct dc_object *obj)
 	return obj->cob_grp_size;
 }
 
+static bool
+obj_grp_shard_valid(struct dc_object *obj, int index,
+		    struct obj_auxi_tgt_list *failed_list)
+{
+	struct dc_obj_shard	*shard = &obj->cob_shards->do_shards[index];
+
+	/* let's skip the rebuild shard */
+	if (shard->do_rebuilding)
+		return false;
+
+	/* Skip the target which is already in the failed list, i.e.
+	 * they have been tried.
+	 */
+	if (failed_list &&
+	    tgt_in_failed_tgts_list(shard->do_target_id, failed_list))
+		return false;
+
+	/* Skip the invalid shards and targets */
+	return shard->do_target_id != -1 || shard->do_shard != -1;
+}
+
+/* First valid shard of the group from a random offset, -1 if none */
+static int
+obj_grp_shard_random(struct dc_object *obj, int grp_start, int grp_size,
+		     int skip, struct obj_auxi_tgt_list *failed_list)
+{
+	int	idx = random() % grp_size;
+	int	index;
+	int	i;
+
+	for (i = 0; i < grp_size; i++, idx++) {
+		index = idx % grp_size + grp_start;
+		if (index != skip &&
+		    obj_grp_shard_valid(obj, index, failed_list))
+			return index;
+	}
+	return -1;
+}
+
 /* Get a valid shard from an object group */
 static int
 obj_grp_valid_shard_get(struct dc_object *obj, int grp_idx,
 			unsigned int map_ver,
 			struct obj_auxi_tgt_list *failed_list)
 {
-	int grp_start;
-	int idx;
-	int grp_size;
-	int i = 0;
+	struct dc_obj_shard	*shard;
+	struct dc_obj_shard	*other;
+	uint64_t		 now;
+	int			 grp_start;
+	int			 idx;
+	int			 alt;
+	int			 grp_size;
 
 	grp_size = obj_get_grp_size(obj);
 	D_ASSERT(grp_size > 0);
@@ -541,34 +595,30 @@ obj_grp_valid_shard_get(struct dc_object *obj, int grp_idx,
 	 */
 	D_ASSERT(grp_size >= obj_get_replicas(obj));
 	grp_start = grp_idx * grp_size;
-	idx = grp_start + random() % grp_size;
-	for (i = 0; i < grp_size; i++, idx++) {
-		uint32_t tgt_id;
-		int index;
-
-		index = idx % grp_size + grp_start;
-		/* let's skip the rebuild shard */
-		if (obj->cob_shards->do_shards[index].do_rebuilding)
-			continue;
+	idx = obj_grp_shard_random(obj, grp_start, grp_size, -1, failed_list);
+	if (idx < 0 || !obj_read_balance || grp_size == 1)
+		goto out;
 
-		/* Skip the target which is already in the failed list, i.e.
-		 * they have been tried.
-		 */
-		tgt_id = obj->cob_shards->do_shards[index].do_target_id;
-		if (failed_list && tgt_in_failed_tgts_list(tgt_id, failed_list))
-			continue;
-
-		/* Skip the invalid shards and targets */
-		if (obj->cob_shards->do_shards[index].do_target_id != -1 ||
-		    obj->cob_shards->do_shards[index].do_shard != -1) {
-			idx = index;
-			break;
-		}
-	}
+	/* Power of two choices: compare with a second random replica and
+	 * read from the target expected to answer first, according to its
+	 * latency and in-flight fetches. It steers reads away from a busy or
+	 * degraded target without sending them all to the fastest one.
+	 */
+	alt = obj_grp_shard_random(obj, grp_start, grp_size, idx, failed_list);
+	if (alt < 0)
+		goto out;
 
+	shard = &obj->cob_shards->do_shards[idx];
+	other = &obj->cob_shards->do_shards[alt];
+	now = daos_getntime_coarse();
+	if (obj_tgt_lat_cost(other->do_target_rank, other->do_target_idx,
+			     now) <
+	    obj_tgt_lat_cost(shard->do_target_rank, shard->do_target_idx, now))
+		idx = alt;
+out:
 	D_RWLOCK_UNLOCK(&obj->cob_lock);
 
-	if (i == grp_size)
+	if (idx < 0)
 		return -DER_NONEXIST;
 
 	return idx;
@@ -870,6 +920,16 @@ obj_op_is_ec_fetch(struct obj_auxi_args *obj_auxi)
 	return obj_auxi->is_ec_obj && obj_auxi->opc == DAOS_OBJ_RPC_FETCH;
 }
 
+/* The fetch can be re-issued to another replica if its target is slow */
+bool
+obj_op_is_hedged_fetch(struct obj_auxi_args *obj_auxi)
+{
+	return obj_hedge_sec > 0 && obj_auxi->opc == DAOS_OBJ_RPC_FETCH &&
+	       !obj_auxi->is_ec_obj && !obj_auxi->spec_shard &&
+	       !obj_auxi->spec_group && !obj_auxi->to_leader &&
+	       !obj_auxi->no_retry && obj_get_replicas(obj_auxi->obj) > 1;
+}
+
 /**
  * Query target info. ec_tgt_idx only used for EC obj fetch.
  */
@@ -3274,6 +3334,18 @@ obj_shard_comp_cb(struct shard_auxi_args *shard_auxi,
 		obj_auxi->result = ret;
 	}
 
+	if (ret == -DER_TIMEDOUT && obj_op_is_hedged_fetch(obj_auxi)) {
+		/* Hedged fetch, retry on another replica than the slow one
+		 * if there is any, or on all of them again otherwise.
+		 */
+		obj_auxi_add_failed_tgt(obj_auxi, shard_auxi->target);
+		if (obj_shard_find_replica(obj_auxi->obj, shard_auxi->target,
+					   obj_auxi->failed_tgt_list) < 0)
+			obj_auxi_free_failed_tgt_list(obj_auxi);
+		D_DEBUG(DB_IO, "hedge fetch of shard %d away from target %u\n",
+			shard_auxi->shard, shard_auxi->target);
+	}
+
 	if (ret) {
 		if (ret != -DER_REC2BIG && !obj_retry_error(ret) &&
 		    !obj_is_modification_opc(obj_auxi->opc) &&
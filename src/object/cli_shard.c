@@ -104,6 +104,8 @@ struct rw_cb_args {
 	daos_iom_t		*maps;
 	crt_endpoint_t		tgt_ep;
 	struct shard_rw_args	*shard_args;
+	/** send time of a fetch to feed the target latency, or 0 */
+	uint64_t		send_time;
 };
 
 static struct dcs_layout *
@@ -702,6 +704,9 @@ dc_rw_cb(tse_task_t *task, void *arg)
 	opc = opc_get(rw_args->rpc->cr_opc);
 	D_DEBUG(DB_IO, "rpc %p opc:%d completed, dt_result %d.\n",
 		rw_args->rpc, opc, ret);
+	if (rw_args->send_time != 0)
+		obj_tgt_lat_end(rw_args->tgt_ep.ep_rank, rw_args->tgt_ep.ep_tag,
+				rw_args->send_time, ret);
 	if (opc == DAOS_OBJ_RPC_FETCH &&
 	    DAOS_FAIL_CHECK(DAOS_SHARD_OBJ_FETCH_TIMEOUT)) {
 		D_ERROR("Inducing -DER_TIMEDOUT error on shard I/O fetch\n");
@@ -1165,10 +1170,27 @@ dc_obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	if (DAOS_FAIL_CHECK(DAOS_SHARD_OBJ_RW_CRT_ERROR))
 		D_GOTO(out_args, rc = -DER_HG);
 
+	/* The latency of the fetches steers the replica selection, and a
+	 * hedged fetch times out once it is slower than most of the previous
+	 * ones of its target, to be retried on another replica.
+	 */
+	rw_args.send_time = 0;
+	if (opc == DAOS_OBJ_RPC_FETCH && !(daos_io_bypass & IOBP_CLI_RPC)) {
+		if (obj_op_is_hedged_fetch(auxi->obj_auxi))
+			crt_req_set_timeout(req, obj_tgt_lat_hedge_sec(
+						 tgt_ep.ep_rank, tgt_ep.ep_tag));
+		rw_args.send_time = obj_tgt_lat_start(tgt_ep.ep_rank,
+						      tgt_ep.ep_tag);
+	}
+
 	rc = tse_task_register_comp_cb(task, dc_rw_cb, &rw_args,
 				       sizeof(rw_args));
-	if (rc != 0)
+	if (rc != 0) {
+		if (rw_args.send_time != 0)
+			obj_tgt_lat_end(tgt_ep.ep_rank, tgt_ep.ep_tag,
+					rw_args.send_time, rc);
 		D_GOTO(out_args, rc);
+	}
 
 	if (daos_io_bypass & IOBP_CLI_RPC) {
 		rc = daos_rpc_complete(req, task);
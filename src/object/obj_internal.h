@@ -45,6 +45,14 @@ struct obj_io_context;
 extern bool	cli_bypass_rpc;
 /** Switch of server-side IO dispatch */
 extern unsigned int	srv_io_mode;
+/** Read from the replica with the lowest expected latency, not a random one */
+extern bool		obj_read_balance;
+/**
+ * Hedged fetch: a fetch that takes longer than the tail latency of its target,
+ * and at least this number of seconds, is re-issued to another replica. 0 to
+ * disable.
+ */
+extern unsigned int	obj_hedge_sec;
 
 /** client object shard */
 struct dc_obj_shard {
@@ -180,6 +188,57 @@ enum_anchor_copy(daos_anchor_t *dst, daos_anchor_t *src)
 
 extern struct dss_module_key obj_module_key;
 
+/* Priority of the migration against the foreground I/O of the target */
+enum migrate_prio {
+	MIGRATE_PRIO_LOW,
+	MIGRATE_PRIO_NORMAL,
+	MIGRATE_PRIO_HIGH,
+};
+
+/* Load of the target sampled by the migration, see migrate_ctl_adjust() */
+struct migrate_ctl_load {
+	/* Smoothed queue wait of the foreground I/O in us */
+	uint64_t		mcl_fg_wait;
+	/* NVMe load in percent */
+	unsigned int		mcl_nvme;
+};
+
+/* Adaptive limits of the inflight migration of a pool on a target, the limits
+ * are raised while the migration is bounded by them, and halved when the
+ * foreground I/O waits longer than the target of the priority, NVMe is busy,
+ * or the network is congested.
+ */
+struct migrate_ctl {
+	/* Current limits */
+	uint64_t		mc_max_size;
+	uint32_t		mc_max_ult;
+	enum migrate_prio	mc_prio;
+	/* Smoothed migrate_dkey() latency in us */
+	uint64_t		mc_lat;
+	/* Lowest mc_lat of the previous window and of the current one */
+	uint64_t		mc_lat_base;
+	uint64_t		mc_lat_min;
+	/* Time of the last adjustment in us, and the adjustments of the
+	 * current window.
+	 */
+	uint64_t		mc_ts;
+	uint32_t		mc_periods;
+	/* Network errors since the last adjustment */
+	uint32_t		mc_net_errs;
+	/* Some ULT waited for the limits since the last adjustment */
+	uint32_t		mc_limited:1;
+};
+
+/* Token bucket of the migration bandwidth of a target */
+struct migrate_bw {
+	/* Bytes per second, 0 for unlimited */
+	uint64_t		mb_rate;
+	/* Available bytes, negative while paying a large transfer back */
+	int64_t			mb_tokens;
+	/* Time of the last refill in us */
+	uint64_t		mb_ts;
+};
+
 /* Per pool attached to the migrate tls(per xstream) */
 struct migrate_pool_tls {
 	/* POOL UUID and pool to be migrated */
@@ -243,6 +302,8 @@ struct migrate_pool_tls {
 	ABT_cond		mpt_inflight_cond;
 	ABT_mutex		mpt_inflight_mutex;
 	int			mpt_inflight_max_ult;
+	/* Adjusts mpt_inflight_max_size and mpt_inflight_max_ult */
+	struct migrate_ctl	mpt_ctl;
 	/* migrate leader ULT */
 	unsigned int		mpt_ult_running:1,
 	/* Indicates whether objects on the migration destination should be
@@ -295,6 +356,16 @@ struct obj_tls {
 	/** Measure update/fetch latency based on I/O size (type = gauge) */
 	struct d_tm_node_t	*ot_update_lat[NR_LATENCY_BUCKETS];
 	struct d_tm_node_t	*ot_fetch_lat[NR_LATENCY_BUCKETS];
+
+	/** Migration bandwidth limit of the target */
+	struct migrate_bw	ot_migrate_bw;
+	/** Limits of inflight migration (type = gauge) */
+	struct d_tm_node_t	*ot_migrate_max_size;
+	struct d_tm_node_t	*ot_migrate_max_ult;
+	/** Inflight migration in bytes (type = gauge) */
+	struct d_tm_node_t	*ot_migrate_inflight;
+	/** Number of times the limits were cut (type = counter) */
+	struct d_tm_node_t	*ot_migrate_backoff;
 };
 
 struct obj_ec_parity {
@@ -498,6 +569,7 @@ int dc_obj_shard_sync(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 int dc_obj_verify_rdg(struct dc_object *obj, struct dc_obj_verify_args *dova,
 		      uint32_t rdg_idx, uint32_t reps, daos_epoch_t epoch);
 bool obj_op_is_ec_fetch(struct obj_auxi_args *obj_auxi);
+bool obj_op_is_hedged_fetch(struct obj_auxi_args *obj_auxi);
 int obj_recx_ec2_daos(struct daos_oclass_attr *oca, int shard,
 		      daos_recx_t **recxs_p, unsigned int *nr);
 int obj_reasb_req_init(struct obj_reasb_req *reasb_req, daos_iod_t *iods,
@@ -901,4 +973,59 @@ dc_tx_convert(struct dc_object *obj, enum obj_rpc_opc opc, tse_task_t *task);
 /* obj_enum.c */
 int
 fill_oid(daos_unit_oid_t oid, struct dss_enum_arg *arg);
+
+/* cli_lat.c */
+/** Count a fetch RPC sent to a target, return the start time for the end */
+uint64_t
+obj_tgt_lat_start(uint32_t rank, uint32_t tgt_idx);
+
+/** Count the completion of a fetch RPC and sample its latency */
+void
+obj_tgt_lat_end(uint32_t rank, uint32_t tgt_idx, uint64_t start, int rc);
+
+/**
+ * Expected time for a target to serve a new fetch, in nanoseconds. Targets
+ * without history cost 0 so that they are tried.
+ */
+uint64_t
+obj_tgt_lat_cost(uint32_t rank, uint32_t tgt_idx, uint64_t now);
+
+/** Timeout in seconds after which a fetch to the target is hedged */
+uint32_t
+obj_tgt_lat_hedge_sec(uint32_t rank, uint32_t tgt_idx);
+
+/* srv_migrate_ctl.c */
+extern enum migrate_prio	migrate_ctl_prio;
+extern uint64_t			migrate_ctl_bw;
+
+/** Read DAOS_REBUILD_PRIORITY and DAOS_REBUILD_BW_MB */
+void
+migrate_ctl_env_init(void);
+
+/** Start with the default limits */
+void
+migrate_ctl_init(struct migrate_ctl *ctl, enum migrate_prio prio);
+
+/** Sample the latency of a migrate_dkey() which returned \a rc */
+void
+migrate_ctl_sample(struct migrate_ctl *ctl, uint64_t lat, int rc);
+
+/**
+ * Adjust the limits once per period, \a now is in us. Return 1 if they were
+ * raised, -1 if they were cut, 0 otherwise.
+ */
+int
+migrate_ctl_adjust(struct migrate_ctl *ctl, uint64_t now,
+		   struct migrate_ctl_load *load);
+
+/** Start a token bucket of \a rate bytes per second, 0 for unlimited */
+void
+migrate_bw_init(struct migrate_bw *bw, uint64_t rate, uint64_t now);
+
+/**
+ * Take \a size bytes from the bucket. Return 0 if they were taken, or the us
+ * to wait before trying again.
+ */
+uint64_t
+migrate_bw_take(struct migrate_bw *bw, uint64_t size, uint64_t now);
 #endif /* __DAOS_OBJ_INTENRAL_H__ */
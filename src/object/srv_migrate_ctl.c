@@ -0,0 +1,227 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * object server: adaptive limits of the inflight migration
+ *
+ * Each pool being migrated on a target bounds the bytes and the ULTs it has
+ * in flight. The bounds follow an additive increase, multiplicative decrease
+ * rule: they grow by an eighth per period while the migration waits for them,
+ * and are halved in a period where the target looks busy, that is
+ * - the foreground I/O waits longer in the scheduler queue than the priority
+ *   of the migration allows,
+ * - the NVMe load is above the one the priority allows,
+ * - migrate_dkey() takes several times longer than the lowest latency of the
+ *   recent windows, or fails on network errors.
+ *
+ * The bandwidth of the migration of a target can also be capped by a token
+ * bucket, which is independent of the limits above.
+ */
+#define D_LOGFAC	DD_FAC(object)
+
+#include <daos/common.h>
+#include "obj_internal.h"
+
+/* Period of the adjustment of the limits */
+#define MIGRATE_CTL_PERIOD_US	100000
+/* Periods of the window of the lowest latency */
+#define MIGRATE_CTL_WINDOW	100
+
+/* The initial limits were the fixed ones, the max size is 50% of the max DMA
+ * buffer of a target.
+ */
+#define MIGRATE_CTL_SIZE_INIT	(1ULL << 28)
+#define MIGRATE_CTL_SIZE_MIN	(1ULL << 24)
+#define MIGRATE_CTL_SIZE_MAX	(1ULL << 29)
+#define MIGRATE_CTL_ULT_INIT	8192
+#define MIGRATE_CTL_ULT_MIN	64
+#define MIGRATE_CTL_ULT_MAX	16384
+
+/* The network is congested when the latency is above this many times the
+ * lowest one, plus some slack for the small latencies.
+ */
+#define MIGRATE_CTL_LAT_FACTOR	4
+#define MIGRATE_CTL_LAT_SLACK	1000	/* us */
+
+static const struct {
+	const char	*mp_name;
+	/* Max foreground I/O queue wait in us, 0 to ignore it */
+	uint64_t	 mp_fg_wait;
+	/* Max NVMe load in percent */
+	unsigned int	 mp_nvme;
+} migrate_prios[] = {
+	[MIGRATE_PRIO_LOW]	= { "low",	1000,	50 },
+	[MIGRATE_PRIO_NORMAL]	= { "normal",	4000,	80 },
+	[MIGRATE_PRIO_HIGH]	= { "high",	0,	95 },
+};
+
+enum migrate_prio	migrate_ctl_prio = MIGRATE_PRIO_NORMAL;
+/* Bytes per second per target, 0 for unlimited */
+uint64_t		migrate_ctl_bw;
+
+void
+migrate_ctl_env_init(void)
+{
+	unsigned int	 bw_mb = 0;
+	char		*env;
+	int		 i;
+
+	env = getenv("DAOS_REBUILD_PRIORITY");
+	if (env != NULL) {
+		for (i = 0; i < ARRAY_SIZE(migrate_prios); i++) {
+			if (strcasecmp(env, migrate_prios[i].mp_name) == 0)
+				break;
+		}
+		if (i < ARRAY_SIZE(migrate_prios))
+			migrate_ctl_prio = i;
+		else
+			D_WARN("Invalid DAOS_REBUILD_PRIORITY %s, use %s\n",
+			       env, migrate_prios[migrate_ctl_prio].mp_name);
+	}
+
+	d_getenv_int("DAOS_REBUILD_BW_MB", &bw_mb);
+	migrate_ctl_bw = (uint64_t)bw_mb << 20;
+
+	D_INFO("Rebuild priority %s, bandwidth %u MB/s per target\n",
+	       migrate_prios[migrate_ctl_prio].mp_name, bw_mb);
+}
+
+void
+migrate_ctl_init(struct migrate_ctl *ctl, enum migrate_prio prio)
+{
+	D_ASSERT(prio < ARRAY_SIZE(migrate_prios));
+
+	memset(ctl, 0, sizeof(*ctl));
+	ctl->mc_max_size = MIGRATE_CTL_SIZE_INIT;
+	ctl->mc_max_ult = MIGRATE_CTL_ULT_INIT;
+	ctl->mc_prio = prio;
+}
+
+void
+migrate_ctl_sample(struct migrate_ctl *ctl, uint64_t lat, int rc)
+{
+	if (rc == -DER_TIMEDOUT || daos_crt_network_error(rc)) {
+		ctl->mc_net_errs++;
+		return;
+	}
+
+	/* other errors say nothing about the load */
+	if (rc != 0)
+		return;
+
+	if (lat == 0)
+		lat = 1;
+	if (ctl->mc_lat == 0)
+		ctl->mc_lat = lat;
+	else
+		ctl->mc_lat = ctl->mc_lat - ctl->mc_lat / 8 + lat / 8;
+}
+
+/* Is the network congested per the latency of the migration? */
+static bool
+ctl_lat_congested(struct migrate_ctl *ctl)
+{
+	uint64_t	base = ctl->mc_lat_base;
+
+	if (ctl->mc_lat == 0)
+		return false;
+
+	if (ctl->mc_lat_min != 0 && (base == 0 || ctl->mc_lat_min < base))
+		base = ctl->mc_lat_min;
+	if (base == 0)
+		return false;
+
+	return ctl->mc_lat > base * MIGRATE_CTL_LAT_FACTOR +
+			     MIGRATE_CTL_LAT_SLACK;
+}
+
+int
+migrate_ctl_adjust(struct migrate_ctl *ctl, uint64_t now,
+		   struct migrate_ctl_load *load)
+{
+	uint64_t	fg_wait = migrate_prios[ctl->mc_prio].mp_fg_wait;
+	uint64_t	size = ctl->mc_max_size;
+	uint32_t	ult = ctl->mc_max_ult;
+	int		rc = 0;
+
+	if (now < ctl->mc_ts + MIGRATE_CTL_PERIOD_US)
+		return 0;
+	ctl->mc_ts = now;
+
+	if ((fg_wait != 0 && load->mcl_fg_wait > fg_wait) ||
+	    load->mcl_nvme > migrate_prios[ctl->mc_prio].mp_nvme ||
+	    ctl->mc_net_errs != 0 || ctl_lat_congested(ctl)) {
+		size = max(size / 2, MIGRATE_CTL_SIZE_MIN);
+		ult = max(ult / 2, MIGRATE_CTL_ULT_MIN);
+		if (size != ctl->mc_max_size || ult != ctl->mc_max_ult)
+			rc = -1;
+		/* the latency of the old limits is not a sample of the new */
+		ctl->mc_lat = 0;
+	} else if (ctl->mc_limited) {
+		size = min(size + size / 8, MIGRATE_CTL_SIZE_MAX);
+		ult = min(ult + ult / 8, MIGRATE_CTL_ULT_MAX);
+		if (size != ctl->mc_max_size || ult != ctl->mc_max_ult)
+			rc = 1;
+	}
+
+	if (rc != 0)
+		D_DEBUG(DB_REBUILD, "limits "DF_U64"/%u -> "DF_U64"/%u, fg wait "
+			DF_U64" nvme %u lat "DF_U64"/"DF_U64" net errs %u\n",
+			ctl->mc_max_size, ctl->mc_max_ult, size, ult,
+			load->mcl_fg_wait, load->mcl_nvme, ctl->mc_lat,
+			ctl->mc_lat_base, ctl->mc_net_errs);
+
+	ctl->mc_max_size = size;
+	ctl->mc_max_ult = ult;
+	ctl->mc_limited = 0;
+	ctl->mc_net_errs = 0;
+
+	if (ctl->mc_lat != 0 &&
+	    (ctl->mc_lat_min == 0 || ctl->mc_lat < ctl->mc_lat_min))
+		ctl->mc_lat_min = ctl->mc_lat;
+	if (++ctl->mc_periods >= MIGRATE_CTL_WINDOW) {
+		ctl->mc_lat_base = ctl->mc_lat_min;
+		ctl->mc_lat_min = 0;
+		ctl->mc_periods = 0;
+	}
+
+	return rc;
+}
+
+void
+migrate_bw_init(struct migrate_bw *bw, uint64_t rate, uint64_t now)
+{
+	bw->mb_rate = rate;
+	bw->mb_tokens = rate;
+	bw->mb_ts = now;
+}
+
+uint64_t
+migrate_bw_take(struct migrate_bw *bw, uint64_t size, uint64_t now)
+{
+	uint64_t	elapsed;
+	int64_t		tokens;
+
+	if (bw->mb_rate == 0)
+		return 0;
+
+	/* refill, at most a second of burst */
+	if (now > bw->mb_ts) {
+		elapsed = min(now - bw->mb_ts, 1000000ULL);
+		tokens = elapsed * bw->mb_rate / 1000000;
+		if (tokens > 0) {
+			bw->mb_tokens = min(bw->mb_tokens + tokens,
+					    (int64_t)bw->mb_rate);
+			bw->mb_ts = now;
+		}
+	}
+
+	if (bw->mb_tokens < 0)
+		return -bw->mb_tokens * 1000000 / bw->mb_rate + 1;
+
+	/* a transfer larger than the bucket is paid back afterwards */
+	bw->mb_tokens -= size;
+	return 0;
+}
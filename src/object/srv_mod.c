@@ -37,6 +37,7 @@ obj_mod_init(void)
 		goto out_class;
 	}
 
+	migrate_ctl_env_init();
 	return 0;
 
 out_class:
@@ -85,11 +86,41 @@ obj_tls_init(int xs_id, int tgt_id)
 		return NULL;
 
 	D_INIT_LIST_HEAD(&tls->ot_pool_list);
+	migrate_bw_init(&tls->ot_migrate_bw, migrate_ctl_bw, daos_getutime());
 
 	if (tgt_id < 0)
 		/** skip sensor setup on system xstreams */
 		return tls;
 
+	/** limits of the inflight migration, adjusted to the load */
+	rc = d_tm_add_metric(&tls->ot_migrate_max_size, D_TM_GAUGE,
+			     "max inflight migration size", "bytes",
+			     "rebuild/inflight/max_size/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create migrate max size sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->ot_migrate_max_ult, D_TM_GAUGE,
+			     "max inflight migration ULTs", "ults",
+			     "rebuild/inflight/max_ult/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create migrate max ULT sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->ot_migrate_inflight, D_TM_GAUGE,
+			     "inflight migration size", "bytes",
+			     "rebuild/inflight/size/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create migrate inflight sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->ot_migrate_backoff, D_TM_COUNTER,
+			     "migration limits cut on load", "cuts",
+			     "rebuild/inflight/backoff/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create migrate backoff sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
 	/** register different per-opcode sensors */
 	for (opc = 0; opc < OBJ_PROTO_CLI_COUNT; opc++) {
 		/** Start with number of active requests, of type gauge */
@@ -25,6 +25,7 @@
 #include <daos_srv/dtx_srv.h>
 #include <daos_srv/security.h>
 #include <daos/checksum.h>
+#include <gurt/trace.h>
 #include "daos_srv/srv_csum.h"
 #include "obj_rpc.h"
 #include "obj_internal.h"
@@ -462,6 +463,9 @@ obj_bulk_transfer(crt_rpc_t *rpc, crt_bulk_op_t bulk_op, bool bulk_bind,
 
 	p_arg->inited = true;
 	D_DEBUG(DB_IO, "bulk_op %d sgl_nr %d\n", bulk_op, sgl_nr);
+	/* only the synchronous transfers are timed, as a whole */
+	if (!async)
+		D_TRACE_BEGIN(D_TRACE_BULK, rpc, bulk_op);
 
 	p_arg->bulks_inflight++;
 
@@ -528,6 +532,7 @@ done:
 		*fbuffer += 0x2;
 		d_sgl_fini(&fsgl, false);
 	}
+	D_TRACE_END(D_TRACE_BULK, rpc, rc);
 	return rc;
 }
 
@@ -19,6 +19,7 @@
 #include <daos_srv/container.h>
 #include <daos_srv/daos_engine.h>
 #include <daos_srv/vos.h>
+#include <daos_srv/bio.h>
 #include <daos_srv/dtx_srv.h>
 #include <daos_srv/srv_csum.h>
 #include "obj_rpc.h"
@@ -28,14 +29,6 @@
 	#pragma GCC diagnostic ignored "-Wframe-larger-than="
 #endif
 
-/* Max inflight data size per xstream */
-/* Set the total inflight size to be 25% of MAX DMA size for
- * the moment, will adjust it later if needed.
- */
-#define MIGRATE_MAX_SIZE	(1 << 28)
-/* Max migrate ULT number on the server */
-#define MIGRATE_MAX_ULT		8192
-
 struct migrate_one {
 	daos_key_t		 mo_dkey;
 	uuid_t			 mo_pool_uuid;
@@ -63,6 +56,17 @@ struct migrate_one {
 	d_iov_t			 mo_csum_iov;
 };
 
+/* Dkeys of a container migrated by one ULT, see migrate_start_ult() */
+struct migrate_batch {
+	/* migrate_one list, linked by mo_list, grouped by object */
+	d_list_t		 mb_list;
+	uuid_t			 mb_pool_uuid;
+	uuid_t			 mb_cont_uuid;
+	uint32_t		 mb_pool_tls_version;
+	unsigned int		 mb_nr;
+	daos_size_t		 mb_size;
+};
+
 struct migrate_obj_key {
 	daos_unit_oid_t oid;
 	daos_epoch_t	eph;
@@ -83,6 +87,8 @@ struct iter_cont_arg {
 	uint32_t		snap_cnt;
 	uint32_t		version;
 	uint32_t		ref_cnt;
+	/* Object group being filled for each target, see migrate_one_object() */
+	struct migrate_obj_group **groups;
 };
 
 /* Argument for object iteration and migrate */
@@ -96,6 +102,51 @@ struct iter_obj_arg {
 	uint64_t		*snaps;
 	uint32_t		snap_cnt;
 	uint32_t		version;
+	/* Link in migrate_obj_group::mog_objs */
+	d_list_t		link;
+	/* Where the enumeration resumes after the object left its group */
+	struct migrate_obj_resume *resume;
+};
+
+/* Enumeration position of a large object handed over to its own ULT */
+struct migrate_obj_resume {
+	daos_anchor_t		mor_anchor;
+	daos_anchor_t		mor_dkey_anchor;
+	daos_anchor_t		mor_akey_anchor;
+	/* Index of the epoch range being enumerated, see migrate_obj_one() */
+	unsigned int		mor_snap_idx;
+};
+
+/* Client pool and container handles shared by the ULTs of an object group,
+ * which all run on the same xstream.
+ */
+struct migrate_cont_hdls {
+	daos_handle_t		mch_poh;
+	daos_handle_t		mch_coh;
+	unsigned int		mch_ref;
+};
+
+/* Objects of a container that go to the same target, migrated one after the
+ * other by one ULT so that they share the client pool and container handles
+ * and their small dkeys share batches, see migrate_obj_group_ult(). An object
+ * which needs more than one enumeration is moved to a group of its own, with
+ * its own ULT, so that it doesn't hold up the small objects behind it.
+ */
+struct migrate_obj_group {
+	/* iter_obj_arg list */
+	d_list_t		 mog_objs;
+	uuid_t			 mog_pool_uuid;
+	uuid_t			 mog_cont_uuid;
+	/* Handles shared with the groups split from this one */
+	struct migrate_cont_hdls *mog_hdls;
+	/* Target the data is migrated to */
+	unsigned int		 mog_tgt_idx;
+	/* Target the objects are enumerated on */
+	unsigned int		 mog_ult_tgt_idx;
+	uint32_t		 mog_version;
+	unsigned int		 mog_nr;
+	/* Batch of inline dkeys being filled */
+	struct migrate_batch	*mog_small;
 };
 
 static int
@@ -400,8 +451,12 @@ migrate_pool_tls_create_one(void *data)
 	pool_tls->mpt_max_eph = arg->max_eph;
 	pool_tls->mpt_pool = ds_pool_child_lookup(arg->pool_uuid);
 	pool_tls->mpt_del_local_objs = arg->del_local_objs;
-	pool_tls->mpt_inflight_max_size = MIGRATE_MAX_SIZE;
-	pool_tls->mpt_inflight_max_ult = MIGRATE_MAX_ULT;
+	migrate_ctl_init(&pool_tls->mpt_ctl, migrate_ctl_prio);
+	pool_tls->mpt_inflight_max_size = pool_tls->mpt_ctl.mc_max_size;
+	pool_tls->mpt_inflight_max_ult = pool_tls->mpt_ctl.mc_max_ult;
+	d_tm_set_gauge(tls->ot_migrate_max_size,
+		       pool_tls->mpt_inflight_max_size);
+	d_tm_set_gauge(tls->ot_migrate_max_ult, pool_tls->mpt_inflight_max_ult);
 	pool_tls->mpt_inflight_size = 0;
 	pool_tls->mpt_refcount = 1;
 	rc = daos_rank_list_copy(&pool_tls->mpt_svc_list, arg->svc_list);
@@ -1367,21 +1422,73 @@ migrate_punch(struct migrate_pool_tls *tls, struct migrate_one *mrone,
 
 static int
 migrate_dkey(struct migrate_pool_tls *tls, struct migrate_one *mrone,
-	     daos_size_t data_size)
+	     struct ds_cont_child *cont, daos_handle_t oh)
 {
+	daos_size_t	data_size;
+	int		rc;
+
+	/* punch the object */
+	if (mrone->mo_obj_punch_eph) {
+		rc = vos_obj_punch(cont->sc_hdl, mrone->mo_oid,
+				   mrone->mo_obj_punch_eph,
+				   tls->mpt_version, VOS_OF_REPLAY_PC,
+				   NULL, 0, NULL, NULL);
+		if (rc) {
+			D_ERROR(DF_UOID" punch obj failed: "DF_RC"\n",
+				DP_UOID(mrone->mo_oid), DP_RC(rc));
+			return rc;
+		}
+	}
+
+	rc = migrate_punch(tls, mrone, cont);
+	if (rc)
+		return rc;
+
+	data_size = daos_iods_len(mrone->mo_iods, mrone->mo_iod_num);
+	if (data_size == 0) {
+		D_DEBUG(DB_REBUILD, "empty mrone %p\n", mrone);
+		return 0;
+	}
+
+	if (mrone->mo_iods[0].iod_type == DAOS_IOD_SINGLE)
+		rc = migrate_fetch_update_single(mrone, oh, cont);
+	else if (data_size < MAX_BUF_SIZE || data_size == (daos_size_t)(-1))
+		rc = migrate_fetch_update_inline(mrone, oh, cont);
+	else
+		rc = migrate_fetch_update_bulk(mrone, oh, cont);
+
+	tls->mpt_rec_count += mrone->mo_rec_num;
+	tls->mpt_size += mrone->mo_size;
+
+	return rc;
+}
+
+/* Migrate the dkeys of a batch, they all belong to the same container and
+ * share the pool and container handles, the object handle is shared by the
+ * consecutive dkeys of an object.
+ */
+static int
+migrate_batch(struct migrate_pool_tls *tls, struct migrate_batch *mb)
+{
+	struct migrate_one	*mrone;
 	struct ds_cont_child	*cont;
 	struct cont_props	 props;
+	struct daos_oclass_attr	 oca;
+	daos_obj_id_t		 oid = { 0 };
+	bool			 have_oid = false;
 	daos_handle_t		 poh = DAOS_HDL_INVAL;
 	daos_handle_t		 coh = DAOS_HDL_INVAL;
 	daos_handle_t		 oh  = DAOS_HDL_INVAL;
+	int			 obj_rc = 0;
 	int			 rc;
+	int			 rc1;
 
-	rc = ds_cont_child_open_create(tls->mpt_pool_uuid, mrone->mo_cont_uuid,
+	rc = ds_cont_child_open_create(tls->mpt_pool_uuid, mb->mb_cont_uuid,
 				       &cont);
 	if (rc) {
 		if (rc == -DER_SHUTDOWN) {
 			D_DEBUG(DB_REBUILD, DF_UUID "container is being"
-				" destroyed\n", DP_UUID(mrone->mo_cont_uuid));
+				" destroyed\n", DP_UUID(mb->mb_cont_uuid));
 			rc = 0;
 		}
 		D_GOTO(out, rc);
@@ -1394,66 +1501,61 @@ migrate_dkey(struct migrate_pool_tls *tls, struct migrate_one *mrone,
 		D_GOTO(cont_put, rc);
 
 	/* Open client dc handle used to read the remote object data */
-	rc = dsc_cont_open(poh, mrone->mo_cont_uuid, tls->mpt_coh_uuid, 0,
+	rc = dsc_cont_open(poh, mb->mb_cont_uuid, tls->mpt_coh_uuid, 0,
 			   &coh);
 	if (rc)
 		D_GOTO(pool_close, rc);
 
-	/* Open the remote object */
-	rc = dsc_obj_open(coh, mrone->mo_oid.id_pub, DAOS_OO_RW, &oh);
-	if (rc)
-		D_GOTO(cont_close, rc);
-
 	if (DAOS_FAIL_CHECK(DAOS_REBUILD_TGT_NOSPACE))
-		D_GOTO(obj_close, rc = -DER_NOSPACE);
+		D_GOTO(cont_close, rc = -DER_NOSPACE);
 
 	if (DAOS_FAIL_CHECK(DAOS_REBUILD_NO_REBUILD)) {
 		D_DEBUG(DB_REBUILD, DF_UUID" disable rebuild\n",
 			DP_UUID(tls->mpt_pool_uuid));
-		D_GOTO(obj_close, rc);
+		D_GOTO(cont_close, rc);
 	}
 
 	dsc_cont_get_props(coh, &props);
-	rc = dsc_obj_id2oc_attr(mrone->mo_oid.id_pub, &props, &mrone->mo_oca);
-	if (rc) {
-		D_ERROR("Unknown object class: %d\n",
-			daos_obj_id2class(mrone->mo_oid.id_pub));
-		D_GOTO(obj_close, rc);
-	}
 
-	/* punch the object */
-	if (mrone->mo_obj_punch_eph) {
-		rc = vos_obj_punch(cont->sc_hdl, mrone->mo_oid,
-				   mrone->mo_obj_punch_eph,
-				   tls->mpt_version, VOS_OF_REPLAY_PC,
-				   NULL, 0, NULL, NULL);
-		if (rc) {
-			D_ERROR(DF_UOID" punch obj failed: "DF_RC"\n",
-				DP_UOID(mrone->mo_oid), DP_RC(rc));
-			D_GOTO(obj_close, rc);
+	d_list_for_each_entry(mrone, &mb->mb_list, mo_list) {
+		/* Open the remote object */
+		if (!have_oid ||
+		    daos_oid_cmp(mrone->mo_oid.id_pub, oid) != 0) {
+			if (daos_handle_is_valid(oh)) {
+				dsc_obj_close(oh);
+				oh = DAOS_HDL_INVAL;
+			}
+
+			oid = mrone->mo_oid.id_pub;
+			have_oid = true;
+			obj_rc = dsc_obj_open(coh, oid, DAOS_OO_RW, &oh);
+			if (obj_rc == 0) {
+				obj_rc = dsc_obj_id2oc_attr(oid, &props, &oca);
+				if (obj_rc)
+					D_ERROR("Unknown object class: %d\n",
+						daos_obj_id2class(oid));
+			}
 		}
-	}
 
-	rc = migrate_punch(tls, mrone, cont);
-	if (rc)
-		D_GOTO(obj_close, rc);
+		if (obj_rc == 0) {
+			mrone->mo_oca = oca;
+			rc1 = migrate_dkey(tls, mrone, cont, oh);
+		} else {
+			rc1 = obj_rc;
+		}
+		D_DEBUG(DB_REBUILD, DF_UOID" migrate dkey "DF_KEY": "DF_RC"\n",
+			DP_UOID(mrone->mo_oid), DP_KEY(&mrone->mo_dkey),
+			DP_RC(rc1));
 
-	if (data_size == 0) {
-		D_DEBUG(DB_REBUILD, "empty mrone %p\n", mrone);
-		D_GOTO(obj_close, rc);
+		/* Carry on with the other dkeys, a nonexistent one is only
+		 * reported if nothing else failed, see migrate_batch_ult().
+		 */
+		if (rc1 != 0 && (rc == 0 || rc == -DER_NONEXIST))
+			rc = rc1;
 	}
 
-	if (mrone->mo_iods[0].iod_type == DAOS_IOD_SINGLE)
-		rc = migrate_fetch_update_single(mrone, oh, cont);
-	else if (data_size < MAX_BUF_SIZE || data_size == (daos_size_t)(-1))
-		rc = migrate_fetch_update_inline(mrone, oh, cont);
-	else
-		rc = migrate_fetch_update_bulk(mrone, oh, cont);
-
-	tls->mpt_rec_count += mrone->mo_rec_num;
-	tls->mpt_size += mrone->mo_size;
-obj_close:
-	dsc_obj_close(oh);
+	if (daos_handle_is_valid(oh))
+		dsc_obj_close(oh);
 cont_close:
 	dsc_cont_close(poh, coh);
 pool_close:
@@ -1494,56 +1596,111 @@ migrate_one_destroy(struct migrate_one *mrone)
 	D_FREE(mrone);
 }
 
+/* Adjust the inflight limits of the pool to the load of the target, the
+ * caller wakes up the ULTs waiting for the limits.
+ */
+static void
+migrate_ctl_update(struct migrate_pool_tls *tls)
+{
+	struct obj_tls		*otls = obj_tls_get();
+	struct migrate_ctl_load	 load;
+	int			 rc;
+
+	load.mcl_fg_wait = sched_fg_wait_us();
+	load.mcl_nvme = bio_xs_load(dss_get_module_info()->dmi_nvme_ctxt);
+	rc = migrate_ctl_adjust(&tls->mpt_ctl, daos_getutime(), &load);
+	if (rc == 0)
+		return;
+
+	tls->mpt_inflight_max_size = tls->mpt_ctl.mc_max_size;
+	tls->mpt_inflight_max_ult = tls->mpt_ctl.mc_max_ult;
+	d_tm_set_gauge(otls->ot_migrate_max_size, tls->mpt_inflight_max_size);
+	d_tm_set_gauge(otls->ot_migrate_max_ult, tls->mpt_inflight_max_ult);
+	if (rc < 0)
+		d_tm_inc_counter(otls->ot_migrate_backoff, 1);
+}
+
+static void
+migrate_batch_destroy(struct migrate_batch *mb)
+{
+	struct migrate_one	*mrone;
+	struct migrate_one	*tmp;
+
+	d_list_for_each_entry_safe(mrone, tmp, &mb->mb_list, mo_list) {
+		d_list_del_init(&mrone->mo_list);
+		migrate_one_destroy(mrone);
+	}
+	D_FREE(mb);
+}
+
 static void
-migrate_one_ult(void *arg)
+migrate_batch_ult(void *arg)
 {
-	struct migrate_one	*mrone = arg;
+	struct migrate_batch	*mb = arg;
 	struct migrate_pool_tls	*tls;
-	daos_size_t		data_size;
+	struct obj_tls		*otls = obj_tls_get();
+	daos_size_t		data_size = mb->mb_size;
+	uint64_t		start;
+	uint64_t		delay;
 	int			rc = 0;
 
 	if (daos_fail_check(DAOS_REBUILD_TGT_REBUILD_HANG))
 		dss_sleep(daos_fail_value_get() * 1000000);
 
-	tls = migrate_pool_tls_lookup(mrone->mo_pool_uuid,
-				      mrone->mo_pool_tls_version);
+	tls = migrate_pool_tls_lookup(mb->mb_pool_uuid,
+				      mb->mb_pool_tls_version);
 	if (tls == NULL || tls->mpt_fini) {
 		D_WARN("some one abort the rebuild "DF_UUID"\n",
-		       DP_UUID(mrone->mo_pool_uuid));
+		       DP_UUID(mb->mb_pool_uuid));
 		goto out;
 	}
 
-	data_size = daos_iods_len(mrone->mo_iods, mrone->mo_iod_num);
-	D_DEBUG(DB_TRACE, "mrone %p data size is "DF_U64"\n",
-		mrone, data_size);
-	D_ASSERT(data_size != (daos_size_t)-1);
-	D_DEBUG(DB_REBUILD, "mrone %p inflight size "DF_U64" max "DF_U64"\n",
-		mrone, tls->mpt_inflight_size, tls->mpt_inflight_max_size);
+	D_DEBUG(DB_REBUILD, "batch %p nr %u inflight size "DF_U64" max "DF_U64
+		"\n", mb, mb->mb_nr, tls->mpt_inflight_size,
+		tls->mpt_inflight_max_size);
 
-	while (tls->mpt_inflight_size + data_size >=
+	/* A batch larger than the limit goes alone */
+	while (tls->mpt_inflight_size != 0 &&
+	       tls->mpt_inflight_size + data_size >=
 	       tls->mpt_inflight_max_size && tls->mpt_inflight_max_size != 0
 	       && !tls->mpt_fini) {
-		D_DEBUG(DB_REBUILD, "mrone %p wait "DF_U64"/"DF_U64"\n",
-			mrone, tls->mpt_inflight_size,
+		D_DEBUG(DB_REBUILD, "batch %p wait "DF_U64"/"DF_U64"\n",
+			mb, tls->mpt_inflight_size,
 			tls->mpt_inflight_max_size);
+		tls->mpt_ctl.mc_limited = 1;
 		ABT_mutex_lock(tls->mpt_inflight_mutex);
 		ABT_cond_wait(tls->mpt_inflight_cond, tls->mpt_inflight_mutex);
 		ABT_mutex_unlock(tls->mpt_inflight_mutex);
 	}
 
+	while (!tls->mpt_fini) {
+		delay = migrate_bw_take(&otls->ot_migrate_bw, data_size,
+					daos_getutime());
+		if (delay == 0)
+			break;
+		dss_sleep(max(delay / 1000, 1));
+	}
+
 	if (tls->mpt_fini)
 		D_GOTO(out, rc);
 
 	tls->mpt_inflight_size += data_size;
-	rc = migrate_dkey(tls, mrone, data_size);
+	d_tm_inc_gauge(otls->ot_migrate_inflight, data_size);
+	start = daos_getutime();
+	rc = migrate_batch(tls, mb);
+	/* the controller compares the latency of single dkeys */
+	migrate_ctl_sample(&tls->mpt_ctl,
+			   (daos_getutime() - start) / mb->mb_nr, rc);
 	tls->mpt_inflight_size -= data_size;
+	d_tm_dec_gauge(otls->ot_migrate_inflight, data_size);
+	migrate_ctl_update(tls);
 
 	ABT_mutex_lock(tls->mpt_inflight_mutex);
 	ABT_cond_broadcast(tls->mpt_inflight_cond);
 	ABT_mutex_unlock(tls->mpt_inflight_mutex);
 
-	D_DEBUG(DB_REBUILD, DF_UOID" migrate dkey "DF_KEY" inflight "DF_U64": "
-		DF_RC"\n", DP_UOID(mrone->mo_oid), DP_KEY(&mrone->mo_dkey),
+	D_DEBUG(DB_REBUILD, DF_UUID" migrate batch %p nr %u inflight "DF_U64": "
+		DF_RC"\n", DP_UUID(mb->mb_cont_uuid), mb, mb->mb_nr,
 		tls->mpt_inflight_size, DP_RC(rc));
 
 	/* Ignore nonexistent error because puller could race
@@ -1557,7 +1714,7 @@ migrate_one_ult(void *arg)
 	if (rc != -DER_NONEXIST && tls->mpt_status == 0)
 		tls->mpt_status = rc;
 out:
-	migrate_one_destroy(mrone);
+	migrate_batch_destroy(mb);
 	if (tls != NULL) {
 		tls->mpt_executed_ult++;
 		migrate_pool_tls_put(tls);
@@ -1832,6 +1989,7 @@ out:
 
 struct enum_unpack_arg {
 	struct iter_obj_arg	*arg;
+	struct migrate_obj_group *group;
 	struct daos_oclass_attr	oc_attr;
 	daos_epoch_range_t	epr;
 	d_list_t		merge_list;
@@ -2092,14 +2250,84 @@ put:
 	return rc;
 }
 
+/* Small dkeys are batched up to these bounds */
+#define MIGRATE_BATCH_NR	64
+#define MIGRATE_BATCH_SIZE	(1 << 20)
+
+/* Can the dkey be migrated without fetching its data? */
+static bool
+migrate_one_is_inline(struct migrate_one *mrone, daos_size_t data_size)
+{
+	int	i;
+
+	if (data_size >= MAX_BUF_SIZE)
+		return false;
+
+	for (i = 0; i < mrone->mo_iod_num; i++) {
+		if (mrone->mo_iods[i].iod_size == 0)
+			continue;
+
+		/* single values are always fetched */
+		if (mrone->mo_iods[i].iod_type == DAOS_IOD_SINGLE)
+			return false;
+
+		if (mrone->mo_sgls == NULL || mrone->mo_sgls[i].sg_nr == 0)
+			return false;
+	}
+
+	return true;
+}
+
+static struct migrate_batch *
+migrate_batch_alloc(struct migrate_pool_tls *tls,
+		    struct migrate_obj_group *group)
+{
+	struct migrate_batch	*mb;
+
+	D_ALLOC_PTR(mb);
+	if (mb == NULL)
+		return NULL;
+
+	D_INIT_LIST_HEAD(&mb->mb_list);
+	uuid_copy(mb->mb_pool_uuid, tls->mpt_pool_uuid);
+	uuid_copy(mb->mb_cont_uuid, group->mog_cont_uuid);
+	mb->mb_pool_tls_version = tls->mpt_version;
+	return mb;
+}
+
+static int
+migrate_batch_start(struct migrate_pool_tls *tls,
+		    struct migrate_obj_group *group, struct migrate_batch *mb)
+{
+	int	rc;
+
+	rc = dss_ult_create(migrate_batch_ult, mb, DSS_XS_VOS,
+			    group->mog_tgt_idx, MIGRATE_STACK_SIZE, NULL);
+	if (rc) {
+		migrate_batch_destroy(mb);
+		return rc;
+	}
+	tls->mpt_generated_ult++;
+	return 0;
+}
+
+/*
+ * Dkeys whose data came inline with the enumeration do not need any RPC, the
+ * ones that are small enough are migrated together by one ULT, with the ones
+ * of the other objects of the group. The others are migrated by a ULT each,
+ * so that their fetches run in parallel.
+ */
 static int
 migrate_start_ult(struct enum_unpack_arg *unpack_arg)
 {
 	struct migrate_pool_tls *tls;
 	struct iter_obj_arg	*arg = unpack_arg->arg;
+	struct migrate_obj_group *group = unpack_arg->group;
+	struct migrate_batch	*mb;
 	struct migrate_one	*mrone;
 	struct migrate_one	*tmp;
-	int			rc = 0;
+	daos_size_t		 data_size;
+	int			 rc = 0;
 
 	tls = migrate_pool_tls_lookup(arg->pool_uuid, arg->version);
 	if (tls == NULL || tls->mpt_fini) {
@@ -2118,14 +2346,40 @@ migrate_start_ult(struct enum_unpack_arg *unpack_arg)
 			DP_KEY(&mrone->mo_dkey), arg->tgt_idx,
 			mrone->mo_iod_num);
 
-		d_list_del_init(&mrone->mo_list);
-		rc = dss_ult_create(migrate_one_ult, mrone, DSS_XS_VOS,
-				    arg->tgt_idx, MIGRATE_STACK_SIZE, NULL);
-		if (rc) {
-			migrate_one_destroy(mrone);
-			break;
+		data_size = daos_iods_len(mrone->mo_iods, mrone->mo_iod_num);
+		D_ASSERT(data_size != (daos_size_t)-1);
+
+		if (migrate_one_is_inline(mrone, data_size)) {
+			if (group->mog_small == NULL) {
+				group->mog_small = migrate_batch_alloc(tls,
+								       group);
+				if (group->mog_small == NULL)
+					D_GOTO(put, rc = -DER_NOMEM);
+			}
+			mb = group->mog_small;
+		} else {
+			mb = migrate_batch_alloc(tls, group);
+			if (mb == NULL)
+				D_GOTO(put, rc = -DER_NOMEM);
+		}
+
+		d_list_move_tail(&mrone->mo_list, &mb->mb_list);
+		mb->mb_nr++;
+		mb->mb_size += data_size;
+
+		/* The batch of inline dkeys is started once full, or once all
+		 * the objects of the group are enumerated.
+		 */
+		if (mb == group->mog_small) {
+			if (mb->mb_nr < MIGRATE_BATCH_NR &&
+			    mb->mb_size < MIGRATE_BATCH_SIZE)
+				continue;
+			group->mog_small = NULL;
 		}
-		tls->mpt_generated_ult++;
+
+		rc = migrate_batch_start(tls, group, mb);
+		if (rc)
+			D_GOTO(put, rc);
 	}
 
 put:
@@ -2134,15 +2388,23 @@ put:
 	return rc;
 }
 
-#define KDS_NUM		16
-#define ITER_BUF_SIZE	2048
+/* Keys and inline data enumerated per RPC, so that an object with many small
+ * dkeys is enumerated in a few RPCs and migrated in a few batches.
+ */
+#define KDS_NUM		64
+#define ITER_BUF_SIZE	8192
+
+/* The object didn't fit in one enumeration and is split from its group */
+#define MIGRATE_OBJ_SPLIT	1
 
 /**
- * Iterate akeys/dkeys of the object
+ * Iterate akeys/dkeys of the object, with the pool and container handles of
+ * its group
  */
 static int
 migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
-			 struct iter_obj_arg *arg)
+			 struct iter_obj_arg *arg,
+			 struct migrate_obj_group *group, daos_handle_t coh)
 {
 	daos_anchor_t		 anchor;
 	daos_anchor_t		 dkey_anchor;
@@ -2157,8 +2419,6 @@ migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
 	struct enum_unpack_arg	 unpack_arg = { 0 };
 	d_iov_t			 iov = { 0 };
 	d_sg_list_t		 sgl = { 0 };
-	daos_handle_t		 poh = DAOS_HDL_INVAL;
-	daos_handle_t		 coh = DAOS_HDL_INVAL;
 	daos_handle_t		 oh  = DAOS_HDL_INVAL;
 	uint32_t		 num;
 	int			 rc = 0;
@@ -2167,31 +2427,25 @@ migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
 		DF_U64"-"DF_U64"\n", DP_UOID(arg->oid), arg->shard, epr->epr_lo,
 		epr->epr_hi);
 
-	rc = dsc_pool_open(tls->mpt_pool_uuid, tls->mpt_poh_uuid, 0,
-			   NULL, tls->mpt_pool->spc_pool->sp_map,
-			   &tls->mpt_svc_list, &poh);
-	if (rc) {
-		D_ERROR("dsc_pool_open failed: "DF_RC"\n", DP_RC(rc));
-		D_GOTO(out, rc);
-	}
-
-	rc = dsc_cont_open(poh, arg->cont_uuid, tls->mpt_coh_uuid, 0, &coh);
-	if (rc) {
-		D_ERROR("dsc_cont_open failed: "DF_RC"\n", DP_RC(rc));
-		D_GOTO(out_pool, rc);
-	}
-
 	rc = dsc_obj_open(coh, arg->oid.id_pub, DAOS_OO_RW, &oh);
 	if (rc) {
 		D_ERROR("dsc_obj_open failed: "DF_RC"\n", DP_RC(rc));
-		D_GOTO(out_cont, rc);
+		D_GOTO(out, rc);
 	}
 
-	memset(&anchor, 0, sizeof(anchor));
-	memset(&dkey_anchor, 0, sizeof(dkey_anchor));
-	dc_obj_shard2anchor(&dkey_anchor, arg->shard);
-	memset(&akey_anchor, 0, sizeof(akey_anchor));
+	if (arg->resume != NULL) {
+		anchor = arg->resume->mor_anchor;
+		dkey_anchor = arg->resume->mor_dkey_anchor;
+		akey_anchor = arg->resume->mor_akey_anchor;
+		D_FREE(arg->resume);
+	} else {
+		memset(&anchor, 0, sizeof(anchor));
+		memset(&dkey_anchor, 0, sizeof(dkey_anchor));
+		dc_obj_shard2anchor(&dkey_anchor, arg->shard);
+		memset(&akey_anchor, 0, sizeof(akey_anchor));
+	}
 	unpack_arg.arg = arg;
+	unpack_arg.group = group;
 	unpack_arg.epr = *epr;
 	D_INIT_LIST_HEAD(&unpack_arg.merge_list);
 	buf = stack_buf;
@@ -2202,7 +2456,7 @@ migrate_one_epoch_object(daos_epoch_range_t *epr, struct migrate_pool_tls *tls,
 	if (rc) {
 		D_ERROR("Unknown object class: %d\n",
 			daos_obj_id2class(arg->oid.id_pub));
-		D_GOTO(out_cont, rc);
+		D_GOTO(out_obj, rc);
 	}
 
 	d_iov_set(&csum, stack_csum_buf, CSUM_BUF_SIZE);
@@ -2318,6 +2572,22 @@ retry:
 
 		if (daos_anchor_is_eof(&dkey_anchor))
 			break;
+
+		/* Hand a large object over to its own ULT, unless it's the
+		 * last one of the group.
+		 */
+		if (arg->link.next != &group->mog_objs) {
+			D_ALLOC_PTR(arg->resume);
+			if (arg->resume == NULL) {
+				rc = -DER_NOMEM;
+				break;
+			}
+			arg->resume->mor_anchor = anchor;
+			arg->resume->mor_dkey_anchor = dkey_anchor;
+			arg->resume->mor_akey_anchor = akey_anchor;
+			rc = MIGRATE_OBJ_SPLIT;
+			break;
+		}
 	}
 
 	if (buf != NULL && buf != stack_buf)
@@ -2326,11 +2596,8 @@ retry:
 	if (csum.iov_buf != NULL && csum.iov_buf != stack_csum_buf)
 		D_FREE(csum.iov_buf);
 
+out_obj:
 	dsc_obj_close(oh);
-out_cont:
-	dsc_cont_close(poh, coh);
-out_pool:
-	dsc_pool_close(poh);
 out:
 	D_DEBUG(DB_REBUILD, "obj "DF_UOID" for shard %u eph "
 		DF_U64"-"DF_U64": "DF_RC"\n", DP_UOID(arg->oid), arg->shard,
@@ -2456,33 +2723,22 @@ destroy_existing_obj(struct migrate_pool_tls *tls, unsigned int tgt_idx,
 }
 
 /**
- * This ULT manages migration one object ID for one container. It does not do
- * the data migration itself - instead it iterates akeys/dkeys as a client and
- * schedules the actual data migration on their own ULTs
- *
- * If this is reintegration (mpt_del_local_objs==true), this ULT will be
- * launched on the target where data is stored so that it can be safely deleted
- * prior to migration. If this not reintegration (mpt_del_local_objs==false),
- * this ULT will be launched on a pseudorandom ULT to increase parallelism by
- * spreading the work among many xstreams.
- *
- * Note that this ULT is guaranteed to only be spawned once per object per
- * container per migration session (using mpt_migrated_root)
+ * Migrate one object ID for one container. It does not do the data migration
+ * itself - instead it iterates akeys/dkeys as a client and schedules the
+ * actual data migration on their own ULTs
  */
-static void
-migrate_obj_ult(void *data)
+static int
+migrate_obj_one(struct migrate_pool_tls *tls, struct iter_obj_arg *arg,
+		struct migrate_obj_group *group, daos_handle_t coh)
 {
-	struct iter_obj_arg	*arg = data;
-	struct migrate_pool_tls	*tls = NULL;
-	daos_epoch_range_t	 epr;
-	int			 i;
-	int			 rc;
+	daos_epoch_range_t	epr;
+	unsigned int		i = 0;
+	int			rc;
 
-	tls = migrate_pool_tls_lookup(arg->pool_uuid, arg->version);
-	if (tls == NULL || tls->mpt_fini) {
-		D_WARN("some one abort the rebuild "DF_UUID"\n",
-		       DP_UUID(arg->pool_uuid));
-		D_GOTO(free, rc = 0);
+	/* Resumed after the split, the object was destroyed/punched already */
+	if (arg->resume != NULL) {
+		i = arg->resume->mor_snap_idx;
+		goto migrate;
 	}
 
 	if (tls->mpt_del_local_objs) {
@@ -2498,34 +2754,44 @@ migrate_obj_ult(void *data)
 			 */
 			D_ERROR("destroy_existing_obj failed: "DF_RC"\n",
 				DP_RC(rc));
-			D_GOTO(free, rc);
+			return rc;
 		}
 	}
 
 	if (arg->epoch != DAOS_EPOCH_MAX) {
 		rc = migrate_obj_punch(arg);
 		if (rc)
-			D_GOTO(free, rc);
+			return rc;
 	}
 
-	for (i = 0; i < arg->snap_cnt; i++) {
-		epr.epr_lo = i > 0 ? arg->snaps[i-1] + 1 : 0;
-		epr.epr_hi = arg->snaps[i];
-		rc = migrate_one_epoch_object(&epr, tls, arg);
+migrate:
+	/* One range per snapshot, then the one after the last snapshot */
+	for (; i <= arg->snap_cnt; i++) {
+		epr.epr_lo = i > 0 ? arg->snaps[i - 1] + 1 : 0;
+		if (i < arg->snap_cnt) {
+			epr.epr_hi = arg->snaps[i];
+		} else {
+			D_ASSERT(tls->mpt_max_eph != 0);
+			epr.epr_hi = tls->mpt_max_eph;
+		}
+
+		rc = migrate_one_epoch_object(&epr, tls, arg, group, coh);
+		if (rc == MIGRATE_OBJ_SPLIT)
+			arg->resume->mor_snap_idx = i;
 		if (rc)
-			D_GOTO(free, rc);
+			return rc;
 	}
 
-	epr.epr_lo = arg->snaps ? arg->snaps[arg->snap_cnt - 1] + 1 : 0;
-	D_ASSERT(tls->mpt_max_eph != 0);
-	epr.epr_hi = tls->mpt_max_eph;
-	rc = migrate_one_epoch_object(&epr, tls, arg);
+	return 0;
+}
 
-free:
+static void
+migrate_obj_done(struct migrate_pool_tls *tls, struct iter_obj_arg *arg,
+		 int rc)
+{
 	if (arg->epoch == DAOS_EPOCH_MAX)
 		tls->mpt_obj_count++;
 
-	tls->mpt_obj_executed_ult++;
 	if (rc == -DER_NONEXIST) {
 		struct ds_cont_child *cont_child = NULL;
 		int ret;
@@ -2551,13 +2817,198 @@ free:
 		tls->mpt_status = rc;
 
 	D_DEBUG(DB_REBUILD, ""DF_UUID"/%u stop migrate obj "DF_UOID
-		" for shard %u executed "DF_U64" : " DF_RC"\n",
-		DP_UUID(tls->mpt_pool_uuid), tls->mpt_version,
-		DP_UOID(arg->oid), arg->shard, tls->mpt_obj_executed_ult,
-		DP_RC(rc));
-	D_FREE(arg->snaps);
-	D_FREE(arg);
-	migrate_pool_tls_put(tls);
+		" for shard %u: "DF_RC"\n", DP_UUID(tls->mpt_pool_uuid),
+		tls->mpt_version, DP_UOID(arg->oid), arg->shard, DP_RC(rc));
+}
+
+static void
+migrate_obj_group_destroy(struct migrate_obj_group *group)
+{
+	struct iter_obj_arg	*arg;
+	struct iter_obj_arg	*tmp;
+
+	d_list_for_each_entry_safe(arg, tmp, &group->mog_objs, link) {
+		d_list_del(&arg->link);
+		D_FREE(arg->resume);
+		D_FREE(arg->snaps);
+		D_FREE(arg);
+	}
+	if (group->mog_small != NULL)
+		migrate_batch_destroy(group->mog_small);
+	D_FREE(group);
+}
+
+static int
+migrate_cont_hdls_open(struct migrate_pool_tls *tls, uuid_t cont_uuid,
+		       struct migrate_cont_hdls **hdlsp)
+{
+	struct migrate_cont_hdls *hdls;
+	int			  rc;
+
+	D_ALLOC_PTR(hdls);
+	if (hdls == NULL)
+		return -DER_NOMEM;
+
+	rc = dsc_pool_open(tls->mpt_pool_uuid, tls->mpt_poh_uuid, 0,
+			   NULL, tls->mpt_pool->spc_pool->sp_map,
+			   &tls->mpt_svc_list, &hdls->mch_poh);
+	if (rc) {
+		D_ERROR("dsc_pool_open failed: "DF_RC"\n", DP_RC(rc));
+		D_GOTO(free, rc);
+	}
+
+	rc = dsc_cont_open(hdls->mch_poh, cont_uuid, tls->mpt_coh_uuid, 0,
+			   &hdls->mch_coh);
+	if (rc) {
+		D_ERROR("dsc_cont_open failed: "DF_RC"\n", DP_RC(rc));
+		dsc_pool_close(hdls->mch_poh);
+		D_GOTO(free, rc);
+	}
+
+	hdls->mch_ref = 1;
+	*hdlsp = hdls;
+	return 0;
+free:
+	D_FREE(hdls);
+	return rc;
+}
+
+static void
+migrate_cont_hdls_put(struct migrate_cont_hdls *hdls)
+{
+	D_ASSERT(hdls->mch_ref > 0);
+	if (--hdls->mch_ref > 0)
+		return;
+
+	dsc_cont_close(hdls->mch_poh, hdls->mch_coh);
+	dsc_pool_close(hdls->mch_poh);
+	D_FREE(hdls);
+}
+
+static void migrate_obj_group_ult(void *data);
+
+/*
+ * Move a large object to a group of its own, migrated by another ULT on the
+ * same xstream with the same handles.
+ */
+static int
+migrate_obj_group_split(struct migrate_pool_tls *tls,
+			struct migrate_obj_group *group,
+			struct iter_obj_arg *arg)
+{
+	struct migrate_obj_group *split;
+	d_list_t		 *next = arg->link.next;
+	int			  rc;
+
+	D_ALLOC_PTR(split);
+	if (split == NULL)
+		return -DER_NOMEM;
+
+	D_INIT_LIST_HEAD(&split->mog_objs);
+	uuid_copy(split->mog_pool_uuid, group->mog_pool_uuid);
+	uuid_copy(split->mog_cont_uuid, group->mog_cont_uuid);
+	split->mog_hdls = group->mog_hdls;
+	split->mog_hdls->mch_ref++;
+	split->mog_tgt_idx = group->mog_tgt_idx;
+	split->mog_ult_tgt_idx = group->mog_ult_tgt_idx;
+	split->mog_version = group->mog_version;
+	split->mog_nr = 1;
+	d_list_move_tail(&arg->link, &split->mog_objs);
+
+	rc = dss_ult_create(migrate_obj_group_ult, split, DSS_XS_VOS,
+			    split->mog_ult_tgt_idx, MIGRATE_STACK_SIZE, NULL);
+	if (rc) {
+		/* Put the object back, the caller reports the failure */
+		d_list_move_tail(&arg->link, next);
+		migrate_cont_hdls_put(split->mog_hdls);
+		split->mog_hdls = NULL;
+		migrate_obj_group_destroy(split);
+		return rc;
+	}
+
+	tls->mpt_obj_generated_ult++;
+	D_DEBUG(DB_REBUILD, "Split "DF_UOID" from group %p, generated "
+		DF_U64"\n", DP_UOID(arg->oid), group,
+		tls->mpt_obj_generated_ult);
+	return 0;
+}
+
+/**
+ * This ULT migrates a group of objects of one container, one after the other
+ * with the same client pool and container handles. An object that doesn't fit
+ * in one enumeration continues on a ULT of its own, see
+ * migrate_obj_group_split().
+ *
+ * If this is reintegration (mpt_del_local_objs==true), this ULT will be
+ * launched on the target where data is stored so that it can be safely deleted
+ * prior to migration. If this not reintegration (mpt_del_local_objs==false),
+ * this ULT will be launched on a pseudorandom ULT to increase parallelism by
+ * spreading the work among many xstreams.
+ *
+ * Note that each object is guaranteed to only be in one group per container
+ * per migration session (using mpt_migrated_root)
+ */
+static void
+migrate_obj_group_ult(void *data)
+{
+	struct migrate_obj_group *group = data;
+	struct migrate_pool_tls	*tls = NULL;
+	struct iter_obj_arg	*arg;
+	struct iter_obj_arg	*tmp;
+	daos_handle_t		 coh;
+	int			 rc = 0;
+	int			 rc1;
+
+	tls = migrate_pool_tls_lookup(group->mog_pool_uuid,
+				      group->mog_version);
+	if (tls == NULL || tls->mpt_fini) {
+		D_WARN("some one abort the rebuild "DF_UUID"\n",
+		       DP_UUID(group->mog_pool_uuid));
+		D_GOTO(free, rc = 0);
+	}
+
+	/* A group split from another one shares its handles */
+	if (group->mog_hdls == NULL)
+		rc = migrate_cont_hdls_open(tls, group->mog_cont_uuid,
+					    &group->mog_hdls);
+	coh = rc == 0 ? group->mog_hdls->mch_coh : DAOS_HDL_INVAL;
+
+	/* The objects fail with the error of the handles, if any */
+	d_list_for_each_entry_safe(arg, tmp, &group->mog_objs, link) {
+		if (tls->mpt_fini)
+			rc1 = 0;
+		else if (rc == 0)
+			rc1 = migrate_obj_one(tls, arg, group, coh);
+		else
+			rc1 = rc;
+
+		if (rc1 == MIGRATE_OBJ_SPLIT) {
+			rc1 = migrate_obj_group_split(tls, group, arg);
+			if (rc1 == 0)
+				continue;
+		}
+		migrate_obj_done(tls, arg, rc1);
+	}
+
+	if (group->mog_small != NULL && !tls->mpt_fini) {
+		rc1 = migrate_batch_start(tls, group, group->mog_small);
+		group->mog_small = NULL;
+		if (tls->mpt_status == 0 && rc1 < 0)
+			tls->mpt_status = rc1;
+	}
+
+free:
+	if (tls != NULL) {
+		tls->mpt_obj_executed_ult++;
+		D_DEBUG(DB_REBUILD, DF_UUID"/%u stop migrate group %p of %u "
+			"objs executed "DF_U64"\n", DP_UUID(tls->mpt_pool_uuid),
+			tls->mpt_version, group, group->mog_nr,
+			tls->mpt_obj_executed_ult);
+		migrate_pool_tls_put(tls);
+	}
+	if (group->mog_hdls != NULL)
+		migrate_cont_hdls_put(group->mog_hdls);
+	migrate_obj_group_destroy(group);
 }
 
 struct migrate_obj_val {
@@ -2566,6 +3017,60 @@ struct migrate_obj_val {
 	uint32_t	tgt_idx;
 };
 
+/* Objects of a container enumerated by one ULT, the ones that need more than
+ * one enumeration are split to their own ULT, see migrate_one_epoch_object().
+ */
+#define MIGRATE_OBJ_GROUP_NR	16
+
+/* Start the ULT of the object group of a target */
+static int
+migrate_obj_group_start(struct iter_cont_arg *cont_arg, unsigned int tgt_idx)
+{
+	struct migrate_pool_tls	 *tls = cont_arg->pool_tls;
+	struct migrate_obj_group *group = cont_arg->groups[tgt_idx];
+	int			  rc;
+
+	cont_arg->groups[tgt_idx] = NULL;
+	rc = dss_ult_create(migrate_obj_group_ult, group, DSS_XS_VOS,
+			    group->mog_ult_tgt_idx, MIGRATE_STACK_SIZE, NULL);
+	if (rc) {
+		migrate_obj_group_destroy(group);
+		return rc;
+	}
+
+	tls->mpt_obj_generated_ult++;
+	D_DEBUG(DB_REBUILD, "Start group of %u objs to tgt %u, generated "
+		DF_U64"\n", group->mog_nr, tgt_idx,
+		tls->mpt_obj_generated_ult);
+	return 0;
+}
+
+/* Start the object groups which are not full at the end of an iteration */
+static int
+migrate_obj_groups_start(struct iter_cont_arg *cont_arg)
+{
+	int	i;
+	int	rc = 0;
+	int	rc1;
+
+	for (i = 0; i < dss_tgt_nr; i++) {
+		if (cont_arg->groups[i] == NULL)
+			continue;
+
+		if (cont_arg->pool_tls->mpt_fini) {
+			migrate_obj_group_destroy(cont_arg->groups[i]);
+			cont_arg->groups[i] = NULL;
+			continue;
+		}
+
+		rc1 = migrate_obj_group_start(cont_arg, i);
+		if (rc == 0)
+			rc = rc1;
+	}
+
+	return rc;
+}
+
 /* This is still running on the main migration ULT */
 static int
 migrate_one_object(daos_unit_oid_t oid, daos_epoch_t eph, unsigned int shard,
@@ -2573,14 +3078,15 @@ migrate_one_object(daos_unit_oid_t oid, daos_epoch_t eph, unsigned int shard,
 {
 	struct iter_cont_arg	*cont_arg = data;
 	struct iter_obj_arg	*obj_arg;
+	struct migrate_obj_group *group;
 	struct migrate_pool_tls *tls = cont_arg->pool_tls;
 	daos_handle_t		 toh = tls->mpt_migrated_root_hdl;
 	struct migrate_obj_val	 val;
 	d_iov_t			 val_iov;
-	int			 ult_tgt_idx;
 	int			 rc;
 
 	D_ASSERT(daos_handle_is_valid(toh));
+	D_ASSERT(tgt_idx < dss_tgt_nr);
 
 	D_ALLOC_PTR(obj_arg);
 	if (obj_arg == NULL)
@@ -2604,33 +3110,40 @@ migrate_one_object(daos_unit_oid_t oid, daos_epoch_t eph, unsigned int shard,
 		       sizeof(*obj_arg->snaps) * cont_arg->snap_cnt);
 	}
 
-	if (cont_arg->pool_tls->mpt_del_local_objs) {
-		/* This ULT will need to destroy objects prior to migration. To
-		 * do this it must be scheduled on the xstream where that data
-		 * is stored.
-		 */
-		ult_tgt_idx = tgt_idx;
-	} else {
-		/* This ULT will not need to destroy data, it will act as a
-		 * client to enumerate the data to migrate, then migrate that
-		 * data on a different ULT that is pinned to the appropriate
-		 * target.
-		 *
-		 * Because no data migration happens here, schedule this
-		 * pseudorandomly to get better performance by leveraging all
-		 * the xstreams.
-		 */
-		ult_tgt_idx = oid.id_pub.lo % dss_tgt_nr;
-	}
+	group = cont_arg->groups[tgt_idx];
+	if (group == NULL) {
+		D_ALLOC_PTR(group);
+		if (group == NULL)
+			D_GOTO(free, rc = -DER_NOMEM);
 
-	/* Let's iterate the object on different xstream */
-	rc = dss_ult_create(migrate_obj_ult, obj_arg, DSS_XS_VOS,
-			    ult_tgt_idx, MIGRATE_STACK_SIZE,
-			    NULL);
-	if (rc)
-		goto free;
+		D_INIT_LIST_HEAD(&group->mog_objs);
+		uuid_copy(group->mog_pool_uuid, tls->mpt_pool_uuid);
+		uuid_copy(group->mog_cont_uuid, cont_arg->cont_uuid);
+		group->mog_version = tls->mpt_version;
+		group->mog_tgt_idx = tgt_idx;
+		if (tls->mpt_del_local_objs) {
+			/* This ULT will need to destroy objects prior to
+			 * migration. To do this it must be scheduled on the
+			 * xstream where that data is stored.
+			 */
+			group->mog_ult_tgt_idx = tgt_idx;
+		} else {
+			/* This ULT will not need to destroy data, it will act
+			 * as a client to enumerate the data to migrate, then
+			 * migrate that data on a different ULT that is pinned
+			 * to the appropriate target.
+			 *
+			 * Because no data migration happens here, schedule
+			 * this pseudorandomly to get better performance by
+			 * leveraging all the xstreams.
+			 */
+			group->mog_ult_tgt_idx = oid.id_pub.lo % dss_tgt_nr;
+		}
+		cont_arg->groups[tgt_idx] = group;
+	}
 
-	tls->mpt_obj_generated_ult++;
+	d_list_add_tail(&obj_arg->link, &group->mog_objs);
+	group->mog_nr++;
 
 	val.epoch = eph;
 	val.shard = shard;
@@ -2639,9 +3152,12 @@ migrate_one_object(daos_unit_oid_t oid, daos_epoch_t eph, unsigned int shard,
 	d_iov_set(&val_iov, &val, sizeof(struct migrate_obj_val));
 	rc = obj_tree_insert(toh, cont_arg->cont_uuid, oid, &val_iov);
 	D_DEBUG(DB_REBUILD, "Insert "DF_UUID"/"DF_UUID"/"DF_UOID": ver %u "
-		"generated "DF_U64" "DF_RC"\n", DP_UUID(tls->mpt_pool_uuid),
+		"group %p nr %u "DF_RC"\n", DP_UUID(tls->mpt_pool_uuid),
 		DP_UUID(cont_arg->cont_uuid), DP_UOID(oid), tls->mpt_version,
-		tls->mpt_obj_generated_ult, DP_RC(rc));
+		group, group->mog_nr, DP_RC(rc));
+
+	if (group->mog_nr >= MIGRATE_OBJ_GROUP_NR)
+		return migrate_obj_group_start(cont_arg, tgt_idx);
 
 	return 0;
 
@@ -2740,7 +3256,13 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 	arg.snap_cnt	= snap_cnt;
 	arg.pool_tls	= tls;
 	uuid_copy(arg.cont_uuid, cont_uuid);
+	D_ALLOC_ARRAY(arg.groups, dss_tgt_nr);
+	if (arg.groups == NULL)
+		D_GOTO(free, rc = -DER_NOMEM);
+
 	while (!dbtree_is_empty(root->root_hdl)) {
+		int rc1;
+
 		uint64_t ult_cnt;
 
 		D_ASSERT(tls->mpt_obj_generated_ult >=
@@ -2753,6 +3275,7 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 			      tls->mpt_executed_ult);
 
 		while (ult_cnt >= tls->mpt_inflight_max_ult && !tls->mpt_fini) {
+			tls->mpt_ctl.mc_limited = 1;
 			ABT_mutex_lock(tls->mpt_inflight_mutex);
 			ABT_cond_wait(tls->mpt_inflight_cond,
 				      tls->mpt_inflight_mutex);
@@ -2774,6 +3297,10 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 
 		rc = dbtree_iterate(root->root_hdl, DAOS_INTENT_MIGRATION,
 				    false, migrate_obj_iter_cb, &arg);
+		/* The groups are only filled within one iteration */
+		rc1 = migrate_obj_groups_start(&arg);
+		if (rc == 0)
+			rc = rc1;
 		if (rc || tls->mpt_fini)
 			break;
 	}
@@ -2805,6 +3332,7 @@ migrate_cont_iter_cb(daos_handle_t ih, d_iov_t *key_iov,
 		D_GOTO(free, rc);
 	}
 free:
+	D_FREE(arg.groups);
 	if (snapshots)
 		D_FREE(snapshots);
 
@@ -0,0 +1,144 @@
+/*
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Unit tests of the client per-target latency estimates used to select the
+ * replica of a fetch.
+ */
+
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <cmocka.h>
+#include <daos/common.h>
+#include "../obj_internal.h"
+
+unsigned int	obj_hedge_sec = 2;
+
+/* a completed fetch which took about \a usec */
+static void
+fetch_sample(uint32_t rank, uint32_t tgt_idx, int usec, int rc)
+{
+	uint64_t	start;
+
+	start = obj_tgt_lat_start(rank, tgt_idx);
+	if (usec > 0)
+		usleep(usec);
+	obj_tgt_lat_end(rank, tgt_idx, start, rc);
+}
+
+static void
+test_unknown_target(void **state)
+{
+	assert_int_equal(obj_tgt_lat_cost(1, 0, daos_get_ntime()), 0);
+	assert_int_equal(obj_tgt_lat_hedge_sec(1, 0), obj_hedge_sec);
+
+	fetch_sample(1, 0, 0, 0);
+	assert_true(obj_tgt_lat_cost(1, 0, daos_get_ntime()) > 0);
+}
+
+static void
+test_slow_target_costs_more(void **state)
+{
+	uint64_t	now;
+	int		i;
+
+	for (i = 0; i < 8; i++) {
+		fetch_sample(2, 0, 0, 0);
+		fetch_sample(2, 1, 5000, 0);
+	}
+
+	now = daos_get_ntime();
+	assert_true(obj_tgt_lat_cost(2, 1, now) > obj_tgt_lat_cost(2, 0, now));
+}
+
+static void
+test_inflight(void **state)
+{
+	uint64_t	start[2];
+	uint64_t	cost;
+
+	fetch_sample(3, 2, 100, 0);
+	cost = obj_tgt_lat_cost(3, 2, daos_get_ntime());
+
+	start[0] = obj_tgt_lat_start(3, 2);
+	start[1] = obj_tgt_lat_start(3, 2);
+	assert_int_equal(obj_tgt_lat_cost(3, 2, daos_get_ntime()), cost * 3);
+
+	/* errors other than time outs are not latency samples */
+	obj_tgt_lat_end(3, 2, start[0] - NSEC_PER_SEC, -DER_NONEXIST);
+	obj_tgt_lat_end(3, 2, start[1] - NSEC_PER_SEC, -DER_INPROGRESS);
+	assert_int_equal(obj_tgt_lat_cost(3, 2, daos_get_ntime()), cost);
+}
+
+static void
+test_decay(void **state)
+{
+	uint64_t	now;
+	uint64_t	cost;
+	uint64_t	start;
+
+	fetch_sample(4, 0, 1000, 0);
+	now = daos_get_ntime();
+	cost = obj_tgt_lat_cost(4, 0, now);
+
+	/* halved for each idle second */
+	assert_int_equal(obj_tgt_lat_cost(4, 0, now + 3ULL * NSEC_PER_SEC),
+			 cost >> 3);
+	assert_int_equal(obj_tgt_lat_cost(4, 0, now + 100ULL * NSEC_PER_SEC),
+			 1);
+
+	/* but not while a fetch is pending */
+	start = obj_tgt_lat_start(4, 0);
+	assert_int_equal(obj_tgt_lat_cost(4, 0, now + 3ULL * NSEC_PER_SEC),
+			 cost * 2);
+	obj_tgt_lat_end(4, 0, start, -DER_NONEXIST);
+}
+
+static void
+test_hedge_timeout(void **state)
+{
+	uint64_t	start;
+
+	fetch_sample(5, 0, 0, 0);
+	assert_int_equal(obj_tgt_lat_hedge_sec(5, 0), obj_hedge_sec);
+
+	/* a time out of several seconds pushes the hedge timeout further */
+	start = obj_tgt_lat_start(5, 0);
+	obj_tgt_lat_end(5, 0, start - 10ULL * NSEC_PER_SEC, -DER_TIMEDOUT);
+	assert_true(obj_tgt_lat_hedge_sec(5, 0) > obj_hedge_sec);
+}
+
+static void
+test_many_targets(void **state)
+{
+	uint32_t	rank;
+
+	/* tracked before the table fills up */
+	fetch_sample(6, 0, 0, 0);
+
+	/* the table is bounded, targets which do not fit are not tracked */
+	for (rank = 1000; rank < 11000; rank++)
+		fetch_sample(rank, 7, 0, 0);
+
+	fetch_sample(6, 0, 0, 0);
+	assert_true(obj_tgt_lat_cost(6, 0, daos_get_ntime()) > 0);
+}
+
+int
+main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_unknown_target),
+		cmocka_unit_test(test_slow_target_costs_more),
+		cmocka_unit_test(test_inflight),
+		cmocka_unit_test(test_decay),
+		cmocka_unit_test(test_hedge_timeout),
+		cmocka_unit_test(test_many_targets),
+	};
+
+	return cmocka_run_group_tests_name("obj_cli_lat", tests, NULL, NULL);
+}
@@ -0,0 +1,191 @@
+/*
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Unit tests of the adaptive limits and of the bandwidth cap of the inflight
+ * migration of a target.
+ */
+
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <cmocka.h>
+#include <daos/common.h>
+#include "../obj_internal.h"
+
+#define PERIOD	100000	/* us, the adjustment period */
+
+static struct migrate_ctl_load	idle_load;
+
+static void
+test_raise_when_limited(void **state)
+{
+	struct migrate_ctl	ctl;
+	uint64_t		size;
+	uint32_t		ult;
+	uint64_t		now = PERIOD;
+	int			i;
+
+	migrate_ctl_init(&ctl, MIGRATE_PRIO_NORMAL);
+	size = ctl.mc_max_size;
+	ult = ctl.mc_max_ult;
+
+	/* nothing waited for the limits */
+	assert_int_equal(migrate_ctl_adjust(&ctl, now, &idle_load), 0);
+	assert_int_equal(ctl.mc_max_size, size);
+
+	/* not before the end of the period */
+	ctl.mc_limited = 1;
+	assert_int_equal(migrate_ctl_adjust(&ctl, now + 1, &idle_load), 0);
+
+	now += PERIOD;
+	assert_int_equal(migrate_ctl_adjust(&ctl, now, &idle_load), 1);
+	assert_true(ctl.mc_max_size > size);
+	assert_true(ctl.mc_max_ult > ult);
+	assert_int_equal(ctl.mc_limited, 0);
+
+	/* up to a bound */
+	for (i = 0; i < 100; i++) {
+		ctl.mc_limited = 1;
+		now += PERIOD;
+		migrate_ctl_adjust(&ctl, now, &idle_load);
+	}
+	size = ctl.mc_max_size;
+	ctl.mc_limited = 1;
+	now += PERIOD;
+	assert_int_equal(migrate_ctl_adjust(&ctl, now, &idle_load), 0);
+	assert_int_equal(ctl.mc_max_size, size);
+}
+
+static void
+test_cut_on_foreground_wait(void **state)
+{
+	struct migrate_ctl_load	load = { 0 };
+	struct migrate_ctl	low;
+	struct migrate_ctl	high;
+	uint64_t		size;
+	uint64_t		now = PERIOD;
+	int			i;
+
+	migrate_ctl_init(&low, MIGRATE_PRIO_LOW);
+	migrate_ctl_init(&high, MIGRATE_PRIO_HIGH);
+	size = low.mc_max_size;
+
+	load.mcl_fg_wait = 2000;
+	low.mc_limited = 1;
+	high.mc_limited = 1;
+	assert_int_equal(migrate_ctl_adjust(&low, now, &load), -1);
+	assert_int_equal(low.mc_max_size, size / 2);
+
+	/* high priority does not yield to the foreground I/O */
+	assert_int_equal(migrate_ctl_adjust(&high, now, &load), 1);
+
+	/* down to a bound */
+	for (i = 0; i < 100; i++) {
+		now += PERIOD;
+		migrate_ctl_adjust(&low, now, &load);
+	}
+	size = low.mc_max_size;
+	assert_true(size > 0);
+	assert_true(low.mc_max_ult > 0);
+	now += PERIOD;
+	assert_int_equal(migrate_ctl_adjust(&low, now, &load), 0);
+	assert_int_equal(low.mc_max_size, size);
+}
+
+static void
+test_cut_on_nvme_load(void **state)
+{
+	struct migrate_ctl_load	load = { 0 };
+	struct migrate_ctl	ctl;
+	uint64_t		size;
+
+	migrate_ctl_init(&ctl, MIGRATE_PRIO_HIGH);
+	size = ctl.mc_max_size;
+
+	load.mcl_nvme = 90;
+	assert_int_equal(migrate_ctl_adjust(&ctl, PERIOD, &load), 0);
+
+	load.mcl_nvme = 100;
+	assert_int_equal(migrate_ctl_adjust(&ctl, 2 * PERIOD, &load), -1);
+	assert_int_equal(ctl.mc_max_size, size / 2);
+}
+
+static void
+test_cut_on_network(void **state)
+{
+	struct migrate_ctl	ctl;
+	uint64_t		now = PERIOD;
+	uint64_t		size;
+	int			i;
+
+	migrate_ctl_init(&ctl, MIGRATE_PRIO_NORMAL);
+	size = ctl.mc_max_size;
+
+	/* errors other than network ones are ignored */
+	migrate_ctl_sample(&ctl, 0, -DER_NONEXIST);
+	assert_int_equal(migrate_ctl_adjust(&ctl, now, &idle_load), 0);
+
+	migrate_ctl_sample(&ctl, 0, -DER_TIMEDOUT);
+	now += PERIOD;
+	assert_int_equal(migrate_ctl_adjust(&ctl, now, &idle_load), -1);
+	assert_int_equal(ctl.mc_max_size, size / 2);
+
+	/* a window of fast migration, then the latency climbs */
+	for (i = 0; i < 200; i++) {
+		migrate_ctl_sample(&ctl, 500, 0);
+		now += PERIOD;
+		assert_int_equal(migrate_ctl_adjust(&ctl, now, &idle_load), 0);
+	}
+	size = ctl.mc_max_size;
+	for (i = 0; i < 64; i++)
+		migrate_ctl_sample(&ctl, 100000, 0);
+	now += PERIOD;
+	assert_int_equal(migrate_ctl_adjust(&ctl, now, &idle_load), -1);
+	assert_int_equal(ctl.mc_max_size, size / 2);
+}
+
+static void
+test_bandwidth(void **state)
+{
+	struct migrate_bw	bw;
+	uint64_t		rate = 1 << 20;
+	uint64_t		delay;
+
+	/* unlimited */
+	migrate_bw_init(&bw, 0, 0);
+	assert_int_equal(migrate_bw_take(&bw, 1ULL << 40, 0), 0);
+
+	/* a second of burst, then a debt of half a second */
+	migrate_bw_init(&bw, rate, 0);
+	assert_int_equal(migrate_bw_take(&bw, rate, 0), 0);
+	assert_int_equal(migrate_bw_take(&bw, rate / 2, 0), 0);
+	delay = migrate_bw_take(&bw, 1, 0);
+	assert_true(delay >= 500000 && delay <= 500001);
+
+	/* paid back after the delay */
+	assert_int_not_equal(migrate_bw_take(&bw, 1, 250000), 0);
+	assert_int_equal(migrate_bw_take(&bw, 1, 500001), 0);
+
+	/* no more than a second of burst after a long idle time */
+	assert_int_equal(migrate_bw_take(&bw, 2 * rate, 100000000), 0);
+	assert_int_not_equal(migrate_bw_take(&bw, 1, 100000000), 0);
+}
+
+int
+main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_raise_when_limited),
+		cmocka_unit_test(test_cut_on_foreground_wait),
+		cmocka_unit_test(test_cut_on_nvme_load),
+		cmocka_unit_test(test_cut_on_network),
+		cmocka_unit_test(test_bandwidth),
+	};
+
+	return cmocka_run_group_tests_name("obj_srv_migrate_ctl", tests, NULL,
+					   NULL);
+}
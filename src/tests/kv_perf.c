@@ -0,0 +1,292 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Throughput benchmark of the flat KV API. A number of small values is put,
+ * fetched and removed one key per call with daos_kv_put/get/remove(), then
+ * again in batches with the daos_kv_*_multi() calls, and the rate of each
+ * phase is reported.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <getopt.h>
+#include <time.h>
+#include <uuid/uuid.h>
+#include <daos.h>
+
+#define KEY_LEN		32
+
+static char		*kp_pool;
+static char		*kp_cont;
+static unsigned int	 kp_keys = 100000;
+static unsigned int	 kp_batch = 64;
+static daos_size_t	 kp_vsize = 64;
+
+static daos_handle_t	 poh;
+static daos_handle_t	 coh;
+
+#define FAIL(fmt, ...)						\
+do {								\
+	fprintf(stderr, "kv_perf: " fmt " aborting\n",		\
+		## __VA_ARGS__);				\
+	exit(1);						\
+} while (0)
+
+#define	ASSERT(cond, ...)					\
+do {								\
+	if (!(cond))						\
+		FAIL(__VA_ARGS__);				\
+} while (0)
+
+enum kp_op {
+	KP_PUT,
+	KP_GET,
+	KP_REMOVE,
+};
+
+static const char *kp_op_names[] = { "put", "get", "remove" };
+
+static double
+kp_now(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void
+kp_report(const char *mode, enum kp_op op, double secs)
+{
+	printf("%-8s %-8s %12.0f ops/s %10.2f MB/s\n", mode, kp_op_names[op],
+	       kp_keys / secs,
+	       op == KP_REMOVE ? 0 : kp_keys * kp_vsize / secs / (1 << 20));
+}
+
+static void
+kp_run_single(daos_handle_t oh, char **keys, char **bufs, enum kp_op op)
+{
+	daos_size_t	size;
+	double		then = kp_now();
+	unsigned int	i;
+	int		rc;
+
+	for (i = 0; i < kp_keys; i++) {
+		switch (op) {
+		case KP_PUT:
+			rc = daos_kv_put(oh, DAOS_TX_NONE, 0, keys[i], kp_vsize,
+					 bufs[i], NULL);
+			break;
+		case KP_GET:
+			size = kp_vsize;
+			rc = daos_kv_get(oh, DAOS_TX_NONE, 0, keys[i], &size,
+					 bufs[i], NULL);
+			ASSERT(rc != 0 || size == kp_vsize,
+			       "Invalid size of %s: %"PRIu64, keys[i], size);
+			break;
+		case KP_REMOVE:
+			rc = daos_kv_remove(oh, DAOS_TX_NONE, 0, keys[i], NULL);
+			break;
+		}
+		ASSERT(rc == 0, "KV %s failed with %d", kp_op_names[op], rc);
+	}
+
+	kp_report("single", op, kp_now() - then);
+}
+
+static void
+kp_run_multi(daos_handle_t oh, char **keys, char **bufs, daos_size_t *sizes,
+	     enum kp_op op)
+{
+	double		then = kp_now();
+	unsigned int	nr;
+	unsigned int	i;
+	unsigned int	j;
+	int		rc;
+
+	for (i = 0; i < kp_keys; i += nr) {
+		nr = kp_keys - i < kp_batch ? kp_keys - i : kp_batch;
+
+		switch (op) {
+		case KP_PUT:
+			rc = daos_kv_put_multi(oh, DAOS_TX_NONE, 0, nr,
+					       (const char *const *)&keys[i],
+					       &sizes[i],
+					       (const void *const *)&bufs[i],
+					       NULL);
+			break;
+		case KP_GET:
+			rc = daos_kv_get_multi(oh, DAOS_TX_NONE, 0, nr,
+					       (const char *const *)&keys[i],
+					       &sizes[i],
+					       (void *const *)&bufs[i], NULL);
+			for (j = i; rc == 0 && j < i + nr; j++)
+				ASSERT(sizes[j] == kp_vsize,
+				       "Invalid size of %s: %"PRIu64, keys[j],
+				       sizes[j]);
+			break;
+		case KP_REMOVE:
+			rc = daos_kv_remove_multi(oh, DAOS_TX_NONE, 0, nr,
+						  (const char *const *)&keys[i],
+						  NULL);
+			break;
+		}
+		ASSERT(rc == 0, "KV multi %s failed with %d", kp_op_names[op],
+		       rc);
+	}
+
+	kp_report("multi", op, kp_now() - then);
+}
+
+static void
+print_usage(const char *prog)
+{
+	printf("Usage: %s -p <pool> [OPTIONS]\n"
+	       "  -p, --pool <pool>    Pool label or UUID\n"
+	       "  -c, --cont <cont>    Container label or UUID, a temporary\n"
+	       "                       container is created if not set\n"
+	       "  -n, --keys <n>       Number of keys (default %u)\n"
+	       "  -b, --batch <n>      Keys per multi call (default %u)\n"
+	       "  -s, --vsize <bytes>  Value size (default %"PRIu64")\n",
+	       prog, kp_keys, kp_batch, kp_vsize);
+}
+
+int
+main(int argc, char **argv)
+{
+	static struct option	long_ops[] = {
+		{ "pool",	required_argument,	NULL,	'p' },
+		{ "cont",	required_argument,	NULL,	'c' },
+		{ "keys",	required_argument,	NULL,	'n' },
+		{ "batch",	required_argument,	NULL,	'b' },
+		{ "vsize",	required_argument,	NULL,	's' },
+		{ "help",	no_argument,		NULL,	'h' },
+		{ NULL,		0,			NULL,	0   },
+	};
+	char			 co_str[37];
+	uuid_t			 co_uuid;
+	bool			 tmp_cont = false;
+	daos_handle_t		 oh;
+	daos_obj_id_t		 oid = { .hi = 0, .lo = 1 };
+	daos_size_t		*sizes;
+	char			**keys;
+	char			**bufs;
+	char			*key_buf;
+	char			*val_buf;
+	unsigned int		 i;
+	int			 opt;
+	int			 rc;
+
+	while ((opt = getopt_long(argc, argv, "p:c:n:b:s:h", long_ops,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'p':
+			kp_pool = optarg;
+			break;
+		case 'c':
+			kp_cont = optarg;
+			break;
+		case 'n':
+			kp_keys = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			kp_batch = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			kp_vsize = strtoull(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (kp_pool == NULL || kp_keys == 0 || kp_batch == 0 || kp_vsize == 0) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	keys = calloc(kp_keys, sizeof(*keys));
+	bufs = calloc(kp_keys, sizeof(*bufs));
+	sizes = calloc(kp_keys, sizeof(*sizes));
+	key_buf = calloc(kp_keys, KEY_LEN);
+	val_buf = malloc(kp_keys * kp_vsize);
+	ASSERT(keys && bufs && sizes && key_buf && val_buf, "Out of memory");
+
+	for (i = 0; i < kp_keys; i++) {
+		keys[i] = &key_buf[i * KEY_LEN];
+		snprintf(keys[i], KEY_LEN, "kv_perf_key_%u", i);
+		bufs[i] = &val_buf[i * kp_vsize];
+		memset(bufs[i], 'a' + i % 26, kp_vsize);
+		sizes[i] = kp_vsize;
+	}
+
+	rc = daos_init();
+	ASSERT(rc == 0, "daos_init failed with %d", rc);
+
+	rc = daos_pool_connect(kp_pool, NULL, DAOS_PC_RW, &poh, NULL, NULL);
+	ASSERT(rc == 0, "pool connect failed with %d", rc);
+
+	if (kp_cont == NULL) {
+		uuid_generate(co_uuid);
+		rc = daos_cont_create(poh, co_uuid, NULL, NULL);
+		ASSERT(rc == 0, "container create failed with %d", rc);
+		uuid_unparse(co_uuid, co_str);
+		kp_cont = co_str;
+		tmp_cont = true;
+	}
+
+	rc = daos_cont_open(poh, kp_cont, DAOS_COO_RW, &coh, NULL, NULL);
+	ASSERT(rc == 0, "container open failed with %d", rc);
+
+	/** the KV API requires the flat feature flag be set in the oid */
+	rc = daos_obj_generate_oid(coh, &oid, DAOS_OF_KV_FLAT, OC_SX, 0, 0);
+	ASSERT(rc == 0, "oid generation failed with %d", rc);
+
+	rc = daos_kv_open(coh, oid, DAOS_OO_RW, &oh, NULL);
+	ASSERT(rc == 0, "KV open failed with %d", rc);
+
+	printf("kv_perf: keys=%u, batch=%u, vsize=%"PRIu64"\n", kp_keys,
+	       kp_batch, kp_vsize);
+
+	kp_run_single(oh, keys, bufs, KP_PUT);
+	kp_run_single(oh, keys, bufs, KP_GET);
+	kp_run_single(oh, keys, bufs, KP_REMOVE);
+
+	kp_run_multi(oh, keys, bufs, sizes, KP_PUT);
+	kp_run_multi(oh, keys, bufs, sizes, KP_GET);
+	kp_run_multi(oh, keys, bufs, sizes, KP_REMOVE);
+
+	rc = daos_kv_destroy(oh, DAOS_TX_NONE, NULL);
+	ASSERT(rc == 0, "KV destroy failed with %d", rc);
+
+	rc = daos_kv_close(oh, NULL);
+	ASSERT(rc == 0, "KV close failed with %d", rc);
+
+	rc = daos_cont_close(coh, NULL);
+	ASSERT(rc == 0, "cont close failed with %d", rc);
+
+	if (tmp_cont) {
+		rc = daos_cont_destroy(poh, kp_cont, 1, NULL);
+		ASSERT(rc == 0, "cont destroy failed with %d", rc);
+	}
+
+	rc = daos_pool_disconnect(poh, NULL);
+	ASSERT(rc == 0, "disconnect failed with %d", rc);
+
+	rc = daos_fini();
+	ASSERT(rc == 0, "daos_fini failed with %d", rc);
+
+	free(val_buf);
+	free(key_buf);
+	free(sizes);
+	free(bufs);
+	free(keys);
+	return 0;
+}
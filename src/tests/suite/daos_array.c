@@ -1080,6 +1080,115 @@ truncate_array(void **state)
 	MPI_Barrier(MPI_COMM_WORLD);
 } /* End str_mem_str_arr_io */
 
+static void
+cached_size(void **state)
+{
+	test_arg_t	*arg = *state;
+	daos_obj_id_t	oid;
+	daos_handle_t	oh, oh_excl;
+	daos_array_iod_t iod = {};
+	daos_range_t	rgs[3] = {};
+	d_iov_t		iov = {};
+	d_sg_list_t	sgl = {};
+	daos_size_t	cell_size, csize;
+	daos_size_t	size, size_excl;
+	char		*buf, *rbuf;
+	int		i, rc;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	oid = daos_test_oid_gen(arg->coh, OC_SX, featb, 0, arg->myrank);
+
+	/** create the array and open a second, exclusive, handle */
+	rc = daos_array_create(arg->coh, oid, DAOS_TX_NONE, 1, chunk_size,
+			       &oh, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_open(arg->coh, oid, DAOS_TX_NONE, DAOS_OO_EXCL,
+			     &cell_size, &csize, &oh_excl, NULL);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(cell_size, 1);
+	assert_int_equal(csize, chunk_size);
+
+	D_ALLOC(buf, NUM_ELEMS);
+	assert_non_null(buf);
+	D_ALLOC(rbuf, NUM_ELEMS);
+	assert_non_null(rbuf);
+	dts_buf_render(buf, NUM_ELEMS);
+
+	rc = daos_array_get_size(oh_excl, DAOS_TX_NONE, &size_excl, NULL);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(size_excl, 0);
+
+	/** adjacent ranges, in the same and in different dkeys */
+	rgs[0].rg_idx = 4;
+	rgs[0].rg_len = 4;
+	rgs[1].rg_idx = 8;
+	rgs[1].rg_len = chunk_size;
+	rgs[2].rg_idx = 8 + chunk_size;
+	rgs[2].rg_len = 2;
+	iod.arr_nr = 3;
+	iod.arr_rgs = rgs;
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &iov;
+	d_iov_set(&iov, buf, 6 + chunk_size);
+
+	print_message("Write and check the size of both handles\n");
+	rc = daos_array_write(oh_excl, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+
+	rc = daos_array_get_size(oh_excl, DAOS_TX_NONE, &size_excl, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_get_size(oh, DAOS_TX_NONE, &size, NULL);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(size, 10 + chunk_size);
+	assert_int_equal(size_excl, size);
+
+	d_iov_set(&iov, rbuf, 6 + chunk_size);
+	rc = daos_array_read(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+	assert_memory_equal(rbuf, buf, 6 + chunk_size);
+
+	print_message("Extend, shrink and punch the tail\n");
+	for (i = 0; i < 3; i++) {
+		switch (i) {
+		case 0:
+			rc = daos_array_set_size(oh_excl, DAOS_TX_NONE,
+						 NUM_ELEMS, NULL);
+			break;
+		case 1:
+			rc = daos_array_set_size(oh_excl, DAOS_TX_NONE, 6,
+						 NULL);
+			break;
+		case 2:
+			rgs[0].rg_idx = 5;
+			rgs[0].rg_len = 1;
+			iod.arr_nr = 1;
+			rc = daos_array_punch(oh_excl, DAOS_TX_NONE, &iod,
+					      NULL);
+			break;
+		}
+		assert_rc_equal(rc, 0);
+
+		rc = daos_array_get_size(oh_excl, DAOS_TX_NONE, &size_excl,
+					 NULL);
+		assert_rc_equal(rc, 0);
+		rc = daos_array_get_size(oh, DAOS_TX_NONE, &size, NULL);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(size_excl, size);
+	}
+	assert_int_equal(size, 5);
+
+	rc = daos_array_close(oh_excl, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_destroy(oh, DAOS_TX_NONE, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	D_FREE(rbuf);
+	D_FREE(buf);
+	MPI_Barrier(MPI_COMM_WORLD);
+} /* End cached_size */
+
 static const struct CMUnitTest array_api_tests[] = {
 	{"Array API: create/open/close (blocking)",
 	 simple_array_mgmt, async_disable, NULL},
@@ -1103,6 +1212,8 @@ static const struct CMUnitTest array_api_tests[] = {
 	 strided_array, async_disable, NULL},
 	{"Array API: write after truncate",
 	 truncate_array, async_disable, NULL},
+	{"Array API: cached size on exclusive open",
+	 cached_size, async_disable, NULL},
 };
 
 static int
@@ -318,6 +318,150 @@ kv_cond_ops(void **state)
 	print_message("all good\n");
 } /* End simple_put_get */
 
+#define MULTI_NR	128
+
+static void
+kv_multi_ops(void **state)
+{
+	test_arg_t	*arg = *state;
+	daos_obj_id_t	oid;
+	daos_handle_t	oh;
+	daos_event_t	ev;
+	char		*keys[MULTI_NR];
+	char		*bufs[MULTI_NR];
+	daos_size_t	sizes[MULTI_NR];
+	char		*buf;
+	char		*buf_out;
+	int		i, num_keys;
+	int		rc;
+
+	D_ALLOC(buf, MULTI_NR * 32);
+	assert_non_null(buf);
+	D_ALLOC(buf_out, MULTI_NR * 32);
+	assert_non_null(buf_out);
+
+	for (i = 0; i < MULTI_NR; i++) {
+		D_ASPRINTF(keys[i], "multi_key%d", i);
+		assert_non_null(keys[i]);
+		bufs[i] = &buf[i * 32];
+		/** values of different sizes */
+		sizes[i] = i % 32 + 1;
+		dts_buf_render(bufs[i], sizes[i]);
+	}
+
+	oid = daos_test_oid_gen(arg->coh, OC_SX, feat, 0, arg->myrank);
+
+	if (arg->async) {
+		rc = daos_event_init(&ev, arg->eq, NULL);
+		assert_rc_equal(rc, 0);
+	}
+
+	rc = daos_kv_open(arg->coh, oid, 0, &oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	rc = daos_kv_put_multi(oh, DAOS_TX_NONE, 0, 0,
+			       (const char *const *)keys, sizes,
+			       (const void *const *)bufs, NULL);
+	assert_rc_equal(rc, -DER_INVAL);
+	rc = daos_kv_get_multi(oh, DAOS_TX_NONE, 0, MULTI_NR,
+			       (const char *const *)keys, NULL, NULL, NULL);
+	assert_rc_equal(rc, -DER_INVAL);
+
+	print_message("Inserting %d Keys in one call\n", MULTI_NR);
+	rc = daos_kv_put_multi(oh, DAOS_TX_NONE, 0, MULTI_NR,
+			       (const char *const *)keys, sizes,
+			       (const void *const *)bufs,
+			       arg->async ? &ev : NULL);
+	assert_rc_equal(rc, 0);
+	if (arg->async) {
+		bool ev_flag;
+
+		rc = daos_event_test(&ev, DAOS_EQ_WAIT, &ev_flag);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(ev_flag, true);
+		assert_int_equal(ev.ev_error, 0);
+	}
+
+	list_keys(oh, &num_keys);
+	assert_int_equal(num_keys, MULTI_NR);
+
+	print_message("Querying the value sizes\n");
+	for (i = 0; i < MULTI_NR; i++)
+		sizes[i] = DAOS_REC_ANY;
+	rc = daos_kv_get_multi(oh, DAOS_TX_NONE, 0, MULTI_NR,
+			       (const char *const *)keys, sizes, NULL, NULL);
+	assert_rc_equal(rc, 0);
+	for (i = 0; i < MULTI_NR; i++)
+		assert_int_equal(sizes[i], i % 32 + 1);
+
+	print_message("Reading and Checking Keys in one call\n");
+	for (i = 0; i < MULTI_NR; i++)
+		bufs[i] = &buf_out[i * 32];
+	rc = daos_kv_get_multi(oh, DAOS_TX_NONE, 0, MULTI_NR,
+			       (const char *const *)keys, sizes,
+			       (void *const *)bufs, arg->async ? &ev : NULL);
+	assert_rc_equal(rc, 0);
+	if (arg->async) {
+		bool ev_flag;
+
+		rc = daos_event_test(&ev, DAOS_EQ_WAIT, &ev_flag);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(ev_flag, true);
+		assert_int_equal(ev.ev_error, 0);
+	}
+	for (i = 0; i < MULTI_NR; i++) {
+		assert_int_equal(sizes[i], i % 32 + 1);
+		assert_memory_equal(&buf_out[i * 32], &buf[i * 32], sizes[i]);
+	}
+
+	print_message("Removing half of the Keys in one call\n");
+	rc = daos_kv_remove_multi(oh, DAOS_TX_NONE, 0, MULTI_NR / 2,
+				  (const char *const *)keys, NULL);
+	assert_rc_equal(rc, 0);
+
+	list_keys(oh, &num_keys);
+	assert_int_equal(num_keys, MULTI_NR / 2);
+
+	/** removed keys report a 0 size */
+	for (i = 0; i < MULTI_NR; i++)
+		sizes[i] = 32;
+	rc = daos_kv_get_multi(oh, DAOS_TX_NONE, 0, MULTI_NR,
+			       (const char *const *)keys, sizes,
+			       (void *const *)bufs, NULL);
+	assert_rc_equal(rc, 0);
+	for (i = 0; i < MULTI_NR; i++)
+		assert_int_equal(sizes[i], i < MULTI_NR / 2 ? 0 : i % 32 + 1);
+
+	print_message("Conditional multi INSERT of existing Keys (should "
+		      "fail)\n");
+	for (i = 0; i < MULTI_NR; i++) {
+		bufs[i] = &buf[i * 32];
+		sizes[i] = i % 32 + 1;
+	}
+	rc = daos_kv_put_multi(oh, DAOS_TX_NONE, DAOS_COND_KEY_INSERT,
+			       MULTI_NR, (const char *const *)keys, sizes,
+			       (const void *const *)bufs, NULL);
+	assert_rc_equal(rc, -DER_EXIST);
+
+	print_message("Destroying KV\n");
+	rc = daos_kv_destroy(oh, DAOS_TX_NONE, NULL);
+	assert_rc_equal(rc, 0);
+
+	rc = daos_kv_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	if (arg->async) {
+		rc = daos_event_fini(&ev);
+		assert_rc_equal(rc, 0);
+	}
+
+	for (i = 0; i < MULTI_NR; i++)
+		D_FREE(keys[i]);
+	D_FREE(buf_out);
+	D_FREE(buf);
+	print_message("all good\n");
+}
+
 static const struct CMUnitTest kv_tests[] = {
 	{"KV: Object Put/GET (blocking)",
 	 simple_put_get, async_disable, NULL},
@@ -325,6 +469,10 @@ static const struct CMUnitTest kv_tests[] = {
 	 simple_put_get, async_enable, NULL},
 	{"KV: Object Conditional Ops (blocking)",
 	 kv_cond_ops, async_disable, NULL},
+	{"KV: Object Multi Key Ops (blocking)",
+	 kv_multi_ops, async_disable, NULL},
+	{"KV: Object Multi Key Ops (non-blocking)",
+	 kv_multi_ops, async_enable, NULL},
 };
 
 int
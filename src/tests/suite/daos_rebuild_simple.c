@@ -1118,6 +1118,81 @@ rebuild_with_large_offset(void **state)
 		assert_rc_equal(rc, -DER_NOSYS);
 }
 
+#define SMALL_OBJ_NR	200
+#define SMALL_DKEY_NR	4
+
+static void
+rebuild_small_objects_verify(test_arg_t *arg, daos_obj_id_t *oids)
+{
+	struct ioreq	req;
+	char		dkey[32];
+	char		rec[32];
+	char		buf[32];
+	int		i;
+	int		j;
+
+	for (i = 0; i < SMALL_OBJ_NR; i++) {
+		ioreq_init(&req, arg->coh, oids[i], DAOS_IOD_ARRAY, arg);
+		for (j = 0; j < SMALL_DKEY_NR; j++) {
+			sprintf(dkey, "small_dkey_%d", j);
+			sprintf(rec, "small_rec_%d_%d", i, j);
+			memset(buf, 0, sizeof(buf));
+			lookup_single(dkey, "small_akey", 0, buf, sizeof(buf),
+				      DAOS_TX_NONE, &req);
+			assert_string_equal(buf, rec);
+		}
+		ioreq_fini(&req);
+	}
+}
+
+static void
+rebuild_small_objects(void **state)
+{
+	test_arg_t	*arg = *state;
+	daos_obj_id_t	oids[SMALL_OBJ_NR];
+	struct ioreq	req;
+	char		dkey[32];
+	char		rec[32];
+	int		tgt = DEFAULT_FAIL_TGT;
+	int		i;
+	int		j;
+	int		rc;
+
+	if (!test_runable(arg, 4))
+		return;
+
+	/* Many objects with a few small dkeys each, so that the migration
+	 * batches span several objects of the same container.
+	 */
+	for (i = 0; i < SMALL_OBJ_NR; i++) {
+		oids[i] = daos_test_oid_gen(arg->coh, arg->obj_class, 0, 0,
+					    arg->myrank);
+		oids[i] = dts_oid_set_rank(oids[i], ranks_to_kill[0]);
+		oids[i] = dts_oid_set_tgt(oids[i], tgt);
+
+		ioreq_init(&req, arg->coh, oids[i], DAOS_IOD_ARRAY, arg);
+		for (j = 0; j < SMALL_DKEY_NR; j++) {
+			sprintf(dkey, "small_dkey_%d", j);
+			sprintf(rec, "small_rec_%d_%d", i, j);
+			insert_single(dkey, "small_akey", 0, rec,
+				      strlen(rec) + 1, DAOS_TX_NONE, &req);
+		}
+		ioreq_fini(&req);
+	}
+
+	rebuild_single_pool_target(arg, ranks_to_kill[0], tgt, false);
+
+	for (i = 0; i < SMALL_OBJ_NR; i++) {
+		rc = daos_obj_verify(arg->coh, oids[i], DAOS_EPOCH_MAX);
+		if (rc != 0)
+			assert_rc_equal(rc, -DER_NOSYS);
+	}
+	rebuild_small_objects_verify(arg, oids);
+
+	reintegrate_with_inflight_io(arg, NULL, ranks_to_kill[0], tgt);
+	rebuild_small_objects_verify(arg, oids);
+}
+
 /** create a new pool/container for each test */
 static const struct CMUnitTest rebuild_tests[] = {
 	{"REBUILD1: rebuild small rec multiple dkeys",
@@ -1158,6 +1233,8 @@ static const struct CMUnitTest rebuild_tests[] = {
 	 rebuild_multiple_group, rebuild_small_sub_setup, test_teardown},
 	{"REBUILD19: rebuild with large offset",
 	 rebuild_with_large_offset, rebuild_small_sub_setup, test_teardown},
+	{"REBUILD20: rebuild many small objects",
+	 rebuild_small_objects, rebuild_sub_setup, test_teardown},
 };
 
 int
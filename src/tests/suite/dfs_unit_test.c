@@ -956,6 +956,230 @@ dfs_test_rename(void **state)
 	assert_int_equal(rc, 0);
 }
 
+#define RDP_NR_FILES	100
+
+static void
+dfs_test_readdirplus(void **state)
+{
+	test_arg_t		*arg = *state;
+	dfs_obj_t		*dir, *obj;
+	char			*dname = "rdp_dir";
+	char			name[16];
+	d_sg_list_t		sgl;
+	d_iov_t			iov;
+	char			buf[64];
+	struct dirent		dirs[16];
+	struct stat		stbufs[16];
+	struct stat		stbuf;
+	dfs_obj_t		*objs[16];
+	daos_anchor_t		anchor = {0};
+	mode_t			mode;
+	uint32_t		nr, total = 0, nr_dirs = 0, nr_links = 0;
+	int			i, idx;
+	int			rc;
+
+	if (arg->myrank != 0)
+		return;
+
+	rc = dfs_open(dfs_mt, NULL, dname, S_IFDIR | S_IWUSR | S_IRUSR | S_IXUSR,
+		      O_RDWR | O_CREAT | O_EXCL, 0, 0, NULL, &dir);
+	assert_int_equal(rc, 0);
+
+	/** file i has a size of i bytes, every tenth entry is a dir */
+	d_iov_set(&iov, buf, sizeof(buf));
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 1;
+	sgl.sg_iovs = &iov;
+	dts_buf_render(buf, sizeof(buf));
+	for (i = 0; i < RDP_NR_FILES; i++) {
+		sprintf(name, "%d", i);
+		if (i % 10 == 0) {
+			rc = dfs_open(dfs_mt, dir, name, S_IFDIR | S_IRWXU,
+				      O_RDWR | O_CREAT, 0, 0, NULL, &obj);
+		} else if (i % 10 == 1) {
+			rc = dfs_open(dfs_mt, dir, name, S_IFLNK, O_RDWR |
+				      O_CREAT, 0, 0, "rdp_target", &obj);
+		} else {
+			rc = dfs_open(dfs_mt, dir, name, S_IFREG | S_IRWXU,
+				      O_RDWR | O_CREAT, 0, 0, NULL, &obj);
+			assert_int_equal(rc, 0);
+			iov.iov_len = i % sizeof(buf);
+			rc = dfs_write(dfs_mt, obj, &sgl, 0, NULL);
+		}
+		assert_int_equal(rc, 0);
+		rc = dfs_release(obj);
+		assert_int_equal(rc, 0);
+	}
+
+	while (!daos_anchor_is_eof(&anchor)) {
+		nr = 16;
+		rc = dfs_readdirplus(dfs_mt, dir, &anchor, &nr, dirs, stbufs,
+				     objs);
+		assert_int_equal(rc, 0);
+
+		for (i = 0; i < nr; i++) {
+			idx = atoi(dirs[i].d_name);
+			if (idx % 10 == 0) {
+				assert_true(S_ISDIR(stbufs[i].st_mode));
+				nr_dirs++;
+			} else if (idx % 10 == 1) {
+				assert_true(S_ISLNK(stbufs[i].st_mode));
+				assert_int_equal(stbufs[i].st_size,
+						 strlen("rdp_target"));
+				nr_links++;
+			} else {
+				assert_true(S_ISREG(stbufs[i].st_mode));
+				assert_int_equal(stbufs[i].st_size,
+						 idx % sizeof(buf));
+				rc = dfs_stat(dfs_mt, dir, dirs[i].d_name,
+					      &stbuf);
+				assert_int_equal(rc, 0);
+				assert_int_equal(stbufs[i].st_blksize,
+						 stbuf.st_blksize);
+			}
+			rc = dfs_get_mode(objs[i], &mode);
+			assert_int_equal(rc, 0);
+			assert_int_equal(mode, stbufs[i].st_mode);
+			rc = dfs_release(objs[i]);
+			assert_int_equal(rc, 0);
+		}
+		total += nr;
+	}
+
+	assert_int_equal(total, RDP_NR_FILES);
+	assert_int_equal(nr_dirs, RDP_NR_FILES / 10);
+	assert_int_equal(nr_links, RDP_NR_FILES / 10);
+
+	/** objects only, as for a plain readdir */
+	memset(&anchor, 0, sizeof(anchor));
+	total = 0;
+	while (!daos_anchor_is_eof(&anchor)) {
+		nr = 16;
+		rc = dfs_readdirplus(dfs_mt, dir, &anchor, &nr, dirs, NULL,
+				     objs);
+		assert_int_equal(rc, 0);
+
+		for (i = 0; i < nr; i++) {
+			rc = dfs_get_mode(objs[i], &mode);
+			assert_int_equal(rc, 0);
+			rc = dfs_release(objs[i]);
+			assert_int_equal(rc, 0);
+		}
+		total += nr;
+	}
+	assert_int_equal(total, RDP_NR_FILES);
+
+	for (i = 0; i < RDP_NR_FILES; i++) {
+		sprintf(name, "%d", i);
+		rc = dfs_remove(dfs_mt, dir, name, 0, NULL);
+		assert_int_equal(rc, 0);
+	}
+	rc = dfs_release(dir);
+	assert_int_equal(rc, 0);
+	rc = dfs_remove(dfs_mt, NULL, dname, 0, NULL);
+	assert_int_equal(rc, 0);
+}
+
+static void
+dfs_test_dcache(void **state)
+{
+	test_arg_t		*arg = *state;
+	dfs_t			*dfs;
+	dfs_obj_t		*dir, *obj;
+	char			*f1 = "dc_f1";
+	char			*f2 = "dc_f2";
+	char			*dname = "dc_dir";
+	struct stat		stbuf;
+	int			rc;
+
+	if (arg->myrank != 0)
+		return;
+
+	/** second mount of the container with the dentry cache enabled */
+	setenv("DFS_DCACHE_TIMEOUT", "2000", 1);
+	rc = dfs_mount(arg->pool.poh, co_hdl, O_RDWR, &dfs);
+	unsetenv("DFS_DCACHE_TIMEOUT");
+	assert_int_equal(rc, 0);
+
+	/** missing entry is cached, creating it invalidates the record */
+	rc = dfs_stat(dfs, NULL, f1, &stbuf);
+	assert_int_equal(rc, ENOENT);
+	rc = dfs_open(dfs, NULL, f1, S_IFREG | S_IWUSR | S_IRUSR,
+		      O_RDWR | O_CREAT | O_EXCL, 0, 0, NULL, &obj);
+	assert_int_equal(rc, 0);
+	rc = dfs_release(obj);
+	assert_int_equal(rc, 0);
+	rc = dfs_stat(dfs, NULL, f1, &stbuf);
+	assert_int_equal(rc, 0);
+	assert_true(S_ISREG(stbuf.st_mode));
+
+	/** hit */
+	rc = dfs_stat(dfs, NULL, f1, &stbuf);
+	assert_int_equal(rc, 0);
+	assert_true(S_ISREG(stbuf.st_mode));
+
+	/** rename invalidates both names */
+	rc = dfs_stat(dfs, NULL, f2, &stbuf);
+	assert_int_equal(rc, ENOENT);
+	rc = dfs_move(dfs, NULL, f1, NULL, f2, NULL);
+	assert_int_equal(rc, 0);
+	rc = dfs_stat(dfs, NULL, f1, &stbuf);
+	assert_int_equal(rc, ENOENT);
+	rc = dfs_stat(dfs, NULL, f2, &stbuf);
+	assert_int_equal(rc, 0);
+
+	rc = dfs_remove(dfs, NULL, f2, 0, NULL);
+	assert_int_equal(rc, 0);
+
+	/** create through another mount is only seen once the record expires */
+	rc = dfs_stat(dfs, NULL, dname, &stbuf);
+	assert_int_equal(rc, ENOENT);
+	rc = dfs_mkdir(dfs_mt, NULL, dname, S_IRWXU, 0);
+	assert_int_equal(rc, 0);
+	rc = dfs_stat(dfs, NULL, dname, &stbuf);
+	assert_int_equal(rc, ENOENT);
+	sleep(3);
+	rc = dfs_stat(dfs, NULL, dname, &stbuf);
+	assert_int_equal(rc, 0);
+	assert_true(S_ISDIR(stbuf.st_mode));
+	rc = dfs_remove(dfs, NULL, dname, 0, NULL);
+	assert_int_equal(rc, 0);
+
+	/** remove through the same mount is seen straight away */
+	rc = dfs_open(dfs, NULL, f1, S_IFREG | S_IWUSR | S_IRUSR,
+		      O_RDWR | O_CREAT | O_EXCL, 0, 0, NULL, &obj);
+	assert_int_equal(rc, 0);
+	rc = dfs_release(obj);
+	assert_int_equal(rc, 0);
+	rc = dfs_stat(dfs, NULL, f1, &stbuf);
+	assert_int_equal(rc, 0);
+	rc = dfs_remove(dfs, NULL, f1, 0, NULL);
+	assert_int_equal(rc, 0);
+	rc = dfs_stat(dfs, NULL, f1, &stbuf);
+	assert_int_equal(rc, ENOENT);
+
+	/** entries under a directory removed with force are dropped too */
+	rc = dfs_open(dfs, NULL, dname, S_IFDIR | S_IRWXU,
+		      O_RDWR | O_CREAT | O_EXCL, 0, 0, NULL, &dir);
+	assert_int_equal(rc, 0);
+	rc = dfs_open(dfs, dir, f1, S_IFREG | S_IWUSR | S_IRUSR,
+		      O_RDWR | O_CREAT | O_EXCL, 0, 0, NULL, &obj);
+	assert_int_equal(rc, 0);
+	rc = dfs_release(obj);
+	assert_int_equal(rc, 0);
+	rc = dfs_stat(dfs, dir, f1, &stbuf);
+	assert_int_equal(rc, 0);
+	rc = dfs_remove(dfs, NULL, dname, true, NULL);
+	assert_int_equal(rc, 0);
+	rc = dfs_stat(dfs, dir, f1, &stbuf);
+	assert_int_equal(rc, ENOENT);
+	rc = dfs_release(dir);
+	assert_int_equal(rc, 0);
+
+	rc = dfs_umount(dfs);
+	assert_int_equal(rc, 0);
+}
+
 static const struct CMUnitTest dfs_unit_tests[] = {
 	{ "DFS_UNIT_TEST1: DFS mount / umount",
 	  dfs_test_mount, async_disable, test_case_teardown},
@@ -979,6 +1203,10 @@ static const struct CMUnitTest dfs_unit_tests[] = {
 	  dfs_test_mt_mkdir, async_disable, test_case_teardown},
 	{ "DFS_UNIT_TEST11: Simple rename",
 	  dfs_test_rename, async_disable, test_case_teardown},
+	{ "DFS_UNIT_TEST12: DFS readdirplus",
+	  dfs_test_readdirplus, async_disable, test_case_teardown},
+	{ "DFS_UNIT_TEST13: DFS dentry cache",
+	  dfs_test_dcache, async_disable, test_case_teardown},
 };
 
 static int
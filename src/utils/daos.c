@@ -621,6 +621,7 @@ common_op_parse_hdlr(int argc, char *argv[], struct cmd_args_s *ap)
 		{"mode",	required_argument,	NULL,	'M'},
 		{"oclass",	required_argument,	NULL,	'o'},
 		{"chunk-size",	required_argument,	NULL,	'z'},
+		{"threads",	required_argument,	NULL,	'T'},
 		{"dfs-prefix",	required_argument,	NULL,	'I'},
 		{"dfs-path",	required_argument,	NULL,	'H'},
 		{"snap",	required_argument,	NULL,	's'},
@@ -810,6 +811,14 @@ common_op_parse_hdlr(int argc, char *argv[], struct cmd_args_s *ap)
 				D_GOTO(out_free, rc = RC_NO_HELP);
 			}
 			break;
+		case 'T':
+			ap->threads = strtoul(optarg, NULL, 10);
+			if (ap->threads == 0) {
+				fprintf(stderr, "failed to parse threads: "
+					"%s\n", optarg);
+				D_GOTO(out_free, rc = RC_PRINT_HELP);
+			}
+			break;
 		case 's':
 			D_STRNDUP(ap->snapname_str, optarg, strlen(optarg));
 			if (ap->snapname_str == NULL)
@@ -1585,7 +1594,8 @@ do { \
 	" filesystem copy options (copy):\n" \
 	"	--src=daos://<pool/cont> | <path>\n" \
 	"	--dst=daos://<pool/cont> | <path>\n" \
-	"	\t type is daos, only specified if pool/cont used\n"); \
+	"	\t type is daos, only specified if pool/cont used\n" \
+	"	--threads=N        number of copy threads (default 8)\n"); \
 	fprintf(stream, "\n"); \
 } while (0)
 
@@ -1740,7 +1750,8 @@ help_hdlr(int argc, char *argv[], struct cmd_args_s *ap)
 			fprintf(stream,
 				"container options (clone):\n"
 			"	--src=</pool/cont | path>\n"
-			"	--=</pool/cont | /pool | path>\n");
+			"	--=</pool/cont | /pool | path>\n"
+			"	--threads=N        number of copy threads (default 8)\n");
 		} else if (strcmp(argv[3], "get-attr") == 0 ||
 			   strcmp(argv[3], "set-attr") == 0 ||
 			   strcmp(argv[3], "del-attr") == 0) {
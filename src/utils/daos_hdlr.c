@@ -21,6 +21,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <daos.h>
 #include <daos/common.h>
 #include <daos/checksum.h>
@@ -1907,53 +1908,6 @@ out:
 	return rc;
 }
 
-static ssize_t
-write_dfs(struct cmd_args_s *ap, struct file_dfs *file_dfs,
-	  const char *file, void *buf, ssize_t size)
-{
-	int		rc;
-	d_iov_t		iov;
-	d_sg_list_t	sgl;
-
-	sgl.sg_nr = 1;
-	sgl.sg_iovs = &iov;
-	sgl.sg_nr_out = 1;
-	d_iov_set(&iov, buf, size);
-	rc = dfs_write(file_dfs->dfs, file_dfs->obj, &sgl,
-		       file_dfs->offset, NULL);
-	if (rc) {
-		fprintf(ap->errstream, "dfs_write %s failed (%d %s)\n",
-			file, rc, strerror(rc));
-		errno = rc;
-		size = -1;
-		D_GOTO(out, rc);
-	}
-	file_dfs->offset += (daos_off_t)size;
-out:
-	return (ssize_t)size;
-}
-
-static ssize_t
-file_write(struct cmd_args_s *ap, struct file_dfs *file_dfs,
-	   const char *file, void *buf, size_t size)
-{
-	ssize_t num_bytes_written = 0;
-
-	if (file_dfs->type == POSIX) {
-		num_bytes_written = write(file_dfs->fd, buf, size);
-	} else if (file_dfs->type == DAOS) {
-		num_bytes_written = write_dfs(ap, file_dfs, file, buf, size);
-	} else {
-		fprintf(ap->errstream, "File type not known: %s type=%d\n",
-			file, file_dfs->type);
-	}
-	if (num_bytes_written < 0) {
-		fprintf(ap->errstream, "write error on %s type=%d\n",
-			file, file_dfs->type);
-	}
-	return num_bytes_written;
-}
-
 static int
 open_dfs(struct cmd_args_s *ap, struct file_dfs *file_dfs, const char *file,
 	 int flags, mode_t mode)
@@ -2271,58 +2225,6 @@ file_lstat(struct cmd_args_s *ap, struct file_dfs *file_dfs,
 	return rc;
 }
 
-static ssize_t
-read_dfs(struct cmd_args_s *ap,
-	 struct file_dfs *file_dfs,
-	 const char *file,
-	 void *buf,
-	 size_t size)
-{
-	d_iov_t		iov;
-	d_sg_list_t	sgl;
-	daos_size_t	got_size;
-
-	d_iov_set(&iov, buf, size);
-	sgl.sg_nr = 1;
-	sgl.sg_iovs = &iov;
-	sgl.sg_nr_out = 1;
-
-	/* execute read operation */
-	d_iov_set(&iov, buf, size);
-	int rc = dfs_read(file_dfs->dfs, file_dfs->obj, &sgl,
-			  file_dfs->offset, &got_size, NULL);
-	if (rc) {
-		fprintf(ap->errstream, "dfs_read %s failed (%d %s)\n",
-			file, rc, strerror(rc));
-		errno = rc;
-		got_size = -1;
-		D_GOTO(out, rc);
-	}
-
-	/* update file pointer with number of bytes read */
-	file_dfs->offset += (daos_off_t)got_size;
-out:
-	return (ssize_t)got_size;
-}
-
-static ssize_t
-file_read(struct cmd_args_s *ap, struct file_dfs *file_dfs,
-	  const char *file, void *buf, size_t size)
-{
-	ssize_t got_size = 0;
-
-	if (file_dfs->type == POSIX) {
-		got_size = read(file_dfs->fd, buf, size);
-	} else if (file_dfs->type == DAOS) {
-		got_size = read_dfs(ap, file_dfs, file, buf, size);
-	} else {
-		got_size = -1;
-		fprintf(ap->errstream, "File type not known: %s type=%d\n",
-			file, file_dfs->type);
-	}
-	return got_size;
-}
-
 static int
 closedir_dfs(struct cmd_args_s *ap, DIR *_dirp)
 {
@@ -2468,87 +2370,757 @@ file_chmod(struct cmd_args_s *ap, struct file_dfs *file_dfs, const char *path,
 	return rc;
 }
 
+/*
+ * Data mover
+ *
+ * The calling thread walks the source tree, or the object table of the source
+ * container, and queues the work to a pool of threads: files are split in
+ * segments which are copied in parallel, objects are cloned one per item.
+ * Each thread keeps DM_DEPTH chunks in flight on its own event queue and
+ * issues the write of a chunk as soon as its read completes, so that the reads
+ * and the writes of a segment overlap. The walker waits when the queue is full
+ * and reports the progress meanwhile.
+ */
+
+/** default number of threads */
+#define DM_THREADS		8
+/** files are split in segments of this size, which are copied in parallel */
+#define DM_SEG_SIZE		(1ULL << 30)
+/** size of one read or write */
+#define DM_CHUNK_SIZE		(4ULL << 20)
+/** number of chunks in flight per thread */
+#define DM_DEPTH		4
+/** number of items queued per thread before the walker waits */
+#define DM_QUEUE_DEPTH		64
+/** seconds between two progress reports */
+#define DM_PROGRESS_SEC		10
+
+struct dm_mover;
+struct dm_worker;
+struct dm_work;
+
+typedef int (*dm_work_fn_t)(struct dm_worker *w, struct dm_work *work);
+
+/** one chunk being copied */
+struct dm_io {
+	daos_event_t	ev;
+	char		*buf;
+	uint64_t	off;
+	daos_size_t	len;
+	/* number of bytes read, hence to write */
+	daos_size_t	got;
+	bool		writing;
+	/* the event is launched, the buffer must not be reused or freed */
+	bool		inflight;
+	d_sg_list_t	sgl;
+	d_iov_t		iov;
+};
+
+struct dm_worker {
+	struct dm_mover	*mv;
+	pthread_t	thread;
+	daos_handle_t	eq;
+	int		nr_ios;
+	struct dm_io	ios[DM_DEPTH];
+};
+
+/** file being copied, shared by its segments */
+struct dm_file {
+	/* only the type and the dfs of these are set */
+	struct file_dfs	src;
+	struct file_dfs	dst;
+	char		*src_path;
+	char		*dst_path;
+	mode_t		mode;
+	/* one per queued segment, plus one held by the walker */
+	uint32_t	refs;
+	int		rc;
+};
+
+/** directory whose mode is set once everything under it is copied */
+struct dm_dir {
+	d_list_t	link;
+	char		*path;
+	mode_t		mode;
+};
+
+struct dm_work {
+	d_list_t	link;
+	/* file segment */
+	struct dm_file	*file;
+	uint64_t	off;
+	uint64_t	len;
+	/* object to clone */
+	daos_obj_id_t	oid;
+};
+
+struct dm_mover {
+	struct cmd_args_s	*ap;
+	dm_work_fn_t		fn;
+	pthread_mutex_t		lock;
+	/* signaled when work is queued or the threads have to exit */
+	pthread_cond_t		work_cond;
+	/* signaled when an item is done */
+	pthread_cond_t		done_cond;
+	d_list_t		queue;
+	uint32_t		queued;
+	uint32_t		busy;
+	bool			stop;
+	/* first error, the remaining items are skipped */
+	int			rc;
+	struct dm_worker	*workers;
+	uint32_t		nr_workers;
+	/* containers of a clone */
+	daos_handle_t		src_coh;
+	daos_handle_t		dst_coh;
+	/* directories of a copy, children first */
+	d_list_t		dirs;
+	/* progress, the totals are only updated by the walker */
+	const char		*unit;
+	uint64_t		items;
+	uint64_t		items_done;
+	uint64_t		bytes;
+	uint64_t		bytes_done;
+	uint64_t		start;
+	uint64_t		report;
+};
+
+static inline bool
+dm_failed(struct dm_mover *mv)
+{
+	return __atomic_load_n(&mv->rc, __ATOMIC_RELAXED) != 0;
+}
+
+static void
+dm_progress(struct dm_mover *mv, bool final)
+{
+	FILE		*out = mv->ap->outstream;
+	uint64_t	now = daos_get_ntime();
+	uint64_t	items_done;
+	uint64_t	bytes_done;
+	double		sec;
+
+	if (!final &&
+	    now - mv->report < DM_PROGRESS_SEC * (uint64_t)NSEC_PER_SEC)
+		return;
+	mv->report = now;
+
+	items_done = __atomic_load_n(&mv->items_done, __ATOMIC_RELAXED);
+	bytes_done = __atomic_load_n(&mv->bytes_done, __ATOMIC_RELAXED);
+	sec = (double)(now - mv->start) / NSEC_PER_SEC;
+	if (sec < 0.001)
+		sec = 0.001;
+
+	fprintf(out, "%s %lu/%lu %s", final ? "Copied" : "Copying",
+		items_done, mv->items, mv->unit);
+	if (mv->bytes != 0)
+		fprintf(out, ", %lu/%lu MiB, %.1f MiB/s", bytes_done >> 20,
+			mv->bytes >> 20, bytes_done / sec / (1 << 20));
+	else
+		fprintf(out, ", %.1f %s/s", items_done / sec, mv->unit);
+	fprintf(out, " in %.1f s\n", sec);
+	fflush(out);
+}
+
+/* Wait for some work to complete, called by the walker with the lock held */
+static void
+dm_wait(struct dm_mover *mv)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += 1;
+	pthread_cond_timedwait(&mv->done_cond, &mv->lock, &ts);
+	dm_progress(mv, false);
+}
+
+static void *
+dm_worker_run(void *arg)
+{
+	struct dm_worker	*w = arg;
+	struct dm_mover		*mv = w->mv;
+	struct dm_work		*work;
+	int			rc;
+
+	D_MUTEX_LOCK(&mv->lock);
+	while (1) {
+		work = d_list_pop_entry(&mv->queue, struct dm_work, link);
+		if (work == NULL) {
+			if (mv->stop)
+				break;
+			pthread_cond_wait(&mv->work_cond, &mv->lock);
+			continue;
+		}
+		mv->queued--;
+		mv->busy++;
+		D_MUTEX_UNLOCK(&mv->lock);
+
+		/* the handler owns the item, and skips it after an error */
+		rc = mv->fn(w, work);
+
+		D_MUTEX_LOCK(&mv->lock);
+		if (rc != 0 && mv->rc == 0)
+			mv->rc = rc;
+		mv->busy--;
+		pthread_cond_broadcast(&mv->done_cond);
+	}
+	D_MUTEX_UNLOCK(&mv->lock);
+	return NULL;
+}
+
+static void
+dm_worker_fini(struct dm_worker *w)
+{
+	int i;
+
+	for (i = 0; i < w->nr_ios; i++) {
+		/* leak the buffers that an I/O could not be reaped from */
+		if (w->ios[i].inflight)
+			continue;
+		daos_event_fini(&w->ios[i].ev);
+		D_FREE(w->ios[i].buf);
+	}
+	w->nr_ios = 0;
+	if (daos_handle_is_valid(w->eq))
+		daos_eq_destroy(w->eq, 0);
+	w->eq = DAOS_HDL_INVAL;
+}
+
+static int
+dm_worker_init(struct dm_worker *w, struct dm_mover *mv, bool bufs)
+{
+	struct dm_io	*io;
+	int		rc;
+
+	w->mv = mv;
+	w->eq = DAOS_HDL_INVAL;
+	if (!bufs)
+		return 0;
+
+	rc = daos_eq_create(&w->eq);
+	if (rc != 0)
+		return rc;
+
+	for (w->nr_ios = 0; w->nr_ios < DM_DEPTH; w->nr_ios++) {
+		io = &w->ios[w->nr_ios];
+		D_ALLOC_NZ(io->buf, DM_CHUNK_SIZE);
+		if (io->buf == NULL)
+			D_GOTO(failed, rc = -DER_NOMEM);
+		rc = daos_event_init(&io->ev, w->eq, NULL);
+		if (rc != 0) {
+			D_FREE(io->buf);
+			D_GOTO(failed, rc);
+		}
+	}
+	return 0;
+failed:
+	dm_worker_fini(w);
+	return rc;
+}
+
+/* Stop and join the threads once the queue is drained, return the first error */
+static int
+dm_mover_fini(struct dm_mover *mv)
+{
+	uint32_t	i;
+
+	D_MUTEX_LOCK(&mv->lock);
+	while (mv->queued > 0 || mv->busy > 0)
+		dm_wait(mv);
+	mv->stop = true;
+	pthread_cond_broadcast(&mv->work_cond);
+	D_MUTEX_UNLOCK(&mv->lock);
+
+	for (i = 0; i < mv->nr_workers; i++) {
+		pthread_join(mv->workers[i].thread, NULL);
+		dm_worker_fini(&mv->workers[i]);
+	}
+	D_FREE(mv->workers);
+	mv->nr_workers = 0;
+
+	pthread_cond_destroy(&mv->work_cond);
+	pthread_cond_destroy(&mv->done_cond);
+	D_MUTEX_DESTROY(&mv->lock);
+
+	if (mv->rc == 0 && mv->items > 0)
+		dm_progress(mv, true);
+	return mv->rc;
+}
+
+/**
+ * Start the threads of a mover, \a bufs is set if the items are copied
+ * through the buffers of the threads.
+ */
+static int
+dm_mover_init(struct dm_mover *mv, struct cmd_args_s *ap, dm_work_fn_t fn,
+	      const char *unit, bool bufs)
+{
+	uint32_t	nr = ap->threads != 0 ? ap->threads : DM_THREADS;
+	int		rc;
+
+	memset(mv, 0, sizeof(*mv));
+	mv->ap = ap;
+	mv->fn = fn;
+	mv->unit = unit;
+	mv->src_coh = DAOS_HDL_INVAL;
+	mv->dst_coh = DAOS_HDL_INVAL;
+	D_INIT_LIST_HEAD(&mv->queue);
+	D_INIT_LIST_HEAD(&mv->dirs);
+	mv->start = daos_get_ntime();
+	mv->report = mv->start;
+
+	D_ALLOC_ARRAY(mv->workers, nr);
+	if (mv->workers == NULL)
+		return -DER_NOMEM;
+
+	rc = D_MUTEX_INIT(&mv->lock, NULL);
+	if (rc != 0)
+		D_GOTO(out_workers, rc);
+	rc = pthread_cond_init(&mv->work_cond, NULL);
+	if (rc != 0)
+		D_GOTO(out_lock, rc = daos_errno2der(rc));
+	rc = pthread_cond_init(&mv->done_cond, NULL);
+	if (rc != 0) {
+		pthread_cond_destroy(&mv->work_cond);
+		D_GOTO(out_lock, rc = daos_errno2der(rc));
+	}
+
+	for (mv->nr_workers = 0; mv->nr_workers < nr; mv->nr_workers++) {
+		struct dm_worker *w = &mv->workers[mv->nr_workers];
+
+		rc = dm_worker_init(w, mv, bufs);
+		if (rc != 0)
+			break;
+		rc = pthread_create(&w->thread, NULL, dm_worker_run, w);
+		if (rc != 0) {
+			dm_worker_fini(w);
+			rc = daos_errno2der(rc);
+			break;
+		}
+	}
+	if (rc != 0) {
+		fprintf(ap->errstream, "failed to start copy threads: "DF_RC"\n",
+			DP_RC(rc));
+		dm_mover_fini(mv);
+	}
+	return rc;
+
+out_lock:
+	D_MUTEX_DESTROY(&mv->lock);
+out_workers:
+	D_FREE(mv->workers);
+	return rc;
+}
+
+/* Record the error of the walker, the items queued are then skipped */
+static void
+dm_mover_fail(struct dm_mover *mv, int rc)
+{
+	D_MUTEX_LOCK(&mv->lock);
+	if (mv->rc == 0)
+		mv->rc = rc;
+	D_MUTEX_UNLOCK(&mv->lock);
+}
+
+/**
+ * Queue an item, wait if the queue is full. The item is not queued if a
+ * previous one failed, the error is returned and the caller keeps it.
+ */
+static int
+dm_mover_add(struct dm_mover *mv, struct dm_work *work)
+{
+	int rc;
+
+	D_MUTEX_LOCK(&mv->lock);
+	while (mv->queued >= DM_QUEUE_DEPTH * mv->nr_workers && mv->rc == 0)
+		dm_wait(mv);
+	rc = mv->rc;
+	if (rc == 0) {
+		d_list_add_tail(&work->link, &mv->queue);
+		mv->queued++;
+		pthread_cond_signal(&mv->work_cond);
+	}
+	D_MUTEX_UNLOCK(&mv->lock);
+	return rc;
+}
+
+static void
+dm_file_dfs(struct file_dfs *to, struct file_dfs *from)
+{
+	to->type = from->type;
+	to->dfs = from->dfs;
+	to->fd = -1;
+	to->offset = 0;
+	to->obj = NULL;
+}
+
+/* Drop a reference, the last one sets the mode of the copy */
+static int
+dm_file_put(struct dm_mover *mv, struct dm_file *file, int rc)
+{
+	if (rc != 0)
+		__atomic_store_n(&file->rc, rc, __ATOMIC_RELAXED);
+	if (__atomic_sub_fetch(&file->refs, 1, __ATOMIC_ACQ_REL) > 0)
+		return rc;
+
+	rc = file->rc;
+	if (rc == 0 && !dm_failed(mv)) {
+		rc = file_chmod(mv->ap, &file->dst, file->dst_path, file->mode);
+		if (rc != 0) {
+			fprintf(mv->ap->errstream, "updating dst file "
+				"permissions failed (%d)\n", rc);
+			rc = daos_errno2der(rc);
+		} else {
+			__atomic_fetch_add(&mv->items_done, 1,
+					   __ATOMIC_RELAXED);
+		}
+	}
+	D_FREE(file->src_path);
+	D_FREE(file->dst_path);
+	D_FREE(file);
+	return rc;
+}
+
+/*
+ * Start reading a chunk, return 1 if the read is in flight, 0 if it is done
+ * or a negative error.
+ */
+static int
+dm_io_read(struct dm_worker *w, struct file_dfs *src, const char *path,
+	   struct dm_io *io)
+{
+	ssize_t	n;
+	int	rc;
+
+	io->writing = false;
+	io->got = 0;
+	if (src->type == DAOS) {
+		d_iov_set(&io->iov, io->buf, io->len);
+		io->sgl.sg_nr = 1;
+		io->sgl.sg_nr_out = 0;
+		io->sgl.sg_iovs = &io->iov;
+		rc = dfs_read(src->dfs, src->obj, &io->sgl, io->off, &io->got,
+			      &io->ev);
+		if (rc != 0) {
+			fprintf(w->mv->ap->errstream,
+				"dfs_read %s failed (%d %s)\n", path, rc,
+				strerror(rc));
+			return daos_errno2der(rc);
+		}
+		return 1;
+	}
+
+	while (io->got < io->len) {
+		n = pread(src->fd, io->buf + io->got, io->len - io->got,
+			  io->off + io->got);
+		if (n < 0) {
+			rc = errno;
+			fprintf(w->mv->ap->errstream, "read failed on %s (%s)\n",
+				path, strerror(rc));
+			return daos_errno2der(rc);
+		}
+		/* the file was truncated meanwhile */
+		if (n == 0)
+			break;
+		io->got += n;
+	}
+	return 0;
+}
+
+/* Start writing a chunk that was read, same return values as dm_io_read() */
+static int
+dm_io_write(struct dm_worker *w, struct file_dfs *dst, const char *path,
+	    struct dm_io *io)
+{
+	daos_size_t	done;
+	ssize_t		n;
+	int		rc;
+
+	if (io->got == 0)
+		return 0;
+
+	io->writing = true;
+	if (dst->type == DAOS) {
+		d_iov_set(&io->iov, io->buf, io->got);
+		io->sgl.sg_nr = 1;
+		io->sgl.sg_nr_out = 0;
+		io->sgl.sg_iovs = &io->iov;
+		rc = dfs_write(dst->dfs, dst->obj, &io->sgl, io->off, &io->ev);
+		if (rc != 0) {
+			fprintf(w->mv->ap->errstream,
+				"dfs_write %s failed (%d %s)\n", path, rc,
+				strerror(rc));
+			return daos_errno2der(rc);
+		}
+		return 1;
+	}
+
+	for (done = 0; done < io->got; done += n) {
+		n = pwrite(dst->fd, io->buf + done, io->got - done,
+			   io->off + done);
+		if (n < 0) {
+			rc = errno;
+			fprintf(w->mv->ap->errstream,
+				"write failed on %s (%s)\n", path, strerror(rc));
+			return daos_errno2der(rc);
+		}
+	}
+	__atomic_fetch_add(&w->mv->bytes_done, io->got, __ATOMIC_RELAXED);
+	return 0;
+}
+
+/* Account an I/O that was just issued, return the error if it failed */
+static inline int
+dm_io_issued(int rc, struct dm_io *io, int *inflight, struct dm_io **free_ios,
+	     int *nr_free)
+{
+	if (rc == 1) {
+		io->inflight = true;
+		(*inflight)++;
+		return 0;
+	}
+	if (rc == 0)
+		free_ios[(*nr_free)++] = io;
+	return rc;
+}
+
+static int
+dm_copy_range(struct dm_worker *w, struct dm_file *file, struct file_dfs *src,
+	      struct file_dfs *dst, uint64_t off, uint64_t len)
+{
+	struct dm_io	*free_ios[DM_DEPTH];
+	struct dm_io	*io;
+	daos_event_t	*evp;
+	uint64_t	end = off + len;
+	int		nr_free;
+	int		inflight = 0;
+	int		rc = 0;
+	int		rc2;
+	int		i;
+	bool		aborted = false;
+
+	for (nr_free = 0; nr_free < w->nr_ios; nr_free++)
+		free_ios[nr_free] = &w->ios[nr_free];
+
+	while (off < end || inflight > 0) {
+		/* read ahead into all the free buffers */
+		while (nr_free > 0 && off < end) {
+			io = free_ios[--nr_free];
+			io->off = off;
+			io->len = min(end - off, DM_CHUNK_SIZE);
+			off += io->len;
+
+			rc = dm_io_read(w, src, file->src_path, io);
+			if (rc == 0)
+				rc = dm_io_write(w, dst, file->dst_path, io);
+			rc = dm_io_issued(rc, io, &inflight, free_ios,
+					  &nr_free);
+			if (rc != 0)
+				D_GOTO(out, rc);
+		}
+		if (inflight == 0)
+			continue;
+
+		rc = daos_eq_poll(w->eq, 1, DAOS_EQ_WAIT, 1, &evp);
+		if (rc < 0) {
+			fprintf(w->mv->ap->errstream,
+				"failed to poll event queue: "DF_RC"\n",
+				DP_RC(rc));
+			D_GOTO(out, rc);
+		}
+		if (rc == 0)
+			continue;
+		inflight--;
+
+		io = container_of(evp, struct dm_io, ev);
+		io->inflight = false;
+		if (evp->ev_error != 0) {
+			fprintf(w->mv->ap->errstream, "%s %s failed (%d %s)\n",
+				io->writing ? "dfs_write" : "dfs_read",
+				io->writing ? file->dst_path : file->src_path,
+				evp->ev_error, strerror(evp->ev_error));
+			D_GOTO(out, rc = daos_errno2der(evp->ev_error));
+		}
+
+		if (io->writing) {
+			__atomic_fetch_add(&w->mv->bytes_done, io->got,
+					   __ATOMIC_RELAXED);
+			free_ios[nr_free++] = io;
+			rc = 0;
+			continue;
+		}
+
+		/* the read is done, write the chunk */
+		rc = dm_io_write(w, dst, file->dst_path, io);
+		rc = dm_io_issued(rc, io, &inflight, free_ios, &nr_free);
+		if (rc != 0)
+			D_GOTO(out, rc);
+	}
+out:
+	/*
+	 * Wait for the I/Os in flight before the buffers are reused, abort them
+	 * if the queue cannot be polled. The buffers of the aborted I/Os are
+	 * leaked by dm_worker_fini(), and the error stops the copy so that
+	 * they are not reused.
+	 */
+	while (inflight > 0) {
+		rc2 = daos_eq_poll(w->eq, 1, DAOS_EQ_WAIT, 1, &evp);
+		if (rc2 > 0) {
+			/* an aborted read or write may still be running */
+			io = container_of(evp, struct dm_io, ev);
+			if (!aborted)
+				io->inflight = false;
+			inflight--;
+			continue;
+		}
+		if (rc2 == 0)
+			continue;
+		if (rc == 0)
+			rc = rc2;
+		if (aborted)
+			break;
+		fprintf(w->mv->ap->errstream,
+			"failed to poll event queue, aborting %d I/Os: "DF_RC"\n",
+			inflight, DP_RC(rc2));
+		for (i = 0; i < w->nr_ios; i++) {
+			if (w->ios[i].inflight)
+				daos_event_abort(&w->ios[i].ev);
+		}
+		aborted = true;
+	}
+	return rc;
+}
+
+/* Copy a segment of a file, the handler of the items of a copy */
+static int
+dm_copy_seg(struct dm_worker *w, struct dm_work *work)
+{
+	struct dm_mover	*mv = w->mv;
+	struct dm_file	*file = work->file;
+	struct file_dfs	src;
+	struct file_dfs	dst;
+	int		rc = 0;
+	int		rc2;
+
+	if (dm_failed(mv))
+		D_GOTO(out, rc);
+
+	dm_file_dfs(&src, &file->src);
+	dm_file_dfs(&dst, &file->dst);
+
+	rc = file_open(mv->ap, &src, file->src_path, O_RDONLY);
+	if (rc != 0)
+		D_GOTO(out, rc = daos_errno2der(rc));
+	rc = file_open(mv->ap, &dst, file->dst_path, O_WRONLY);
+	if (rc != 0)
+		D_GOTO(out_src, rc = daos_errno2der(rc));
+
+	rc = dm_copy_range(w, file, &src, &dst, work->off, work->len);
+
+	rc2 = file_close(mv->ap, &dst, file->dst_path);
+	if (rc == 0 && rc2 != 0)
+		rc = daos_errno2der(rc2);
+out_src:
+	file_close(mv->ap, &src, file->src_path);
+out:
+	rc = dm_file_put(mv, file, rc);
+	D_FREE(work);
+	return rc;
+}
+
+/*
+ * Set the mode of the copied directories, deferred until their files are
+ * copied as the mode may not allow to create them.
+ */
+static int
+dm_set_dir_modes(struct dm_mover *mv, struct file_dfs *dst_file_dfs, int rc)
+{
+	struct dm_dir	*dir;
+	int		rc2;
+
+	while ((dir = d_list_pop_entry(&mv->dirs, struct dm_dir, link))) {
+		if (rc == 0) {
+			rc2 = file_chmod(mv->ap, dst_file_dfs, dir->path,
+					 dir->mode);
+			if (rc2 != 0) {
+				fprintf(mv->ap->errstream, "updating "
+					"destination permissions failed on "
+					"%s (%d)\n", dir->path, rc2);
+				rc = rc2;
+			}
+		}
+		D_FREE(dir->path);
+		D_FREE(dir);
+	}
+	return rc;
+}
+
+/* Create the destination file and queue the copy of its segments */
 static int
 fs_copy_file(struct cmd_args_s *ap,
+	     struct dm_mover *mv,
 	     struct file_dfs *src_file_dfs,
 	     struct file_dfs *dst_file_dfs,
 	     struct stat *src_stat,
 	     const char *src_path,
 	     const char *dst_path)
 {
-	int src_flags		= O_RDONLY;
 	int dst_flags		= O_CREAT | O_WRONLY;
 	mode_t tmp_mode_file	= S_IRUSR | S_IWUSR;
-	int rc;
 	uint64_t file_length	= src_stat->st_size;
-	uint64_t total_bytes	= 0;
-	uint64_t buf_size	= 64 * 1024 * 1024;
-	void *buf		= NULL;
-
-	/* Open source file */
-	rc = file_open(ap, src_file_dfs, src_path, src_flags);
-	if (rc != 0)
-		D_GOTO(out, rc);
+	uint64_t off		= 0;
+	struct dm_file *file	= NULL;
+	struct dm_work *work;
+	int rc;
 
-	/* Open destination file */
+	/* Create the destination file, the segments are written in place */
 	rc = file_open(ap, dst_file_dfs, dst_path, dst_flags, tmp_mode_file);
 	if (rc != 0)
-		D_GOTO(out_src_file, rc);
+		return rc;
+	rc = file_close(ap, dst_file_dfs, dst_path);
+	if (rc != 0)
+		return rc;
 
-	/* Allocate read/write buffer */
-	D_ALLOC(buf, buf_size);
-	if (buf == NULL)
-		D_GOTO(out_dst_file, rc = ENOMEM);
-
-	/* read from source file, then write to dest file */
-	while (total_bytes < file_length) {
-		size_t left_to_read = buf_size;
-		uint64_t bytes_left = file_length - total_bytes;
-
-		if (bytes_left < buf_size)
-			left_to_read = (size_t)bytes_left;
-		ssize_t bytes_read = file_read(ap, src_file_dfs, src_path,
-					       buf, left_to_read);
-		if (bytes_read < 0) {
-			fprintf(stderr, "read failed on %s\n", src_path);
-			D_GOTO(out_buf, rc = EIO);
-		}
-		size_t bytes_to_write = (size_t)bytes_read;
-		ssize_t bytes_written;
-
-		bytes_written = file_write(ap, dst_file_dfs, dst_path,
-					   buf, bytes_to_write);
-		if (bytes_written < 0) {
-			fprintf(stderr, "write failed on %s\n", dst_path);
-			D_GOTO(out_buf, rc = EIO);
-		}
+	D_ALLOC_PTR(file);
+	if (file == NULL)
+		return ENOMEM;
+	dm_file_dfs(&file->src, src_file_dfs);
+	dm_file_dfs(&file->dst, dst_file_dfs);
+	file->mode = src_stat->st_mode;
+	file->refs = 1;
+	D_STRNDUP(file->src_path, src_path, strlen(src_path));
+	D_STRNDUP(file->dst_path, dst_path, strlen(dst_path));
+	if (file->src_path == NULL || file->dst_path == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
 
-		total_bytes += bytes_read;
-	}
+	mv->items++;
+	mv->bytes += file_length;
+	while (off < file_length) {
+		D_ALLOC_PTR(work);
+		if (work == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+		work->file = file;
+		work->off = off;
+		work->len = min(file_length - off, DM_SEG_SIZE);
+		off += work->len;
 
-	/* set perms on destination to original source perms */
-	rc = file_chmod(ap, dst_file_dfs, dst_path, src_stat->st_mode);
-	if (rc != 0) {
-		fprintf(stderr, "updating dst file "
-			"permissions failed (%d)\n", rc);
-		D_GOTO(out_buf, rc);
+		__atomic_add_fetch(&file->refs, 1, __ATOMIC_RELAXED);
+		rc = dm_mover_add(mv, work);
+		if (rc != 0) {
+			dm_file_put(mv, file, rc);
+			D_FREE(work);
+			D_GOTO(out, rc);
+		}
 	}
-
-out_buf:
-	D_FREE(buf);
-out_dst_file:
-	file_close(ap, dst_file_dfs, dst_path);
-out_src_file:
-	file_close(ap, src_file_dfs, src_path);
 out:
-	/* reset offsets if there is another file to copy */
-	src_file_dfs->offset = 0;
-	dst_file_dfs->offset = 0;
-	return rc;
+	/* the mode is set by whoever copies the last segment */
+	rc = dm_file_put(mv, file, rc);
+	return daos_der2errno(rc);
 }
 
 static int
 fs_copy_dir(struct cmd_args_s *ap,
+	    struct dm_mover *mv,
 	    struct file_dfs *src_file_dfs,
 	    struct file_dfs *dst_file_dfs,
 	    struct stat *src_stat,
@@ -2564,6 +3136,7 @@ fs_copy_dir(struct cmd_args_s *ap,
 	char			*next_dst_path = NULL;
 	struct stat		next_src_stat;
 	mode_t			tmp_mode_dir = S_IRWXU;
+	struct dm_dir		*dir;
 	int			rc;
 
 	/* begin by opening source directory */
@@ -2625,7 +3198,7 @@ fs_copy_dir(struct cmd_args_s *ap,
 
 		switch (next_src_stat.st_mode & S_IFMT) {
 		case S_IFREG:
-			rc = fs_copy_file(ap, src_file_dfs, dst_file_dfs,
+			rc = fs_copy_file(ap, mv, src_file_dfs, dst_file_dfs,
 					  &next_src_stat, next_src_path,
 					  next_dst_path);
 			if (rc != 0)
@@ -2633,7 +3206,7 @@ fs_copy_dir(struct cmd_args_s *ap,
 			(*num_files)++;
 			break;
 		case S_IFDIR:
-			rc = fs_copy_dir(ap, src_file_dfs, dst_file_dfs,
+			rc = fs_copy_dir(ap, mv, src_file_dfs, dst_file_dfs,
 					 &next_src_stat, next_src_path,
 					 next_dst_path, num_dirs, num_files);
 			if (rc != 0)
@@ -2650,12 +3223,16 @@ fs_copy_dir(struct cmd_args_s *ap,
 	}
 
 	/* set original source perms on directories after copying */
-	rc = file_chmod(ap, dst_file_dfs, dst_path, src_stat->st_mode);
-	if (rc != 0) {
-		fprintf(stderr, "updating destination permissions failed on "
-			"%s (%d)\n", dst_path, rc);
-		D_GOTO(out, rc);
+	D_ALLOC_PTR(dir);
+	if (dir == NULL)
+		D_GOTO(out, rc = ENOMEM);
+	D_STRNDUP(dir->path, dst_path, strlen(dst_path));
+	if (dir->path == NULL) {
+		D_FREE(dir);
+		D_GOTO(out, rc = ENOMEM);
 	}
+	dir->mode = src_stat->st_mode;
+	d_list_add_tail(&dir->link, &mv->dirs);
 out:
 	if (rc != 0) {
 		D_FREE(next_src_path);
@@ -2692,6 +3269,8 @@ fs_copy(struct cmd_args_s *ap,
 	char		*tmp_path = NULL;
 	char		*tmp_dir = NULL;
 	char		*tmp_name = NULL;
+	struct dm_mover	mv;
+	int		mv_rc;
 
 	/* Make sure the source exists. */
 	rc = file_lstat(ap, src_file_dfs, src_path, &src_stat);
@@ -2733,25 +3312,39 @@ fs_copy(struct cmd_args_s *ap,
 		}
 	}
 
+	rc = dm_mover_init(&mv, ap, dm_copy_seg, "files", true);
+	if (rc != 0)
+		D_GOTO(out, rc = daos_der2errno(rc));
+
 	switch (src_stat.st_mode & S_IFMT) {
 	case S_IFREG:
-		rc = fs_copy_file(ap, src_file_dfs, dst_file_dfs, &src_stat,
-				  src_path, dst_path);
+		rc = fs_copy_file(ap, &mv, src_file_dfs, dst_file_dfs,
+				  &src_stat, src_path, dst_path);
 		if (rc == 0)
 			(*num_files)++;
 		break;
 	case S_IFDIR:
-		rc = fs_copy_dir(ap, src_file_dfs, dst_file_dfs, &src_stat,
-				 src_path, dst_path, num_dirs, num_files);
+		rc = fs_copy_dir(ap, &mv, src_file_dfs, dst_file_dfs,
+				 &src_stat, src_path, dst_path, num_dirs,
+				 num_files);
 		if (rc == 0)
 			(*num_dirs)++;
 		break;
 	default:
 		fprintf(ap->errstream,
 			"Only files and directories are supported\n");
-		D_GOTO(out, rc = ENOTSUP);
+		rc = ENOTSUP;
+		break;
 	}
 
+	/* wait for the files to be copied, skip them if the walk failed */
+	if (rc != 0)
+		dm_mover_fail(&mv, daos_errno2der(rc));
+	mv_rc = dm_mover_fini(&mv);
+	if (rc == 0)
+		rc = daos_der2errno(mv_rc);
+	rc = dm_set_dir_modes(&mv, dst_file_dfs, rc);
+
 out:
 	if (copy_into_dst) {
 		D_FREE(tmp_path);
@@ -3636,6 +4229,56 @@ out:
 	return rc;
 }
 
+/* Copy all the keys of an object, the handler of the items of a clone */
+static int
+dm_clone_obj(struct dm_worker *w, struct dm_work *work)
+{
+	struct dm_mover		*mv = w->mv;
+	struct cmd_args_s	*ap = mv->ap;
+	daos_handle_t		oh;
+	daos_handle_t		dst_oh;
+	int			rc = 0;
+	int			rc2;
+
+	if (dm_failed(mv))
+		D_GOTO(out, rc);
+
+	rc = daos_obj_open(mv->src_coh, work->oid, 0, &oh, NULL);
+	if (rc != 0) {
+		fprintf(ap->errstream, "failed to open source object\n");
+		D_GOTO(out, rc);
+	}
+	rc = daos_obj_open(mv->dst_coh, work->oid, 0, &dst_oh, NULL);
+	if (rc != 0) {
+		fprintf(ap->errstream, "failed to open destination object\n");
+		D_GOTO(out_src, rc);
+	}
+	rc = cont_clone_list_dkeys(ap, &oh, &dst_oh);
+	if (rc != 0)
+		fprintf(ap->errstream, "failed to list keys\n");
+
+	rc2 = daos_obj_close(dst_oh, NULL);
+	if (rc2 != 0) {
+		fprintf(ap->errstream,
+			"failed to close destination object: %d\n", rc2);
+		if (rc == 0)
+			rc = rc2;
+	}
+out_src:
+	rc2 = daos_obj_close(oh, NULL);
+	if (rc2 != 0) {
+		fprintf(ap->errstream,
+			"failed to close source object: %d\n", rc2);
+		if (rc == 0)
+			rc = rc2;
+	}
+out:
+	if (rc == 0 && !dm_failed(mv))
+		__atomic_fetch_add(&mv->items_done, 1, __ATOMIC_RELAXED);
+	D_FREE(work);
+	return rc;
+}
+
 int
 cont_clone_hdlr(struct cmd_args_s *ap)
 {
@@ -3650,8 +4293,9 @@ cont_clone_hdlr(struct cmd_args_s *ap)
 	daos_epoch_t		epoch;
 	struct			dm_args ca = {0};
 	bool			is_posix_copy = false;
-	daos_handle_t		oh;
-	daos_handle_t		dst_oh;
+	struct dm_mover		mv;
+	struct dm_work		*work;
+	int			rc2;
 	struct file_dfs		src_cp_type = {0};
 	struct file_dfs		dst_cp_type = {0};
 	char			*src_str = NULL;
@@ -3760,84 +4404,67 @@ cont_clone_hdlr(struct cmd_args_s *ap)
 		fprintf(ap->errstream, "failed to open object iterator\n");
 		D_GOTO(out_snap, rc);
 	}
+	rc = dm_mover_init(&mv, ap, dm_clone_obj, "objects", false);
+	if (rc != 0)
+		D_GOTO(out_oit, rc);
+	mv.src_coh = ca.src_coh;
+	mv.dst_coh = ca.dst_coh;
+
 	memset(&anchor, 0, sizeof(anchor));
 	while (!daos_anchor_is_eof(&anchor)) {
 		oids_nr = OID_ARR_SIZE;
 		rc = daos_oit_list(toh, oids, &oids_nr, &anchor, NULL);
 		if (rc != 0) {
 			fprintf(ap->errstream, "failed to list objects\n");
-			D_GOTO(out_oit, rc);
+			D_GOTO(out_mover, rc);
 		}
 
-		/* list object ID's */
+		/* queue the objects to the copy threads */
 		for (i = 0; i < oids_nr; i++) {
-			rc = daos_obj_open(ca.src_coh, oids[i],
-					   0, &oh, NULL);
-			if (rc != 0) {
-				fprintf(ap->errstream, "failed to open source "
-					"object\n");
-				D_GOTO(out_oit, rc);
-			}
-			rc = daos_obj_open(ca.dst_coh, oids[i], 0,
-					   &dst_oh, NULL);
-			if (rc != 0) {
-				fprintf(ap->errstream,
-					"failed to open destination object\n");
-				D_GOTO(err_dst, rc);
-			}
-			rc = cont_clone_list_dkeys(ap, &oh, &dst_oh);
-			if (rc != 0) {
-				fprintf(ap->errstream, "failed to list keys\n");
-				D_GOTO(err_obj, rc);
-			}
-			rc = daos_obj_close(oh, NULL);
-			if (rc != 0) {
-				fprintf(ap->errstream, "failed to close source "
-					"object: %d\n", rc);
-				D_GOTO(out_oit, rc);
-			}
-			rc = daos_obj_close(dst_oh, NULL);
+			D_ALLOC_PTR(work);
+			if (work == NULL)
+				D_GOTO(out_mover, rc = -DER_NOMEM);
+			work->oid = oids[i];
+			rc = dm_mover_add(&mv, work);
 			if (rc != 0) {
-				fprintf(ap->errstream,
-				"failed to close destination "
-				"object: %d\n", rc);
-				D_GOTO(err_dst, rc);
+				D_FREE(work);
+				D_GOTO(out_mover, rc);
 			}
+			mv.items++;
 		}
 	}
-	D_GOTO(out_oit, rc);
-err_obj:
-	rc = daos_obj_close(dst_oh, NULL);
-	if (rc != 0) {
-		fprintf(ap->errstream,
-			"failed to close destination object: %d\n", rc);
-	}
-err_dst:
-	rc = daos_obj_close(oh, NULL);
-	if (rc != 0) {
-		fprintf(ap->errstream,
-			"failed to close source object: %d\n", rc);
-	}
+out_mover:
+	if (rc != 0)
+		dm_mover_fail(&mv, rc);
+	rc2 = dm_mover_fini(&mv);
+	if (rc == 0)
+		rc = rc2;
 out_oit:
-	rc = daos_oit_close(toh, NULL);
-	if (rc != 0) {
+	rc2 = daos_oit_close(toh, NULL);
+	if (rc2 != 0) {
 		fprintf(ap->errstream,
-			"failed to close object iterator: %d\n", rc);
-		D_GOTO(out, rc);
+			"failed to close object iterator: %d\n", rc2);
+		if (rc == 0)
+			rc = rc2;
 	}
 out_snap:
 	epr.epr_lo = epoch;
 	epr.epr_hi = epoch;
-	rc = daos_cont_destroy_snap(ca.src_coh, epr, NULL);
-	if (rc != 0) {
-		fprintf(ap->errstream, "failed to destroy snapshot: %d\n", rc);
+	rc2 = daos_cont_destroy_snap(ca.src_coh, epr, NULL);
+	if (rc2 != 0) {
+		fprintf(ap->errstream, "failed to destroy snapshot: %d\n",
+			rc2);
+		if (rc == 0)
+			rc = rc2;
 	}
 out_disconnect:
 	/* close src and dst pools, conts */
-	rc = dm_disconnect(ap, is_posix_copy, &ca, &src_cp_type,
-			   &dst_cp_type);
-	if (rc != 0) {
-		fprintf(ap->errstream, "failed to disconnect: %d\n", rc);
+	rc2 = dm_disconnect(ap, is_posix_copy, &ca, &src_cp_type,
+			    &dst_cp_type);
+	if (rc2 != 0) {
+		fprintf(ap->errstream, "failed to disconnect: %d\n", rc2);
+		if (rc == 0)
+			rc = rc2;
 	}
 out:
 	if (rc == 0) {
@@ -93,6 +93,7 @@ struct cmd_args_s {
 	daos_oclass_id_t	oclass;		/* --oclass object class */
 	uint32_t		mode;		/* --posix consistency mode */
 	daos_size_t		chunk_size;	/* --chunk_size of cont objs */
+	uint32_t		threads;	/* --threads of copy and clone */
 
 	/* Container snapshot/rollback related */
 	char			*snapname_str;	/* --snap cont snapshot name */
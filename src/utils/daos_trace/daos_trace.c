@@ -0,0 +1,719 @@
+/*
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/*
+ * This utility reads the trace ring of a process, either live from its shared
+ * memory segment or from a dump, and prints the latency of each traced stage.
+ * It also turns the recording of a live process on and off.
+ */
+
+#include <getopt.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gurt/trace.h"
+
+static const char *stage_names[] = {
+	[D_TRACE_RPC]			= "rpc",
+	[D_TRACE_SCHED]			= "sched",
+	[D_TRACE_VOS_UPDATE_BEGIN]	= "vos_update_begin",
+	[D_TRACE_VOS_UPDATE_END]	= "vos_update_end",
+	[D_TRACE_BIO_PREP]		= "bio_iod_prep",
+	[D_TRACE_BULK]			= "bulk",
+};
+
+/** a record and the ring it was read from */
+struct trace_event {
+	struct d_trace_rec	te_rec;
+	uint32_t		te_ring;
+};
+
+/** a begin event paired with its end event */
+struct trace_span {
+	uint64_t	ts_start;
+	uint64_t	ts_end;
+	uint64_t	ts_tag;
+	uint32_t	ts_ring;
+	/** argument of the begin event, the opcode of a RPC */
+	uint32_t	ts_arg;
+	uint16_t	ts_stage;
+};
+
+/** time spent in each stage by the RPCs of an opcode */
+struct trace_opc {
+	uint32_t	to_opc;
+	uint64_t	to_count;
+	uint64_t	to_ns[D_TRACE_STAGE_MAX];
+	uint64_t	to_self_ns;
+};
+
+static void
+print_usage(const char *prog_name)
+{
+	printf("Usage: %s [optional arguments]\n"
+	       "\n"
+	       "--pid, -p\n"
+	       "\tRead the trace ring of this process\n"
+	       "--input, -i\n"
+	       "\tRead the trace ring from a file written with --output\n"
+	       "--output, -o\n"
+	       "\tWrite the trace ring to a file rather than printing it\n"
+	       "--enable, -e\n"
+	       "\tResume the recording of the process\n"
+	       "--disable, -d\n"
+	       "\tSuspend the recording of the process\n"
+	       "--folded, -f\n"
+	       "\tPrint the time of each stage per opcode in the folded "
+	       "format\n\tof flamegraph.pl rather than the latency summary\n"
+	       "--help, -h\n"
+	       "\tThis help text\n\n"
+	       "The process records its trace when it is started with %s set\n"
+	       "to the number of records of each ring, e.g. %s=65536\n",
+	       prog_name, D_TRACE_RING_ENV, D_TRACE_RING_ENV);
+}
+
+static int
+hdr_check(struct d_trace_hdr *hdr, uint64_t size)
+{
+	if (size < sizeof(*hdr) ||
+	    __atomic_load_n(&hdr->th_magic, __ATOMIC_ACQUIRE) !=
+	    D_TRACE_MAGIC) {
+		fprintf(stderr, "Not a trace ring\n");
+		return -1;
+	}
+	if (hdr->th_version != D_TRACE_VERSION) {
+		fprintf(stderr, "Unsupported trace ring version %u\n",
+			hdr->th_version);
+		return -1;
+	}
+	if (hdr->th_ring_size == 0 ||
+	    (hdr->th_ring_size & (hdr->th_ring_size - 1)) != 0) {
+		fprintf(stderr, "Invalid ring size %u\n", hdr->th_ring_size);
+		return -1;
+	}
+	if (size < sizeof(*hdr) +
+		   hdr->th_nr_rings * d_trace_ring_bytes(hdr->th_ring_size)) {
+		fprintf(stderr, "Truncated trace ring\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+shm_map(int pid, bool rdwr, struct d_trace_hdr **hdrp, uint64_t *sizep)
+{
+	struct d_trace_hdr	*hdr;
+	struct stat		 st;
+	char			 name[64];
+	int			 fd;
+
+	snprintf(name, sizeof(name), D_TRACE_SHM_FMT, pid);
+	fd = shm_open(name, rdwr ? O_RDWR : O_RDONLY, 0);
+	if (fd < 0) {
+		fprintf(stderr, "No trace ring for pid %d, is %s set? %s\n",
+			pid, D_TRACE_RING_ENV, strerror(errno));
+		return -1;
+	}
+
+	if (fstat(fd, &st) != 0) {
+		fprintf(stderr, "Failed to stat %s: %s\n", name,
+			strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	hdr = mmap(NULL, st.st_size, PROT_READ | (rdwr ? PROT_WRITE : 0),
+		   MAP_SHARED, fd, 0);
+	close(fd);
+	if (hdr == MAP_FAILED) {
+		fprintf(stderr, "Failed to map %s: %s\n", name,
+			strerror(errno));
+		return -1;
+	}
+
+	if (hdr_check(hdr, st.st_size) != 0) {
+		munmap(hdr, st.st_size);
+		return -1;
+	}
+
+	*hdrp = hdr;
+	*sizep = st.st_size;
+	return 0;
+}
+
+/*
+ * Copy the live segment. The writers keep going while a ring is copied, so the
+ * head is read before and after the copy: the records older than the second
+ * head minus the ring size may have been overwritten and are cleared, and the
+ * head of the copy is set to the first head.
+ */
+static void *
+shm_snapshot(struct d_trace_hdr *hdr, uint64_t size)
+{
+	struct d_trace_hdr	*copy;
+	struct d_trace_ring	*src;
+	struct d_trace_ring	*dst;
+	uint64_t		 nr = hdr->th_ring_size;
+	uint64_t		 h1;
+	uint64_t		 h2;
+	uint64_t		 seq;
+	uint32_t		 used;
+	uint32_t		 i;
+
+	copy = calloc(1, size);
+	if (copy == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return NULL;
+	}
+	*copy = *hdr;
+
+	used = __atomic_load_n(&hdr->th_rings_used, __ATOMIC_ACQUIRE);
+	if (used > hdr->th_nr_rings)
+		used = hdr->th_nr_rings;
+	copy->th_rings_used = used;
+
+	for (i = 0; i < used; i++) {
+		src = d_trace_ring_at(hdr, i);
+		dst = d_trace_ring_at(copy, i);
+
+		h1 = __atomic_load_n(&src->trr_head, __ATOMIC_ACQUIRE);
+		memcpy(dst->trr_recs, src->trr_recs,
+		       nr * sizeof(struct d_trace_rec));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		h2 = __atomic_load_n(&src->trr_head, __ATOMIC_RELAXED);
+
+		dst->trr_head = h1;
+		dst->trr_tid = src->trr_tid;
+		/* the record of sequence h2 may be half written as well */
+		seq = h1 > nr ? h1 - nr : 0;
+		for (; seq < h1 && seq + nr <= h2; seq++)
+			memset(&dst->trr_recs[seq & (nr - 1)], 0,
+			       sizeof(struct d_trace_rec));
+	}
+	return copy;
+}
+
+static void *
+file_load(const char *path, uint64_t *sizep)
+{
+	struct stat	 st;
+	void		*buf;
+	FILE		*fp;
+
+	fp = fopen(path, "r");
+	if (fp == NULL || fstat(fileno(fp), &st) != 0) {
+		fprintf(stderr, "Failed to open %s: %s\n", path,
+			strerror(errno));
+		if (fp != NULL)
+			fclose(fp);
+		return NULL;
+	}
+
+	buf = malloc(st.st_size);
+	if (buf == NULL || fread(buf, 1, st.st_size, fp) != st.st_size) {
+		fprintf(stderr, "Failed to read %s\n", path);
+		free(buf);
+		fclose(fp);
+		return NULL;
+	}
+	fclose(fp);
+
+	if (hdr_check(buf, st.st_size) != 0) {
+		free(buf);
+		return NULL;
+	}
+	*sizep = st.st_size;
+	return buf;
+}
+
+static int
+file_dump(const char *path, void *buf, uint64_t size)
+{
+	FILE	*fp;
+	int	 rc = 0;
+
+	fp = fopen(path, "w");
+	if (fp == NULL) {
+		fprintf(stderr, "Failed to create %s: %s\n", path,
+			strerror(errno));
+		return -1;
+	}
+	if (fwrite(buf, 1, size, fp) != size) {
+		fprintf(stderr, "Failed to write %s\n", path);
+		rc = -1;
+	}
+	if (fclose(fp) != 0)
+		rc = -1;
+	return rc;
+}
+
+static int
+event_cmp(const void *a, const void *b)
+{
+	const struct d_trace_rec *ra = &((const struct trace_event *)a)->te_rec;
+	const struct d_trace_rec *rb = &((const struct trace_event *)b)->te_rec;
+
+	if (ra->tr_stage != rb->tr_stage)
+		return ra->tr_stage < rb->tr_stage ? -1 : 1;
+	if (ra->tr_tag != rb->tr_tag)
+		return ra->tr_tag < rb->tr_tag ? -1 : 1;
+	if (ra->tr_time != rb->tr_time)
+		return ra->tr_time < rb->tr_time ? -1 : 1;
+	/* a begin and its end in the same nanosecond */
+	return (int)ra->tr_end - (int)rb->tr_end;
+}
+
+/*
+ * Gather the records of all rings and pair each begin with the next event of
+ * the same stage and tag if it is an end. Begins without end are still running
+ * or lost their end to a wrap of the ring, they are dropped.
+ */
+static struct trace_span *
+spans_build(struct d_trace_hdr *hdr, uint64_t *nr_spans)
+{
+	struct trace_event	*events;
+	struct trace_span	*spans;
+	struct d_trace_ring	*ring;
+	struct d_trace_rec	*rec;
+	uint64_t		 nr = hdr->th_ring_size;
+	uint64_t		 nr_events = 0;
+	uint64_t		 seq;
+	uint64_t		 i;
+	uint64_t		 j;
+	uint32_t		 r;
+
+	if (hdr->th_rings_used > hdr->th_nr_rings)
+		hdr->th_rings_used = hdr->th_nr_rings;
+
+	for (r = 0; r < hdr->th_rings_used; r++) {
+		ring = d_trace_ring_at(hdr, r);
+		nr_events += ring->trr_head < nr ? ring->trr_head : nr;
+	}
+
+	events = calloc(nr_events + 1, sizeof(*events));
+	spans = calloc(nr_events / 2 + 1, sizeof(*spans));
+	if (events == NULL || spans == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		free(events);
+		free(spans);
+		return NULL;
+	}
+
+	for (i = 0, r = 0; r < hdr->th_rings_used; r++) {
+		ring = d_trace_ring_at(hdr, r);
+		seq = ring->trr_head > nr ? ring->trr_head - nr : 0;
+		for (; seq < ring->trr_head; seq++) {
+			rec = &ring->trr_recs[seq & (nr - 1)];
+			if (rec->tr_time == 0 ||
+			    rec->tr_stage >= D_TRACE_STAGE_MAX)
+				continue;
+			events[i].te_rec = *rec;
+			events[i].te_ring = r;
+			i++;
+		}
+	}
+	nr_events = i;
+	qsort(events, nr_events, sizeof(*events), event_cmp);
+
+	for (i = 0, j = 0; i + 1 < nr_events; i++) {
+		struct d_trace_rec *b = &events[i].te_rec;
+		struct d_trace_rec *e = &events[i + 1].te_rec;
+
+		if (b->tr_end || !e->tr_end || b->tr_stage != e->tr_stage ||
+		    b->tr_tag != e->tr_tag)
+			continue;
+
+		spans[j].ts_start = b->tr_time;
+		spans[j].ts_end = e->tr_time;
+		spans[j].ts_tag = b->tr_tag;
+		spans[j].ts_ring = events[i].te_ring;
+		spans[j].ts_arg = b->tr_arg;
+		spans[j].ts_stage = b->tr_stage;
+		j++;
+		i++;
+	}
+
+	free(events);
+	*nr_spans = j;
+	return spans;
+}
+
+static int
+u64_cmp(const void *a, const void *b)
+{
+	uint64_t	x = *(const uint64_t *)a;
+	uint64_t	y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void
+latency_print(const char *name, uint64_t *lat, uint64_t nr)
+{
+	uint64_t	sum = 0;
+	uint64_t	i;
+
+	if (nr == 0)
+		return;
+
+	qsort(lat, nr, sizeof(*lat), u64_cmp);
+	for (i = 0; i < nr; i++)
+		sum += lat[i];
+
+	printf("%-24s %10"PRIu64" %12.1f %12.1f %12.1f %12.1f\n", name, nr,
+	       sum / 1e3 / nr, lat[nr / 2] / 1e3, lat[nr * 99 / 100] / 1e3,
+	       lat[nr - 1] / 1e3);
+}
+
+static int
+span_opc_cmp(const void *a, const void *b)
+{
+	const struct trace_span	*sa = a;
+	const struct trace_span	*sb = b;
+
+	if (sa->ts_arg != sb->ts_arg)
+		return sa->ts_arg < sb->ts_arg ? -1 : 1;
+	return 0;
+}
+
+static int
+summary_print(struct trace_span *spans, uint64_t nr_spans)
+{
+	struct trace_span	*rpcs;
+	uint64_t		*lat;
+	uint64_t		 nr_rpcs = 0;
+	uint64_t		 nr;
+	uint64_t		 i;
+	uint64_t		 j;
+	char			 name[32];
+	int			 s;
+
+	lat = calloc(nr_spans + 1, sizeof(*lat));
+	rpcs = calloc(nr_spans + 1, sizeof(*rpcs));
+	if (lat == NULL || rpcs == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		free(lat);
+		free(rpcs);
+		return -1;
+	}
+
+	printf("%-24s %10s %12s %12s %12s %12s\n", "stage", "count",
+	       "mean(us)", "p50(us)", "p99(us)", "max(us)");
+	for (s = 0; s < D_TRACE_STAGE_MAX; s++) {
+		for (i = 0, nr = 0; i < nr_spans; i++) {
+			if (spans[i].ts_stage != s)
+				continue;
+			lat[nr++] = spans[i].ts_end - spans[i].ts_start;
+			if (s == D_TRACE_RPC)
+				rpcs[nr_rpcs++] = spans[i];
+		}
+		latency_print(stage_names[s], lat, nr);
+	}
+
+	/* RPC latency per opcode */
+	qsort(rpcs, nr_rpcs, sizeof(*rpcs), span_opc_cmp);
+	for (i = 0; i < nr_rpcs; i = j) {
+		for (j = i, nr = 0; j < nr_rpcs &&
+		     rpcs[j].ts_arg == rpcs[i].ts_arg; j++)
+			lat[nr++] = rpcs[j].ts_end - rpcs[j].ts_start;
+		snprintf(name, sizeof(name), "  rpc opc %#x", rpcs[i].ts_arg);
+		latency_print(name, lat, nr);
+	}
+
+	free(rpcs);
+	free(lat);
+	return 0;
+}
+
+static int
+span_tag_cmp(const void *a, const void *b)
+{
+	const struct trace_span	*sa = *(const struct trace_span **)a;
+	const struct trace_span	*sb = *(const struct trace_span **)b;
+
+	if (sa->ts_tag != sb->ts_tag)
+		return sa->ts_tag < sb->ts_tag ? -1 : 1;
+	return sa->ts_start < sb->ts_start ? -1 : sa->ts_start > sb->ts_start;
+}
+
+static int
+span_ring_cmp(const void *a, const void *b)
+{
+	const struct trace_span	*sa = *(const struct trace_span **)a;
+	const struct trace_span	*sb = *(const struct trace_span **)b;
+
+	if (sa->ts_ring != sb->ts_ring)
+		return sa->ts_ring < sb->ts_ring ? -1 : 1;
+	return sa->ts_start < sb->ts_start ? -1 : sa->ts_start > sb->ts_start;
+}
+
+/*
+ * Find the RPC of a span: the RPC with the same tag for the stages tagged by
+ * the RPC, otherwise the latest RPC started on the same ring which contains
+ * the span. The handlers of several RPCs can be interleaved on one xstream, so
+ * the latter is a best guess.
+ */
+static struct trace_span *
+span_rpc_find(struct trace_span **index, uint64_t nr, struct trace_span *span,
+	      bool by_tag)
+{
+	struct trace_span	 key = *span;
+	struct trace_span	*kp = &key;
+	uint64_t		 lo = 0;
+	uint64_t		 hi = nr;
+	uint64_t		 mid;
+	int			 steps;
+
+	/* last RPC which sorts before or equal to the span */
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if ((by_tag ? span_tag_cmp : span_ring_cmp)(&index[mid],
+							    &kp) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (steps = 0; lo > 0 && steps < 64; lo--, steps++) {
+		struct trace_span *rpc = index[lo - 1];
+
+		if (by_tag ? rpc->ts_tag != span->ts_tag :
+			     rpc->ts_ring != span->ts_ring)
+			break;
+		if (rpc->ts_start <= span->ts_start &&
+		    rpc->ts_end >= span->ts_end)
+			return rpc;
+		if (by_tag)
+			break;
+	}
+	return NULL;
+}
+
+static struct trace_opc *
+opc_get(struct trace_opc **opcs, int *nr_opcs, uint32_t opc)
+{
+	struct trace_opc	*tmp;
+	int			 i;
+
+	for (i = 0; i < *nr_opcs; i++) {
+		if ((*opcs)[i].to_opc == opc)
+			return &(*opcs)[i];
+	}
+
+	tmp = realloc(*opcs, (*nr_opcs + 1) * sizeof(*tmp));
+	if (tmp == NULL)
+		return NULL;
+	*opcs = tmp;
+	memset(&tmp[*nr_opcs], 0, sizeof(*tmp));
+	tmp[*nr_opcs].to_opc = opc;
+	return &tmp[(*nr_opcs)++];
+}
+
+static int
+folded_print(struct trace_span *spans, uint64_t nr_spans)
+{
+	struct trace_span	**by_tag;
+	struct trace_span	**by_ring;
+	struct trace_span	 *rpc;
+	struct trace_opc	 *opcs = NULL;
+	struct trace_opc	 *to;
+	uint64_t		 *child_ns;
+	uint64_t		  nr_rpcs = 0;
+	uint64_t		  i;
+	int			  nr_opcs = 0;
+	int			  s;
+	int			  rc = -1;
+
+	by_tag = calloc(nr_spans + 1, sizeof(*by_tag));
+	by_ring = calloc(nr_spans + 1, sizeof(*by_ring));
+	child_ns = calloc(nr_spans + 1, sizeof(*child_ns));
+	if (by_tag == NULL || by_ring == NULL || child_ns == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		goto out;
+	}
+
+	for (i = 0; i < nr_spans; i++) {
+		if (spans[i].ts_stage != D_TRACE_RPC)
+			continue;
+		by_tag[nr_rpcs] = &spans[i];
+		by_ring[nr_rpcs] = &spans[i];
+		nr_rpcs++;
+	}
+	qsort(by_tag, nr_rpcs, sizeof(*by_tag), span_tag_cmp);
+	qsort(by_ring, nr_rpcs, sizeof(*by_ring), span_ring_cmp);
+
+	for (i = 0; i < nr_spans; i++) {
+		uint64_t	ns = spans[i].ts_end - spans[i].ts_start;
+
+		s = spans[i].ts_stage;
+		if (s == D_TRACE_RPC)
+			continue;
+
+		rpc = span_rpc_find(s == D_TRACE_SCHED || s == D_TRACE_BULK ?
+				    by_tag : by_ring, nr_rpcs, &spans[i],
+				    s == D_TRACE_SCHED || s == D_TRACE_BULK);
+		if (rpc == NULL)
+			continue;
+
+		to = opc_get(&opcs, &nr_opcs, rpc->ts_arg);
+		if (to == NULL)
+			goto oom;
+		to->to_ns[s] += ns;
+		child_ns[rpc - spans] += ns;
+	}
+
+	for (i = 0; i < nr_rpcs; i++) {
+		uint64_t	ns;
+
+		rpc = by_tag[i];
+		ns = rpc->ts_end - rpc->ts_start;
+		to = opc_get(&opcs, &nr_opcs, rpc->ts_arg);
+		if (to == NULL)
+			goto oom;
+		to->to_count++;
+		if (ns > child_ns[rpc - spans])
+			to->to_self_ns += ns - child_ns[rpc - spans];
+	}
+
+	/* one line per stack with its time in microseconds */
+	for (i = 0; i < nr_opcs; i++) {
+		to = &opcs[i];
+		printf("opc_%#x %"PRIu64"\n", to->to_opc, to->to_self_ns / 1000);
+		for (s = 0; s < D_TRACE_STAGE_MAX; s++) {
+			if (to->to_ns[s] == 0)
+				continue;
+			printf("opc_%#x;%s %"PRIu64"\n", to->to_opc,
+			       stage_names[s], to->to_ns[s] / 1000);
+		}
+	}
+	rc = 0;
+	goto out;
+oom:
+	fprintf(stderr, "Out of memory\n");
+out:
+	free(opcs);
+	free(child_ns);
+	free(by_ring);
+	free(by_tag);
+	return rc;
+}
+
+int
+main(int argc, char **argv)
+{
+	struct d_trace_hdr	*shm = NULL;
+	struct d_trace_hdr	*hdr = NULL;
+	struct trace_span	*spans;
+	uint64_t		 shm_size = 0;
+	uint64_t		 size = 0;
+	uint64_t		 nr_spans;
+	char			*input = NULL;
+	char			*output = NULL;
+	bool			 folded = false;
+	int			 enable = -1;
+	int			 pid = 0;
+	int			 opt;
+	int			 rc;
+
+	while (1) {
+		static struct option long_options[] = {
+			{"pid", required_argument, NULL, 'p'},
+			{"input", required_argument, NULL, 'i'},
+			{"output", required_argument, NULL, 'o'},
+			{"enable", no_argument, NULL, 'e'},
+			{"disable", no_argument, NULL, 'd'},
+			{"folded", no_argument, NULL, 'f'},
+			{"help", no_argument, NULL, 'h'},
+			{NULL, 0, NULL, 0}
+		};
+
+		opt = getopt_long_only(argc, argv, "p:i:o:edfh", long_options,
+				       NULL);
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'p':
+			pid = atoi(optarg);
+			break;
+		case 'i':
+			input = optarg;
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		case 'e':
+			enable = 1;
+			break;
+		case 'd':
+			enable = 0;
+			break;
+		case 'f':
+			folded = true;
+			break;
+		case 'h':
+		case '?':
+		default:
+			print_usage(argv[0]);
+			exit(opt == 'h' ? 0 : -1);
+		}
+	}
+
+	if ((pid <= 0) == (input == NULL) || (input != NULL && enable >= 0)) {
+		print_usage(argv[0]);
+		exit(-1);
+	}
+
+	if (pid > 0) {
+		rc = shm_map(pid, enable >= 0, &shm, &shm_size);
+		if (rc != 0)
+			exit(-1);
+
+		if (enable >= 0) {
+			__atomic_store_n(&shm->th_enabled, enable,
+					 __ATOMIC_RELAXED);
+			printf("Trace ring of pid %d %s\n", pid,
+			       enable ? "enabled" : "disabled");
+			munmap(shm, shm_size);
+			exit(0);
+		}
+
+		size = shm_size;
+		hdr = shm_snapshot(shm, shm_size);
+		munmap(shm, shm_size);
+	} else {
+		hdr = file_load(input, &size);
+	}
+	if (hdr == NULL)
+		exit(-1);
+
+	if (output != NULL) {
+		rc = file_dump(output, hdr, size);
+		free(hdr);
+		exit(rc == 0 ? 0 : -1);
+	}
+
+	spans = spans_build(hdr, &nr_spans);
+	if (spans == NULL) {
+		free(hdr);
+		exit(-1);
+	}
+
+	if (folded)
+		rc = folded_print(spans, nr_spans);
+	else
+		rc = summary_print(spans, nr_spans);
+
+	free(spans);
+	free(hdr);
+	return rc == 0 ? 0 : -1;
+}
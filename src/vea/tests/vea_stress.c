@@ -0,0 +1,301 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Fragmentation stress benchmark of VEA, it fragments the free space with
+ * randomly sized reservations, then reports the latency distribution of
+ * small extent reservations with the size classed LRU scan and with the LRU
+ * bitmap summary.
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <getopt.h>
+#include <daos/common.h>
+#include <daos/btree_class.h>
+#include <daos_srv/vea.h>
+#include "../vea_internal.h"
+
+static uint64_t	vs_capacity = 32ULL << 30;	/* 32GB */
+static int	vs_ops = 100000;
+static int	vs_batch = 1000;
+static int	vs_max_blks = 256;		/* 1MB */
+static unsigned	vs_seed;
+
+struct vs_args {
+	struct umem_instance		 va_umm;
+	struct umem_tx_stage_data	 va_txd;
+	struct vea_space_df		*va_md;
+	struct vea_space_info		*va_vsi;
+	/* Reservations kept to hold the fragments */
+	d_list_t			 va_hold_list;
+};
+
+static int
+vs_u64_cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void
+vs_print_stat(struct vs_args *args, const char *title)
+{
+	struct vea_stat	stat;
+	int		rc;
+
+	rc = vea_query(args->va_vsi, NULL, &stat);
+	if (rc != 0)
+		return;
+
+	printf("%s: free_blks:"DF_U64", large_frags:"DF_U64", small_frags:"
+	       DF_U64", largest_blks:%u\n", title, stat.vs_free_transient,
+	       stat.vs_large_frags, stat.vs_small_frags,
+	       stat.vs_largest_blks);
+}
+
+/* Verify the LRU bitmap summary matches the size classed LRUs */
+static int
+vs_verify_bmap(struct vea_free_class *vfc)
+{
+	int i;
+
+	for (i = 0; i < vfc->vfc_lru_cnt; i++) {
+		bool set = vfc->vfc_lru_bmap & (1ULL << i);
+
+		if (set == d_list_empty(&vfc->vfc_lrus[i])) {
+			fprintf(stderr, "Size class %d bitmap %d mismatched\n",
+				i, set);
+			return -DER_INVAL;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Fill the device with randomly sized reservations, then cancel about half of
+ * them to leave small free fragments all over the device. The large free
+ * extents merged from adjacent fragments are held as well, so that all the
+ * following reservations have to be served from the small free extents.
+ */
+static int
+vs_fragment(struct vs_args *args)
+{
+	struct vea_free_class	*vfc = &args->va_vsi->vsi_class;
+	struct vea_resrvd_ext	*ext, *tmp;
+	struct vea_entry	*entry;
+	d_list_t		 cancel_list;
+	uint32_t		 blk_cnt;
+	int			 rc = 0;
+
+	while (rc == 0) {
+		blk_cnt = rand() % (vs_max_blks * 4) + 1;
+		rc = vea_reserve(args->va_vsi, blk_cnt, NULL,
+				 &args->va_hold_list);
+	}
+	if (rc != -DER_NOSPACE)
+		return rc;
+
+	D_INIT_LIST_HEAD(&cancel_list);
+	d_list_for_each_entry_safe(ext, tmp, &args->va_hold_list, vre_link) {
+		if (rand() % 2 == 0)
+			d_list_move_tail(&ext->vre_link, &cancel_list);
+	}
+
+	rc = vea_cancel(args->va_vsi, NULL, &cancel_list);
+	while (rc == 0 && !d_binheap_is_empty(&vfc->vfc_heap)) {
+		entry = container_of(d_binheap_root(&vfc->vfc_heap),
+				     struct vea_entry, ve_node);
+		rc = vea_reserve(args->va_vsi, entry->ve_ext.vfe_blk_cnt, NULL,
+				 &args->va_hold_list);
+	}
+
+	return rc;
+}
+
+static int
+vs_run(struct vs_args *args, const char *name, bool bmap)
+{
+	struct vea_free_class	*vfc = &args->va_vsi->vsi_class;
+	d_list_t		 resrvd_list;
+	uint64_t		*lats, then;
+	uint32_t		 blk_cnt;
+	int			 i, nr = 0, rc = 0;
+
+	D_ALLOC_ARRAY(lats, vs_ops);
+	if (lats == NULL)
+		return -DER_NOMEM;
+
+	D_INIT_LIST_HEAD(&resrvd_list);
+	vfc->vfc_bmap_resrv = bmap;
+	srand(vs_seed + 1);
+
+	for (i = 0; i < vs_ops; i++) {
+		blk_cnt = rand() % vs_max_blks + 1;
+
+		then = daos_get_ntime();
+		rc = vea_reserve(args->va_vsi, blk_cnt, NULL, &resrvd_list);
+		lats[nr] = daos_get_ntime() - then;
+		if (rc == 0)
+			nr++;
+		else if (rc != -DER_NOSPACE)
+			break;
+
+		/* Cancel in batch to keep the fragmentation steady */
+		if (rc == -DER_NOSPACE || (i + 1) % vs_batch == 0) {
+			rc = vea_cancel(args->va_vsi, NULL, &resrvd_list);
+			if (rc != 0)
+				break;
+		}
+	}
+
+	if (rc == 0)
+		rc = vea_cancel(args->va_vsi, NULL, &resrvd_list);
+	if (rc == 0)
+		rc = vs_verify_bmap(vfc);
+	if (rc != 0 || nr == 0) {
+		fprintf(stderr, "%s reserve failed: %d\n", name, rc);
+		goto out;
+	}
+
+	qsort(lats, nr, sizeof(*lats), vs_u64_cmp);
+	printf("%-6s reserves:%d p50:"DF_U64" p90:"DF_U64" p99:"DF_U64
+	       " p99.9:"DF_U64" max:"DF_U64" (ns)\n", name, nr,
+	       lats[nr / 2], lats[nr * 90 / 100], lats[nr * 99 / 100],
+	       lats[nr * 999 / 1000], lats[nr - 1]);
+out:
+	D_FREE(lats);
+	return rc;
+}
+
+static void
+print_usage(const char *prog)
+{
+	printf("Usage: %s [OPTIONS]\n"
+	       "  -c, --capacity <GB>  Device capacity (default "DF_U64")\n"
+	       "  -n, --ops <n>        Number of reserves (default %d)\n"
+	       "  -b, --batch <n>      Reserves per cancel (default %d)\n"
+	       "  -m, --max <blks>     Max reserve size (default %d)\n"
+	       "  -s, --seed <n>       Random seed (default time)\n",
+	       prog, vs_capacity >> 30, vs_ops, vs_batch, vs_max_blks);
+}
+
+int
+main(int argc, char **argv)
+{
+	static struct option	long_ops[] = {
+		{ "capacity",	required_argument,	NULL,	'c' },
+		{ "ops",	required_argument,	NULL,	'n' },
+		{ "batch",	required_argument,	NULL,	'b' },
+		{ "max",	required_argument,	NULL,	'm' },
+		{ "seed",	required_argument,	NULL,	's' },
+		{ "help",	no_argument,		NULL,	'h' },
+		{ NULL,		0,			NULL,	0   },
+	};
+	struct vs_args		 args = { 0 };
+	struct vea_unmap_context unmap_ctxt = { 0 };
+	struct vea_resrvd_ext	*ext, *tmp;
+	struct umem_attr	 uma = { 0 };
+	int			 opt;
+	int			 rc;
+
+	vs_seed = time(NULL);
+	while ((opt = getopt_long(argc, argv, "c:n:b:m:s:h", long_ops,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'c':
+			vs_capacity = strtoull(optarg, NULL, 0) << 30;
+			break;
+		case 'n':
+			vs_ops = atoi(optarg);
+			break;
+		case 'b':
+			vs_batch = atoi(optarg);
+			break;
+		case 'm':
+			vs_max_blks = atoi(optarg);
+			break;
+		case 's':
+			vs_seed = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (vs_capacity == 0 || vs_ops <= 0 || vs_batch <= 0 ||
+	    vs_max_blks <= 0) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	rc = dbtree_class_register(DBTREE_CLASS_IV,
+				   BTR_FEAT_UINT_KEY | BTR_FEAT_DIRECT_KEY,
+				   &dbtree_iv_ops);
+	if (rc != 0 && rc != -DER_EXIST)
+		goto out;
+
+	/* Allocation metadata is kept in DRAM, no SCM is required */
+	uma.uma_id = UMEM_CLASS_VMEM;
+	rc = umem_class_init(&uma, &args.va_umm);
+	if (rc != 0)
+		goto out;
+	umem_init_txd(&args.va_txd);
+	D_INIT_LIST_HEAD(&args.va_hold_list);
+
+	D_ALLOC_PTR(args.va_md);
+	if (args.va_md == NULL) {
+		rc = -DER_NOMEM;
+		goto out_txd;
+	}
+
+	rc = vea_format(&args.va_umm, &args.va_txd, args.va_md, 0, 1,
+			vs_capacity, NULL, NULL, false);
+	if (rc != 0)
+		goto out_md;
+
+	rc = vea_load(&args.va_umm, &args.va_txd, args.va_md, &unmap_ctxt,
+		      &args.va_vsi);
+	if (rc != 0)
+		goto out_md;
+
+	printf("VEA fragmentation stress, capacity="DF_U64"GB, ops=%d, "
+	       "batch=%d, max_blks=%d, seed=%u\n", vs_capacity >> 30, vs_ops,
+	       vs_batch, vs_max_blks, vs_seed);
+
+	srand(vs_seed);
+	rc = vs_fragment(&args);
+	if (rc != 0) {
+		fprintf(stderr, "Fragment device failed: %d\n", rc);
+		goto out_unload;
+	}
+	vs_print_stat(&args, "fragmented");
+
+	rc = vs_run(&args, "scan", false);
+	if (rc == 0)
+		rc = vs_run(&args, "bitmap", true);
+	vs_print_stat(&args, "finished");
+
+out_unload:
+	d_list_for_each_entry_safe(ext, tmp, &args.va_hold_list, vre_link) {
+		d_list_del(&ext->vre_link);
+		D_FREE(ext);
+	}
+	vea_unload(args.va_vsi);
+out_md:
+	D_FREE(args.va_md);
+out_txd:
+	umem_fini_txd(&args.va_txd);
+out:
+	daos_debug_fini();
+	return rc;
+}
@@ -881,8 +881,8 @@ ut_inval_params_hint_load(void **state)
 	print_message("Testing invalid parameters to vea_hint_load\n");
 	ut_setup(&args);
 
-	expect_assert_failure(vea_hint_load(NULL, &args.vua_hint_ctxt[0]));
 	expect_assert_failure(vea_hint_load(args.vua_hint[0], NULL));
+	expect_assert_failure(vea_hint_load(NULL, NULL));
 
 	ut_teardown(&args);
 }
@@ -1254,6 +1254,85 @@ ut_fragmentation(void **state)
 	ut_teardown(&args);
 }
 
+static void
+ut_transient_hint(void **state)
+{
+	struct vea_ut_args args;
+	struct vea_unmap_context unmap_ctxt;
+	struct vea_hint_context *h_ctxt[2];
+	struct vea_resrvd_ext *ext;
+	d_list_t *r_list;
+	uint32_t block_size = 0; /* use the default size */
+	uint32_t header_blocks = 1;
+	uint32_t block_count = 16;
+	uint64_t capacity = ((VEA_LARGE_EXT_MB * 2) << 20); /* 128 MB */
+	uint64_t blk_off[2];
+	int rc, i, j;
+
+	print_message("Test interleaved reserves from transient I/O streams\n");
+	ut_setup(&args);
+	rc = vea_format(&args.vua_umm, &args.vua_txd, args.vua_md, block_size,
+			header_blocks, capacity, NULL, NULL, false);
+	assert_int_equal(rc, 0);
+
+	unmap_ctxt.vnc_unmap = NULL;
+	unmap_ctxt.vnc_data = NULL;
+	rc = vea_load(&args.vua_umm, &args.vua_txd, args.vua_md, &unmap_ctxt,
+		      &args.vua_vsi);
+	assert_int_equal(rc, 0);
+
+	for (i = 0; i < 2; i++) {
+		rc = vea_hint_load(NULL, &h_ctxt[i]);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(h_ctxt[i]->vhc_off, VEA_HINT_OFF_INVAL);
+	}
+
+	/* Interleave the reserves from the two I/O streams */
+	for (j = 0; j < 8; j++) {
+		for (i = 0; i < 2; i++) {
+			r_list = &args.vua_resrvd_list[i];
+			rc = vea_reserve(args.vua_vsi, block_count, h_ctxt[i],
+					 r_list);
+			assert_rc_equal(rc, 0);
+		}
+	}
+
+	/* Each I/O stream should get contiguous extents */
+	for (i = 0; i < 2; i++) {
+		r_list = &args.vua_resrvd_list[i];
+		ext = d_list_entry(r_list->next, struct vea_resrvd_ext,
+				   vre_link);
+		blk_off[i] = ext->vre_blk_off;
+
+		d_list_for_each_entry(ext, r_list, vre_link) {
+			assert_int_equal(ext->vre_blk_off, blk_off[i]);
+			blk_off[i] += ext->vre_blk_cnt;
+		}
+		assert_int_equal(h_ctxt[i]->vhc_off, blk_off[i]);
+	}
+
+	/* Transient hint isn't persisted on publish */
+	rc = umem_tx_begin(&args.vua_umm, &args.vua_txd);
+	assert_int_equal(rc, 0);
+
+	for (i = 0; i < 2; i++) {
+		r_list = &args.vua_resrvd_list[i];
+		rc = vea_tx_publish(args.vua_vsi, h_ctxt[i], r_list);
+		assert_int_equal(rc, 0);
+	}
+
+	rc = umem_tx_commit(&args.vua_umm);
+	assert_int_equal(rc, 0);
+
+	for (i = 0; i < 2; i++) {
+		assert_int_equal(h_ctxt[i]->vhc_pd->vhd_off, blk_off[i]);
+		vea_hint_unload(h_ctxt[i]);
+	}
+
+	vea_unload(args.vua_vsi);
+	ut_teardown(&args);
+}
+
 static const struct CMUnitTest vea_uts[] = {
 	{ "vea_format", ut_format, NULL, NULL},
 	{ "vea_load", ut_load, NULL, NULL},
@@ -1279,6 +1358,7 @@ static const struct CMUnitTest vea_uts[] = {
 	  NULL, NULL},
 	{ "vea_free_invalid_space", ut_free_invalid_space, NULL, NULL},
 	{ "vea_interleaved_ops", ut_interleaved_ops, NULL, NULL},
+	{ "vea_transient_hint", ut_transient_hint, NULL, NULL},
 	{ "vea_fragmentation", ut_fragmentation, NULL, NULL}
 };
 
@@ -280,6 +280,50 @@ cursor_next(struct vea_free_class *vfc, struct free_ext_cursor *cursor)
 	return cursor->fec_cur;
 }
 
+/*
+ * Find a free extent for @blk_cnt through the LRU bitmap summary, it picks
+ * the oldest extent from the smallest size class which can satisfy the
+ * request, so the cost is bounded by the number of size classes no matter
+ * how many small free extents there are.
+ */
+static struct vea_entry *
+bmap_find(struct vea_free_class *vfc, uint32_t blk_cnt)
+{
+	struct vea_entry *entry;
+	uint64_t avail;
+	int idx;
+
+	/*
+	 * Locate the size class containing @blk_cnt, all the extents in
+	 * the size classes before it are larger than @blk_cnt.
+	 */
+	for (idx = vfc->vfc_lru_cnt - 1; idx > 0; idx--) {
+		if (blk_cnt <= vfc->vfc_sizes[idx])
+			break;
+	}
+
+	/* Try the oldest extent in the containing size class first */
+	if (vfc->vfc_lru_bmap & (1ULL << idx)) {
+		entry = d_list_entry(vfc->vfc_lrus[idx].next, struct vea_entry,
+				     ve_link);
+		if (entry->ve_ext.vfe_blk_cnt >= blk_cnt)
+			return entry;
+	}
+
+	avail = vfc->vfc_lru_bmap & ((1ULL << idx) - 1);
+	if (avail == 0)
+		return NULL;
+
+	/* Highest set bit is the smallest size class */
+	idx = 63 - __builtin_clzll(avail);
+	D_ASSERT(!d_list_empty(&vfc->vfc_lrus[idx]));
+	entry = d_list_entry(vfc->vfc_lrus[idx].next, struct vea_entry,
+			     ve_link);
+	D_ASSERT(entry->ve_ext.vfe_blk_cnt >= blk_cnt);
+
+	return entry;
+}
+
 int
 reserve_small(struct vea_space_info *vsi, uint32_t blk_cnt,
 	      struct vea_resrvd_ext *resrvd)
@@ -293,6 +337,29 @@ reserve_small(struct vea_space_info *vsi, uint32_t blk_cnt,
 	if (blk_cnt > vsi->vsi_class.vfc_large_thresh)
 		return 0;
 
+	if (vsi->vsi_class.vfc_bmap_resrv) {
+		entry = bmap_find(&vsi->vsi_class, blk_cnt);
+		if (entry == NULL)
+			goto scan;
+
+		vfe.vfe_blk_off = entry->ve_ext.vfe_blk_off;
+		vfe.vfe_blk_cnt = blk_cnt;
+
+		rc = compound_alloc(vsi, &vfe, entry);
+		if (rc)
+			return rc;
+
+		resrvd->vre_blk_off = vfe.vfe_blk_off;
+		resrvd->vre_blk_cnt = blk_cnt;
+
+		vsi->vsi_stat[STAT_RESRV_SMALL] += 1;
+		vsi->vsi_stat[STAT_RESRV_BMAP] += 1;
+
+		D_DEBUG(DB_IO, "["DF_U64", %u]\n", resrvd->vre_blk_off,
+			resrvd->vre_blk_cnt);
+		return 0;
+	}
+scan:
 	cursor = cursor_prepare(&vsi->vsi_class, blk_cnt);
 	D_ASSERT(cursor != NULL);
 
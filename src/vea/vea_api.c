@@ -590,11 +590,13 @@ vea_get_ext_vector(struct vea_space_info *vsi, uint64_t blk_off,
 	return 0;
 }
 
-/* Load persistent hint data and initialize in-memory hint context */
+/*
+ * Load persistent hint data and initialize in-memory hint context, the hint
+ * data is kept in the context itself for transient I/O stream (@phd is NULL).
+ */
 int
 vea_hint_load(struct vea_hint_df *phd, struct vea_hint_context **thc)
 {
-	D_ASSERT(phd != NULL);
 	D_ASSERT(thc != NULL);
 	struct vea_hint_context *hint_ctxt;
 
@@ -602,6 +604,9 @@ vea_hint_load(struct vea_hint_df *phd, struct vea_hint_context **thc)
 	if (hint_ctxt == NULL)
 		return -DER_NOMEM;
 
+	if (phd == NULL)
+		phd = &hint_ctxt->vhc_df;
+
 	hint_ctxt->vhc_pd = phd;
 	hint_ctxt->vhc_off = phd->vhd_off;
 	hint_ctxt->vhc_seq = phd->vhd_seq;
@@ -723,6 +728,7 @@ vea_query(struct vea_space_info *vsi, struct vea_attr *attr,
 		stat->vs_resrv_hint = vsi->vsi_stat[STAT_RESRV_HINT];
 		stat->vs_resrv_large = vsi->vsi_stat[STAT_RESRV_LARGE];
 		stat->vs_resrv_small = vsi->vsi_stat[STAT_RESRV_SMALL];
+		stat->vs_resrv_bmap = vsi->vsi_stat[STAT_RESRV_BMAP];
 		stat->vs_resrv_vec = vsi->vsi_stat[STAT_RESRV_VEC];
 	}
 
@@ -742,3 +748,16 @@ vea_flush(struct vea_space_info *vsi, bool plug)
 	vsi->vsi_agg_time = 0;
 	migrate_free_exts(vsi, false);
 }
+
+void
+vea_compact(struct vea_space_info *vsi)
+{
+	D_ASSERT(vsi != NULL);
+
+	/* Migration is already scheduled in transaction end callback */
+	if (vsi->vsi_agg_scheduled || d_list_empty(&vsi->vsi_agg_lru))
+		return;
+
+	/* The aging time is checked by migrate_end_cb() */
+	migrate_free_exts(vsi, false);
+}
@@ -41,6 +41,14 @@ free_class_remove(struct vea_free_class *vfc, struct vea_entry *entry)
 			  vfc->vfc_large_thresh);
 		d_binheap_remove(&vfc->vfc_heap, &entry->ve_node);
 		entry->ve_in_heap = 0;
+	} else if (!d_list_empty(&entry->ve_link) &&
+		   entry->ve_link.next == entry->ve_link.prev) {
+		/* The only entry in the LRU, clear the bitmap summary */
+		d_list_t *lru_head = entry->ve_link.next;
+		int idx = lru_head - vfc->vfc_lrus;
+
+		D_ASSERT(idx >= 0 && idx < vfc->vfc_lru_cnt);
+		vfc->vfc_lru_bmap &= ~(1ULL << idx);
 	}
 	d_list_del_init(&entry->ve_link);
 }
@@ -79,6 +87,8 @@ free_class_add(struct vea_free_class *vfc, struct vea_entry *entry)
 		}
 		if (d_list_empty(&entry->ve_link))
 			d_list_add(&entry->ve_link, lru_head);
+
+		vfc->vfc_lru_bmap |= 1ULL << (lru_head - vfc->vfc_lrus);
 	}
 
 	return 0;
@@ -84,9 +84,13 @@ hint_tx_publish(struct umem_instance *umm, struct vea_hint_context *hint,
 		/* Subsequent reserve is already published */
 		return 0;
 	} else if (hint->vhc_pd->vhd_seq < seq_min) {
-		rc = umem_tx_add_ptr(umm, hint->vhc_pd, sizeof(*hint->vhc_pd));
-		if (rc != 0)
-			return rc;
+		/* Transient hint data is in DRAM, no need to be logged */
+		if (!hint_is_transient(hint)) {
+			rc = umem_tx_add_ptr(umm, hint->vhc_pd,
+					     sizeof(*hint->vhc_pd));
+			if (rc != 0)
+				return rc;
+		}
 
 		hint->vhc_pd->vhd_off = off;
 		hint->vhc_pd->vhd_seq = seq_max;
@@ -95,7 +95,12 @@ create_free_class(struct vea_free_class *vfc, struct vea_space_df *md)
 		max_blks >>= 1;
 	}
 	D_ASSERT(vfc->vfc_lru_cnt == 0);
+	D_ASSERT(lru_cnt <= 64);
 	vfc->vfc_lru_cnt = lru_cnt;
+	vfc->vfc_lru_bmap = 0;
+
+	vfc->vfc_bmap_resrv = true;
+	d_getenv_bool("DAOS_VEA_BMAP_RESRV", &vfc->vfc_bmap_resrv);
 
 	D_ASSERT(vfc->vfc_cursor == NULL);
 	size = lru_cnt * sizeof(struct vea_entry *);
@@ -17,7 +17,10 @@
 
 /* Per I/O stream hint context */
 struct vea_hint_context {
+	/* Persistent hint data, points to vhc_df for transient I/O stream */
 	struct vea_hint_df	*vhc_pd;
+	/* Hint data of transient I/O stream, which isn't persisted */
+	struct vea_hint_df	 vhc_df;
 	/* In-memory hint block offset */
 	uint64_t		 vhc_off;
 	/* In-memory hint sequence */
@@ -70,17 +73,25 @@ struct vea_free_class {
 	 * vfc_sizes[i + 1] < blk_cnt <= vfc_sizes[i].
 	 */
 	uint32_t		*vfc_sizes;
+	/*
+	 * Bitmap summary of the size classed LRUs, bit i is set when
+	 * vfc_lrus[i] isn't empty.
+	 */
+	uint64_t		 vfc_lru_bmap;
 	/*
 	 * Cursor used to scan the size classed LRUs when trying to reserve
 	 * from small extents.
 	 */
 	struct free_ext_cursor	*vfc_cursor;
+	/* Reserve small extents through the LRU bitmap summary */
+	bool			 vfc_bmap_resrv;
 };
 
 enum {
 	STAT_RESRV_HINT	= 0,
 	STAT_RESRV_LARGE,
 	STAT_RESRV_SMALL,
+	STAT_RESRV_BMAP,
 	STAT_RESRV_VEC,
 	STAT_FREE_BLKS,
 	STAT_MAX,
@@ -130,6 +141,11 @@ static inline bool ext_is_idle(struct vea_free_extent *vfe)
 	return vfe->vfe_age == VEA_EXT_AGE_MAX;
 }
 
+static inline bool hint_is_transient(struct vea_hint_context *hint)
+{
+	return hint->vhc_pd == &hint->vhc_df;
+}
+
 enum vea_free_flags {
 	VEA_FL_NO_MERGE		= (1 << 0),
 	VEA_FL_NO_ACCOUNTING	= (1 << 1),
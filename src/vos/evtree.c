@@ -284,33 +284,125 @@ evt_ent_array_init_(struct evt_entry_array *ent_array, int embedded, int max)
 	ent_array->ea_max = max;
 }
 
+/** When we go over the embedded limit, set a minimum allocation */
+#define EVT_MIN_ALLOC		4096
+/** Largest entry array buffer kept by the xstream for reuse */
+#define EVT_CACHED_ALLOC_MAX	(EVT_MIN_ALLOC * 4)
+/** Largest sort scratch buffer kept by the xstream for reuse */
+#define EVT_SCRATCH_MAX		(1UL << 22)
+
+/**
+ * Get a buffer for \a size entries, the buffer released by the last
+ * evt_ent_array_fini() on this xstream is reused if it is large enough.
+ * \a size returns the real number of entries of the buffer.
+ */
+static struct evt_list_entry *
+evt_ents_get(uint32_t *size)
+{
+	struct vos_tls		*tls = vos_tls_get();
+	struct evt_list_entry	*ents;
+
+	if (tls != NULL && tls->vtl_evt_ents != NULL &&
+	    tls->vtl_evt_ents_nr >= *size) {
+		ents = tls->vtl_evt_ents;
+		*size = tls->vtl_evt_ents_nr;
+		tls->vtl_evt_ents = NULL;
+		tls->vtl_evt_ents_nr = 0;
+		return ents;
+	}
+
+	D_ALLOC_ARRAY_NZ(ents, *size);
+	return ents;
+}
+
+/** Keep the larger one of \a ents and the cached buffer for reuse */
+static void
+evt_ents_put(struct evt_list_entry *ents, uint32_t size)
+{
+	struct vos_tls	*tls = vos_tls_get();
+
+	if (tls == NULL || size > EVT_CACHED_ALLOC_MAX ||
+	    size <= tls->vtl_evt_ents_nr) {
+		D_FREE(ents);
+		return;
+	}
+
+	D_FREE(tls->vtl_evt_ents);
+	tls->vtl_evt_ents = ents;
+	tls->vtl_evt_ents_nr = size;
+}
+
+/**
+ * Get the per-xstream scratch buffer of at least \a size bytes. The buffer is
+ * only valid until evt_scratch_put(), caller must not yield in between.
+ */
+static void *
+evt_scratch_get(size_t size)
+{
+	struct vos_tls	*tls = vos_tls_get();
+	void		*buf;
+
+	if (tls == NULL) {
+		D_ALLOC_NZ(buf, size);
+		return buf;
+	}
+
+	if (tls->vtl_evt_scratch_size < size) {
+		D_FREE(tls->vtl_evt_scratch);
+		tls->vtl_evt_scratch_size = 0;
+
+		/* round up to avoid reallocating for slowly growing arrays */
+		size = 1UL << daos_power2_nbits(size);
+		D_ALLOC_NZ(tls->vtl_evt_scratch, size);
+		if (tls->vtl_evt_scratch == NULL)
+			return NULL;
+		tls->vtl_evt_scratch_size = size;
+	}
+
+	return tls->vtl_evt_scratch;
+}
+
+static void
+evt_scratch_put(void *buf)
+{
+	struct vos_tls	*tls = vos_tls_get();
+
+	if (tls == NULL) {
+		D_FREE(buf);
+		return;
+	}
+
+	D_ASSERT(buf == tls->vtl_evt_scratch);
+	if (tls->vtl_evt_scratch_size > EVT_SCRATCH_MAX) {
+		D_FREE(tls->vtl_evt_scratch);
+		tls->vtl_evt_scratch_size = 0;
+	}
+}
+
 /** Finalize an entry list */
 void
 evt_ent_array_fini_(struct evt_entry_array *ent_array, int embedded)
 {
 	if (ent_array->ea_size > embedded)
-		D_FREE(ent_array->ea_ents);
+		evt_ents_put(ent_array->ea_ents, ent_array->ea_size);
 
 	ent_array->ea_size = ent_array->ea_ent_nr = 0;
 }
 
-/** When we go over the embedded limit, set a minimum allocation */
-#define EVT_MIN_ALLOC 4096
-
 static bool
 ent_array_resize(struct evt_context *tcx, struct evt_entry_array *ent_array,
 		 uint32_t new_size)
 {
 	struct evt_list_entry	*ents;
 
-	D_ALLOC_ARRAY(ents, new_size);
+	ents = evt_ents_get(&new_size);
 	if (ents == NULL)
 		return -DER_NOMEM;
 
 	memcpy(ents, ent_array->ea_ents,
 	       sizeof(ents[0]) * ent_array->ea_ent_nr);
 	if (ent_array->ea_ents != ent_array->ea_embedded_ents)
-		D_FREE(ent_array->ea_ents);
+		evt_ents_put(ent_array->ea_ents, ent_array->ea_size);
 	ent_array->ea_ents = ents;
 	ent_array->ea_size = new_size;
 
@@ -439,15 +531,6 @@ evt_rect_cmp(const struct evt_rect *rt1, const struct evt_rect *rt2)
 	 evt_flags_get(flags) == EVT_REMOVE ||	\
 	 evt_flags_get(flags) == EVT_COVERED)
 
-/* Mask for prioritizing visible entries */
-static const int vis_cmp_mask[] = {
-	0,
-	0, /* EVT_VISIBLE */
-	1, /* EVT_COVERED */
-	0,
-	1, /* EVT_REMOVE */
-};
-
 static inline int
 evt_ent_cmp(const struct evt_entry *ent1, const struct evt_entry *ent2,
 	    const int mask[])
@@ -487,15 +570,6 @@ evt_ent_list_cmp(const void *p1, const void *p2)
 	return evt_ent_cmp(&le1->le_ent, &le2->le_ent, NULL);
 }
 
-static int
-evt_ent_list_cmp_visible(const void *p1, const void *p2)
-{
-	const struct evt_list_entry	*le1	= p1;
-	const struct evt_list_entry	*le2	= p2;
-
-	return evt_ent_cmp(&le1->le_ent, &le2->le_ent, vis_cmp_mask);
-}
-
 static inline struct evt_list_entry *
 evt_array_link2le(d_list_t *link)
 {
@@ -541,17 +615,76 @@ set_visibility(struct evt_entry *ent, uint32_t flags)
 	ent->en_visibility |= flags;
 }
 
+/**
+ * Binary min-heap of entries in evt_ent_cmp() order. It holds the entries
+ * which have not been processed by the visibility sweep.
+ */
+struct evt_ent_heap {
+	struct evt_entry	**eh_ents;
+	uint32_t		  eh_nr;
+};
+
+static inline bool
+evt_ent_heap_less(struct evt_entry *ent1, struct evt_entry *ent2)
+{
+	return evt_ent_cmp(ent1, ent2, NULL) < 0;
+}
+
+static void
+evt_ent_heap_push(struct evt_ent_heap *heap, struct evt_entry *ent)
+{
+	struct evt_entry	**ents = heap->eh_ents;
+	uint32_t		  at = heap->eh_nr++;
+	uint32_t		  parent;
+
+	while (at > 0) {
+		parent = (at - 1) / 2;
+		if (!evt_ent_heap_less(ent, ents[parent]))
+			break;
+		ents[at] = ents[parent];
+		at = parent;
+	}
+	ents[at] = ent;
+}
+
 static struct evt_entry *
-evt_find_next_visible(struct evt_entry *this_ent, d_list_t *head,
-		      d_list_t **next)
+evt_ent_heap_pop(struct evt_ent_heap *heap)
+{
+	struct evt_entry	**ents = heap->eh_ents;
+	struct evt_entry	 *top = ents[0];
+	struct evt_entry	 *last;
+	uint32_t		  at = 0;
+	uint32_t		  child;
+
+	D_ASSERT(heap->eh_nr > 0);
+	last = ents[--heap->eh_nr];
+	while ((child = at * 2 + 1) < heap->eh_nr) {
+		if (child + 1 < heap->eh_nr &&
+		    evt_ent_heap_less(ents[child + 1], ents[child]))
+			child++;
+		if (!evt_ent_heap_less(ents[child], last))
+			break;
+		ents[at] = ents[child];
+		at = child;
+	}
+	ents[at] = last;
+
+	return top;
+}
+
+/**
+ * Return the first pending entry which is not covered by \a this_ent, the
+ * entry is left in the heap. Covered entries are marked and dropped.
+ */
+static struct evt_entry *
+evt_find_next_visible(struct evt_entry *this_ent, struct evt_ent_heap *heap)
 {
-	d_list_t		*temp;
 	struct evt_extent	*this_ext;
 	struct evt_extent	*next_ext;
 	struct evt_entry	*next_ent;
 
-	while (*next != head) {
-		next_ent = evt_array_link2entry(*next);
+	while (heap->eh_nr > 0) {
+		next_ent = heap->eh_ents[0];
 
 		if (evt_ent_is_later(next_ent, this_ent))
 			return next_ent; /* next_ent is a later update */
@@ -562,8 +695,7 @@ evt_find_next_visible(struct evt_entry *this_ent, d_list_t *head,
 
 		/* next_ent is covered */
 		set_visibility(next_ent, EVT_COVERED);
-		temp = *next;
-		*next = temp->next;
+		evt_ent_heap_pop(heap);
 	}
 
 	return NULL;
@@ -789,9 +921,15 @@ process_ext:
 	return 0;
 }
 
+/**
+ * Sweep the sorted entries in extent order to find the visible ones.
+ * \a heap has space for all entries of \a ent_array, visible entries are
+ * stored in extent order in \a visible.
+ */
 static int
 evt_find_visible(struct evt_context *tcx, const struct evt_filter *filter,
-		 struct evt_entry_array *ent_array, int *num_visible)
+		 struct evt_entry_array *ent_array, struct evt_ent_heap *heap,
+		 struct evt_entry **visible, int *num_visible)
 {
 	struct evt_extent	*this_ext;
 	struct evt_extent	*next_ext;
@@ -801,7 +939,6 @@ evt_find_visible(struct evt_context *tcx, const struct evt_filter *filter,
 	struct evt_entry	*split;
 	d_list_t		 covered;
 	d_list_t		 removals;
-	d_list_t		*current;
 	d_list_t		*next;
 	bool			 insert;
 	int			 rc = 0;
@@ -842,31 +979,35 @@ evt_find_visible(struct evt_context *tcx, const struct evt_filter *filter,
 	if (d_list_empty(&covered))
 		return 0;
 
+	/* The list is sorted, so it is already a valid heap */
+	heap->eh_nr = 0;
+	d_list_for_each(next, &covered)
+		heap->eh_ents[heap->eh_nr++] = evt_array_link2entry(next);
+
 	/* Now uncover entries */
-	current = covered.next;
+	next_ent = evt_ent_heap_pop(heap);
 	/* Some compilers can't tell that this_ent will be initialized */
-	this_ent = evt_array_link2entry(current);
+	this_ent = next_ent;
 	insert = true;
-	next = current->next;
 
-	while (next != &covered) {
+	while (heap->eh_nr > 0) {
 		if (insert) {
-			this_ent = evt_array_link2entry(current);
+			this_ent = next_ent;
 			evt_mark_visible(this_ent, false, num_visible);
+			visible[*num_visible - 1] = this_ent;
 			evt_array_entry2le(this_ent)->le_prev = NULL;
 		}
 
 		insert = true;
 
 		/* Find next visible rectangle */
-		next_ent = evt_find_next_visible(this_ent, &covered, &next);
+		next_ent = evt_find_next_visible(this_ent, heap);
 		if (next_ent == NULL)
 			return 0;
 
+		evt_ent_heap_pop(heap);
 		this_ext = &this_ent->en_sel_ext;
 		next_ext = &next_ent->en_sel_ext;
-		current = next;
-		next = current->next;
 		/* NB: Three possibilities
 		 * 1. No intersection.  Current entry is inserted in entirety
 		 * 2. Partial intersection, next is earlier. Next is truncated
@@ -892,12 +1033,10 @@ evt_find_visible(struct evt_context *tcx, const struct evt_filter *filter,
 			if (rc != 0)
 				return rc;
 
-			/* current now points at next_ent.  Remove it and
-			 * reinsert it in the list in case truncation moved
-			 * it to a new position
+			/* Reinsert next_ent in case truncation moved it to a
+			 * new position
 			 */
-			d_list_del(current);
-			next = evt_insert_sorted(next_ent, &covered, next);
+			evt_ent_heap_push(heap, next_ent);
 
 			/* Now we need to rerun this iteration without
 			 * inserting this_ent again
@@ -929,17 +1068,17 @@ evt_find_visible(struct evt_context *tcx, const struct evt_filter *filter,
 				ent_array->ea_ent_nr--;
 				return rc;
 			}
-			/* Case #4, split, insert tail into sorted list */
+			/* Case #4, split, insert tail into the heap */
 			evt_split_entry(tcx, this_ent, next_ent, split,
 					temp_ent);
-			/* Current points at next_ent */
-			next = evt_insert_sorted(split, &covered, next);
+			evt_ent_heap_push(heap, split);
 		}
 	}
 
-	this_ent = evt_array_link2entry(current);
+	this_ent = next_ent;
 	D_ASSERT(!evt_flags_equal(this_ent->en_visibility, EVT_COVERED));
 	evt_mark_visible(this_ent, false, num_visible);
+	visible[*num_visible - 1] = this_ent;
 
 	return 0;
 }
@@ -954,10 +1093,13 @@ evt_ent_array_sort(struct evt_context *tcx, struct evt_entry_array *ent_array,
 		   const struct evt_filter *filter, int flags)
 {
 	struct evt_list_entry	*ents;
+	struct evt_list_entry	*copy;
 	struct evt_entry	*ent;
-	int			(*compar)(const void *, const void *);
-	int			 total;
+	struct evt_entry	**visible = NULL;
+	struct evt_ent_heap	 heap;
+	void			*scratch = NULL;
 	int			 num_visible = 0;
+	int			 i;
 	int			 rc;
 
 	D_DEBUG(DB_TRACE, "Sorting array with filter "DF_FILTER"\n",
@@ -972,7 +1114,8 @@ evt_ent_array_sort(struct evt_context *tcx, struct evt_entry_array *ent_array,
 		} else {
 			evt_mark_visible(ent, true, &num_visible);
 		}
-		goto re_sort;
+		ent_array->ea_ent_nr = (flags & EVT_COVERED) ? 1 : num_visible;
+		return 0;
 	}
 
 	for (;;) {
@@ -982,10 +1125,24 @@ evt_ent_array_sort(struct evt_context *tcx, struct evt_entry_array *ent_array,
 		qsort(ents, ent_array->ea_ent_nr, sizeof(ents[0]),
 		      evt_ent_list_cmp);
 
-		/* Now separate entries into covered and visible */
-		rc = evt_find_visible(tcx, filter, ent_array, &num_visible);
+		/* Space for the heap, the visible entries and a copy of the
+		 * visible entries, the array can't grow during the sweep
+		 * without returning -DER_AGAIN.
+		 */
+		scratch = evt_scratch_get(ent_array->ea_size *
+					  (sizeof(*visible) * 2 +
+					   sizeof(*copy)));
+		if (scratch == NULL)
+			return -DER_NOMEM;
+
+		heap.eh_ents = scratch;
+		visible = heap.eh_ents + ent_array->ea_size;
 
+		/* Now separate entries into covered and visible */
+		rc = evt_find_visible(tcx, filter, ent_array, &heap, visible,
+				      &num_visible);
 		if (rc != 0) {
+			evt_scratch_put(scratch);
 			if (rc == -DER_AGAIN)
 				continue; /* List reallocated, start over */
 			return rc;
@@ -993,22 +1150,23 @@ evt_ent_array_sort(struct evt_context *tcx, struct evt_entry_array *ent_array,
 		break;
 	}
 
-re_sort:
 	ents = ent_array->ea_ents;
-	/* Now re-sort the entries */
 	if (flags & EVT_COVERED) {
-		total = ent_array->ea_ent_nr;
-		compar = evt_ent_list_cmp;
+		/* Now re-sort the entries */
+		qsort(ents, ent_array->ea_ent_nr, sizeof(ents[0]),
+		      evt_ent_list_cmp);
 	} else {
 		D_ASSERT(flags & EVT_VISIBLE);
-		compar = evt_ent_list_cmp_visible;
-		total = num_visible;
+		/* Visible entries are found in extent order, move them to the
+		 * head of the array rather than sorting the whole array.
+		 */
+		copy = (struct evt_list_entry *)(visible + ent_array->ea_size);
+		for (i = 0; i < num_visible; i++)
+			copy[i] = *evt_array_entry2le(visible[i]);
+		memcpy(ents, copy, sizeof(ents[0]) * num_visible);
+		ent_array->ea_ent_nr = num_visible;
 	}
-
-	if (ent_array->ea_ent_nr != 1)
-		qsort(ents, ent_array->ea_ent_nr, sizeof(ents[0]), compar);
-
-	ent_array->ea_ent_nr = total;
+	evt_scratch_put(scratch);
 
 	return 0;
 }
@@ -3202,6 +3360,7 @@ static struct evt_policy_ops evt_ssof_pol_ops = {
 	.po_adjust		= evt_ssof_adjust,
 	.po_split		= evt_even_split,
 	.po_rect_weight		= evt_common_rect_weight,
+	.po_cmp_rect		= evt_ssof_cmp_rect,
 };
 
 /**
@@ -3301,6 +3460,7 @@ static struct evt_policy_ops evt_sdist_pol_ops = {
 	.po_adjust		= evt_sdist_adjust,
 	.po_split		= evt_sdist_split,
 	.po_rect_weight		= evt_common_rect_weight,
+	.po_cmp_rect		= evt_sdist_cmp_rect,
 };
 
 static struct evt_policy_ops evt_sdist_even_pol_ops = {
@@ -3308,6 +3468,7 @@ static struct evt_policy_ops evt_sdist_even_pol_ops = {
 	.po_adjust		= evt_sdist_adjust,
 	.po_split		= evt_even_split,
 	.po_rect_weight		= evt_common_rect_weight,
+	.po_cmp_rect		= evt_sdist_cmp_rect,
 };
 
 /** After the current cursor is deleted, the trace
@@ -3816,3 +3977,364 @@ out:
 	tcx->tc_creds = 0;
 	return rc;
 }
+
+/** Count the leaf records and the leaf nodes of the subtree at \a nd_off */
+static void
+evt_rebuild_count(struct evt_context *tcx, umem_off_t nd_off, int *ent_nr,
+		  int *leaf_nr)
+{
+	struct evt_node	*nd = evt_off2node(tcx, nd_off);
+	int		 i;
+
+	if (evt_node_is_leaf(tcx, nd)) {
+		*ent_nr += nd->tn_nr;
+		(*leaf_nr)++;
+		return;
+	}
+
+	for (i = 0; i < nd->tn_nr; i++)
+		evt_rebuild_count(tcx, nd->tn_child[i], ent_nr, leaf_nr);
+}
+
+/** Copy all leaf records of the subtree at \a nd_off to \a ents */
+static void
+evt_rebuild_collect(struct evt_context *tcx, umem_off_t nd_off,
+		    struct evt_node_entry *ents, int *ent_nr)
+{
+	struct evt_node	*nd = evt_off2node(tcx, nd_off);
+	int		 i;
+
+	if (evt_node_is_leaf(tcx, nd)) {
+		memcpy(&ents[*ent_nr], evt_node_entry_at(tcx, nd, 0),
+		       sizeof(ents[0]) * nd->tn_nr);
+		*ent_nr += nd->tn_nr;
+		return;
+	}
+
+	for (i = 0; i < nd->tn_nr; i++)
+		evt_rebuild_collect(tcx, nd->tn_child[i], ents, ent_nr);
+}
+
+/** Free the nodes of the subtree at \a nd_off, leaf records are kept */
+static int
+evt_rebuild_free(struct evt_context *tcx, umem_off_t nd_off)
+{
+	struct evt_node	*nd = evt_off2node(tcx, nd_off);
+	int		 i;
+	int		 rc;
+
+	if (!evt_node_is_leaf(tcx, nd)) {
+		for (i = 0; i < nd->tn_nr; i++) {
+			rc = evt_rebuild_free(tcx, nd->tn_child[i]);
+			if (rc != 0)
+				return rc;
+		}
+	}
+
+	return evt_node_free(tcx, nd_off);
+}
+
+static int
+evt_rebuild_ent_cmp(const void *p1, const void *p2)
+{
+	struct evt_rect	rt1;
+	struct evt_rect	rt2;
+
+	evt_rect_read(&rt1, &((const struct evt_node_entry *)p1)->ne_rect);
+	evt_rect_read(&rt2, &((const struct evt_node_entry *)p2)->ne_rect);
+
+	return evt_rect_cmp(&rt1, &rt2);
+}
+
+/** Sort the entries of a node in the order of the tree policy */
+static void
+evt_rebuild_node_sort(struct evt_context *tcx, struct evt_node *nd)
+{
+	struct evt_node_entry	 ne;
+	struct evt_rect		 rect;
+	struct evt_rect		 rtmp;
+	uint64_t		 child;
+	bool			 leaf = evt_node_is_leaf(tcx, nd);
+	int			 i;
+	int			 j;
+
+	/* Insertion sort, there are at most tc_order entries */
+	for (i = 1; i < nd->tn_nr; i++) {
+		evt_node_rect_read_at(tcx, nd, i, &rect);
+		if (leaf)
+			ne = nd->tn_rec[i];
+		else
+			child = nd->tn_child[i];
+
+		for (j = i; j > 0; j--) {
+			evt_node_rect_read_at(tcx, nd, j - 1, &rtmp);
+			if (tcx->tc_ops->po_cmp_rect(tcx, nd, &rtmp,
+						     &rect) <= 0)
+				break;
+			if (leaf)
+				nd->tn_rec[j] = nd->tn_rec[j - 1];
+			else
+				nd->tn_child[j] = nd->tn_child[j - 1];
+		}
+
+		if (leaf)
+			nd->tn_rec[j] = ne;
+		else
+			nd->tn_child[j] = child;
+	}
+}
+
+/** Fill target of the rebuilt nodes in percent of the tree order, the
+ * headroom lets the next inserts go in without splitting the nodes.
+ */
+#define EVT_REBUILD_FILL	75
+/** Max number of nodes rebuilt in one transaction */
+#define EVT_REBUILD_TX_NODES	256
+
+static inline int
+evt_rebuild_fill(struct evt_context *tcx)
+{
+	return max(tcx->tc_order * EVT_REBUILD_FILL / 100, 2);
+}
+
+/** Number of nodes of \a height levels to pack \a nr records by \a fill */
+static int
+evt_rebuild_nodes(int nr, int fill, int height)
+{
+	int	total = 0;
+
+	do {
+		nr = (nr + fill - 1) / fill;
+		total += nr;
+	} while (--height > 0 || (height < 0 && nr > 1));
+
+	return total;
+}
+
+/** Number of levels to pack \a nr records into a single node by \a fill */
+static int
+evt_rebuild_depth(int nr, int fill)
+{
+	int	depth = 1;
+
+	for (; nr > fill; depth++)
+		nr = (nr + fill - 1) / fill;
+
+	return depth;
+}
+
+/**
+ * Pack \a nr leaf records (\a ents) or child nodes (\a children) evenly into
+ * nodes of \a fill entries at most. Offsets of the new nodes are returned in
+ * \a children, which can be the input array because a node never takes less
+ * than one child. A single node is the root of the tree if \a root is set.
+ */
+static int
+evt_rebuild_level(struct evt_context *tcx, struct evt_node_entry *ents,
+		  umem_off_t *children, int nr, int fill, bool root,
+		  int *nd_nr)
+{
+	struct evt_node	*nd;
+	umem_off_t	 nd_off;
+	unsigned int	 flags;
+	int		 nodes;
+	int		 start;
+	int		 cnt;
+	int		 i;
+	int		 rc;
+
+	nodes = (nr + fill - 1) / fill;
+	flags = ents != NULL ? EVT_NODE_LEAF : 0;
+	if (nodes == 1 && root)
+		flags |= EVT_NODE_ROOT;
+
+	for (i = 0, start = 0; i < nodes; i++, start += cnt) {
+		cnt = nr / nodes + (i < nr % nodes);
+
+		rc = evt_node_alloc(tcx, flags, &nd_off);
+		if (rc != 0)
+			return rc;
+
+		nd = evt_off2node(tcx, nd_off);
+		if (ents != NULL)
+			memcpy(evt_node_entry_at(tcx, nd, 0), &ents[start],
+			       sizeof(ents[0]) * cnt);
+		else
+			memcpy(&nd->tn_child[0], &children[start],
+			       sizeof(children[0]) * cnt);
+		nd->tn_nr = cnt;
+
+		evt_node_mbr_cal(tcx, nd);
+		evt_rebuild_node_sort(tcx, nd);
+		children[i] = nd_off;
+	}
+
+	*nd_nr = nodes;
+	return 0;
+}
+
+/**
+ * Rebuild the subtree at \a nd_off in one transaction. It is the whole tree
+ * if \a parent is NULL, otherwise it is child \a idx of \a parent and keeps
+ * its \a height, so that all leaves of the tree stay at the same depth.
+ */
+static int
+evt_rebuild_subtree(struct evt_context *tcx, struct evt_node *parent,
+		    int idx, int height, int ent_nr, int *nodes_used)
+{
+	struct evt_root		*root = tcx->tc_root;
+	struct evt_node_entry	*ents;
+	umem_off_t		*nodes = NULL;
+	umem_off_t		 nd_off;
+	int			 fill = evt_rebuild_fill(tcx);
+	int			 nd_nr;
+	int			 depth;
+	int			 rc;
+
+	nd_off = parent == NULL ? root->tr_node : parent->tn_child[idx];
+
+	/* The tree must not grow and a subtree must keep its height, both
+	 * always fit when nodes are full.
+	 */
+	if (evt_rebuild_depth(ent_nr, fill) > height)
+		fill = tcx->tc_order;
+
+	D_ALLOC_ARRAY_NZ(ents, ent_nr);
+	if (ents == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_ARRAY_NZ(nodes, (ent_nr + fill - 1) / fill);
+	if (nodes == NULL)
+		D_GOTO(free, rc = -DER_NOMEM);
+
+	/* Leaves are tiled by extent only, records at all epochs of an
+	 * extent range land in the same leaves, because reads at the latest
+	 * epoch can't prune anything on the epoch axis.
+	 */
+	rc = 0;
+	evt_rebuild_collect(tcx, nd_off, ents, &rc);
+	D_ASSERT(rc == ent_nr);
+	qsort(ents, ent_nr, sizeof(ents[0]), evt_rebuild_ent_cmp);
+
+	rc = evt_tx_begin(tcx);
+	if (rc != 0)
+		goto free;
+
+	rc = evt_rebuild_level(tcx, ents, nodes, ent_nr, fill, parent == NULL,
+			       &nd_nr);
+	*nodes_used = nd_nr;
+	for (depth = 1; rc == 0; depth++) {
+		if (parent == NULL ? nd_nr == 1 : depth == height)
+			break;
+		rc = evt_rebuild_level(tcx, NULL, nodes, nd_nr, fill,
+				       parent == NULL, &nd_nr);
+		*nodes_used += nd_nr;
+	}
+	if (rc != 0)
+		goto out;
+	D_ASSERT(nd_nr == 1);
+
+	/* Nothing refers to the old nodes, records are still referenced by
+	 * the new leaves.
+	 */
+	rc = evt_rebuild_free(tcx, nd_off);
+	if (rc != 0)
+		goto out;
+
+	if (parent != NULL) {
+		/* the records and so the MBR of the child are unchanged */
+		rc = evt_node_tx_add(tcx, parent);
+		if (rc != 0)
+			goto out;
+		parent->tn_child[idx] = nodes[0];
+		goto out;
+	}
+
+	rc = evt_root_tx_add(tcx);
+	if (rc != 0)
+		goto out;
+
+	D_DEBUG(DB_TRACE, "Rebuilt evtree with %d records, depth %d -> %d\n",
+		ent_nr, root->tr_depth, depth);
+	root->tr_node = nodes[0];
+	root->tr_depth = depth;
+out:
+	evt_tcx_reset_trace(tcx);
+	rc = evt_tx_end(tcx, rc);
+	if (rc != 0)
+		/* Transaction aborted, restore the cached depth */
+		evt_tcx_reset_trace(tcx);
+free:
+	D_FREE(nodes);
+	D_FREE(ents);
+	return rc;
+}
+
+/**
+ * Rebuild the sparse subtree of child \a idx of \a parent, which has \a height
+ * levels, or rebuild the whole tree if \a parent is NULL. A subtree too large
+ * for one transaction is rebuilt one child at a time.
+ */
+static int
+evt_rebuild_node(struct evt_context *tcx, struct evt_node *parent, int idx,
+		 int height, int *credits, bool *rebuilt)
+{
+	struct evt_node	*nd;
+	umem_off_t	 nd_off;
+	int		 fill = evt_rebuild_fill(tcx);
+	int		 ent_nr = 0;
+	int		 leaf_nr = 0;
+	int		 nodes;
+	int		 i;
+	int		 rc;
+
+	nd_off = parent == NULL ? tcx->tc_root->tr_node : parent->tn_child[idx];
+	evt_rebuild_count(tcx, nd_off, &ent_nr, &leaf_nr);
+	if (leaf_nr <= (ent_nr + fill - 1) / fill) {
+		D_DEBUG(DB_TRACE, "Evtree with %d records in %d leaves is "
+			"already packed\n", ent_nr, leaf_nr);
+		return 0;
+	}
+
+	nodes = evt_rebuild_nodes(ent_nr, fill, parent == NULL ? -1 : height);
+	if (nodes > EVT_REBUILD_TX_NODES && height > 2) {
+		nd = evt_off2node(tcx, nd_off);
+		for (i = 0; i < nd->tn_nr && *credits > 0; i++) {
+			rc = evt_rebuild_node(tcx, nd, i, height - 1, credits,
+					      rebuilt);
+			if (rc != 0)
+				return rc;
+		}
+		return 0;
+	}
+
+	rc = evt_rebuild_subtree(tcx, parent, idx, height, ent_nr, &nodes);
+	if (rc != 0)
+		return rc;
+
+	*credits -= nodes;
+	*rebuilt = true;
+	return 0;
+}
+
+int
+evt_rebuild(daos_handle_t toh, int *credits, bool *rebuilt)
+{
+	struct evt_context	*tcx;
+	bool			 done = false;
+	int			 rc;
+
+	tcx = evt_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	if (!evt_root_empty(tcx))
+		rc = evt_rebuild_node(tcx, NULL, 0, tcx->tc_root->tr_depth,
+				      credits, &done);
+	else
+		rc = 0;
+
+	if (rebuilt)
+		*rebuilt = done;
+	return rc;
+}
@@ -281,7 +281,8 @@ ilog_init(void)
 {
 	int	rc;
 
-	rc = dbtree_class_register(VOS_BTR_ILOG, BTR_FEAT_UINT_KEY,
+	rc = dbtree_class_register(VOS_BTR_ILOG,
+				   BTR_FEAT_UINT_KEY | BTR_FEAT_KEY_SCAN,
 				   &ilog_btr_ops);
 	if (rc != 0)
 		D_ERROR("Failed to register incarnation log btree class: %s\n",
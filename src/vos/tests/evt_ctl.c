@@ -753,6 +753,91 @@ ts_many_add(void)
 	D_FREE(seq);
 }
 
+static void
+ts_find_perf(void)
+{
+	struct evt_entry_in	 entry = {0};
+	struct evt_filter	 filter = {0};
+	struct evt_rect		*rect;
+	char			*arg;
+	char			*tmp;
+	double			 then;
+	double			 duration = 0;
+	int			 visible = 0;
+	int			 loops;
+	int			 nr;
+	int			 i;
+	int			 rc;
+	/* argument format: "n:NUM,l:NUM"
+	 * n: number of extents overwriting a 1MiB range
+	 * l: number of times to find the whole range
+	 */
+	arg = tst_fn_val.optval;
+	if (arg == NULL || arg[0] != 'n' || arg[1] != EVT_SEP_VAL) {
+		D_PRINT("need input parameters n:NUM,l:NUM\n");
+		fail();
+	}
+
+	nr = strtol(&arg[2], &tmp, 0);
+	if (nr <= 0 || *tmp != EVT_SEP) {
+		D_PRINT("Invalid parameter %s\n", arg);
+		fail();
+	}
+	arg = tmp + 1;
+
+	if (arg[0] != 'l' || arg[1] != EVT_SEP_VAL) {
+		D_PRINT("Invalid parameter %s\n", arg);
+		fail();
+	}
+	loops = strtol(&arg[2], &tmp, 0);
+	if (loops <= 0) {
+		D_PRINT("Invalid loop number %d\n", loops);
+		fail();
+	}
+
+	/* Random 4K aligned extents with increasing epochs, like a checkpoint
+	 * file being rewritten over and over. Holes are used because only
+	 * the tree is being measured.
+	 */
+	rect = &entry.ei_rect;
+	bio_addr_set_hole(&entry.ei_addr, 1);
+	for (i = 0; i < nr; i++) {
+		rect->rc_ex.ex_lo = (rand() % 241) * D_1K_SIZE * 4;
+		rect->rc_ex.ex_hi = rect->rc_ex.ex_lo +
+				    (1 + rand() % 16) * D_1K_SIZE * 4 - 1;
+		rect->rc_epc = i + 1;
+		entry.ei_bound = rect->rc_epc;
+		entry.ei_inob = 1;
+
+		rc = evt_insert(ts_toh, &entry, NULL);
+		if (rc != 0) {
+			D_FATAL("Add rect %d failed "DF_RC"\n", i, DP_RC(rc));
+			fail();
+		}
+	}
+
+	filter.fr_ex.ex_hi = D_1M_SIZE - 1;
+	filter.fr_epr.epr_hi = nr;
+	filter.fr_epoch = nr;
+	for (i = 0; i < loops; i++) {
+		EVT_ENT_ARRAY_LG_PTR(ent_array);
+
+		evt_ent_array_init(ent_array, 0);
+		then = dts_time_now();
+		rc = evt_find(ts_toh, &filter, ent_array);
+		duration += dts_time_now() - then;
+		if (rc != 0) {
+			D_FATAL("Find failed "DF_RC"\n", DP_RC(rc));
+			fail();
+		}
+		visible = ent_array->ea_ent_nr;
+		evt_ent_array_fini(ent_array);
+	}
+
+	D_PRINT("Find 1MiB over %d extents: %d visible, %.2f usec per find\n",
+		nr, visible, duration * 1000000 / loops);
+}
+
 static void
 ts_tree_debug(void)
 {
@@ -789,6 +874,34 @@ ts_drain(void)
 	}
 }
 
+static void
+ts_rebuild(void)
+{
+	bool	rebuilt = false;
+	bool	chunk;
+	int	depth = ts_root->tr_depth;
+	int	credits;
+	int	rc;
+
+	do {
+		/* small credits to rebuild large trees in several chunks */
+		credits = 64;
+		rc = evt_rebuild(ts_toh, &credits, &chunk);
+		if (rc) {
+			print_message("Failed to rebuild: %s\n",
+				      d_errstr(rc));
+			fail();
+		}
+		rebuilt |= chunk;
+	} while (credits <= 0);
+	print_message("%s tree, depth %d -> %d\n",
+		      rebuilt ? "rebuilt" : "packed", depth, ts_root->tr_depth);
+	if (ts_root->tr_depth > depth) {
+		print_message("Rebuild should never grow the tree\n");
+		fail();
+	}
+}
+
 int
 teardown_builtin(void **state)
 {
@@ -2251,8 +2364,10 @@ static struct option ts_ops[] = {
 	{ "open",	no_argument,		NULL,	'o'	},
 	{ "close",	no_argument,		NULL,	'c'	},
 	{ "drain",	required_argument,	NULL,	'e'	},
+	{ "rebuild",	no_argument,		NULL,	'R'	},
 	{ "add",	required_argument,	NULL,	'a'	},
 	{ "many_add",	required_argument,	NULL,	'm'	},
+	{ "find_perf",	required_argument,	NULL,	'p'	},
 	{ "find",	required_argument,	NULL,	'f'	},
 	{ "remove_all",	required_argument,	NULL,	'r'	},
 	{ "delete",	required_argument,	NULL,	'd'	},
@@ -2296,9 +2411,15 @@ ts_cmd_run(char opc, char *args)
 	case 'e':
 		ts_drain();
 		break;
+	case 'R':
+		ts_rebuild();
+		break;
 	case 'f':
 		ts_find_rect();
 		break;
+	case 'p':
+		ts_find_perf();
+		break;
 	case 'l':
 		ts_list_rect();
 		break;
@@ -2336,7 +2457,7 @@ ts_group(void **state)
 
 	while ((opc = getopt_long(test_group_argc,
 				 test_group_args,
-				 "C:a:m:e:f:g:d:b:Docl::tsr:",
+				 "C:a:m:e:f:g:d:b:p:RDocl::tsr:",
 				 ts_ops, NULL)) != -1){
 		ts_cmd_run(opc, optarg);
 	}
@@ -192,4 +192,26 @@ echo "$cmd"
 eval "$cmd"
 result="${PIPESTATUS[0]}"
 echo "Drain test returned $result"
+if (( result != 0 )); then
+        exit "$result"
+fi
+
+# Rebuild tests
+cmd="$VCMD $EVT_CTL --start-test \"evtree rebuild tests $*\" $* -C o:4"
+cmd+=" -m s:0,e:128,n:2379 -R -f 0-4096@2379 -R -b -2 -D"
+echo "$cmd"
+eval "$cmd"
+result="${PIPESTATUS[0]}"
+echo "Rebuild test returned $result"
+if (( result != 0 )) || [ -z "$EVT_CTL_PERF" ]; then
+        exit "$result"
+fi
+
+# Find performance test, only run if EVT_CTL_PERF is set
+cmd="$VCMD $EVT_CTL --start-test \"evtree find perf tests $*\" $* -C o:23"
+cmd+=" -p n:4096,l:10 -D"
+echo "$cmd"
+eval "$cmd"
+result="${PIPESTATUS[0]}"
+echo "Find perf test returned $result"
 exit "$result"
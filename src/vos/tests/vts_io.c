@@ -842,7 +842,7 @@ io_obj_cache_test(void **state)
 	daos_handle_t		 l_poh, l_coh;
 	int			 i, rc;
 
-	rc = vos_obj_cache_create(10, &occ);
+	rc = vos_obj_cache_create(1 << 10, &occ);
 	assert_rc_equal(rc, 0);
 
 	rc = vts_alloc_gen_fname(&po_name);
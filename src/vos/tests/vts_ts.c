@@ -25,7 +25,6 @@ struct ts_test_arg {
 	void			*old_table;
 	struct vos_ts_set	*ta_ts_set;
 	uint32_t		 ta_counts[VOS_TS_TYPE_COUNT];
-	uint32_t		 ta_extra_records[NUM_EXTRA];
 };
 
 static void
@@ -65,6 +64,25 @@ run_negative_entry_test(struct ts_test_arg *ts_arg, uint32_t type)
 	}
 }
 
+/** Find \p nr records after \p first that are cached in the same set */
+static void
+find_set_records(struct ts_test_arg *ts_arg, uint32_t type, uint32_t first,
+		 uint32_t *records, int nr)
+{
+	struct vos_ts_info	*info;
+	uint32_t		 set;
+	uint32_t		 idx;
+	int			 found = 0;
+
+	info = &vos_ts_table_get()->tt_type_info[type];
+	set = vos_ts_set_idx(info, &ts_arg->ta_records[type][first]);
+	for (idx = first + 1; idx < VOS_TS_SIZE && found < nr; idx++) {
+		if (vos_ts_set_idx(info, &ts_arg->ta_records[type][idx]) == set)
+			records[found++] = idx;
+	}
+	assert_int_equal(found, nr);
+}
+
 static void
 run_positive_entry_test(struct ts_test_arg *ts_arg, uint32_t type)
 {
@@ -73,9 +91,11 @@ run_positive_entry_test(struct ts_test_arg *ts_arg, uint32_t type)
 	uint32_t		*idx_ptr;
 	uint32_t		 children_per_parent = 100;
 	uint32_t		 parent_idx;
+	uint32_t		 set_recs[VOS_TS_WAYS];
 	uint32_t		 idx;
 	bool			 reset = false;
 	bool			 found;
+	int			 i;
 
 	for (idx = 0; idx < ts_arg->ta_counts[type]; idx++) {
 		found = vos_ts_lookup(ts_arg->ta_ts_set,
@@ -87,12 +107,14 @@ run_positive_entry_test(struct ts_test_arg *ts_arg, uint32_t type)
 
 		if (type != VOS_TS_TYPE_CONT) {
 			vos_ts_set_reset(ts_arg->ta_ts_set, type - 1, 0);
-			/** ignore the entries that were evicted */
 			parent_idx = idx / children_per_parent + NUM_EXTRA + 1;
 			idx_ptr = &ts_arg->ta_records[type - 1][parent_idx];
 			found = vos_ts_lookup(ts_arg->ta_ts_set, idx_ptr,
 					      false, &entry);
-			assert_true(found);
+			/** Parent may have been evicted by its set */
+			if (!found)
+				entry = vos_ts_alloc(ts_arg->ta_ts_set, idx_ptr,
+						     parent_idx);
 			assert_non_null(entry);
 		}
 
@@ -111,68 +133,69 @@ run_positive_entry_test(struct ts_test_arg *ts_arg, uint32_t type)
 	}
 	assert_int_equal(ts_arg->ta_ts_set->ts_init_count, 1 + type);
 
-	/** Lookup an entry entry */
-	found = vos_ts_lookup(ts_arg->ta_ts_set,
-			      &ts_arg->ta_records[type][NUM_EXTRA - 2], true,
-			      &entry);
-	assert_true(found);
-	assert_non_null(entry);
-
-	assert_int_equal(ts_arg->ta_ts_set->ts_init_count, 1 + type);
-	/** Now evict a few entries */
-	for (idx = 0; idx < NUM_EXTRA; idx++) {
+	/** Fill the set of record 0 with record 0 and other records in it */
+	find_set_records(ts_arg, type, 0, set_recs, VOS_TS_WAYS);
+	for (i = -1; i < VOS_TS_WAYS - 1; i++) {
+		idx = i < 0 ? 0 : set_recs[i];
 		vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
+		found = vos_ts_lookup(ts_arg->ta_ts_set,
+				      &ts_arg->ta_records[type][idx], false,
+				      &entry);
+		if (found)
+			continue;
 		entry = vos_ts_alloc(ts_arg->ta_ts_set,
-				     &ts_arg->ta_extra_records[idx], idx);
+				     &ts_arg->ta_records[type][idx], idx);
 		assert_non_null(entry);
-		assert_int_equal(entry->te_info->ti_type, type);
 	}
-	assert_int_equal(ts_arg->ta_ts_set->ts_init_count, 1 + type);
 
-	/** Now check original entries, only the one used above should still be
-	 * there.   Others will have been evicted by LRU policy
-	 */
-	for (idx = 0; idx <= NUM_EXTRA; idx++) {
+	/** Touch record 0 so that the next record evicts set_recs[0] */
+	vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
+	found = vos_ts_lookup(ts_arg->ta_ts_set, &ts_arg->ta_records[type][0],
+			      false, &entry);
+	assert_true(found);
+	assert_non_null(entry);
+
+	idx = set_recs[VOS_TS_WAYS - 1];
+	vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
+	entry = vos_ts_alloc(ts_arg->ta_ts_set, &ts_arg->ta_records[type][idx],
+			     idx);
+	assert_non_null(entry);
+	assert_int_equal(entry->te_info->ti_type, type);
+
+	/** Only the least recently used record of the set is evicted */
+	for (i = -1; i < VOS_TS_WAYS; i++) {
+		idx = i < 0 ? 0 : set_recs[i];
 		vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
 		found = vos_ts_lookup(ts_arg->ta_ts_set,
 				      &ts_arg->ta_records[type][idx], false,
 				      &entry);
-		if (idx == (NUM_EXTRA - 2))
-			assert_true(found);
-		else
+		if (i == 0)
 			assert_false(found);
+		else
+			assert_true(found);
 	}
 
-	/** Now evict the extra records to reset the array for child tests */
-	for (idx = 0; idx < NUM_EXTRA; idx++)
-		vos_ts_evict(&ts_arg->ta_extra_records[idx], type);
-
-	/** evicting an entry should move it to lru */
+	/** evicting an entry should free it for reuse in its set */
 	vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
-	found = vos_ts_lookup(ts_arg->ta_ts_set, &ts_arg->ta_records[type][20],
+	idx = set_recs[2];
+	found = vos_ts_lookup(ts_arg->ta_ts_set, &ts_arg->ta_records[type][idx],
 			      false, &same);
 	assert_true(found);
 	assert_int_equal(same->te_info->ti_type, type);
-	vos_ts_evict(&ts_arg->ta_records[type][20], type);
-	found = vos_ts_lookup(ts_arg->ta_ts_set, &ts_arg->ta_records[type][20],
+	vos_ts_evict(&ts_arg->ta_records[type][idx], type);
+	found = vos_ts_lookup(ts_arg->ta_ts_set, &ts_arg->ta_records[type][idx],
 			      true, &entry);
 	assert_false(found);
-	entry = vos_ts_alloc(ts_arg->ta_ts_set, &ts_arg->ta_records[type][20],
-			     20);
+	entry = vos_ts_alloc(ts_arg->ta_ts_set, &ts_arg->ta_records[type][idx],
+			     idx);
 	assert_int_equal(entry->te_info->ti_type, type);
 	assert_ptr_equal(entry, same);
 
-	for (idx = 0; idx <= NUM_EXTRA; idx++) {
-		if (idx == (NUM_EXTRA - 2))
+	/** Final check...the whole set should exist */
+	for (i = -1; i < VOS_TS_WAYS; i++) {
+		idx = i < 0 ? 0 : set_recs[i];
+		if (i == 0)
 			continue;
-		vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
-		entry = vos_ts_alloc(ts_arg->ta_ts_set,
-				     &ts_arg->ta_records[type][idx], idx);
-		assert_non_null(entry);
-	}
-
-	/** Final check...all of them should exist */
-	for (idx = 0; idx < ts_arg->ta_counts[type]; idx++) {
 		found = vos_ts_lookup(ts_arg->ta_ts_set,
 				      &ts_arg->ta_records[type][idx], true,
 				      &entry);
@@ -34,8 +34,19 @@
  * physical entries. If any old physical entry (not fully covered in current
  * window) straddles window end, it has to be head-truncated on window flush,
  * and the remaining part will be processed in next merge window.
+ *
+ * Aggregation deletes and reinserts many records, which leaves the EV tree
+ * with sparsely filled nodes. When the percentage of deleted records reaches
+ * vos_agg_evt_rebuild, the tree is rebuilt bottom-up once the akey is done,
+ * a large tree is rebuilt in chunks and aggregation yields between them.
  */
 
+/* Minimum physical entries for an EV tree rebuild to pay off */
+#define AGG_EVT_REBUILD_MIN	(VOS_EVT_ORDER * 4)
+
+/* Percentage of deleted records to trigger EV tree rebuild, 0 to disable */
+unsigned int vos_agg_evt_rebuild;
+
 /* EV tree physical entry */
 struct agg_phy_ent {
 	d_list_t		pe_link;
@@ -133,6 +144,9 @@ struct agg_merge_window {
 	/* I/O context for transferring data on flush */
 	struct agg_io_context		 mw_io_ctxt;
 	bool				 mw_csum_support;
+	/* Physical entries seen and deleted in current EV tree */
+	unsigned int			 mw_ent_cnt;
+	unsigned int			 mw_del_cnt;
 };
 
 struct vos_agg_param {
@@ -412,6 +426,10 @@ vos_agg_akey(daos_handle_t ih, vos_iter_entry_t *entry,
 		agg_param->ap_window.mw_io_ctxt.ic_csum_buf_len = 0;
 	}
 
+	/* Restart EV tree rebuild accounting for this akey */
+	agg_param->ap_window.mw_ent_cnt = 0;
+	agg_param->ap_window.mw_del_cnt = 0;
+
 	return 0;
 }
 
@@ -807,9 +825,10 @@ static int
 reserve_segment(struct vos_object *obj, struct agg_io_context *io,
 		daos_size_t size, bio_addr_t *addr)
 {
-	uint64_t	off;
-	uint16_t	media;
-	int		rc;
+	struct vea_hint_context	*hint;
+	uint64_t		 off;
+	uint16_t		 media;
+	int			 rc;
 
 	memset(addr, 0, sizeof(*addr));
 	media = vos_media_select(vos_obj2pool(obj), DAOS_IOD_ARRAY, size);
@@ -825,8 +844,9 @@ reserve_segment(struct vos_object *obj, struct agg_io_context *io,
 	}
 
 	D_ASSERT(media == DAOS_MEDIA_NVME);
-	rc = vos_reserve_blocks(obj->obj_cont, &io->ic_nvme_exts, size,
-				VOS_IOS_AGGREGATION, &off);
+	hint = vos_cont2hint(obj->obj_cont, VOS_IOS_AGGREGATION);
+	rc = vos_reserve_blocks(obj->obj_cont, &io->ic_nvme_exts, size, hint,
+				&off);
 	if (rc)
 		D_ERROR("Reserve "DF_U64" from NVMe failed. "DF_RC"\n",
 			size, DP_RC(rc));
@@ -1271,6 +1291,8 @@ process_removals(struct agg_merge_window *mw, struct vos_obj_iter *oiter, d_list
 			D_DEBUG(DB_EPC, "Removing physical removal record: "DF_RECT"\n",
 				DP_RECT(&rm_ent->re_rect));
 			rc = evt_delete(oiter->it_hdl, &rect, NULL);
+			if (rc == 0)
+				mw->mw_del_cnt++;
 		} else {
 			D_ASSERT(top);
 			D_DEBUG(DB_EPC, "Removing logical removal record: "DF_RECT"\n",
@@ -1306,6 +1328,7 @@ insert_segments(daos_handle_t ih, struct agg_merge_window *mw,
 	struct agg_lgc_seg	*lgc_seg;
 	struct evt_entry_in	*ent_in;
 	struct evt_rect		 rect;
+	struct vea_hint_context	*hint;
 	unsigned int		 i, leftovers = 0;
 	int			 rc;
 
@@ -1378,6 +1401,7 @@ insert_segments(daos_handle_t ih, struct agg_merge_window *mw,
 				DP_RC(rc));
 			goto abort;
 		}
+		mw->mw_del_cnt++;
 
 		/* Physical entry is in window or fully removed */
 		if (rect.rc_ex.ex_hi <= mw->mw_ext.ex_hi ||
@@ -1422,8 +1446,8 @@ insert_segments(daos_handle_t ih, struct agg_merge_window *mw,
 	mw->mw_ext.ex_lo = mw->mw_ext.ex_hi = 0;
 
 	/* Publish NVMe reservations */
-	rc = vos_publish_blocks(obj->obj_cont, &io->ic_nvme_exts, true,
-				VOS_IOS_AGGREGATION);
+	hint = vos_cont2hint(obj->obj_cont, VOS_IOS_AGGREGATION);
+	rc = vos_publish_blocks(obj->obj_cont, &io->ic_nvme_exts, true, hint);
 	if (rc) {
 		D_ERROR("Publish NVMe extents error: "DF_RC"\n", DP_RC(rc));
 		goto abort;
@@ -1450,7 +1474,8 @@ cleanup_segments(daos_handle_t ih, struct agg_merge_window *mw, int rc)
 
 		if (!d_list_empty(&io->ic_nvme_exts))
 			vos_publish_blocks(obj->obj_cont, &io->ic_nvme_exts,
-					   false, VOS_IOS_AGGREGATION);
+				false, vos_cont2hint(obj->obj_cont,
+						     VOS_IOS_AGGREGATION));
 	}
 
 	/* Reset io context */
@@ -1865,6 +1890,7 @@ join_merge_window(daos_handle_t ih, struct agg_merge_window *mw,
 		rc = delete_evt_entry(oiter, entry, acts, "covered");
 		if (rc)
 			return rc;
+		mw->mw_del_cnt++;
 		goto out;
 	}
 
@@ -2024,6 +2050,9 @@ vos_agg_ev(daos_handle_t ih, vos_iter_entry_t *entry,
 		return rc;
 	}
 
+	if (phy_ext.ex_lo == lgc_ext.ex_lo)
+		mw->mw_ent_cnt++;
+
 	/* Aggregation Yield for testing purpose */
 	while (DAOS_FAIL_CHECK(DAOS_VOS_AGG_BLOCKED)) {
 		ABT_thread_yield();
@@ -2161,6 +2190,46 @@ vos_aggregate_pre_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 	return 0;
 }
 
+static bool
+agg_evt_rebuild_yield(void *arg)
+{
+	struct vos_agg_param	*agg_param = arg;
+
+	if (vos_aggregate_yield(agg_param)) {
+		D_DEBUG(DB_EPC, "EV tree rebuild aborted\n");
+		return true;
+	}
+	return false;
+}
+
+/* Rebuild the EV tree of current akey if aggregation has thinned it out */
+static int
+agg_evt_rebuild(daos_handle_t ih, struct vos_agg_param *agg_param,
+		unsigned int *acts)
+{
+	struct agg_merge_window	*mw = &agg_param->ap_window;
+	unsigned int		 ent_cnt = mw->mw_ent_cnt;
+	unsigned int		 del_cnt = mw->mw_del_cnt;
+	bool			 yielded;
+	int			 rc;
+
+	if (vos_agg_evt_rebuild == 0 || agg_param->ap_discard ||
+	    ent_cnt < AGG_EVT_REBUILD_MIN ||
+	    (uint64_t)del_cnt * 100 < (uint64_t)ent_cnt * vos_agg_evt_rebuild)
+		return 0;
+
+	rc = vos_obj_iter_evt_rebuild(ih, agg_evt_rebuild_yield, agg_param,
+				      &yielded);
+	if (yielded)
+		*acts |= VOS_ITER_CB_YIELD;
+	if (rc)
+		D_CDEBUG(rc == -DER_TX_BUSY, DB_EPC, DLOG_ERR,
+			 "Rebuild EV tree (%u/%u deleted) error: "DF_RC"\n",
+			 del_cnt, ent_cnt, DP_RC(rc));
+	/* Tree is still valid, it's just not packed */
+	return 0;
+}
+
 static int
 vos_aggregate_post_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 		      vos_iter_type_t type, vos_iter_param_t *param,
@@ -2194,6 +2263,8 @@ vos_aggregate_post_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 			break;
 		}
 		rc = vos_obj_iter_aggregate(ih, agg_param->ap_discard);
+		if (rc == 0 && type == VOS_ITER_AKEY)
+			rc = agg_evt_rebuild(ih, agg_param, acts);
 		break;
 	case VOS_ITER_SINGLE:
 		return 0;
@@ -203,7 +203,7 @@ vos_tx_publish(struct dtx_handle *dth, bool publish)
 
 		/** Function checks if list is empty */
 		rc = vos_publish_blocks(cont, &dru->dru_nvme,
-					publish, VOS_IOS_GENERIC);
+					publish, dru->dru_hint);
 		if (rc && publish)
 			return rc;
 	}
@@ -217,10 +217,13 @@ vos_tx_publish(struct dtx_handle *dth, bool publish)
 			return rc;
 	}
 
-	/** Handle the deferred NVMe cancellations */
+	/**
+	 * Handle the deferred NVMe cancellations, they could be reserved
+	 * from different I/O streams, so don't revert any hint.
+	 */
 	if (!publish)
 		vos_publish_blocks(cont, &dth->dth_deferred_nvme,
-				   false, VOS_IOS_GENERIC);
+				   false, NULL);
 
 	return 0;
 }
@@ -245,8 +248,8 @@ vos_tx_begin(struct dtx_handle *dth, struct umem_instance *umm)
 
 int
 vos_tx_end(struct vos_container *cont, struct dtx_handle *dth_in,
-	   struct vos_rsrvd_scm **rsrvd_scmp, d_list_t *nvme_exts, bool started,
-	   int err)
+	   struct vos_rsrvd_scm **rsrvd_scmp, d_list_t *nvme_exts,
+	   struct vea_hint_context *hint, bool started, int err)
 {
 	struct dtx_handle	*dth = dth_in;
 	struct dtx_rsrvd_uint	*dru;
@@ -271,6 +274,7 @@ vos_tx_end(struct vos_container *cont, struct dtx_handle *dth_in,
 
 		D_INIT_LIST_HEAD(&dru->dru_nvme);
 		d_list_splice_init(nvme_exts, &dru->dru_nvme);
+		dru->dru_hint = hint;
 	}
 
 	if (!dth->dth_local_tx_started)
@@ -340,8 +344,11 @@ vos_tls_fini(void *data)
 		gc_del_pool(pool);
 	}
 
-	if (tls->vtl_ocache)
+	if (tls->vtl_ocache) {
+		/* Publish what is left over from the last batch */
+		vos_obj_cache_metrics_update(tls);
 		vos_obj_cache_destroy(tls->vtl_ocache);
+	}
 
 	if (tls->vtl_pool_hhash)
 		d_uhash_destroy(tls->vtl_pool_hhash);
@@ -350,6 +357,8 @@ vos_tls_fini(void *data)
 		d_uhash_destroy(tls->vtl_cont_hhash);
 
 	umem_fini_txd(&tls->vtl_txd);
+	D_FREE(tls->vtl_evt_ents);
+	D_FREE(tls->vtl_evt_scratch);
 	if (tls->vtl_ts_table)
 		vos_ts_table_free(&tls->vtl_ts_table);
 	D_FREE(tls);
@@ -366,7 +375,7 @@ vos_tls_init(int xs_id, int tgt_id)
 		return NULL;
 
 	D_INIT_LIST_HEAD(&tls->vtl_gc_pools);
-	rc = vos_obj_cache_create(LRU_CACHE_BITS, &tls->vtl_ocache);
+	rc = vos_obj_cache_create(vos_obj_cache_size, &tls->vtl_ocache);
 	if (rc) {
 		D_ERROR("Error in creating object cache\n");
 		goto failed;
@@ -412,6 +421,9 @@ vos_tls_init(int xs_id, int tgt_id)
 		D_WARN("Failed to create committed cnt sensor: "DF_RC"\n",
 		       DP_RC(rc));
 
+	vos_ts_table_metrics_init(tls->vtl_ts_table, tgt_id);
+	vos_obj_cache_metrics_init(tls, tgt_id);
+
 	return tls;
 failed:
 	vos_tls_fini(tls);
@@ -427,6 +439,36 @@ struct dss_module_key vos_module_key = {
 
 daos_epoch_t	vos_start_epoch = DAOS_EPOCH_MAX;
 
+/**
+ * DAOS_VOS_OBJ_CACHE_MB is the per xstream memory budget of the object
+ * cache, DAOS_VOS_OBJ_CACHE_POLICY selects the replacement policy, either
+ * "flush" (default) or "2q".
+ */
+static void
+vos_obj_cache_env_init(void)
+{
+	unsigned int	 cache_mb = 0;
+	uint64_t	 size;
+	char		*policy;
+
+	d_getenv_int("DAOS_VOS_OBJ_CACHE_MB", &cache_mb);
+	if (cache_mb != 0) {
+		size = ((uint64_t)cache_mb << 20) / sizeof(struct vos_object);
+		if (size == 0)
+			size = 1;
+		vos_obj_cache_size = min_t(uint64_t, size, UINT_MAX);
+	}
+
+	policy = getenv("DAOS_VOS_OBJ_CACHE_POLICY");
+	if (policy != NULL && strcasecmp(policy, "2q") == 0)
+		vos_obj_cache_policy = DAOS_LRU_POLICY_2Q;
+	else if (policy != NULL && strcasecmp(policy, "flush") != 0)
+		D_WARN("Unknown object cache policy %s, use flush\n", policy);
+
+	D_INFO("Object cache size %u, policy %s\n", vos_obj_cache_size,
+	       vos_obj_cache_policy == DAOS_LRU_POLICY_2Q ? "2q" : "flush");
+}
+
 static int
 vos_mod_init(void)
 {
@@ -464,10 +506,26 @@ vos_mod_init(void)
 	}
 
 	rc = vos_ilog_init();
-	if (rc)
+	if (rc) {
 		D_ERROR("Failed to initialize incarnation log capability\n");
+		return rc;
+	}
 
-	return rc;
+	d_getenv_int("DAOS_VOS_AGG_EVT_REBUILD", &vos_agg_evt_rebuild);
+	if (vos_agg_evt_rebuild > 100)
+		vos_agg_evt_rebuild = 100;
+	if (vos_agg_evt_rebuild != 0)
+		D_INFO("Rebuild EV tree when %u%% records are deleted by "
+		       "aggregation\n", vos_agg_evt_rebuild);
+
+	d_getenv_int("DAOS_VOS_HINT_STREAMS", &vos_hint_streams);
+	if (vos_hint_streams > VOS_HINT_STREAMS_MAX)
+		vos_hint_streams = VOS_HINT_STREAMS_MAX;
+	D_INFO("%u allocation streams per container\n", vos_hint_streams);
+
+	vos_obj_cache_env_init();
+
+	return 0;
 }
 
 static int
@@ -586,18 +644,17 @@ vos_self_init(const char *db_path)
 
 	vos_start_epoch = 0;
 
-#if VOS_STANDALONE
-	self_mode.self_tls = vos_tls_init(0, -1);
-	if (!self_mode.self_tls) {
-		ABT_finalize();
-		D_MUTEX_UNLOCK(&self_mode.self_lock);
-		return rc;
-	}
-#endif
+	/* The object cache settings must be read before the TLS is created */
 	rc = vos_mod_init();
 	if (rc)
 		D_GOTO(failed, rc);
 
+#if VOS_STANDALONE
+	self_mode.self_tls = vos_tls_init(0, -1);
+	if (!self_mode.self_tls)
+		D_GOTO(failed, rc = -DER_NOMEM);
+#endif
+
 	rc = vos_db_init(db_path, "self_db", true);
 	if (rc)
 		D_GOTO(failed, rc);
@@ -23,6 +23,13 @@
 
 #include "vos_internal.h"
 
+/**
+ * Number of transient per object allocation streams for regular updates in
+ * each container, zero means all the regular updates share the persistent
+ * generic hint.
+ */
+unsigned int vos_hint_streams = 16;
+
 /**
  * Parameters for vos_cont_df btree
  */
@@ -199,6 +206,14 @@ cont_free_internal(struct vos_container *cont)
 			vea_hint_unload(cont->vc_hint_ctxt[i]);
 	}
 
+	if (cont->vc_hint_streams != NULL) {
+		for (i = 0; i < vos_hint_streams; i++) {
+			if (cont->vc_hint_streams[i])
+				vea_hint_unload(cont->vc_hint_streams[i]);
+		}
+		D_FREE(cont->vc_hint_streams);
+	}
+
 	D_FREE(cont);
 }
 
@@ -434,6 +449,22 @@ vos_cont_open(daos_handle_t poh, uuid_t co_uuid, daos_handle_t *coh)
 				goto exit;
 			}
 		}
+
+		if (vos_hint_streams != 0) {
+			D_ALLOC_ARRAY(cont->vc_hint_streams, vos_hint_streams);
+			if (cont->vc_hint_streams == NULL)
+				D_GOTO(exit, rc = -DER_NOMEM);
+		}
+
+		for (i = 0; i < vos_hint_streams; i++) {
+			rc = vea_hint_load(NULL, &cont->vc_hint_streams[i]);
+			if (rc) {
+				D_ERROR("Error loading allocator stream %d "
+					"hint "DF_UUID": %d\n", i,
+					DP_UUID(co_uuid), rc);
+				goto exit;
+			}
+		}
 	}
 
 	rc = vos_dtx_act_reindex(cont);
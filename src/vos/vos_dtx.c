@@ -2619,7 +2619,8 @@ vos_dtx_cleanup(struct dtx_handle *dth)
 	/** This will abort the transaction and callback to
 	 *  vos_dtx_cleanup_internal
 	 */
-	vos_tx_end(cont, dth, NULL, NULL, true /* don't care */, -DER_CANCELED);
+	vos_tx_end(cont, dth, NULL, NULL, NULL, true /* don't care */,
+		   -DER_CANCELED);
 }
 
 int
@@ -1091,8 +1091,12 @@ vos_gc_pool(daos_handle_t poh, int credits, bool (*yield_func)(void *arg),
 	int		 rc, total = 0;
 
 	D_ASSERT(daos_handle_is_valid(poh));
-	if (!gc_have_pool(pool))
+	if (!gc_have_pool(pool)) {
+		/* Coalesce the aged free extents in VEA aging buffer */
+		if (pool->vp_vea_info != NULL)
+			vea_compact(pool->vp_vea_info);
 		return 0; /* nothing to reclaim for this pool */
+	}
 
 	tls->vtl_gc_running++;
 	/*
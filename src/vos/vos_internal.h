@@ -103,6 +103,9 @@ enum {
 /* Force aggregation/discard ULT yield on certain amount of tight loops */
 #define VOS_AGG_CREDITS_MAX	32
 
+/* Force EV tree rebuild to yield after rebuilding this many tree nodes */
+#define VOS_EVT_REBUILD_CREDITS	1024
+
 static inline uint32_t vos_byte2blkcnt(uint64_t bytes)
 {
 	D_ASSERT(bytes != 0);
@@ -210,6 +213,11 @@ struct vos_container {
 	 * durable hints in vos_cont_df
 	 */
 	struct vea_hint_context	*vc_hint_ctxt[VOS_IOS_CNT];
+	/**
+	 * Transient allocation hints of the per object I/O streams for
+	 * regular updates, vos_hint_streams entries, NULL if disabled.
+	 */
+	struct vea_hint_context	**vc_hint_streams;
 	/* Current ongoing aggregation ERR */
 	daos_epoch_range_t	vc_epr_aggregation;
 	/* Current ongoing discard EPR */
@@ -320,6 +328,15 @@ struct vos_dtx_cmt_ent {
 #define DCE_EPOCH(dce)		((dce)->dce_base.dce_epoch)
 
 extern int vos_evt_feats;
+extern unsigned int vos_agg_evt_rebuild;
+
+/** Max number of per object allocation streams per container */
+#define VOS_HINT_STREAMS_MAX	64
+extern unsigned int vos_hint_streams;
+
+/** Max number of cached objects per xstream, and replacement policy */
+extern unsigned int vos_obj_cache_size;
+extern enum daos_lru_policy vos_obj_cache_policy;
 
 #define VOS_KEY_CMP_LEXICAL	(1ULL << 63)
 
@@ -978,6 +995,7 @@ vos_tx_begin(struct dtx_handle *dth, struct umem_instance *umm);
  * \param[in]	dth_in		The dtx handle, if applicable
  * \param[in]	rsrvd_scmp	Pointer to reserved scm, will be consumed
  * \param[in]	nvme_exts	List of resreved nvme extents
+ * \param[in]	hint		Allocation hint of \a nvme_exts
  * \param[in]	started		Only applies when dth_in is invalid,
  *				indicates if vos_tx_begin was successful
  * \param[in]	err		the error code
@@ -986,8 +1004,8 @@ vos_tx_begin(struct dtx_handle *dth, struct umem_instance *umm);
  */
 int
 vos_tx_end(struct vos_container *cont, struct dtx_handle *dth_in,
-	   struct vos_rsrvd_scm **rsrvd_scmp, d_list_t *nvme_exts, bool started,
-	   int err);
+	   struct vos_rsrvd_scm **rsrvd_scmp, d_list_t *nvme_exts,
+	   struct vea_hint_context *hint, bool started, int err);
 
 /* vos_obj.c */
 int
@@ -1037,11 +1055,38 @@ vos_publish_scm(struct vos_container *cont, struct vos_rsrvd_scm *rsrvd_scm,
 		bool publish);
 int
 vos_reserve_blocks(struct vos_container *cont, d_list_t *rsrvd_nvme,
-		   daos_size_t size, enum vos_io_stream ios, uint64_t *off);
+		   daos_size_t size, struct vea_hint_context *hint,
+		   uint64_t *off);
 
 int
 vos_publish_blocks(struct vos_container *cont, d_list_t *blk_list, bool publish,
-		   enum vos_io_stream ios);
+		   struct vea_hint_context *hint);
+
+static inline struct vea_hint_context *
+vos_cont2hint(struct vos_container *cont, enum vos_io_stream ios)
+{
+	return cont->vc_hint_ctxt[ios];
+}
+
+/**
+ * Select the allocation hint for the regular updates on \a oid, the updates
+ * on the same object always go to the same I/O stream, so that the extents
+ * of an object are kept contiguous even if many objects are being written
+ * concurrently. The persistent generic hint is used when the per object
+ * streams are disabled.
+ */
+static inline struct vea_hint_context *
+vos_cont_hint_select(struct vos_container *cont, daos_unit_oid_t oid)
+{
+	uint64_t	hash;
+
+	if (cont->vc_hint_streams == NULL)
+		return vos_cont2hint(cont, VOS_IOS_GENERIC);
+
+	hash = d_hash_murmur64((unsigned char *)&oid.id_pub,
+			       sizeof(oid.id_pub), VOS_BTR_MUR_SEED);
+	return cont->vc_hint_streams[hash % vos_hint_streams];
+}
 
 static inline struct umem_instance *
 vos_pool2umm(struct vos_pool *pool)
@@ -1120,6 +1165,23 @@ oi_iter_aggregate(daos_handle_t ih, bool discard);
 int
 vos_obj_iter_aggregate(daos_handle_t ih, bool discard);
 
+/**
+ * Rebuild the EV tree of the current entry of the akey iterator, so that
+ * the nodes are filled evenly after aggregation. A large tree is rebuilt in
+ * chunks, \a yield_func is called between chunks and stops the rebuild by
+ * returning true.
+ *
+ * \param ih[IN]		Iterator handle
+ * \param yield_func[IN]	Yield function
+ * \param yield_arg[IN]	Argument of \a yield_func
+ * \param yielded[OUT]	Set to true if \a yield_func was called
+ *
+ * \return		Zero on Success, negative value otherwise
+ */
+int
+vos_obj_iter_evt_rebuild(daos_handle_t ih, bool (*yield_func)(void *arg),
+			 void *yield_arg, bool *yielded);
+
 /** Internal bit for initializing iterator from open tree handle */
 #define VOS_IT_KEY_TREE	(1 << 31)
 /** Ensure there is no overlap with public iterator flags (defined in
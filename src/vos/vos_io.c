@@ -16,6 +16,7 @@
 #include <daos_types.h>
 #include <daos_srv/vos.h>
 #include <daos.h>
+#include <gurt/trace.h>
 #include "vos_internal.h"
 #include "evt_priv.h"
 
@@ -53,6 +54,8 @@ struct vos_io_context {
 	unsigned int		 ic_umoffs_at;
 	/** reserved NVMe extents */
 	d_list_t		 ic_blk_exts;
+	/** Allocation hint of the I/O stream for NVMe reservations */
+	struct vea_hint_context	*ic_hint;
 	daos_size_t		 ic_space_held[DAOS_MEDIA_MAX];
 	/** number DAOS IO descriptors */
 	unsigned int		 ic_iod_nr;
@@ -1879,23 +1882,21 @@ vos_reserve_scm(struct vos_container *cont, struct vos_rsrvd_scm *rsrvd_scm,
 
 int
 vos_reserve_blocks(struct vos_container *cont, d_list_t *rsrvd_nvme,
-		   daos_size_t size, enum vos_io_stream ios, uint64_t *off)
+		   daos_size_t size, struct vea_hint_context *hint,
+		   uint64_t *off)
 {
 	struct vea_space_info	*vsi;
-	struct vea_hint_context	*hint_ctxt;
 	struct vea_resrvd_ext	*ext;
 	uint32_t		 blk_cnt;
 	int			 rc;
 
 	vsi = vos_cont2pool(cont)->vp_vea_info;
 	D_ASSERT(vsi);
-
-	hint_ctxt = cont->vc_hint_ctxt[ios];
-	D_ASSERT(hint_ctxt);
+	D_ASSERT(hint);
 
 	blk_cnt = vos_byte2blkcnt(size);
 
-	rc = vea_reserve(vsi, blk_cnt, hint_ctxt, rsrvd_nvme);
+	rc = vea_reserve(vsi, blk_cnt, hint, rsrvd_nvme);
 	if (rc)
 		return rc;
 
@@ -1930,7 +1931,7 @@ reserve_space(struct vos_io_context *ioc, uint16_t media, daos_size_t size,
 
 	D_ASSERT(media == DAOS_MEDIA_NVME);
 	rc = vos_reserve_blocks(ioc->ic_cont, &ioc->ic_blk_exts, size,
-				VOS_IOS_GENERIC, off);
+				ioc->ic_hint, off);
 	if (rc)
 		D_ERROR("Reserve "DF_U64" from NVMe failed. "DF_RC"\n",
 			size, DP_RC(rc));
@@ -2151,13 +2152,15 @@ vos_publish_scm(struct vos_container *cont, struct vos_rsrvd_scm *rsrvd_scm,
 	return rc;
 }
 
-/* Publish or cancel the NVMe block reservations */
+/*
+ * Publish or cancel the NVMe block reservations, @hint could be NULL when
+ * canceling the reservations from different I/O streams.
+ */
 int
 vos_publish_blocks(struct vos_container *cont, d_list_t *blk_list, bool publish,
-		   enum vos_io_stream ios)
+		   struct vea_hint_context *hint)
 {
 	struct vea_space_info	*vsi;
-	struct vea_hint_context	*hint_ctxt;
 	int			 rc;
 
 	if (d_list_empty(blk_list))
@@ -2165,11 +2168,10 @@ vos_publish_blocks(struct vos_container *cont, d_list_t *blk_list, bool publish,
 
 	vsi = cont->vc_pool->vp_vea_info;
 	D_ASSERT(vsi);
-	hint_ctxt = cont->vc_hint_ctxt[ios];
-	D_ASSERT(hint_ctxt);
+	D_ASSERT(hint || !publish);
 
-	rc = publish ? vea_tx_publish(vsi, hint_ctxt, blk_list) :
-		       vea_cancel(vsi, hint_ctxt, blk_list);
+	rc = publish ? vea_tx_publish(vsi, hint, blk_list) :
+		       vea_cancel(vsi, hint, blk_list);
 	if (rc)
 		D_ERROR("Error on %s NVMe reservations. "DF_RC"\n",
 			publish ? "publish" : "cancel", DP_RC(rc));
@@ -2214,6 +2216,7 @@ vos_update_end(daos_handle_t ioh, uint32_t pm_ver, daos_key_t *dkey, int err,
 	bool			 tx_started = false;
 
 	VOS_TIME_START(time, VOS_UPDATE_END);
+	D_TRACE_BEGIN(D_TRACE_VOS_UPDATE_END, ioh.cookie, 0);
 	D_ASSERT(ioc->ic_update);
 	vos_dedup_verify_fini(ioh);
 
@@ -2285,7 +2288,7 @@ abort:
 	}
 
 	err = vos_tx_end(ioc->ic_cont, dth, &ioc->ic_rsrvd_scm,
-			 &ioc->ic_blk_exts, tx_started, err);
+			 &ioc->ic_blk_exts, ioc->ic_hint, tx_started, err);
 	if (err == 0) {
 		vos_ts_set_upgrade(ioc->ic_ts_set);
 		if (daes != NULL) {
@@ -2319,6 +2322,7 @@ abort:
 	D_FREE(dces);
 	vos_ioc_destroy(ioc, err != 0);
 	vos_dth_set(NULL);
+	D_TRACE_END(D_TRACE_VOS_UPDATE_END, ioh.cookie, err);
 
 	return err;
 }
@@ -2371,16 +2375,20 @@ vos_update_begin(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
 		", flags="DF_X64"\n", DP_UOID(oid), iod_nr,
 		dtx_is_valid_handle(dth) ? dth->dth_epoch :  epoch, flags);
 
+	D_TRACE_BEGIN(D_TRACE_VOS_UPDATE_BEGIN, ioh, iod_nr);
 	rc = vos_check_akeys(iod_nr, iods);
 	if (rc != 0) {
 		D_ERROR("Detected duplicate akeys, operation not allowed\n");
-		return rc;
+		goto out;
 	}
 
 	rc = vos_ioc_create(coh, oid, false, epoch, iod_nr, iods, iods_csums,
 			    flags, NULL, dedup_th, dth, &ioc);
 	if (rc != 0)
-		return rc;
+		goto out;
+
+	/* Pick the I/O stream for NVMe reservations by object */
+	ioc->ic_hint = vos_cont_hint_select(ioc->ic_cont, oid);
 
 	/* flags may have VOS_OF_CRIT to skip sys/held checks here */
 	rc = vos_space_hold(vos_cont2pool(ioc->ic_cont), flags, dkey, iod_nr,
@@ -2398,9 +2406,11 @@ vos_update_begin(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
 		goto error;
 	}
 	*ioh = vos_ioc2ioh(ioc);
-	return 0;
+	goto out;
 error:
 	vos_update_end(vos_ioc2ioh(ioc), 0, dkey, rc, NULL, dth);
+out:
+	D_TRACE_END(D_TRACE_VOS_UPDATE_BEGIN, ioh, rc);
 	return rc;
 }
 
@@ -412,7 +412,7 @@ reset:
 			rc = -DER_TX_RESTART;
 	}
 
-	rc = vos_tx_end(cont, dth, NULL, NULL, true, rc);
+	rc = vos_tx_end(cont, dth, NULL, NULL, NULL, true, rc);
 
 	if (rc == 0) {
 		vos_ts_set_upgrade(ts_set);
@@ -1874,6 +1874,64 @@ exit:
 	return rc;
 }
 
+int
+vos_obj_iter_evt_rebuild(daos_handle_t ih, bool (*yield_func)(void *arg),
+			 void *yield_arg, bool *yielded)
+{
+	struct vos_iterator	*iter = vos_hdl2iter(ih);
+	struct vos_obj_iter	*oiter = vos_iter2oiter(iter);
+	struct vos_krec_df	*krec;
+	struct vos_object	*obj;
+	struct evt_desc_cbs	 cbs;
+	daos_key_t		 key;
+	struct vos_rec_bundle	 rbund;
+	daos_handle_t		 toh;
+	bool			 rebuilt = false;
+	int			 credits;
+	int			 rc;
+
+	D_ASSERTF(iter->it_type == VOS_ITER_AKEY,
+		  "EV tree rebuild only supported on akey\n");
+
+	*yielded = false;
+	rc = key_iter_fetch_helper(oiter, &rbund, &key, NULL);
+	if (rc != 0)
+		return rc == -DER_NONEXIST ? 0 : rc;
+
+	/* The akey record stays in place across yields, only aggregation
+	 * removes it.
+	 */
+	krec = rbund.rb_krec;
+	obj = oiter->it_obj;
+	vos_evt_desc_cbs_init(&cbs, vos_obj2pool(obj),
+			      vos_cont2hdl(obj->obj_cont));
+	while (1) {
+		if (!(krec->kr_bmap & KREC_BF_EVT) ||
+		    evt_is_empty(&krec->kr_evt))
+			break;
+
+		/* Reopen the tree after yield, it could be changed by others */
+		rc = evt_open(&krec->kr_evt, vos_obj2uma(obj), &cbs, &toh);
+		if (rc != 0)
+			return rc;
+
+		credits = VOS_EVT_REBUILD_CREDITS;
+		rc = evt_rebuild(toh, &credits, &rebuilt);
+		evt_close(toh);
+		if (rc != 0 || credits > 0)
+			break;
+
+		*yielded = true;
+		if (yield_func(yield_arg))
+			break;
+	}
+
+	if (rc == 0 && rebuilt)
+		D_DEBUG(DB_EPC, "Rebuilt EV tree of akey "DF_KEY"\n",
+			DP_KEY(&key));
+	return rc;
+}
+
 static int
 vos_obj_iter_delete(struct vos_iterator *iter, void *args)
 {
@@ -23,6 +23,8 @@
 #include "vos_ts.h"
 
 #define LRU_CACHE_BITS 16
+/** Publish object cache statistics to telemetry every this many lookups */
+#define VOS_OBJ_CACHE_TM_BATCH	1024
 
 /* Internal container handle structure */
 struct vos_container;
@@ -114,13 +116,13 @@ int vos_obj_evict_by_oid(struct daos_lru_cache *occ, struct vos_container *cont,
 			 daos_unit_oid_t oid);
 
 /**
- * Create an object cache.
+ * Create an object cache with the replacement policy vos_obj_cache_policy.
  *
- * \param cache_size	[IN]	Cache size
+ * \param cache_size	[IN]	Max number of cached objects
  * \param occ_p		[OUT]	Newly created cache.
  */
 int
-vos_obj_cache_create(int32_t cache_size, struct daos_lru_cache **occ_p);
+vos_obj_cache_create(uint32_t cache_size, struct daos_lru_cache **occ_p);
 
 /**
  * Destroy an object cache, and release all cached object references.
@@ -139,6 +141,14 @@ void vos_obj_cache_evict(struct daos_lru_cache *occ,
  */
 struct daos_lru_cache *vos_obj_cache_current(void);
 
+struct vos_tls;
+
+/** Register hit/miss/evict sensors of the object cache of \a tls */
+void vos_obj_cache_metrics_init(struct vos_tls *tls, int tgt_id);
+
+/** Publish statistics of the object cache of \a tls to telemetry */
+void vos_obj_cache_metrics_update(struct vos_tls *tls);
+
 /**
  * Object Index API and handles
  * For internal use by object cache
@@ -129,6 +129,14 @@ obj_lop_print_key(void *key, unsigned int ksize)
 		DP_UUID(cont->vc_id), DP_UOID(lkey->olk_oid));
 }
 
+/**
+ * Max number of cached objects per xstream, it can be set via the memory
+ * budget DAOS_VOS_OBJ_CACHE_MB.
+ */
+unsigned int vos_obj_cache_size = (1U << LRU_CACHE_BITS);
+/** Object cache replacement policy, see DAOS_VOS_OBJ_CACHE_POLICY */
+enum daos_lru_policy vos_obj_cache_policy = DAOS_LRU_POLICY_FLUSH;
+
 static struct daos_llink_ops obj_lru_ops = {
 	.lop_free_ref	= obj_lop_free,
 	.lop_alloc_ref	= obj_lop_alloc,
@@ -138,13 +146,15 @@ static struct daos_llink_ops obj_lru_ops = {
 };
 
 int
-vos_obj_cache_create(int32_t cache_size, struct daos_lru_cache **occ)
+vos_obj_cache_create(uint32_t cache_size, struct daos_lru_cache **occ)
 {
 	int	rc;
 
-	D_DEBUG(DB_TRACE, "Creating an object cache %d\n", (1 << cache_size));
-	rc = daos_lru_cache_create(cache_size, D_HASH_FT_NOLOCK,
-				   &obj_lru_ops, occ);
+	D_DEBUG(DB_TRACE, "Creating an object cache %u, policy %d\n",
+		cache_size, vos_obj_cache_policy);
+	rc = daos_lru_cache_create_policy(cache_size, D_HASH_FT_NOLOCK,
+					  vos_obj_cache_policy, &obj_lru_ops,
+					  occ);
 	if (rc)
 		D_ERROR("Error in creating lru cache: "DF_RC"\n", DP_RC(rc));
 	return rc;
@@ -185,6 +195,43 @@ vos_obj_cache_current(void)
 	return vos_obj_cache_get();
 }
 
+void
+vos_obj_cache_metrics_init(struct vos_tls *tls, int tgt_id)
+{
+	int	rc;
+
+	rc = d_tm_add_metric(&tls->vtl_ocache_hit, D_TM_COUNTER,
+			     "object cache lookup hits", "lookups",
+			     "vos/obj_cache/hit/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create obj cache hit sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->vtl_ocache_miss, D_TM_COUNTER,
+			     "object cache lookup misses", "lookups",
+			     "vos/obj_cache/miss/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create obj cache miss sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->vtl_ocache_evict, D_TM_COUNTER,
+			     "objects evicted from cache for capacity",
+			     "objects", "vos/obj_cache/evict/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create obj cache evict sensor: "DF_RC"\n",
+		       DP_RC(rc));
+}
+
+void
+vos_obj_cache_metrics_update(struct vos_tls *tls)
+{
+	struct daos_lru_cache	*occ = tls->vtl_ocache;
+
+	d_tm_set_counter(tls->vtl_ocache_hit, occ->dlc_hits);
+	d_tm_set_counter(tls->vtl_ocache_miss, occ->dlc_misses);
+	d_tm_set_counter(tls->vtl_ocache_evict, occ->dlc_evicts);
+}
+
 void
 vos_obj_release(struct daos_lru_cache *occ, struct vos_object *obj, bool evict)
 {
@@ -236,6 +283,12 @@ vos_obj_hold(struct daos_lru_cache *occ, struct vos_container *cont,
 	if (rc)
 		D_GOTO(failed_2, rc);
 
+	/* Keep the lookup path free of telemetry locking */
+	if (((occ->dlc_hits + occ->dlc_misses) &
+	     (VOS_OBJ_CACHE_TM_BATCH - 1)) == 0 &&
+	    occ == vos_obj_cache_get())
+		vos_obj_cache_metrics_update(vos_tls_get());
+
 	obj = container_of(lret, struct vos_object, obj_llink);
 
 	if (obj->obj_zombie)
@@ -63,6 +63,16 @@ struct vos_tls {
 		bool			 vtl_hash_set;
 	};
 	struct d_tm_node_t		 *vtl_committed;
+	/** object cache telemetry */
+	struct d_tm_node_t		 *vtl_ocache_hit;
+	struct d_tm_node_t		 *vtl_ocache_miss;
+	struct d_tm_node_t		 *vtl_ocache_evict;
+	/** evtree entry array buffer kept for reuse */
+	struct evt_list_entry		*vtl_evt_ents;
+	uint32_t			 vtl_evt_ents_nr;
+	/** scratch buffer for evtree sorting */
+	void				*vtl_evt_scratch;
+	size_t				 vtl_evt_scratch_size;
 };
 
 struct bio_xs_context *vos_xsctxt_get(void);
@@ -791,7 +791,8 @@ static struct vos_btr_attr vos_btr_attrs[] = {
 		.ta_class	= VOS_BTR_DKEY,
 		.ta_order	= VOS_KTR_ORDER,
 		.ta_feats	= VOS_OFEAT_BITS | BTR_FEAT_UINT_KEY |
-				  BTR_FEAT_DIRECT_KEY | BTR_FEAT_DYNAMIC_ROOT,
+				  BTR_FEAT_DIRECT_KEY | BTR_FEAT_DYNAMIC_ROOT |
+				  BTR_FEAT_KEY_SCAN,
 		.ta_name	= "vos_dkey",
 		.ta_ops		= &key_btr_ops,
 	},
@@ -799,7 +800,8 @@ static struct vos_btr_attr vos_btr_attrs[] = {
 		.ta_class	= VOS_BTR_AKEY,
 		.ta_order	= VOS_KTR_ORDER,
 		.ta_feats	= VOS_OFEAT_BITS | BTR_FEAT_UINT_KEY |
-				  BTR_FEAT_DIRECT_KEY | BTR_FEAT_DYNAMIC_ROOT,
+				  BTR_FEAT_DIRECT_KEY | BTR_FEAT_DYNAMIC_ROOT |
+				  BTR_FEAT_KEY_SCAN,
 		.ta_name	= "vos_akey",
 		.ta_ops		= &key_btr_ops,
 	},
@@ -13,18 +13,23 @@
 
 #include "vos_internal.h"
 
-#define DEFINE_TS_STR(type, desc, count)	desc,
+#define DEFINE_TS_STR(type, desc, count, env)	desc,
 
 /** Strings corresponding to timestamp types */
 static const char * const type_strs[] = {
 	D_FOREACH_TS_TYPE(DEFINE_TS_STR)
 };
 
-#define DEFINE_TS_COUNT(type, desc, count)	count,
+#define DEFINE_TS_COUNT(type, desc, count, env)	count,
 static const uint32_t type_counts[] = {
 	D_FOREACH_TS_TYPE(DEFINE_TS_COUNT)
 };
 
+#define DEFINE_TS_ENV(type, desc, count, env)	env,
+static const char * const type_envs[] = {
+	D_FOREACH_TS_TYPE(DEFINE_TS_ENV)
+};
+
 #define OBJ_MISS_SIZE (1 << 16)
 #define DKEY_MISS_SIZE (1 << 16)
 #define AKEY_MISS_SIZE (1 << 16)
@@ -38,15 +43,17 @@ static const uint32_t type_counts[] = {
 /** The entry is being evicted either because there is no space in the cache or
  *  the item it represents has been removed.  In either case, update the
  *  corresponding negative entry.
+ *
+ *  Returns true if the read timestamps of the negative (or global) entry were
+ *  raised, i.e. other items sharing it may now see conflicts they wouldn't
+ *  have seen with the evicted entry in cache.
  */
 static bool
 ts_update_on_evict(struct vos_ts_table *ts_table, struct vos_ts_entry *entry)
 {
 	struct vos_wts_cache	*wcache;
 	struct vos_wts_cache	*dest;
-
-	if (entry->te_record_ptr == NULL)
-		return false;
+	bool			 raised;
 
 	wcache = &entry->te_w_cache;
 
@@ -55,20 +62,25 @@ ts_update_on_evict(struct vos_ts_table *ts_table, struct vos_ts_entry *entry)
 		 * just update the global entries
 		 */
 		dest = &ts_table->tt_w_cache;
+		raised = false;
 		if (entry->te_ts.tp_ts_rl > ts_table->tt_ts_rl) {
 			vos_ts_copy(&ts_table->tt_ts_rl, &ts_table->tt_tx_rl,
 				    entry->te_ts.tp_ts_rl,
 				    &entry->te_ts.tp_tx_rl);
+			raised = true;
 		}
 		if (entry->te_ts.tp_ts_rh > ts_table->tt_ts_rh) {
 			vos_ts_copy(&ts_table->tt_ts_rh, &ts_table->tt_tx_rh,
 				    entry->te_ts.tp_ts_rh,
 				    &entry->te_ts.tp_tx_rh);
+			raised = true;
 		}
 		goto update_w_cache;
 	}
 
 	dest = &entry->te_negative->te_w_cache;
+	raised = entry->te_ts.tp_ts_rl > entry->te_negative->te_ts.tp_ts_rl ||
+		 entry->te_ts.tp_ts_rh > entry->te_negative->te_ts.tp_ts_rh;
 	vos_ts_rl_update(entry->te_negative, entry->te_ts.tp_ts_rl,
 			 &entry->te_ts.tp_tx_rl);
 	vos_ts_rh_update(entry->te_negative, entry->te_ts.tp_ts_rh,
@@ -77,32 +89,39 @@ update_w_cache:
 	vos_ts_update_wcache(dest, wcache->wc_ts_w[0]);
 	vos_ts_update_wcache(dest, wcache->wc_ts_w[1]);
 
-	return true;
+	return raised;
 }
 
-static void evict_entry(void *payload, uint32_t idx, void *arg)
+void
+vos_ts_evict_entry(struct vos_ts_table *ts_table, struct vos_ts_entry *entry,
+		   uint32_t idx)
 {
-	struct vos_ts_info	*info = arg;
-	struct vos_ts_entry	*entry = payload;
+	D_ASSERT(entry->te_record_ptr != NULL);
 
-	if (ts_update_on_evict(info->ti_table, entry)) {
-		TS_TRACE("Evicted", entry, idx, info->ti_type);
-		entry->te_record_ptr = NULL;
-	}
+	ts_update_on_evict(ts_table, entry);
+	TS_TRACE("Evicted", entry, idx, entry->te_info->ti_type);
+	entry->te_record_ptr = NULL;
 }
 
-static void init_entry(void *payload, uint32_t idx, void *arg)
+/** Number of cache entries for \p type, environment overrides the default */
+static uint32_t
+ts_type_count(uint32_t type)
 {
-	struct vos_ts_info	*info = arg;
-	struct vos_ts_entry	*entry = payload;
+	unsigned int	count = type_counts[type];
 
-	entry->te_info = info;
-}
+	d_getenv_int(type_envs[type], &count);
+	if (count < VOS_TS_WAYS)
+		count = VOS_TS_WAYS;
+	else if (count > VOS_TS_MAX_COUNT)
+		count = VOS_TS_MAX_COUNT;
 
-static const struct lru_callbacks lru_cbs = {
-	.lru_on_evict = evict_entry,
-	.lru_on_init = init_entry,
-};
+	count = 1U << daos_power2_nbits(count);
+	if (count != type_counts[type])
+		D_DEBUG(DB_TRACE, "%s timestamp cache has %u entries\n",
+			type_strs[type], count);
+
+	return count;
+}
 
 int
 vos_ts_table_alloc(struct vos_ts_table **ts_tablep)
@@ -113,7 +132,7 @@ vos_ts_table_alloc(struct vos_ts_table **ts_tablep)
 	struct vos_ts_entry	*miss_cursor;
 	int			 rc;
 	uint32_t		 i;
-	int			 j;
+	uint32_t		 j;
 	uint32_t		 miss_size;
 
 	*ts_tablep = NULL;
@@ -138,7 +157,8 @@ vos_ts_table_alloc(struct vos_ts_table **ts_tablep)
 		info = &ts_table->tt_type_info[i];
 
 		info->ti_type = i;
-		info->ti_count = type_counts[i];
+		info->ti_count = ts_type_count(i);
+		info->ti_set_mask = info->ti_count / VOS_TS_WAYS - 1;
 		info->ti_table = ts_table;
 		switch (i) {
 		case VOS_TS_TYPE_OBJ:
@@ -178,11 +198,13 @@ vos_ts_table_alloc(struct vos_ts_table **ts_tablep)
 			}
 		}
 
-		rc = lrua_array_alloc(&info->ti_array, info->ti_count, 1,
-				      sizeof(struct vos_ts_entry), 0, &lru_cbs,
-				      info);
-		if (rc != 0)
+		D_ALLOC_ARRAY(info->ti_entries, info->ti_count);
+		if (info->ti_entries == NULL) {
+			rc = -DER_NOMEM;
 			goto cleanup;
+		}
+		for (j = 0; j < info->ti_count; j++)
+			info->ti_entries[j].te_info = info;
 	}
 
 	*ts_tablep = ts_table;
@@ -191,7 +213,7 @@ vos_ts_table_alloc(struct vos_ts_table **ts_tablep)
 
 cleanup:
 	for (i = 0; i < VOS_TS_TYPE_COUNT; i++)
-		lrua_array_free(ts_table->tt_type_info[i].ti_array);
+		D_FREE(ts_table->tt_type_info[i].ti_entries);
 	D_FREE(ts_table->tt_misses);
 free_table:
 	D_FREE(ts_table);
@@ -203,10 +225,17 @@ void
 vos_ts_table_free(struct vos_ts_table **ts_tablep)
 {
 	struct vos_ts_table	*ts_table = *ts_tablep;
+	struct vos_ts_info	*info;
 	int			 i;
 
-	for (i = 0; i < VOS_TS_TYPE_COUNT; i++)
-		lrua_array_free(ts_table->tt_type_info[i].ti_array);
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+		/* Publish what is left over from the last batch */
+		d_tm_set_counter(info->ti_hit_tm, info->ti_nr_hit);
+		d_tm_set_counter(info->ti_miss_tm, info->ti_nr_miss);
+		d_tm_set_counter(info->ti_evict_tm, info->ti_nr_evict);
+		D_FREE(info->ti_entries);
+	}
 
 	D_FREE(ts_table->tt_misses);
 	D_FREE(ts_table);
@@ -214,6 +243,43 @@ vos_ts_table_free(struct vos_ts_table **ts_tablep)
 	*ts_tablep = NULL;
 }
 
+void
+vos_ts_table_metrics_init(struct vos_ts_table *ts_table, int tgt_id)
+{
+	struct vos_ts_info	*info;
+	int			 rc;
+	int			 i;
+
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+
+		rc = d_tm_add_metric(&info->ti_hit_tm, D_TM_COUNTER,
+				     "timestamp cache lookup hits", "lookups",
+				     "vos/ts/%s/hit/tgt_%u", type_strs[i],
+				     tgt_id);
+		if (rc)
+			D_WARN("Failed to create ts hit sensor: "DF_RC"\n",
+			       DP_RC(rc));
+
+		rc = d_tm_add_metric(&info->ti_miss_tm, D_TM_COUNTER,
+				     "timestamp cache lookup misses", "lookups",
+				     "vos/ts/%s/miss/tgt_%u", type_strs[i],
+				     tgt_id);
+		if (rc)
+			D_WARN("Failed to create ts miss sensor: "DF_RC"\n",
+			       DP_RC(rc));
+
+		rc = d_tm_add_metric(&info->ti_evict_tm, D_TM_COUNTER,
+				     "timestamp cache evictions raising shared "
+				     "read timestamps", "evictions",
+				     "vos/ts/%s/evict_conflict/tgt_%u",
+				     type_strs[i], tgt_id);
+		if (rc)
+			D_WARN("Failed to create ts evict sensor: "DF_RC"\n",
+			       DP_RC(rc));
+	}
+}
+
 void
 vos_ts_evict_lru(struct vos_ts_table *ts_table, struct vos_ts_entry **entryp,
 		 uint32_t *idx, uint32_t hash_idx, uint32_t type)
@@ -221,10 +287,37 @@ vos_ts_evict_lru(struct vos_ts_table *ts_table, struct vos_ts_entry **entryp,
 	struct vos_ts_entry	*entry;
 	struct vos_ts_entry	*neg_entry = NULL;
 	struct vos_ts_info	*info = &ts_table->tt_type_info[type];
-	int			 rc;
+	uint32_t		 first;
+	uint32_t		 victim;
+	uint32_t		 age;
+	uint32_t		 max_age = 0;
+	uint32_t		 i;
+
+	/* Take a free way of the set, otherwise the least recently used one */
+	first = vos_ts_set_idx(info, idx) * VOS_TS_WAYS;
+	victim = first;
+	for (i = first; i < first + VOS_TS_WAYS; i++) {
+		entry = &info->ti_entries[i];
+		if (entry->te_record_ptr == NULL) {
+			victim = i;
+			break;
+		}
 
-	rc = lrua_alloc(ts_table->tt_type_info[type].ti_array, idx, &entry);
-	D_ASSERT(rc == 0); /** autoeviction and no allocation */
+		age = info->ti_clock - entry->te_stamp;
+		if (age > max_age) {
+			max_age = age;
+			victim = i;
+		}
+	}
+
+	entry = &info->ti_entries[victim];
+	if (entry->te_record_ptr != NULL) {
+		if (ts_update_on_evict(ts_table, entry))
+			vos_ts_stat_inc(&info->ti_nr_evict, info->ti_evict_tm);
+		TS_TRACE("Evicted", entry, victim, type);
+	}
+	*idx = victim;
+	entry->te_stamp = ++info->ti_clock;
 
 	if (info->ti_cache_mask)
 		neg_entry = &info->ti_misses[hash_idx];
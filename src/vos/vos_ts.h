@@ -20,18 +20,39 @@
 struct vos_ts_table;
 struct vos_ts_entry;
 
+/** Number of entries in a set of the timestamp cache */
+#define VOS_TS_WAYS		8
+/** Upper limit of entries in the timestamp cache for a type */
+#define VOS_TS_MAX_COUNT	(1U << 23)
+/** Cache statistics are published to telemetry once per this many events */
+#define VOS_TS_TM_BATCH		1024
+
 struct vos_ts_info {
-	/** The LRU array */
-	struct lru_array	*ti_array;
+	/** The entries, every VOS_TS_WAYS entries form a set */
+	struct vos_ts_entry	*ti_entries;
 	/** Back pointer to table */
 	struct vos_ts_table	*ti_table;
 	/** Negative entries for this type */
 	struct vos_ts_entry	*ti_misses;
+	/** Telemetry for lookup hits, misses and evictions raising the
+	 *  timestamps of a shared entry.
+	 */
+	struct d_tm_node_t	*ti_hit_tm;
+	struct d_tm_node_t	*ti_miss_tm;
+	struct d_tm_node_t	*ti_evict_tm;
+	/** Statistics, published to telemetry in batches */
+	uint64_t		ti_nr_hit;
+	uint64_t		ti_nr_miss;
+	uint64_t		ti_nr_evict;
+	/** Access clock for picking the victim in a set */
+	uint32_t		ti_clock;
 	/** Type identifier */
 	uint32_t		ti_type;
 	/** Mask for negative entry cache */
 	uint32_t		ti_cache_mask;
-	/** Number of entries in cache for type (for testing) */
+	/** Mask for set index */
+	uint32_t		ti_set_mask;
+	/** Number of entries in cache for type */
 	uint32_t		ti_count;
 };
 
@@ -63,6 +84,8 @@ struct vos_ts_entry {
 	struct vos_ts_pair	 te_ts;
 	/** Write timestamps for epoch bound check */
 	struct vos_wts_cache	 te_w_cache;
+	/** Access clock of the last lookup */
+	uint32_t		 te_stamp;
 };
 
 /** Check/update flags for a ts set entry */
@@ -124,14 +147,20 @@ struct vos_ts_set {
 	struct vos_ts_set_entry	 ts_entries[0];
 };
 
-/** Timestamp types (should all be powers of 2) */
+/** Timestamp types, default entry counts (should all be powers of 2) and the
+ *  environment variables overriding them
+ */
 #define D_FOREACH_TS_TYPE(ACTION)					\
-	ACTION(VOS_TS_TYPE_CONT,	"container",	1024)		\
-	ACTION(VOS_TS_TYPE_OBJ,		"object",	32 * 1024)	\
-	ACTION(VOS_TS_TYPE_DKEY,	"dkey",		128 * 1024)	\
-	ACTION(VOS_TS_TYPE_AKEY,	"akey",		512 * 1024)
+	ACTION(VOS_TS_TYPE_CONT,	"container",	1024,			\
+	       "DAOS_VOS_TS_CONT_SIZE")					\
+	ACTION(VOS_TS_TYPE_OBJ,		"object",	32 * 1024,		\
+	       "DAOS_VOS_TS_OBJ_SIZE")					\
+	ACTION(VOS_TS_TYPE_DKEY,	"dkey",		128 * 1024,		\
+	       "DAOS_VOS_TS_DKEY_SIZE")					\
+	ACTION(VOS_TS_TYPE_AKEY,	"akey",		512 * 1024,		\
+	       "DAOS_VOS_TS_AKEY_SIZE")
 
-#define DEFINE_TS_TYPE(type, desc, count)	type,
+#define DEFINE_TS_TYPE(type, desc, count, env)	type,
 
 enum {
 	D_FOREACH_TS_TYPE(DEFINE_TS_TYPE)
@@ -230,18 +259,63 @@ vos_ts_set_reset(struct vos_ts_set *ts_set, uint32_t type, uint32_t akey_nr)
 	ts_set->ts_init_count = idx;
 }
 
+/** Internal API: Return the set that the record owning \p idx is cached in.
+ *  The address of the index is the only stable identity of a record, so it
+ *  is hashed to spread neighboring records across sets.
+ */
+static inline uint32_t
+vos_ts_set_idx(const struct vos_ts_info *info, const uint32_t *idx)
+{
+	uint64_t	hash = (uint64_t)idx * 0x9E3779B97F4A7C15ULL;
+
+	return (hash >> 32) & info->ti_set_mask;
+}
+
+/** Internal API: Return the cached entry for the record owning \p idx or
+ *  NULL if it has been evicted.  Lookups with \p touch set make the entry
+ *  the most recently used one of its set.
+ */
+static inline struct vos_ts_entry *
+vos_ts_entry_get(struct vos_ts_info *info, const uint32_t *idx, bool touch)
+{
+	struct vos_ts_entry	*entry;
+
+	if (*idx >= info->ti_count)
+		return NULL;
+
+	entry = &info->ti_entries[*idx];
+	if (entry->te_record_ptr != idx)
+		return NULL;
+
+	if (touch)
+		entry->te_stamp = ++info->ti_clock;
+
+	return entry;
+}
+
+/** Internal API: Bump a statistic, publishing it to telemetry once per
+ *  VOS_TS_TM_BATCH events to keep the lookup path free of telemetry locking.
+ */
+static inline void
+vos_ts_stat_inc(uint64_t *stat, struct d_tm_node_t *tm)
+{
+	(*stat)++;
+	if ((*stat & (VOS_TS_TM_BATCH - 1)) == 0)
+		d_tm_set_counter(tm, *stat);
+}
+
 static inline bool
 vos_ts_lookup_internal(struct vos_ts_set *ts_set, uint32_t type, uint32_t *idx,
 		       struct vos_ts_entry **entryp)
 {
 	struct vos_ts_table	*ts_table = vos_ts_table_get();
 	struct vos_ts_info	*info = &ts_table->tt_type_info[type];
-	void			*entry;
+	struct vos_ts_entry	*entry;
 	struct vos_ts_set_entry	 set_entry = {0};
-	bool found;
 
-	found = lrua_lookup(info->ti_array, idx, &entry);
-	if (found) {
+	entry = vos_ts_entry_get(info, idx, true);
+	if (entry != NULL) {
+		vos_ts_stat_inc(&info->ti_nr_hit, info->ti_hit_tm);
 		D_ASSERT(ts_set->ts_set_size != ts_set->ts_init_count);
 		set_entry.se_entry = entry;
 		ts_set->ts_entries[ts_set->ts_init_count++] = set_entry;
@@ -249,6 +323,7 @@ vos_ts_lookup_internal(struct vos_ts_set *ts_set, uint32_t type, uint32_t *idx,
 		return true;
 	}
 
+	vos_ts_stat_inc(&info->ti_nr_miss, info->ti_miss_tm);
 	return false;
 }
 
@@ -281,7 +356,9 @@ vos_ts_lookup(struct vos_ts_set *ts_set, uint32_t *idx, bool reset,
 	return vos_ts_lookup_internal(ts_set, type, idx, entryp);
 }
 
-/** Internal function to evict LRU and initialize an entry */
+/** Internal function to evict the least recently used entry in the set of
+ *  the record and initialize it for the record
+ */
 void
 vos_ts_evict_lru(struct vos_ts_table *ts_table, struct vos_ts_entry **new_entry,
 		 uint32_t *idx, uint32_t hash_idx, uint32_t new_type);
@@ -572,9 +649,16 @@ vos_ts_set_mark_entry(struct vos_ts_set *ts_set, uint32_t *idx)
 	entry->se_create_idx = idx;
 }
 
+/** Internal function to evict an entry and update the negative or global
+ *  timestamps for the type
+ */
+void
+vos_ts_evict_entry(struct vos_ts_table *ts_table, struct vos_ts_entry *entry,
+		   uint32_t idx);
+
 /** If an entry is still in the thread local timestamp cache, evict it and
- *  update global timestamps for the type.  Move the evicted entry to the LRU
- *  and mark it as already evicted.
+ *  update global timestamps for the type.  The evicted entry is marked free
+ *  so that it is reused first in its set.
  *
  * \param[in]	idx	Address of the entry index.
  * \param[in]	type	Type of the object
@@ -583,8 +667,11 @@ static inline void
 vos_ts_evict(uint32_t *idx, uint32_t type)
 {
 	struct vos_ts_table	*ts_table = vos_ts_table_get();
+	struct vos_ts_entry	*entry;
 
-	lrua_evict(ts_table->tt_type_info[type].ti_array, idx);
+	entry = vos_ts_entry_get(&ts_table->tt_type_info[type], idx, false);
+	if (entry != NULL)
+		vos_ts_evict_entry(ts_table, entry, *idx);
 }
 
 static inline bool
@@ -593,10 +680,13 @@ vos_ts_peek_entry(uint32_t *idx, uint32_t type, struct vos_ts_entry **entryp)
 	struct vos_ts_table	*ts_table = vos_ts_table_get();
 	struct vos_ts_info	*info = &ts_table->tt_type_info[type];
 
-	return lrua_peek(info->ti_array, idx, entryp);
+	*entryp = vos_ts_entry_get(info, idx, false);
+	return *entryp != NULL;
 }
 
-/** Allocate thread local timestamp cache.   Set the initial global times
+/** Allocate thread local timestamp cache.   Set the initial global times.
+ *  The number of entries for each type can be overridden by the environment
+ *  variables in D_FOREACH_TS_TYPE, it's rounded up to a power of 2.
  *
  * \param[in,out]	ts_table	Thread local table pointer
  *
@@ -606,6 +696,14 @@ vos_ts_peek_entry(uint32_t *idx, uint32_t type, struct vos_ts_entry **entryp)
 int
 vos_ts_table_alloc(struct vos_ts_table **ts_table);
 
+/** Register telemetry for the thread local timestamp cache
+ *
+ * \param[in]	ts_table	Thread local table
+ * \param[in]	tgt_id		Target of the xstream
+ */
+void
+vos_ts_table_metrics_init(struct vos_ts_table *ts_table, int tgt_id);
+
 
 /** Free the thread local timestamp cache and reset pointer to NULL
  *
@@ -14,6 +14,7 @@ the client with fault injection of D_ALLOC() usage.
 # pylint: disable=protected-access
 
 import os
+import errno
 import bz2
 import sys
 import time
@@ -938,7 +939,9 @@ class DFuse():
                  container=None,
                  mount_path=None,
                  uns_path=None,
-                 caching=True):
+                 caching=True,
+                 chunk_cache=None,
+                 env=None):
         if mount_path:
             self.dir = mount_path
         else:
@@ -957,6 +960,8 @@ class DFuse():
             self.cores = None
         self._daos = daos
         self.caching = caching
+        self.chunk_cache = chunk_cache
+        self.env = env
         self.use_valgrind = True
         self._sp = None
 
@@ -990,6 +995,8 @@ class DFuse():
         my_env['DAOS_AGENT_DRPC_DIR'] = self._daos.agent_dir
         if self.conf.args.dtx == 'yes':
             my_env['DFS_USE_DTX'] = '1'
+        if self.env:
+            my_env.update(self.env)
 
         self.valgrind = ValgrindHelper(self.conf, v_hint)
         if self.conf.args.memcheck == 'no':
@@ -1016,6 +1023,9 @@ class DFuse():
         if not self.caching:
             cmd.append('--disable-caching')
 
+        if self.chunk_cache:
+            cmd.extend(['--chunk-cache', str(self.chunk_cache)])
+
         if self.uns_path:
             cmd.extend(['--path', self.uns_path])
 
@@ -1842,6 +1852,135 @@ class posix_tests():
         if dfuse.stop():
             self.fatal_errors = True
 
+    def test_chunk_cache(self):
+        """Test the dfuse chunk cache.
+
+        The cache is only used where data caching is enabled, make it small
+        enough that writing the file evicts dirty chunks.
+        """
+
+        container = create_cont(self.conf, self.pool.id(), posix=True,
+                                label='chunk_cache')
+        run_daos_cmd(self.conf,
+                     ['container', 'set-attr',
+                      self.pool.id(), container,
+                      '--attr', 'dfuse-attr-time', '--value', '60s'],
+                     show_stdout=True)
+
+        dfuse = DFuse(self.server,
+                      self.conf,
+                      pool=self.pool.uuid,
+                      container=container,
+                      chunk_cache=4)
+        dfuse.start(v_hint='chunk_cache')
+
+        fname = os.path.join(dfuse.dir, 'chunk_file')
+        block = 64 * 1024
+        data = bytearray()
+        for i in range(8 * 1024 * 1024 // block):
+            data.extend(bytes([i % 251]) * block)
+
+        # Small sequential writes, more than the cache holds.
+        with open(fname, 'wb') as fd:
+            for i in range(0, len(data), block):
+                fd.write(data[i:i + block])
+
+        # Read back twice, the second time served from the cache.
+        for _ in range(2):
+            with open(fname, 'rb') as fd:
+                if fd.read() != data:
+                    print('Data mismatch reading back')
+                    self.fail()
+
+        # Write via a second handle, the first one has the range cached
+        # and should see the new data.
+        with open(fname, 'rb') as rfd:
+            rfd.seek(block)
+            rfd.read(block)
+            with open(fname, 'r+b') as wfd:
+                wfd.seek(block + 100)
+                wfd.write(b'x' * 1000)
+                data[block + 100:block + 1100] = b'x' * 1000
+            rfd.seek(0)
+            if rfd.read() != data:
+                print('Data mismatch after overwrite')
+                self.fail()
+
+        os.truncate(fname, 3 * block)
+        with open(fname, 'rb') as fd:
+            if fd.read() != data[:3 * block]:
+                print('Data mismatch after truncate')
+                self.fail()
+
+        # Write past EOF leaving a hole, the data after the hole is still
+        # cached when reading before it.
+        sparse = os.path.join(dfuse.dir, 'sparse_file')
+        hole = 3 * 1024 * 1024
+        fd = os.open(sparse, os.O_RDWR | os.O_CREAT)
+        os.pwrite(fd, b'a' * 10, 0)
+        os.pwrite(fd, b'b' * 10, hole)
+        sdata = os.pread(fd, hole + 100, 0)
+        os.close(fd)
+        if sdata != b'a' * 10 + bytes(hole - 10) + b'b' * 10:
+            print('Data mismatch reading before sparse write, {} bytes'.
+                  format(len(sdata)))
+            self.fail()
+        if os.stat(sparse).st_size != hole + 10:
+            print('Wrong size after sparse write')
+            self.fail()
+
+        for name in ['fsync_file', 'close_file']:
+            with open(os.path.join(dfuse.dir, name), 'wb') as fd:
+                fd.write(b'c' * 100)
+
+        if dfuse.stop():
+            self.fatal_errors = True
+
+        # Fail all object updates, write back errors should be returned by
+        # fsync and close.
+        fi_file = tempfile.NamedTemporaryFile(prefix='fi_chunk_cache_',
+                                              suffix='.yaml')
+        fi_conf = {'fault_config': [{'id': 65540,
+                                     'probability_x': 1,
+                                     'probability_y': 1}]}
+        fi_file.write(yaml.dump(fi_conf, encoding='utf=8'))
+        fi_file.flush()
+
+        dfuse = DFuse(self.server,
+                      self.conf,
+                      pool=self.pool.uuid,
+                      container=container,
+                      chunk_cache=4,
+                      env={'D_FI_CONFIG': fi_file.name})
+        dfuse.start(v_hint='chunk_cache_fi')
+
+        fd = os.open(os.path.join(dfuse.dir, 'fsync_file'), os.O_RDWR)
+        os.pwrite(fd, b'd' * 100, 0)
+        try:
+            os.fsync(fd)
+            print('fsync did not return the write back error')
+            self.fail()
+        except OSError as error:
+            if error.errno != errno.ENOSPC:
+                raise
+        os.close(fd)
+
+        fd = os.open(os.path.join(dfuse.dir, 'close_file'), os.O_RDWR)
+        os.pwrite(fd, b'd' * 100, 0)
+        try:
+            os.close(fd)
+            print('close did not return the write back error')
+            self.fail()
+        except OSError as error:
+            if error.errno != errno.ENOSPC:
+                raise
+
+        if dfuse.stop():
+            self.fatal_errors = True
+        fi_file.close()
+
+        destroy_container(self.conf, self.pool.id(), container)
+
     @needs_dfuse
     def test_daos_fs_tool(self):
         """Create a UNS entry point"""
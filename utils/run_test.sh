@@ -152,6 +152,7 @@ if [ -d "/mnt/daos" ]; then
 
     COMP="UTEST_client"
     run_test "${SL_BUILD_DIR}/src/client/api/tests/eq_tests"
+    run_test "${SL_BUILD_DIR}/src/object/tests/cli_lat_tests"
 
     COMP="UTEST_security"
     run_test "${SL_BUILD_DIR}/src/security/tests/cli_security_tests"
@@ -162,6 +163,7 @@ if [ -d "/mnt/daos" ]; then
     run_test "${SL_BUILD_DIR}/src/engine/tests/drpc_progress_tests"
     run_test "${SL_BUILD_DIR}/src/engine/tests/drpc_handler_tests"
     run_test "${SL_BUILD_DIR}/src/engine/tests/drpc_listener_tests"
+    run_test "${SL_BUILD_DIR}/src/object/tests/srv_migrate_ctl_tests"
 
     COMP="UTEST_mgmt"
     run_test "${SL_BUILD_DIR}/src/mgmt/tests/srv_drpc_tests"